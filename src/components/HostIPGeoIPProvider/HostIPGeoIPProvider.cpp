@@ -22,15 +22,30 @@
  */
 
 #include "HostIPGeoIPProvider.h"
-#include "Cache.h"
 
+#include "GeoIPCache/GeoIPCache.h"
+
+#include <ICore>
+#include <QDateTime>
+#include <QFileInfo>
 #include <QJsonDocument>
 #include <QNetworkAccessManager>
 #include <QNetworkReply>
 #include <QObject>
+#include <QThread>
+#include <QTimer>
+
+constexpr auto CacheFilename = "host-ip-cache.db";
+constexpr auto CacheCapacity = 4096;
+constexpr auto CacheTimeToLive = 7*24*60*60;
+constexpr auto NegativeCacheTimeToLive = 60*60;
+constexpr auto UnknownCountryCode = "XX";
 
 Nedrysoft::HostIPGeoIPProvider::HostIPGeoIPProvider::HostIPGeoIPProvider() :
-        m_cache(new Nedrysoft::HostIPGeoIPProvider::Cache()) {
+        m_cache(new Nedrysoft::GeoIPCache::GeoIPCache(
+            QFileInfo(Nedrysoft::Core::ICore::getInstance()->storageFolder(), CacheFilename).absoluteFilePath(),
+            CacheCapacity
+        )) {
 
 }
 
@@ -42,11 +57,33 @@ auto Nedrysoft::HostIPGeoIPProvider::HostIPGeoIPProvider::lookup(
         const QString host,
         Nedrysoft::Core::GeoFunction function ) -> void {
 
-    auto cacheResultObject = QJsonObject();
+    /**
+     * the cache belongs to the thread of the provider, a lookup from another thread is handed over to it.
+     */
+
+    if (QThread::currentThread()!=thread()) {
+        QTimer::singleShot(0, this, [=]() {
+            lookup(host, function);
+        });
+
+        return;
+    }
+
+    if (Nedrysoft::GeoIPCache::GeoIPCache::isPrivateAddress(host)) {
+        return;
+    }
+
+    m_cache->lookup(host, [=](Nedrysoft::GeoIPCache::GeoIPCache::Status status, const QVariantMap &cacheResult) {
+        if (status==Nedrysoft::GeoIPCache::GeoIPCache::Status::Hit) {
+            function(host, cacheResult);
+
+            return;
+        }
+
+        if (status==Nedrysoft::GeoIPCache::GeoIPCache::Status::NegativeHit) {
+            return;
+        }
 
-    if (m_cache->find(host, cacheResultObject)) {
-        function(host, cacheResultObject.toVariantMap());
-    } else {
         auto manager = new QNetworkAccessManager();
 
         connect(manager, &QNetworkAccessManager::finished, [this, host, function](QNetworkReply *reply) {
@@ -66,10 +103,10 @@ auto Nedrysoft::HostIPGeoIPProvider::HostIPGeoIPProvider::lookup(
                         }
                     }
 
-                    if (responseValid) {
-                        m_cache->add(jsonDocument.object());
-
-                        resultMap["creationTime"] = jsonDocument.object()["country_name"].toVariant();
+                    if (responseValid && (jsonDocument.object()["country_code"].toString()==UnknownCountryCode)) {
+                        m_cache->addNegative(host, NegativeCacheTimeToLive);
+                    } else if (responseValid) {
+                        resultMap["country"] = jsonDocument.object()["country_name"].toVariant();
                         resultMap["city"] = jsonDocument.object()["city"].toVariant();
                         resultMap["countryCode"] = jsonDocument.object()["country_code"].toVariant();
 #if (QT_VERSION_MAJOR>=6)
@@ -77,6 +114,8 @@ auto Nedrysoft::HostIPGeoIPProvider::HostIPGeoIPProvider::lookup(
 #else
                         resultMap["creationTime"] = QDateTime::currentDateTimeUtc().toTime_t();
 #endif
+                        m_cache->add(host, resultMap, CacheTimeToLive);
+
                         function(host, resultMap);
                     }
                 }
@@ -87,7 +126,7 @@ auto Nedrysoft::HostIPGeoIPProvider::HostIPGeoIPProvider::lookup(
         });
 
         manager->get(QNetworkRequest(QUrl("https://api.hostip.info/get_json.php?ip=" + host)));
-    }
+    });
 }
 
 auto Nedrysoft::HostIPGeoIPProvider::HostIPGeoIPProvider::lookup(const QString host) -> void {
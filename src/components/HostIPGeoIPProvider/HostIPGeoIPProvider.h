@@ -31,10 +31,16 @@
 #include <QObject>
 #include <QVariantMap>
 
+namespace Nedrysoft { namespace GeoIPCache {
+    class GeoIPCache;
+}}
+
 namespace Nedrysoft { namespace HostIPGeoIPProvider {
-    class Cache;
     /**
      * @brief       The HostIPGeoIPProvider class provides a geo lookup using hostip.com.
+     *
+     * @details     Answers are cached, private and reserved addresses and addresses that hostip.com could not
+     *              locate are never requested.
      */
     class HostIPGeoIPProvider :
             public Nedrysoft::Core::IGeoIPProvider {
@@ -83,7 +89,7 @@ namespace Nedrysoft { namespace HostIPGeoIPProvider {
         private:
             //! @cond
 
-            Nedrysoft::HostIPGeoIPProvider::Cache *m_cache;
+            Nedrysoft::GeoIPCache::GeoIPCache *m_cache;
 
             //! @endcond
     };
@@ -26,6 +26,8 @@
 #include "ICMPAPIPingTarget.h"
 #include "ICMPAPIPingTransmitter.h"
 
+#include <PacketRateGovernor>
+#include <SingleShotPool>
 #include <QMutex>
 #include <QThread>
 #include <WS2tcpip.h>
@@ -38,8 +40,31 @@
 constexpr auto DefaultTransmitTimeout = 1000;
 constexpr auto DefaultReplyTimeout = 3000;
 constexpr auto PingPayloadLength = 64;
+constexpr auto IcmpHeaderLength = 8;
 constexpr auto NanosecondsInMillisecond = 1.0e6;
 
+/**
+ * @brief       Returns whether an ICMP API status is one of the destination unreachable results.
+ *
+ * @param[in]   status the status returned by the ICMP API.
+ *
+ * @returns     true if the destination was unreachable; otherwise false.
+ */
+static auto isUnreachable(ULONG status) -> bool {
+    switch(status) {
+        case IP_DEST_NET_UNREACHABLE:
+        case IP_DEST_HOST_UNREACHABLE:
+        case IP_DEST_PROT_UNREACHABLE:
+        case IP_DEST_PORT_UNREACHABLE: {
+            return true;
+        }
+
+        default: {
+            return false;
+        }
+    }
+}
+
 /**
  * @brief       Private class to store the engines instance data.
  */
@@ -74,6 +99,8 @@ class Nedrysoft::ICMPAPIPingEngine::ICMPAPIPingEngineData {
 
         int m_timeout;
         int m_interval;
+
+        Nedrysoft::RouteAnalyser::SingleShotPool m_singleShotPool;
 };
 
 Nedrysoft::ICMPAPIPingEngine::ICMPAPIPingEngine::ICMPAPIPingEngine(Nedrysoft::Core::IPVersion version) :
@@ -83,6 +110,8 @@ Nedrysoft::ICMPAPIPingEngine::ICMPAPIPingEngine::ICMPAPIPingEngine(Nedrysoft::Co
 }
 
 Nedrysoft::ICMPAPIPingEngine::ICMPAPIPingEngine::~ICMPAPIPingEngine() {
+    d->m_singleShotPool.waitForDone();
+
     doStop();
 
     d.reset();
@@ -223,6 +252,10 @@ auto Nedrysoft::ICMPAPIPingEngine::ICMPAPIPingEngine::singleShot(
         memcpy(targetAddress.sin6_addr.u.Word, hostAddress.toIPv6Address().c, sizeof(targetAddress.sin6_addr));
     }
 
+    Nedrysoft::RouteAnalyser::PacketRateGovernor::getInstance()->acquire(
+            this,
+            IcmpHeaderLength + dataBuffer.length() );
+
     timer.restart();
 
     if (hostAddress.protocol() == QAbstractSocket::IPv4Protocol) {
@@ -267,6 +300,8 @@ auto Nedrysoft::ICMPAPIPingEngine::ICMPAPIPingEngine::singleShot(
                 resultCode = Nedrysoft::RouteAnalyser::PingResult::ResultCode::Ok;
             } else if (pEchoReply->Status == IP_TTL_EXPIRED_TRANSIT) {
                 resultCode = Nedrysoft::RouteAnalyser::PingResult::ResultCode::TimeExceeded;
+            } else if (isUnreachable(pEchoReply->Status)) {
+                resultCode = Nedrysoft::RouteAnalyser::PingResult::ResultCode::Unreachable;
             }
         } else {
             PICMPV6_ECHO_REPLY pEchoReply = (PICMPV6_ECHO_REPLY) replyBuffer.data();
@@ -285,6 +320,8 @@ auto Nedrysoft::ICMPAPIPingEngine::ICMPAPIPingEngine::singleShot(
                 resultCode = Nedrysoft::RouteAnalyser::PingResult::ResultCode::Ok;
             } else if (pEchoReply->Status == IP_TTL_EXPIRED_TRANSIT) {
                 resultCode = Nedrysoft::RouteAnalyser::PingResult::ResultCode::TimeExceeded;
+            } else if (isUnreachable(pEchoReply->Status)) {
+                resultCode = Nedrysoft::RouteAnalyser::PingResult::ResultCode::Unreachable;
             }
         }
     }
@@ -302,6 +339,16 @@ auto Nedrysoft::ICMPAPIPingEngine::ICMPAPIPingEngine::singleShot(
     );
 }
 
+auto Nedrysoft::ICMPAPIPingEngine::ICMPAPIPingEngine::singleShot(
+        const Nedrysoft::RouteAnalyser::SingleShotProbeList &probes,
+        double timeout,
+        uint16_t flowId,
+        Nedrysoft::RouteAnalyser::SingleShotCallback callback )
+            -> std::future<QList<Nedrysoft::RouteAnalyser::PingResult> > {
+
+    return d->m_singleShotPool.singleShot(this, probes, timeout, flowId, callback);
+}
+
 auto Nedrysoft::ICMPAPIPingEngine::ICMPAPIPingEngine::targets() -> QList<Nedrysoft::RouteAnalyser::IPingTarget *> {
     QList<Nedrysoft::RouteAnalyser::IPingTarget *> list;
 
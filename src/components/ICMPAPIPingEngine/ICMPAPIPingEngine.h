@@ -142,6 +142,27 @@ namespace Nedrysoft { namespace ICMPAPIPingEngine {
                     int ttl,
                     double timeout ) -> Nedrysoft::RouteAnalyser::PingResult override;
 
+            /**
+             * @brief       Transmits a batch of single pings concurrently.
+             *
+             * @details     Each probe is run as a blocking single shot on the pool owned by the engine.
+             *
+             * @see         Nedrysoft::RouteAnalyser::IPingEngine::singleShot
+             *
+             * @param[in]   probes the list of probes to send.
+             * @param[in]   timeout time in seconds to wait for the responses.
+             * @param[in]   flowId the flow identifier to use for the probes, 0 if the engine should choose.
+             * @param[in]   callback called with the index of the probe and its result as each probe completes.
+             *
+             * @returns     a future which holds the results in the same order as the probes.
+             */
+            auto singleShot(
+                    const Nedrysoft::RouteAnalyser::SingleShotProbeList &probes,
+                    double timeout,
+                    uint16_t flowId,
+                    Nedrysoft::RouteAnalyser::SingleShotCallback callback
+            ) -> std::future<QList<Nedrysoft::RouteAnalyser::PingResult> > override;
+
             /**
              * @brief       Removes a ping target from this engine instance.
              *
@@ -32,11 +32,21 @@
 #include "ICMPPacket/ICMPPacket.h"
 #include "Utils.h"
 
+#include <ICore>
+#include <PacketRateGovernor>
+#include <SingleShotPool>
 #include <QElapsedTimer>
+#include <QHash>
 #include <QMap>
 #include <QMutex>
+#include <QSemaphore>
+#include <QVector>
 #include <QThread>
+#include <atomic>
+#include <cmath>
 #include <cstdint>
+#include <memory>
+#include <spdlog/spdlog.h>
 
 constexpr auto DefaultReceiveTimeout = 1000;
 constexpr auto DefaultTerminateThreadTimeout = 5000;
@@ -46,6 +56,34 @@ constexpr auto SecondsToMs(double seconds) {
     return seconds*1000;
 }
 
+constexpr auto DefaultPayloadLength = 52;
+
+/**
+ * @brief       Private class which tracks a single shot request while it waits on the shared receiver.
+ */
+class Nedrysoft::ICMPPingEngine::ICMPPingSingleShot {
+    public:
+        /**
+         * @brief       Constructs a ICMPPingSingleShot for the given ttl.
+         *
+         * @param[in]   ttl the ttl that the request was sent with.
+         */
+        ICMPPingSingleShot(int ttl) :
+                m_ttl(ttl) {
+
+        }
+
+        friend class ICMPPingEngine;
+
+    private:
+        QElapsedTimer m_timer;
+        QDateTime m_transmitEpoch;
+        QSemaphore m_replied;
+        std::shared_ptr<QSemaphore> m_batchReplied;
+        Nedrysoft::RouteAnalyser::PingResult m_result;
+        int m_ttl;
+};
+
 /**
  * @brief       Private class to store the ping engines instance data.
  */
@@ -65,8 +103,11 @@ class Nedrysoft::ICMPPingEngine::ICMPPingEngineData {
                 m_timeout(DefaultReceiveTimeout),
                 m_epoch(QDateTime::currentDateTime()),
                 m_receiverWorker(nullptr),
-                m_interval(DefaultTransmitInterval) {
+                m_interval(DefaultTransmitInterval),
+                m_singleShotId(Nedrysoft::Core::ICore::getInstance()->random(1.0, UINT16_MAX-1)),
+                m_flowId(0) {
 
+            m_deadlineTimer.start();
         }
 
         friend class ICMPPingEngine;
@@ -82,9 +123,13 @@ class Nedrysoft::ICMPPingEngine::ICMPPingEngineData {
         QThread *m_timeoutThread;
 
         QMap<uint32_t, Nedrysoft::ICMPPingEngine::ICMPPingItem *> m_pingRequests;
+        QMultiMap<int64_t, uint32_t> m_requestDeadlines;
+        QElapsedTimer m_deadlineTimer;
         QMutex m_requestsMutex;
 
         QList<Nedrysoft::ICMPPingEngine::ICMPPingTarget *> m_targetList;
+        QHash<Nedrysoft::ICMPPingEngine::ICMPPingTarget *, int> m_targetIndex;
+        QMutex m_targetListMutex;
 
         int m_timeout;
 
@@ -95,6 +140,18 @@ class Nedrysoft::ICMPPingEngine::ICMPPingEngineData {
         Nedrysoft::Core::IPVersion m_version;
 
         Nedrysoft::ICMPPingEngine::ICMPPingReceiverWorker *m_receiverWorker;
+
+        QMap<int, Nedrysoft::ICMPSocket::ICMPSocket *> m_writeSockets;
+        QMutex m_writeSocketsMutex;
+
+        QMap<uint32_t, Nedrysoft::ICMPPingEngine::ICMPPingSingleShot *> m_singleShotRequests;
+        QMutex m_singleShotMutex;
+
+        uint16_t m_singleShotId;
+
+        uint16_t m_flowId;
+
+        Nedrysoft::RouteAnalyser::SingleShotPool m_singleShotPool;
 };
 
 Nedrysoft::ICMPPingEngine::ICMPPingEngine::ICMPPingEngine(Nedrysoft::Core::IPVersion version) :
@@ -106,19 +163,25 @@ Nedrysoft::ICMPPingEngine::ICMPPingEngine::ICMPPingEngine(Nedrysoft::Core::IPVer
 }
 
 Nedrysoft::ICMPPingEngine::ICMPPingEngine::~ICMPPingEngine() {
+    /**
+     * a batch that is still running uses the receiver and the single shot requests of the engine, so it must
+     * finish before anything is torn down.
+     */
+
+    d->m_singleShotPool.waitForDone();
+
     doStop();
 
+    qDeleteAll(d->m_targetList);
+    qDeleteAll(d->m_writeSockets);
+
     d.reset();
 }
 
 auto Nedrysoft::ICMPPingEngine::ICMPPingEngine::addTarget(
         QHostAddress hostAddress) -> Nedrysoft::RouteAnalyser::IPingTarget * {
 
-    auto target = new Nedrysoft::ICMPPingEngine::ICMPPingTarget(this, hostAddress);
-
-    d->m_transmitterWorker->addTarget(target);
-
-    return target;
+    return addTarget(hostAddress, 0);
 }
 
 auto Nedrysoft::ICMPPingEngine::ICMPPingEngine::addTarget(
@@ -127,13 +190,102 @@ auto Nedrysoft::ICMPPingEngine::ICMPPingEngine::addTarget(
 
     auto target = new Nedrysoft::ICMPPingEngine::ICMPPingTarget(this, hostAddress, ttl);
 
+    target->retransmissionTimeout()->setInitialTimeout(d->m_timeout/1000.0);
+
+    QMutexLocker locker(&d->m_targetListMutex);
+
+    if (d->m_flowId) {
+        target->setId(d->m_flowId);
+    }
+
+    d->m_targetIndex[target] = d->m_targetList.count();
     d->m_targetList.append(target);
 
+    /**
+     * if the engine is already running then the target is handed straight to the transmitter, it will be
+     * included from the next transmission round onwards without disturbing the existing targets.
+     */
+
+    if (d->m_transmitterWorker) {
+        d->m_transmitterWorker->addTarget(target);
+    }
+
     return target;
 }
 
+auto Nedrysoft::ICMPPingEngine::ICMPPingEngine::nextSequenceId() -> uint16_t {
+    static std::atomic<uint16_t> sequenceId(
+        static_cast<uint16_t>(Nedrysoft::Core::ICore::getInstance()->random(0.0, UINT16_MAX))
+    );
+
+    return sequenceId++;
+}
+
+auto Nedrysoft::ICMPPingEngine::ICMPPingEngine::setFlowId(uint16_t flowId) -> bool {
+    QMutexLocker locker(&d->m_targetListMutex);
+
+    d->m_flowId = flowId;
+
+    return true;
+}
+
 auto Nedrysoft::ICMPPingEngine::ICMPPingEngine::removeTarget(Nedrysoft::RouteAnalyser::IPingTarget *target) -> bool {
-    Q_UNUSED(target)
+    auto pingTarget = qobject_cast<Nedrysoft::ICMPPingEngine::ICMPPingTarget *>(target);
+
+    QMutexLocker locker(&d->m_targetListMutex);
+
+    if (!pingTarget || !d->m_targetIndex.contains(pingTarget)) {
+        return false;
+    }
+
+    /**
+     * once removed from the transmitter no new requests can be created for the target, the transmitter then
+     * deletes the target when no round that it is sending references it.
+     */
+
+    auto transmitterOwnsTarget = (d->m_transmitterWorker && d->m_transmitterWorker->removeTarget(pingTarget));
+
+    // reclaim any requests that are still in flight, any late replies will no longer match a request.
+
+    d->m_requestsMutex.lock();
+
+    QMutableMapIterator<uint32_t, Nedrysoft::ICMPPingEngine::ICMPPingItem *> i(d->m_pingRequests);
+
+    while (i.hasNext()) {
+        i.next();
+
+        if (i.value()->target() == pingTarget) {
+            d->m_requestDeadlines.remove(i.value()->deadline(), i.key());
+
+            delete i.value();
+
+            i.remove();
+        }
+    }
+
+    d->m_requestsMutex.unlock();
+
+    /**
+     * the order of the targets is not significant, so the last target is moved into the slot of the removed
+     * target which keeps the removal O(1).
+     */
+
+    auto index = d->m_targetIndex.take(pingTarget);
+    auto lastTarget = d->m_targetList.takeLast();
+
+    if (lastTarget != pingTarget) {
+        d->m_targetList[index] = lastTarget;
+        d->m_targetIndex[lastTarget] = index;
+    }
+
+    /**
+     * results are emitted while the requests mutex is held, so any result that references this target has
+     * already been queued, deleting later ensures that the target outlives those queued results.
+     */
+
+    if (!transmitterOwnsTarget) {
+        pingTarget->deleteLater();
+    }
 
     return true;
 }
@@ -157,14 +309,7 @@ auto Nedrysoft::ICMPPingEngine::ICMPPingEngine::start() -> bool {
 
     // connect to the receiver thread
 
-    d->m_receiverWorker = Nedrysoft::ICMPPingEngine::ICMPPingReceiverWorker::getInstance();
-
-    connect(d->m_receiverWorker,
-            &Nedrysoft::ICMPPingEngine::ICMPPingReceiverWorker::packetReceived,
-            this,
-            &Nedrysoft::ICMPPingEngine::ICMPPingEngine::onPacketReceived,
-            Qt::DirectConnection
-    );
+    connectReceiver();
 
     // transmitter thread
 
@@ -176,10 +321,14 @@ auto Nedrysoft::ICMPPingEngine::ICMPPingEngine::start() -> bool {
 
     d->m_transmitterWorker->setInterval(d->m_interval);
 
+    d->m_targetListMutex.lock();
+
     for (auto target : d->m_targetList) {
         d->m_transmitterWorker->addTarget(target);
     }
 
+    d->m_targetListMutex.unlock();
+
     connect(d->m_transmitterThread, &QThread::started, d->m_transmitterWorker,
             &Nedrysoft::ICMPPingEngine::ICMPPingTransmitter::doWork);
 
@@ -232,17 +381,22 @@ auto Nedrysoft::ICMPPingEngine::ICMPPingEngine::doStop() -> bool {
         d->m_timeoutThread = nullptr;
     }
 
+    d->m_targetListMutex.lock();
+
     delete d->m_transmitterWorker;
     delete d->m_timeoutWorker;
 
     d->m_transmitterWorker = nullptr;
     d->m_timeoutWorker = nullptr;
 
-    for (auto request : d->m_pingRequests) {
-        delete request;
-    }
+    d->m_targetListMutex.unlock();
+
+    QMutexLocker locker(&d->m_requestsMutex);
+
+    qDeleteAll(d->m_pingRequests);
 
     d->m_pingRequests.clear();
+    d->m_requestDeadlines.clear();
 
     return true;
 }
@@ -256,7 +410,17 @@ auto Nedrysoft::ICMPPingEngine::ICMPPingEngine::addRequest(Nedrysoft::ICMPPingEn
 
     auto id = Nedrysoft::Utils::fzMake32(pingItem->id(), pingItem->sequenceId());
 
+    /**
+     * the deadline is taken from the adaptive timeout of the target (srtt+4*rttvar) when the request is created, a
+     * request that is sent later than this is given the remainder of its timeout when the deadline is reached.
+     */
+
+    pingItem->setDeadline(
+            d->m_deadlineTimer.elapsed() +
+            static_cast<int64_t>(std::ceil(SecondsToMs(pingItem->target()->retransmissionTimeout()->timeout()))) );
+
     d->m_pingRequests[id] = pingItem;
+    d->m_requestDeadlines.insert(pingItem->deadline(), id);
 }
 
 auto Nedrysoft::ICMPPingEngine::ICMPPingEngine::removeRequest(
@@ -268,6 +432,7 @@ auto Nedrysoft::ICMPPingEngine::ICMPPingEngine::removeRequest(
 
     if (d->m_pingRequests.contains(id)) {
         d->m_pingRequests.remove(id);
+        d->m_requestDeadlines.remove(pingItem->deadline(), id);
 
         delete pingItem;
     }
@@ -295,42 +460,75 @@ auto Nedrysoft::ICMPPingEngine::ICMPPingEngine::setTimeout(int timeout) -> bool
     return true;
 }
 
-auto Nedrysoft::ICMPPingEngine::ICMPPingEngine::timeoutRequests() -> void {
+auto Nedrysoft::ICMPPingEngine::ICMPPingEngine::timeoutRequests() -> int {
     QMutexLocker locker(&d->m_requestsMutex);
-    QMutableMapIterator<uint32_t, Nedrysoft::ICMPPingEngine::ICMPPingItem *> i(d->m_pingRequests);
 
-    while (i.hasNext()) {
-        i.next();
+    auto currentTime = d->m_deadlineTimer.elapsed();
+
+    while (!d->m_requestDeadlines.isEmpty()) {
+        auto deadlineIterator = d->m_requestDeadlines.begin();
+
+        if (deadlineIterator.key()>currentTime) {
+            return static_cast<int>(deadlineIterator.key()-currentTime);
+        }
+
+        auto requestId = deadlineIterator.value();
 
-        auto pingItem = i.value();
+        d->m_requestDeadlines.erase(deadlineIterator);
 
-        auto elapsedTime = pingItem->elapsedTime();
+        auto pingItem = d->m_pingRequests.value(requestId, nullptr);
 
-        if (elapsedTime > d->m_timeout/1000.0) {
-            if (pingItem->lock()) {
-                if (!pingItem->serviced()) {
-                    QHostAddress hostAddress;
+        if (!pingItem) {
+            continue;
+        }
 
-                    pingItem->setServiced(true);
+        /**
+         * each target has its own adaptive timeout (srtt+4*rttvar), so a nearby hop is declared lost within a
+         * few milliseconds of its normal reply time while a slow link is given longer than the default.  the
+         * packet may have been sent after the deadline was set or the timeout may have grown since, in which
+         * case the request is put back with the time that it has left.
+         */
 
-                    Nedrysoft::RouteAnalyser::PingResult pingResult(
-                            pingItem->sampleNumber(),
-                            Nedrysoft::RouteAnalyser::PingResult::ResultCode::NoReply,
-                            hostAddress,
-                            pingItem->transmitEpoch(),
-                            pingItem->elapsedTime()/1e9,
-                            pingItem->target(),
-                            -1);
+        auto retransmissionTimeout = pingItem->target()->retransmissionTimeout();
 
-                    Q_EMIT result(pingResult);
-                }
+        auto remainingTime = retransmissionTimeout->timeout()-pingItem->elapsedTime();
 
-                i.remove();
+        if ((remainingTime>0) || (!pingItem->lock())) {
+            pingItem->setDeadline(
+                    currentTime+qMax<int64_t>(1, static_cast<int64_t>(std::ceil(SecondsToMs(remainingTime)))) );
 
-                pingItem->unlock();
-            }
+            d->m_requestDeadlines.insert(pingItem->deadline(), requestId);
+
+            continue;
         }
+
+        if (!pingItem->serviced()) {
+            QHostAddress hostAddress;
+
+            pingItem->setServiced(true);
+
+            retransmissionTimeout->addLoss();
+
+            Nedrysoft::RouteAnalyser::PingResult pingResult(
+                    pingItem->sampleNumber(),
+                    Nedrysoft::RouteAnalyser::PingResult::ResultCode::NoReply,
+                    hostAddress,
+                    pingItem->transmitEpoch(),
+                    pingItem->elapsedTime(),
+                    pingItem->target(),
+                    -1);
+
+            Q_EMIT result(pingResult);
+        }
+
+        d->m_pingRequests.remove(requestId);
+
+        pingItem->unlock();
+
+        delete pingItem;
     }
+
+    return -1;
 }
 
 auto Nedrysoft::ICMPPingEngine::ICMPPingEngine::saveConfiguration() -> QJsonObject {
@@ -355,6 +553,36 @@ auto Nedrysoft::ICMPPingEngine::ICMPPingEngine::version() -> Nedrysoft::Core::IP
     return d->m_version;
 }
 
+auto Nedrysoft::ICMPPingEngine::ICMPPingEngine::connectReceiver() -> void {
+    d->m_receiverWorker = Nedrysoft::ICMPPingEngine::ICMPPingReceiverWorker::getInstance(d->m_version);
+
+    connect(d->m_receiverWorker,
+            &Nedrysoft::ICMPPingEngine::ICMPPingReceiverWorker::packetReceived,
+            this,
+            &Nedrysoft::ICMPPingEngine::ICMPPingEngine::onPacketReceived,
+            static_cast<Qt::ConnectionType>(Qt::DirectConnection | Qt::UniqueConnection)
+    );
+}
+
+auto Nedrysoft::ICMPPingEngine::ICMPPingEngine::writeSocket(int ttl) -> Nedrysoft::ICMPSocket::ICMPSocket * {
+    QMutexLocker locker(&d->m_writeSocketsMutex);
+
+    auto socket = d->m_writeSockets.value(ttl, nullptr);
+
+    if (!socket) {
+        socket = Nedrysoft::ICMPSocket::ICMPSocket::createWriteSocket(
+            ttl,
+            static_cast<Nedrysoft::ICMPSocket::IPVersion>(d->m_version)
+        );
+
+        if (socket) {
+            d->m_writeSockets[ttl] = socket;
+        }
+    }
+
+    return socket;
+}
+
 void Nedrysoft::ICMPPingEngine::ICMPPingEngine::onPacketReceived(
         QElapsedTimer receiveTimer,
         QByteArray receiveBuffer,
@@ -380,36 +608,83 @@ void Nedrysoft::ICMPPingEngine::ICMPPingEngine::onPacketReceived(
         resultCode = Nedrysoft::RouteAnalyser::PingResult::ResultCode::TimeExceeded;
     }
 
-    auto pingItem = this->getRequest(Nedrysoft::Utils::fzMake32(responsePacket.id(), responsePacket.sequence()));
+    if (responsePacket.resultCode() == Nedrysoft::ICMPPacket::DestinationUnreachable) {
+        resultCode = Nedrysoft::RouteAnalyser::PingResult::ResultCode::Unreachable;
+    }
 
-    if (pingItem) {
-        auto elapsedTime = pingItem->elapsedTime();
+    auto requestId = Nedrysoft::Utils::fzMake32(responsePacket.id(), responsePacket.sequence());
 
-        pingItem->lock();
+    d->m_singleShotMutex.lock();
 
-        if (!pingItem->serviced()) {
+    auto singleShot = d->m_singleShotRequests.take(requestId);
 
-            auto pingResult = Nedrysoft::RouteAnalyser::PingResult(
-                pingItem->sampleNumber(),
-                resultCode,
-                receiveAddress,
-                pingItem->transmitEpoch(),
-                elapsedTime,
-                pingItem->target(),
-                -1
-            );
+    d->m_singleShotMutex.unlock();
 
-            pingItem->setServiced(true);
+    if (singleShot) {
+        auto hopsToTarget = -1;
+
+        if (responsePacket.ttl()!=-1) {
+            hopsToTarget = singleShot->m_ttl-responsePacket.ttl();
+        }
+
+        singleShot->m_result = Nedrysoft::RouteAnalyser::PingResult(
+            0,
+            resultCode,
+            receiveAddress,
+            singleShot->m_transmitEpoch,
+            singleShot->m_timer.nsecsElapsed()/1e9,
+            nullptr,
+            hopsToTarget
+        );
+
+        /**
+         * the requester may free the request as soon as it has been signalled, so the batch semaphore is taken
+         * before the request is released.
+         */
 
-            pingItem->unlock();
+        auto batchReplied = singleShot->m_batchReplied;
 
-            Q_EMIT Nedrysoft::ICMPPingEngine::ICMPPingEngine::result(pingResult);
+        singleShot->m_replied.release();
 
-            removeRequest(pingItem);
-        } else {
-            pingItem->unlock();
+        if (batchReplied) {
+            batchReplied->release();
         }
+
+        return;
+    }
+
+    /**
+     * the request is taken out of the map while the mutex is held, this makes the receiver the sole owner of
+     * the item and guarantees that a concurrent timeout or target removal cannot reclaim it underneath us.
+     */
+
+    QMutexLocker locker(&d->m_requestsMutex);
+
+    auto pingItem = d->m_pingRequests.take(requestId);
+
+    if (!pingItem) {
+        return;
     }
+
+    d->m_requestDeadlines.remove(pingItem->deadline(), requestId);
+
+    auto pingResult = Nedrysoft::RouteAnalyser::PingResult(
+        pingItem->sampleNumber(),
+        resultCode,
+        receiveAddress,
+        pingItem->transmitEpoch(),
+        pingItem->elapsedTime(),
+        pingItem->target(),
+        -1
+    );
+
+    pingItem->setServiced(true);
+
+    pingItem->target()->retransmissionTimeout()->addSample(pingItem->elapsedTime());
+
+    Q_EMIT Nedrysoft::ICMPPingEngine::ICMPPingEngine::result(pingResult);
+
+    delete pingItem;
 }
 
 auto Nedrysoft::ICMPPingEngine::ICMPPingEngine::interval() -> int {
@@ -417,6 +692,7 @@ auto Nedrysoft::ICMPPingEngine::ICMPPingEngine::interval() -> int {
 }
 
 auto Nedrysoft::ICMPPingEngine::ICMPPingEngine::targets() -> QList<Nedrysoft::RouteAnalyser::IPingTarget *> {
+    QMutexLocker locker(&d->m_targetListMutex);
     QList<Nedrysoft::RouteAnalyser::IPingTarget *> list;
 
     for (auto target : d->m_targetList) {
@@ -431,108 +707,251 @@ auto Nedrysoft::ICMPPingEngine::ICMPPingEngine::singleShot(
         int ttl,
         double timeout ) -> Nedrysoft::RouteAnalyser::PingResult {
 
-    Nedrysoft::ICMPSocket::ICMPSocket *writeSocket;
-    Nedrysoft::ICMPSocket::ICMPSocket *readSocket;
+    return singleShot(hostAddress, ttl, timeout, d->m_singleShotId);
+}
+
+auto Nedrysoft::ICMPPingEngine::ICMPPingEngine::singleShot(
+        QHostAddress hostAddress,
+        int ttl,
+        double timeout,
+        uint16_t flowId ) -> Nedrysoft::RouteAnalyser::PingResult {
+
+    /**
+     * the request is sent on a write socket that is shared by all single shot requests with the same ttl, the
+     * reply is picked up by the shared receiver thread and matched to this request in onPacketReceived, so
+     * the only per-call cost is building and sending the packet.
+     */
 
-    Nedrysoft::RouteAnalyser::PingResult pingResult;
+    connectReceiver();
 
-    if (hostAddress.protocol() == QAbstractSocket::IPv4Protocol) {
-        writeSocket = Nedrysoft::ICMPSocket::ICMPSocket::createWriteSocket(ttl, Nedrysoft::ICMPSocket::V4);
-    } else if (hostAddress.protocol() == QAbstractSocket::IPv6Protocol) {
-        writeSocket = Nedrysoft::ICMPSocket::ICMPSocket::createWriteSocket(ttl, Nedrysoft::ICMPSocket::V6);
-    }
+    auto socket = writeSocket(ttl);
 
-    if (hostAddress.protocol() == QAbstractSocket::IPv4Protocol) {
-        readSocket = Nedrysoft::ICMPSocket::ICMPSocket::createReadSocket(Nedrysoft::ICMPSocket::V4);
-    } else if (hostAddress.protocol() == QAbstractSocket::IPv6Protocol) {
-        readSocket = Nedrysoft::ICMPSocket::ICMPSocket::createReadSocket(Nedrysoft::ICMPSocket::V6);
+    if (!socket) {
+        return Nedrysoft::RouteAnalyser::PingResult();
     }
 
-    QByteArray receiveBuffer;
+    auto sequenceId = nextSequenceId();
 
-    // TODO: fix
+    auto requestId = Nedrysoft::Utils::fzMake32(flowId, sequenceId);
 
-    int id = 6666;
-    int sequenceId = 5555 + ttl;
+    Nedrysoft::ICMPPingEngine::ICMPPingSingleShot request(ttl);
 
     auto buffer = Nedrysoft::ICMPPacket::ICMPPacket::pingPacket(
-        id,
+        flowId,
         sequenceId,
-        52,
+        DefaultPayloadLength,
         hostAddress,
-        static_cast<Nedrysoft::ICMPPacket::IPVersion>(version())
+        static_cast<Nedrysoft::ICMPPacket::IPVersion>(version()),
+        true
     );
 
-    auto transmitEpoch = QDateTime::currentDateTime();
+    Nedrysoft::RouteAnalyser::PacketRateGovernor::getInstance()->acquire(this, buffer.length());
+
+    d->m_singleShotMutex.lock();
+
+    d->m_singleShotRequests[requestId] = &request;
+
+    request.m_transmitEpoch = QDateTime::currentDateTime();
+    request.m_timer.start();
 
-    writeSocket->sendto(buffer, hostAddress);
+    d->m_singleShotMutex.unlock();
 
-    QHostAddress receiveAddress;
+    if (socket->sendto(buffer, hostAddress) != buffer.length()) {
+        SPDLOG_ERROR("Unable to send packet to "+hostAddress.toString().toStdString());
+    }
+
+    if (request.m_replied.tryAcquire(1, static_cast<int>(SecondsToMs(timeout)))) {
+        return request.m_result;
+    }
+
+    /**
+     * if the request is no longer in the map then the receiver has claimed it and is about to signal us, so
+     * we must wait for it to finish with the request before it goes out of scope.
+     */
 
-    QElapsedTimer timer;
+    d->m_singleShotMutex.lock();
 
-    timer.start();
+    auto timedOut = d->m_singleShotRequests.remove(requestId) != 0;
 
-    while(timer.elapsed()<(SecondsToMs(timeout))) {
-        auto remaining = DefaultReceiveTimeout-timer.elapsed();
+    d->m_singleShotMutex.unlock();
+
+    if (!timedOut) {
+        request.m_replied.acquire();
+
+        return request.m_result;
+    }
 
-        if (remaining<=0) {
-            return pingResult;
+    return Nedrysoft::RouteAnalyser::PingResult();
+}
+
+auto Nedrysoft::ICMPPingEngine::ICMPPingEngine::singleShot(
+        const Nedrysoft::RouteAnalyser::SingleShotProbeList &probes,
+        double timeout,
+        uint16_t flowId,
+        Nedrysoft::RouteAnalyser::SingleShotCallback callback )
+            -> std::future<QList<Nedrysoft::RouteAnalyser::PingResult> > {
+
+    auto batchPromise = std::make_shared<std::promise<QList<Nedrysoft::RouteAnalyser::PingResult> > >();
+    auto batchFuture = batchPromise->get_future();
+
+    if (!flowId) {
+        flowId = d->m_singleShotId;
+    }
+
+    d->m_singleShotPool.start([this, probes, timeout, flowId, callback, batchPromise]() {
+        batchPromise->set_value(batchSingleShot(probes, timeout, flowId, callback));
+    });
+
+    return batchFuture;
+}
+
+auto Nedrysoft::ICMPPingEngine::ICMPPingEngine::batchSingleShot(
+        const Nedrysoft::RouteAnalyser::SingleShotProbeList &probes,
+        double timeout,
+        uint16_t flowId,
+        Nedrysoft::RouteAnalyser::SingleShotCallback callback ) -> QList<Nedrysoft::RouteAnalyser::PingResult> {
+
+    auto packetRateGovernor = Nedrysoft::RouteAnalyser::PacketRateGovernor::getInstance();
+    auto batchReplied = std::make_shared<QSemaphore>();
+    auto requests = QList<Nedrysoft::ICMPPingEngine::ICMPPingSingleShot *>();
+    auto requestIds = QList<uint32_t>();
+    auto results = QList<Nedrysoft::RouteAnalyser::PingResult>();
+    auto delivered = QVector<bool>(probes.count(), false);
+    auto pendingCount = 0;
+    auto queuedCount = 0;
+
+    connectReceiver();
+
+    /**
+     * every request is registered and queued before any are sent, the whole batch is then handed to the kernel
+     * together and the replies are collected by the shared receiver as they arrive.
+     */
+
+    for (auto index = 0; index < probes.count(); index++) {
+        auto hostAddress = probes.at(index).first;
+        auto ttl = probes.at(index).second;
+        auto socket = writeSocket(ttl);
+
+        results.append(Nedrysoft::RouteAnalyser::PingResult());
+
+        if (!socket) {
+            requests.append(nullptr);
+            requestIds.append(0);
+
+            continue;
         }
 
-        if (readSocket->recvfrom(receiveBuffer, receiveAddress, remaining)) {
-            auto responseTime = QDateTime::currentDateTime();
-            auto roundTripTime = timer.nsecsElapsed();
+        auto sequenceId = nextSequenceId();
 
-            Nedrysoft::RouteAnalyser::PingResult::ResultCode resultCode;
+        auto requestId = Nedrysoft::Utils::fzMake32(flowId, sequenceId);
+        auto request = new Nedrysoft::ICMPPingEngine::ICMPPingSingleShot(ttl);
 
-            if (!receiveBuffer.length()) {
-                continue;
-            }
+        request->m_batchReplied = batchReplied;
 
-            auto responsePacket = Nedrysoft::ICMPPacket::ICMPPacket::fromData(
-                receiveBuffer,
-                static_cast<Nedrysoft::ICMPPacket::IPVersion>(this->version())
-            );
+        auto buffer = Nedrysoft::ICMPPacket::ICMPPacket::pingPacket(
+            flowId,
+            sequenceId,
+            DefaultPayloadLength,
+            hostAddress,
+            static_cast<Nedrysoft::ICMPPacket::IPVersion>(version()),
+            true
+        );
 
-            if ((responsePacket.id()!=id) || (responsePacket.sequence()!=sequenceId)) {
-                continue;
-            }
+        if (!packetRateGovernor->tryAcquire(this, buffer.length())) {
+            queuedCount -= Nedrysoft::ICMPSocket::ICMPSocket::flush();
+
+            packetRateGovernor->acquire(this, buffer.length());
+        }
+
+        d->m_singleShotMutex.lock();
+
+        d->m_singleShotRequests[requestId] = request;
+
+        request->m_transmitEpoch = QDateTime::currentDateTime();
+        request->m_timer.start();
+
+        d->m_singleShotMutex.unlock();
+
+        socket->queueSendto(buffer, hostAddress);
 
-            if (responsePacket.resultCode() == Nedrysoft::ICMPPacket::Invalid) {
+        requests.append(request);
+        requestIds.append(requestId);
+
+        queuedCount++;
+        pendingCount++;
+    }
+
+    queuedCount -= Nedrysoft::ICMPSocket::ICMPSocket::flush();
+
+    if (queuedCount) {
+        SPDLOG_ERROR(QString("Unable to send %1 single shot packets.").arg(queuedCount).toStdString());
+    }
+
+    auto deliverReplies = [&]() {
+        for (auto index = 0; index < requests.count(); index++) {
+            auto request = requests.at(index);
+
+            if ((!request) || (delivered[index]) || (!request->m_replied.tryAcquire())) {
                 continue;
             }
 
-            if (responsePacket.resultCode() == Nedrysoft::ICMPPacket::EchoReply) {
-                resultCode = Nedrysoft::RouteAnalyser::PingResult::ResultCode::Ok;
-            }
+            results[index] = request->m_result;
+            delivered[index] = true;
+
+            pendingCount--;
 
-            if (responsePacket.resultCode() == Nedrysoft::ICMPPacket::TimeExceeded) {
-                resultCode = Nedrysoft::RouteAnalyser::PingResult::ResultCode::TimeExceeded;
+            if (callback) {
+                callback(index, results[index]);
             }
+        }
+    };
 
-            int hopsToTarget = -1;
+    QElapsedTimer waitTimer;
 
-            if (responsePacket.ttl()!=-1) {
-                hopsToTarget = ttl-responsePacket.ttl();
-            }
+    waitTimer.start();
 
-            pingResult = Nedrysoft::RouteAnalyser::PingResult(
-                0,
-                resultCode,
-                receiveAddress,
-                transmitEpoch,
-                roundTripTime/1e9,
-                nullptr,
-                hopsToTarget
-            );
+    while (pendingCount > 0) {
+        auto remainingTime = static_cast<int>(SecondsToMs(timeout)-waitTimer.elapsed());
 
+        if ((remainingTime <= 0) || (!batchReplied->tryAcquire(1, remainingTime))) {
             break;
         }
+
+        deliverReplies();
     }
 
-    delete writeSocket;
-    delete readSocket;
+    /**
+     * requests which are still in the map have timed out, any that are missing have been claimed by the receiver
+     * which is about to signal them so we wait for it to finish with them before they are freed.
+     */
+
+    for (auto index = 0; index < requests.count(); index++) {
+        auto request = requests.at(index);
 
-    return pingResult;
-}
\ No newline at end of file
+        if (delivered[index]) {
+            continue;
+        }
+
+        if (request) {
+            d->m_singleShotMutex.lock();
+
+            auto timedOut = d->m_singleShotRequests.remove(requestIds.at(index)) != 0;
+
+            d->m_singleShotMutex.unlock();
+
+            if (!timedOut) {
+                request->m_replied.acquire();
+
+                results[index] = request->m_result;
+            }
+        }
+
+        if (callback) {
+            callback(index, results[index]);
+        }
+    }
+
+    qDeleteAll(requests);
+
+    return results;
+}
@@ -31,8 +31,13 @@
 #include <QDateTime>
 #include <memory>
 
+namespace Nedrysoft { namespace ICMPSocket {
+    class ICMPSocket;
+}}
+
 namespace Nedrysoft { namespace ICMPPingEngine {
     class ICMPPingEngineData;
+    class ICMPPingSingleShot;
     class ICMPPingTransitter;
     class ICMPPingItem;
 
@@ -81,6 +86,9 @@ namespace Nedrysoft { namespace ICMPPingEngine {
             /**
              * @brief       Sets the reply timeout for this engine instance.
              *
+             * @details     The timeout is used for targets added after this call until their round trip time is
+             *              known, from then on each target uses its own adaptive timeout.
+             *
              * @see         Nedrysoft::RouteAnalyser::IPingEngine::setTimeout
              *
              * @param[in]   timeout the number of milliseconds before we consider that the packet was lost.
@@ -121,6 +129,9 @@ namespace Nedrysoft { namespace ICMPPingEngine {
             /**
              * @brief       Adds a ping target to this engine instance.
              *
+             * @details     If the engine is running the target is added to the live schedule and is pinged from
+             *              the next transmission round.
+             *
              * @see         Nedrysoft::RouteAnalyser::IPingEngine::addTarget
              *
              * @param[in]   hostAddress the host address of the ping target.
@@ -133,6 +144,10 @@ namespace Nedrysoft { namespace ICMPPingEngine {
             /**
              * @brief       Transmits a single ping.
              *
+             * @details     The request is sent on a write socket which is shared with other single shot requests
+             *              of the same ttl and the reply is collected by the shared receiver thread, each request
+             *              is given a unique id/sequence so concurrent calls do not interfere with each other.
+             *
              * @note        This is a blocking function.
              *
              * @param[in]   hostAddress the target host address.
@@ -147,10 +162,87 @@ namespace Nedrysoft { namespace ICMPPingEngine {
                 double timeout
             ) -> Nedrysoft::RouteAnalyser::PingResult override;
 
+            /**
+             * @brief       Transmits a single ping on a given flow.
+             *
+             * @details     The flow identifier is used as the ICMP id and the packet is built so that its
+             *              checksum does not change with the sequence number, routers that balance traffic on the
+             *              ICMP header therefore send every probe on the flow along the same path.
+             *
+             * @see         Nedrysoft::RouteAnalyser::IPingEngine::singleShot
+             *
+             * @param[in]   hostAddress the target host address.
+             * @param[in]   ttl time to live for this packet.
+             * @param[in]   timeout time in seconds to wait for response.
+             * @param[in]   flowId the flow identifier to use for the probe.
+             *
+             * @returns     the result of the ping.
+             */
+            auto singleShot(
+                QHostAddress hostAddress,
+                int ttl,
+                double timeout,
+                uint16_t flowId
+            ) -> Nedrysoft::RouteAnalyser::PingResult override;
+
+            /**
+             * @brief       Transmits a batch of single pings concurrently.
+             *
+             * @details     The probes are queued on the shared write sockets and sent together, the replies are
+             *              matched by the shared receiver and a thread from the pool owned by the engine delivers
+             *              them to the callback as they arrive.
+             *
+             * @see         Nedrysoft::RouteAnalyser::IPingEngine::singleShot
+             *
+             * @param[in]   probes the list of probes to send.
+             * @param[in]   timeout time in seconds to wait for the responses.
+             * @param[in]   flowId the flow identifier to use for the probes, 0 if the engine should choose.
+             * @param[in]   callback called with the index of the probe and its result as each probe completes.
+             *
+             * @returns     a future which holds the results in the same order as the probes.
+             */
+            auto singleShot(
+                const Nedrysoft::RouteAnalyser::SingleShotProbeList &probes,
+                double timeout,
+                uint16_t flowId,
+                Nedrysoft::RouteAnalyser::SingleShotCallback callback
+            ) -> std::future<QList<Nedrysoft::RouteAnalyser::PingResult> > override;
+
+            /**
+             * @brief       Sets the flow identifier used for targets that are added to this engine.
+             *
+             * @details     Targets added after this call share the flow identifier as their ICMP id, the process
+             *              wide sequence number keeps their requests unique.
+             *
+             * @see         Nedrysoft::RouteAnalyser::IPingEngine::setFlowId
+             *
+             * @param[in]   flowId the flow identifier, 0 allocates a flow per target.
+             *
+             * @returns     true.
+             */
+            auto setFlowId(uint16_t flowId) -> bool override;
+
+            /**
+             * @brief       Returns the sequence number to use for the next request.
+             *
+             * @details     The monitoring engine, the route engine and every bulk discovery worker can share one
+             *              flow identifier as their ICMP id, and every engine sees every reply.  Sequence numbers
+             *              are therefore taken from a single process wide counter so that no two requests in
+             *              flight have the same id and sequence pair, the flow stays constant as the payload
+             *              compensates for the sequence number.
+             *
+             * @returns     the sequence number.
+             */
+            static auto nextSequenceId() -> uint16_t;
+
             /**
              * @brief       Removes a ping target from this engine instance.
              *
-             * @see         Nedrysoft::RouteAnalyser::IPingEngine::addTarget
+             * @details     The target may be removed while the engine is running, any requests that are still
+             *              in flight for the target are discarded and the target is deleted once any pending
+             *              results for it have been delivered.
+             *
+             * @see         Nedrysoft::RouteAnalyser::IPingEngine::removeTarget
              *
              * @param[in]   target the ping target to remove.
              *
@@ -213,9 +305,14 @@ namespace Nedrysoft { namespace ICMPPingEngine {
             /**
              * @brief       Checks for any timed out requests and removes and signals that a timeout occurred.
              *
+             * @details     Requests are held in deadline order, so only the requests that have reached their
+             *              deadline are examined.
+             *
              * @see         Nedrysoft::ICMPPingEngine::ICMPPingTimeout
+             *
+             * @returns     the number of milliseconds until the next deadline, -1 if there are no requests.
              */
-            auto timeoutRequests(void) -> void;
+            auto timeoutRequests(void) -> int;
 
             /**
              * @brief       Adds a ping request to the engine so it can be tracked.
@@ -283,6 +380,44 @@ namespace Nedrysoft { namespace ICMPPingEngine {
              */
             auto doStop() -> bool;
 
+            /**
+             * @brief       Connects the engine to the shared receiver for the engines IP version.
+             *
+             * @note        It is safe to call this multiple times, the connection is only made once.
+             */
+            auto connectReceiver() -> void;
+
+            /**
+             * @brief       Returns the shared write socket for the given ttl.
+             *
+             * @details     Sockets are created on first use and then reused by all single shot requests with
+             *              the same ttl for the lifetime of the engine.
+             *
+             * @param[in]   ttl the ttl of the socket.
+             *
+             * @returns     the socket if it could be created; otherwise nullptr.
+             */
+            auto writeSocket(int ttl) -> Nedrysoft::ICMPSocket::ICMPSocket *;
+
+            /**
+             * @brief       Sends a batch of single pings and waits for the results.
+             *
+             * @note        This is a blocking function, it is run on a separate thread by the batch singleShot.
+             *
+             * @param[in]   probes the list of probes to send.
+             * @param[in]   timeout time in seconds to wait for the responses.
+             * @param[in]   flowId the flow identifier to use for the probes.
+             * @param[in]   callback called with the index of the probe and its result as each probe completes.
+             *
+             * @returns     the results in the same order as the probes.
+             */
+            auto batchSingleShot(
+                const Nedrysoft::RouteAnalyser::SingleShotProbeList &probes,
+                double timeout,
+                uint16_t flowId,
+                Nedrysoft::RouteAnalyser::SingleShotCallback callback
+            ) -> QList<Nedrysoft::RouteAnalyser::PingResult>;
+
             friend class ICMPPingTransmitter;
             friend class ICMPPingTimeout;
             friend class ICMPPingReceiverWorker;
@@ -56,10 +56,12 @@ Nedrysoft::ICMPPingEngine::ICMPPingEngineFactory::ICMPPingEngineFactory() :
 Nedrysoft::ICMPPingEngine::ICMPPingEngineFactory::~ICMPPingEngineFactory() {
     qDeleteAll(d->m_engineList);
 
-    auto receiverWorker = Nedrysoft::ICMPPingEngine::ICMPPingReceiverWorker::getInstance(true);
+    for (auto version : {Nedrysoft::Core::IPVersion::V4, Nedrysoft::Core::IPVersion::V6}) {
+        auto receiverWorker = Nedrysoft::ICMPPingEngine::ICMPPingReceiverWorker::getInstance(version, true);
 
-    if (receiverWorker) {
-        delete receiverWorker;
+        if (receiverWorker) {
+            delete receiverWorker;
+        }
     }
 
     d.reset();
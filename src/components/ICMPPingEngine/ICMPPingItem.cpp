@@ -26,6 +26,7 @@
 #include <QTimer>
 
 Nedrysoft::ICMPPingEngine::ICMPPingItem::ICMPPingItem() :
+        m_deadline(0),
         m_id(0),
         m_sequenceId(0),
         m_serviced(false),
@@ -95,6 +96,14 @@ auto Nedrysoft::ICMPPingEngine::ICMPPingItem::sampleNumber() -> unsigned long {
     return m_sampleNumber;
 }
 
+auto Nedrysoft::ICMPPingEngine::ICMPPingItem::setDeadline(int64_t deadline) -> void {
+    m_deadline = deadline;
+}
+
+auto Nedrysoft::ICMPPingEngine::ICMPPingItem::deadline() -> int64_t {
+    return m_deadline;
+}
+
 auto Nedrysoft::ICMPPingEngine::ICMPPingItem::lock() -> bool {
     return m_mutex.tryLock();
 }
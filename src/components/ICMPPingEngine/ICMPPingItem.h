@@ -163,6 +163,20 @@ namespace Nedrysoft { namespace ICMPPingEngine {
              */
             auto transmitEpoch() -> QDateTime;
 
+            /**
+             * @brief       Sets the time at which the request is next checked for a timeout.
+             *
+             * @param[in]   deadline the deadline in milliseconds on the engines deadline clock.
+             */
+            auto setDeadline(int64_t deadline) -> void;
+
+            /**
+             * @brief       Returns the time at which the request is next checked for a timeout.
+             *
+             * @returns     the deadline in milliseconds on the engines deadline clock.
+             */
+            auto deadline() -> int64_t;
+
             /**
              * @brief       Locks the item for exclusive access.
              *
@@ -182,6 +196,7 @@ namespace Nedrysoft { namespace ICMPPingEngine {
             QDateTime m_transmitEpoch;
 
             int64_t m_elapsedTime;
+            int64_t m_deadline;
 
             uint16_t m_id;
             uint16_t m_sequenceId;
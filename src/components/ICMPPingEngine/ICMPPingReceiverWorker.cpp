@@ -30,22 +30,39 @@
 #include "ICMPSocket/ICMPSocket.h"
 
 #include <QHostAddress>
+#include <QMap>
+#include <QMutex>
 #include <QThread>
 #include <QtEndian>
 #include <spdlog/spdlog.h>
 
 constexpr auto DefaultReplyTimeout = 1000;
 
-Nedrysoft::ICMPPingEngine::ICMPPingReceiverWorker::ICMPPingReceiverWorker() :
+//! @cond
+QMap<Nedrysoft::Core::IPVersion, Nedrysoft::ICMPPingEngine::ICMPPingReceiverWorker *>
+        Nedrysoft::ICMPPingEngine::ICMPPingReceiverWorker::m_instances;
+QMutex Nedrysoft::ICMPPingEngine::ICMPPingReceiverWorker::m_instancesMutex;
+//! @endcond
+
+Nedrysoft::ICMPPingEngine::ICMPPingReceiverWorker::ICMPPingReceiverWorker(Nedrysoft::Core::IPVersion version) :
         m_engine(nullptr),
         m_receiveWorker(nullptr),
         m_receiverThread(nullptr),
         m_socket(nullptr),
+        m_version(version),
         m_isRunning(false) {
 
 }
 
 Nedrysoft::ICMPPingEngine::ICMPPingReceiverWorker::~ICMPPingReceiverWorker() {
+    m_instancesMutex.lock();
+
+    if (m_instances.value(m_version) == this) {
+        m_instances.remove(m_version);
+    }
+
+    m_instancesMutex.unlock();
+
     if (m_engine) {
         delete m_engine;
     }
@@ -64,8 +81,13 @@ Nedrysoft::ICMPPingEngine::ICMPPingReceiverWorker::~ICMPPingReceiverWorker() {
     }
 }
 
-auto Nedrysoft::ICMPPingEngine::ICMPPingReceiverWorker::getInstance(bool returnNull) -> Nedrysoft::ICMPPingEngine::ICMPPingReceiverWorker * {
-    static Nedrysoft::ICMPPingEngine::ICMPPingReceiverWorker *instance = nullptr;
+auto Nedrysoft::ICMPPingEngine::ICMPPingReceiverWorker::getInstance(
+        Nedrysoft::Core::IPVersion version,
+        bool returnNull) -> Nedrysoft::ICMPPingEngine::ICMPPingReceiverWorker * {
+
+    QMutexLocker locker(&m_instancesMutex);
+
+    auto instance = m_instances.value(version, nullptr);
 
     if (instance) {
         return instance;
@@ -75,7 +97,18 @@ auto Nedrysoft::ICMPPingEngine::ICMPPingReceiverWorker::getInstance(bool returnN
         return nullptr;
     }
 
-    instance = new Nedrysoft::ICMPPingEngine::ICMPPingReceiverWorker;
+    instance = new Nedrysoft::ICMPPingEngine::ICMPPingReceiverWorker(version);
+
+    /**
+     * the read socket is created before the thread is started so that it exists before the first packet can be
+     * sent, a reply from a nearby hop could otherwise arrive before anything is listening for it.
+     */
+
+    instance->m_socket = Nedrysoft::ICMPSocket::ICMPSocket::createReadSocket(
+        static_cast<Nedrysoft::ICMPSocket::IPVersion>(version)
+    );
+
+    instance->m_isRunning = true;
 
     instance->m_receiverThread = new QThread;
 
@@ -87,20 +120,20 @@ auto Nedrysoft::ICMPPingEngine::ICMPPingReceiverWorker::getInstance(bool returnN
 
     instance->m_receiveWorker = instance;
 
+    m_instances[version] = instance;
+
     return instance;
 }
 
 void Nedrysoft::ICMPPingEngine::ICMPPingReceiverWorker::doWork() {
     QByteArray receiveBuffer;
 
-    m_socket =  Nedrysoft::ICMPSocket::ICMPSocket::createReadSocket(
-        static_cast<Nedrysoft::ICMPSocket::IPVersion>(Nedrysoft::ICMPSocket::V4)
-    );
+    if (!m_socket) {
+        return;
+    }
 
     QHostAddress receiveAddress;
 
-    m_isRunning = true;
-
     while (QThread::currentThread()->isRunning() && (m_isRunning)) {
         QElapsedTimer receiveTimer;
 
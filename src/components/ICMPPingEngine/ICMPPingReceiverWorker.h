@@ -24,10 +24,13 @@
 #ifndef PINGNOO_COMPONENTS_ICMPPINGENGINE_ICMPPINGRECEIVERWORKER_H
 #define PINGNOO_COMPONENTS_ICMPPINGENGINE_ICMPPINGRECEIVERWORKER_H
 
+#include <ICore>
 #include <QObject>
 #include <QByteArray>
 #include <QElapsedTimer>
 #include <QHostAddress>
+#include <QMap>
+#include <QMutex>
 #include <QThread>
 
 namespace Nedrysoft { namespace ICMPSocket {
@@ -41,8 +44,9 @@ namespace Nedrysoft { namespace ICMPPingEngine {
     /**
      * @brief       The ICMP packet receiver class.
      *
-     * @details     This is a singleton class, there is a single receive thread which reads packets as they arrive
-     *              and then signals that a packet is available, other objects can then process the packet.
+     * @details     This is a singleton class (one instance per IP version), there is a single receive thread for
+     *              each IP version which reads packets as they arrive and then signals that a packet is available,
+     *              other objects can then process the packet.
      */
     class ICMPPingReceiverWorker :
             public QObject {
@@ -55,8 +59,10 @@ namespace Nedrysoft { namespace ICMPPingEngine {
              * @brief       Constructs a ICMPPingReceiverWorker.
              *
              * @note        Hidden as this is a singleton class and should be accessed through getInstance().
+             *
+             * @param[in]   version the IP version of the packets that this receiver reads.
              */
-            ICMPPingReceiverWorker();
+            ICMPPingReceiverWorker(Nedrysoft::Core::IPVersion version);
 
             /**
              * @brief       Destroys the ICMPPingReceiverWorker.
@@ -65,13 +71,20 @@ namespace Nedrysoft { namespace ICMPPingEngine {
 
         public:
             /**
-             * @brief       Returns the ICMPPingReceiverWorker singleton instance.
+             * @brief       Returns the ICMPPingReceiverWorker singleton instance for the given IP version.
+             *
+             * @details     When the instance is created its read socket is opened before this returns, so packets
+             *              sent afterwards are always received.
              *
+             * @param[in]   version the IP version of the receiver.
              * @param[in]   returnNull if the singleton has not been allocated, then return null if true.
              *
              * @returns     the singleton instance.
              */
-            static auto getInstance(bool returnNull=false) -> Nedrysoft::ICMPPingEngine::ICMPPingReceiverWorker *;
+            static auto getInstance(
+                Nedrysoft::Core::IPVersion version = Nedrysoft::Core::IPVersion::V4,
+                bool returnNull = false
+            ) -> Nedrysoft::ICMPPingEngine::ICMPPingReceiverWorker *;
 
             /**
              * @brief       This signal is emitted when an ICMP packet has been received.
@@ -102,9 +115,13 @@ namespace Nedrysoft { namespace ICMPPingEngine {
             Nedrysoft::ICMPPingEngine::ICMPPingReceiverWorker *m_receiveWorker;
             QThread *m_receiverThread;
             Nedrysoft::ICMPSocket::ICMPSocket *m_socket;
+            Nedrysoft::Core::IPVersion m_version;
 
             bool m_isRunning;
 
+            static QMap<Nedrysoft::Core::IPVersion, Nedrysoft::ICMPPingEngine::ICMPPingReceiverWorker *> m_instances;
+            static QMutex m_instancesMutex;
+
             //! @endcond
     };
 }}
@@ -57,6 +57,7 @@ class Nedrysoft::ICMPPingEngine::ICMPPingTargetData {
         Nedrysoft::ICMPPingEngine::ICMPPingEngine *m_engine;
         Nedrysoft::ICMPSocket::ICMPSocket *m_socket;
         uint16_t m_id;
+        Nedrysoft::RouteAnalyser::RetransmissionTimeout m_retransmissionTimeout;
         void *m_userData;
         int m_ttl;
 };
@@ -113,6 +114,16 @@ auto Nedrysoft::ICMPPingEngine::ICMPPingTarget::id() -> uint16_t {
     return d->m_id;
 }
 
+auto Nedrysoft::ICMPPingEngine::ICMPPingTarget::setId(uint16_t id) -> void {
+    d->m_id = id;
+}
+
+auto Nedrysoft::ICMPPingEngine::ICMPPingTarget::retransmissionTimeout() ->
+        Nedrysoft::RouteAnalyser::RetransmissionTimeout * {
+
+    return &d->m_retransmissionTimeout;
+}
+
 auto Nedrysoft::ICMPPingEngine::ICMPPingTarget::ttl() -> uint16_t {
     return d->m_ttl;
 }
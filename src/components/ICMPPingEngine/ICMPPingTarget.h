@@ -25,6 +25,7 @@
 #define PINGNOO_COMPONENTS_ICMPPINGENGINE_ICMPPINGTARGET_H
 
 #include <IPingTarget>
+#include <RetransmissionTimeout>
 
 #if defined(Q_OS_WIN)
 #include <WS2tcpip.h>
@@ -156,6 +157,22 @@ namespace Nedrysoft { namespace ICMPPingEngine {
              */
             auto id() -> uint16_t;
 
+            /**
+             * @brief       Sets the ICMP id used for this target.
+             *
+             * @param[in]   id the id.
+             */
+            auto setId(uint16_t id) -> void;
+
+            /**
+             * @brief       Returns the adaptive reply timeout for this target.
+             *
+             * @note        The engine serialises access to the timeout using its request lock.
+             *
+             * @returns     the retransmission timeout.
+             */
+            auto retransmissionTimeout() -> Nedrysoft::RouteAnalyser::RetransmissionTimeout *;
+
             friend class ICMPPingTransmitter;
 
         protected:
@@ -27,7 +27,12 @@
 
 #include <QThread>
 
-constexpr auto DefaultSleepTime = 1000;
+/**
+ * the worker sleeps until the earliest request deadline, a request added while it sleeps may have an earlier
+ * deadline so the sleep is capped.
+ */
+
+constexpr auto MaximumSleepTime = 20;
 
 Nedrysoft::ICMPPingEngine::ICMPPingTimeout::ICMPPingTimeout(Nedrysoft::ICMPPingEngine::ICMPPingEngine *engine) :
         m_engine(engine),
@@ -39,8 +44,12 @@ void Nedrysoft::ICMPPingEngine::ICMPPingTimeout::doWork() {
     m_isRunning = true;
 
     while (m_isRunning) {
-        m_engine->timeoutRequests();
+        auto nextDeadline = m_engine->timeoutRequests();
+
+        if (nextDeadline<0) {
+            nextDeadline = MaximumSleepTime;
+        }
 
-        QThread::msleep(DefaultSleepTime);
+        QThread::msleep(static_cast<unsigned long>(qBound(1, nextDeadline, MaximumSleepTime)));
     }
 }
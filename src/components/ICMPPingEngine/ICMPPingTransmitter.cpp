@@ -29,30 +29,32 @@
 #include "ICMPPingTarget.h"
 #include "ICMPSocket/ICMPSocket.h"
 
+#include <PacketRateGovernor>
 #include <QThread>
 #include <QtEndian>
 #include <cstdint>
 #include <spdlog/spdlog.h>
 
 constexpr auto DefaultTransmitInterval = 10000;
-
-//! @cond
-uint16_t Nedrysoft::ICMPPingEngine::ICMPPingTransmitter::m_sequenceId = 1;
-QMutex Nedrysoft::ICMPPingEngine::ICMPPingTransmitter::m_sequenceMutex;
-//! @endcond
+constexpr auto PayloadLength = 52;
+constexpr auto IcmpHeaderLength = 8;
 
 Nedrysoft::ICMPPingEngine::ICMPPingTransmitter::ICMPPingTransmitter(Nedrysoft::ICMPPingEngine::ICMPPingEngine *engine) :
         m_interval(DefaultTransmitInterval),
         m_engine(engine),
+        m_isSending(false),
         m_isRunning(false) {
 
 }
 
 Nedrysoft::ICMPPingEngine::ICMPPingTransmitter::~ICMPPingTransmitter() {
-    qDeleteAll(m_targets);
+    for (auto target : m_removedTargets) {
+        target->deleteLater();
+    }
 }
 
 void Nedrysoft::ICMPPingEngine::ICMPPingTransmitter::doWork() {
+    auto packetRateGovernor = Nedrysoft::RouteAnalyser::PacketRateGovernor::getInstance();
     QElapsedTimer elapsedTimer;
     unsigned long sampleNumber = 0;
 
@@ -61,22 +63,71 @@ void Nedrysoft::ICMPPingEngine::ICMPPingTransmitter::doWork() {
     m_engine->setEpoch(QDateTime::currentDateTime());
 
     while (m_isRunning) {
-        if (!m_targets.isEmpty()) {
-            SPDLOG_TRACE("Preparing ping set to " + m_targets.last()->hostAddress().toString().toStdString());
+        /**
+         * the round works from a copy of the targets taken at the start, a target that is removed part way
+         * through is skipped and is not deleted until the round has been sent, so targets that move within the
+         * list are neither skipped nor pinged twice.
+         */
+
+        m_targetsMutex.lock();
+
+        auto roundTargets = m_targets;
+
+        m_isSending = true;
+
+        m_targetsMutex.unlock();
+
+        if (!roundTargets.isEmpty()) {
+            SPDLOG_TRACE("Preparing ping set to " + roundTargets.last()->hostAddress().toString().toStdString());
         }
 
         elapsedTimer.restart();
 
-        m_targetsMutex.lock();
+        /**
+         * the packet rate governor may hold us back, so the targets lock is only held while a packet is being
+         * queued to allow targets to be added or removed while the round is throttled.
+         *
+         * packets are queued and sent together at the end of the round (a single system call with the io_uring
+         * backend), if the governor is about to make us wait then the packets queued so far are sent first.
+         */
+
+        auto queuedCount = 0;
+
+        auto flushQueue = [&queuedCount]() {
+            auto sentCount = Nedrysoft::ICMPSocket::ICMPSocket::flush();
+
+            if (sentCount != queuedCount) {
+                SPDLOG_ERROR(QString("Unable to send %1 of %2 packets.")
+                        .arg(queuedCount-sentCount)
+                        .arg(queuedCount)
+                        .toStdString() );
+            }
+
+            queuedCount = 0;
+        };
+
+        for (auto target : roundTargets) {
+            if (!m_isRunning) {
+                break;
+            }
+
+            if (!packetRateGovernor->tryAcquire(m_engine, IcmpHeaderLength + PayloadLength)) {
+                flushQueue();
+
+                packetRateGovernor->acquire(m_engine, IcmpHeaderLength + PayloadLength);
+            }
+
+            QMutexLocker locker(&m_targetsMutex);
+
+            if (!m_targetIndex.contains(target)) {
+                continue;
+            }
 
-        for (auto target : m_targets) {
             auto socket = target->socket();
 
             auto pingItem = new Nedrysoft::ICMPPingEngine::ICMPPingItem();
 
-            m_sequenceMutex.lock();
-            uint16_t currentSequenceId = m_sequenceId++;
-            m_sequenceMutex.unlock();
+            auto currentSequenceId = Nedrysoft::ICMPPingEngine::ICMPPingEngine::nextSequenceId();
 
             pingItem->setTarget(target);
             pingItem->setId(target->id());
@@ -88,27 +139,45 @@ void Nedrysoft::ICMPPingEngine::ICMPPingTransmitter::doWork() {
             auto buffer = Nedrysoft::ICMPPacket::ICMPPacket::pingPacket(
                     target->id(),
                     currentSequenceId,
-                    52,
+                    PayloadLength,
                     target->hostAddress(),
-                    static_cast<Nedrysoft::ICMPPacket::IPVersion>(m_engine->version()) );
+                    static_cast<Nedrysoft::ICMPPacket::IPVersion>(m_engine->version()),
+                    true );
 
-            auto result = socket->sendto(buffer, target->hostAddress());
+            socket->queueSendto(buffer, target->hostAddress());
+
+            queuedCount++;
 
             pingItem->startTimer();
 
             SPDLOG_TRACE(
-                    QString("Sent ping to %1 (TTL=%2, Result=%3)")
+                    QString("Queued ping to %1 (TTL=%2)")
                     .arg(target->hostAddress().toString())
-                    .arg(socket->ttl()).arg(result)
+                    .arg(socket->ttl())
                     .toStdString() );
-
-            if (result != buffer.length()) {
-                SPDLOG_ERROR("Unable to send packet to "+target->hostAddress().toString().toStdString());
-            }
         }
 
+        flushQueue();
+
+        /**
+         * a queued packet only holds the descriptor of the socket that it is sent on, the sockets belong to the
+         * targets so targets removed during the round can only be deleted now that every packet has been sent.
+         */
+
+        m_targetsMutex.lock();
+
+        auto removedTargets = m_removedTargets;
+
+        m_removedTargets.clear();
+
+        m_isSending = false;
+
         m_targetsMutex.unlock();
 
+        for (auto target : removedTargets) {
+            target->deleteLater();
+        }
+
         auto elapsedTime = elapsedTimer.elapsed();
 
         if (elapsedTime < m_interval) {
@@ -128,9 +197,46 @@ auto Nedrysoft::ICMPPingEngine::ICMPPingTransmitter::setInterval(int interval) -
 auto Nedrysoft::ICMPPingEngine::ICMPPingTransmitter::addTarget(Nedrysoft::ICMPPingEngine::ICMPPingTarget *target) -> void {
     QMutexLocker locker(&m_targetsMutex);
 
+    if (m_targetIndex.contains(target)) {
+        return;
+    }
+
+    m_targetIndex[target] = m_targets.count();
+
     m_targets.append(target);
 }
 
+auto Nedrysoft::ICMPPingEngine::ICMPPingTransmitter::removeTarget(
+        Nedrysoft::ICMPPingEngine::ICMPPingTarget *target) -> bool {
+
+    QMutexLocker locker(&m_targetsMutex);
+
+    if (!m_targetIndex.contains(target)) {
+        return false;
+    }
+
+    /**
+     * the order of transmission within a round is not significant, so the last target is moved into the slot
+     * of the removed target which keeps the removal O(1).
+     */
+
+    auto index = m_targetIndex.take(target);
+    auto lastTarget = m_targets.takeLast();
+
+    if (lastTarget != target) {
+        m_targets[index] = lastTarget;
+        m_targetIndex[lastTarget] = index;
+    }
+
+    if (m_isSending) {
+        m_removedTargets.append(target);
+    } else {
+        target->deleteLater();
+    }
+
+    return true;
+}
+
 auto Nedrysoft::ICMPPingEngine::ICMPPingTransmitter::interval() -> int {
     return m_interval;
 }
\ No newline at end of file
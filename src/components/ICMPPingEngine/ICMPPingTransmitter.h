@@ -26,6 +26,7 @@
 
 #include <PingResult>
 
+#include <QHash>
 #include <QMutex>
 #include <QObject>
 
@@ -80,6 +81,21 @@ namespace Nedrysoft { namespace ICMPPingEngine {
              */
             auto addTarget(Nedrysoft::ICMPPingEngine::ICMPPingTarget *target) -> void;
 
+            /**
+             * @brief       Removes a ping target from the transmitter.
+             *
+             * @details     The target is removed from the transmission schedule in constant time, once this call
+             *              returns no further requests will be created for the target.
+             *
+             * @note        Ownership of the target passes to the transmitter, a round that is in progress may still
+             *              reference it so it is deleted once that round has been sent.
+             *
+             * @param[in]   target the target to remove.
+             *
+             * @returns     true if the target was removed; otherwise false.
+             */
+            auto removeTarget(Nedrysoft::ICMPPingEngine::ICMPPingTarget *target) -> bool;
+
         private:
 
             /**
@@ -104,13 +120,13 @@ namespace Nedrysoft { namespace ICMPPingEngine {
             Nedrysoft::ICMPPingEngine::ICMPPingEngine *m_engine;
 
             QList<Nedrysoft::ICMPPingEngine::ICMPPingTarget *> m_targets;
+            QHash<Nedrysoft::ICMPPingEngine::ICMPPingTarget *, int> m_targetIndex;
+            QList<Nedrysoft::ICMPPingEngine::ICMPPingTarget *> m_removedTargets;
             QMutex m_targetsMutex;
+            bool m_isSending;
 
             QDateTime m_epoch;
 
-            static QMutex m_sequenceMutex;
-            static uint16_t m_sequenceId;
-
         protected:
             bool m_isRunning;
 
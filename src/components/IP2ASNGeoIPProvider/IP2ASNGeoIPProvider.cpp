@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 19/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "IP2ASNGeoIPProvider.h"
+
+#include <ICore>
+#include <QDateTime>
+#include <QFileInfo>
+#include <QHostAddress>
+#include <QJsonObject>
+
+constexpr auto DefaultDatabase = "ip2asn-combined.tsv";
+constexpr auto DatabaseKey = "database";
+
+Nedrysoft::IP2ASNGeoIPProvider::IP2ASNGeoIPProvider::IP2ASNGeoIPProvider() {
+    auto storageFolder = Nedrysoft::Core::ICore::getInstance()->storageFolder();
+
+    m_databaseFilename = QFileInfo(storageFolder, DefaultDatabase).absoluteFilePath();
+
+    m_database.load(m_databaseFilename);
+}
+
+Nedrysoft::IP2ASNGeoIPProvider::IP2ASNGeoIPProvider::~IP2ASNGeoIPProvider() {
+
+}
+
+auto Nedrysoft::IP2ASNGeoIPProvider::IP2ASNGeoIPProvider::lookup(
+        const QString host,
+        Nedrysoft::Core::GeoFunction function ) -> void {
+
+    auto hostAddress = QHostAddress();
+    auto record = Nedrysoft::IP2ASNDatabase::IP2ASNDatabase::Record();
+
+    if (!hostAddress.setAddress(host)) {
+        return;
+    }
+
+    if (!m_database.find(hostAddress, record)) {
+        return;
+    }
+
+    /**
+     * the fields are named to match the other providers.
+     */
+
+    auto resultMap = QVariantMap();
+
+    resultMap["asn"] = QString("AS%1 %2").arg(record.m_asn).arg(record.m_description).trimmed();
+    resultMap["org"] = record.m_description;
+    resultMap["isp"] = record.m_description;
+
+#if (QT_VERSION_MAJOR>=6)
+    resultMap["creationTime"] = QDateTime::currentDateTimeUtc().toSecsSinceEpoch();
+#else
+    resultMap["creationTime"] = QDateTime::currentDateTimeUtc().toTime_t();
+#endif
+
+    function(host, resultMap);
+}
+
+auto Nedrysoft::IP2ASNGeoIPProvider::IP2ASNGeoIPProvider::lookup(const QString host) -> void {
+    lookup(host, [=](const QString &hostAddress, const QVariantMap &result) {
+        Q_EMIT this->result(hostAddress, result);
+    });
+}
+
+auto Nedrysoft::IP2ASNGeoIPProvider::IP2ASNGeoIPProvider::saveConfiguration() -> QJsonObject {
+    auto configuration = QJsonObject();
+
+    configuration.insert(DatabaseKey, m_databaseFilename);
+
+    return configuration;
+}
+
+auto Nedrysoft::IP2ASNGeoIPProvider::IP2ASNGeoIPProvider::loadConfiguration(QJsonObject configuration) -> bool {
+    auto databaseFilename = configuration.value(DatabaseKey).toString(m_databaseFilename);
+
+    /**
+     * the table is only reloaded if it has changed, loading a full table takes a noticeable fraction of a second.
+     */
+
+    if ((databaseFilename!=m_databaseFilename) || (m_database.count()==0)) {
+        m_databaseFilename = databaseFilename;
+
+        m_database.clear();
+        m_database.load(m_databaseFilename);
+    }
+
+    return true;
+}
@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 19/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PINGNOO_COMPONENTS_IP2ASNGEOIPPROVIDER_IP2ASNGEOIPPROVIDER_H
+#define PINGNOO_COMPONENTS_IP2ASNGEOIPPROVIDER_IP2ASNGEOIPPROVIDER_H
+
+#include "ComponentSystem/IInterface.h"
+#include "IP2ASNDatabase/IP2ASNDatabase.h"
+#include "IP2ASNGeoIPProviderSpec.h"
+
+#include <IConfiguration>
+#include <IGeoIPProvider>
+#include <QObject>
+#include <QString>
+#include <QVariantMap>
+
+namespace Nedrysoft { namespace IP2ASNGeoIPProvider {
+    /**
+     * @brief       The IP2ASNGeoIPProvider provides an offline AS lookup from an ip2asn table.
+     *
+     * @details     Loads an ip2asn table, such as ip2asn-combined.tsv from iptoasn.com, from the storage folder
+     *              and answers lookups with the AS number and owner of the range that contains the address.  The
+     *              table is searched in memory so a lookup is answered immediately without any network access.
+     *
+     *              The country in the table is the country of the AS rather than the location of the address, so
+     *              it is not reported.
+     */
+    class IP2ASNGeoIPProvider :
+            public Nedrysoft::Core::IGeoIPProvider,
+            public Nedrysoft::Core::IConfiguration {
+
+        private:
+            Q_OBJECT
+
+            Q_INTERFACES(Nedrysoft::Core::IGeoIPProvider)
+
+        public:
+            /**
+             * @brief       Constructs an IP2ASNGeoIPProvider.
+             */
+            IP2ASNGeoIPProvider();
+
+            /**
+             * @brief       Destroys the IP2ASNGeoIPProvider.
+             */
+            ~IP2ASNGeoIPProvider();
+
+            /**
+             * @brief       Performs a host lookup using IP address.
+             *
+             * @details     The result is provided via the Nedrysoft::Core::IGeoIPProvider::result signal before
+             *              this returns.
+             *
+             * @see         Nedrysoft::Core::IGeoIPProvider::lookup
+             *
+             * @param[in]   host the host address to be looked up.
+             */
+            auto lookup(const QString host) -> void override;
+
+            /**
+             * @brief       Performs a host lookup using IP address.
+             *
+             * @details     The function is called before this returns if the table has a range that contains the
+             *              address, otherwise it is not called.
+             *
+             * @see         Nedrysoft::Core::IGeoIPProvider::lookup
+             *
+             * @param[in]   host the host address to be looked up.
+             * @param[in]   function the function called when a result is available.
+             */
+            auto lookup(const QString host, Nedrysoft::Core::GeoFunction function) -> void override;
+
+        public:
+            /**
+             * @brief       Saves the configuration to a JSON object.
+             *
+             * @returns     the JSON configuration.
+             */
+            auto saveConfiguration() -> QJsonObject override;
+
+            /**
+             * @brief       Loads the configuration.
+             *
+             * @note        The "database" key sets the filename of the table.
+             *
+             * @param[in]   configuration the configuration as JSON object.
+             *
+             * @returns     true if loaded; otherwise false.
+             */
+            auto loadConfiguration(QJsonObject configuration) -> bool override;
+
+        private:
+            //! @cond
+
+            Nedrysoft::IP2ASNDatabase::IP2ASNDatabase m_database;
+            QString m_databaseFilename;
+
+            //! @endcond
+    };
+}}
+
+#endif // PINGNOO_COMPONENTS_IP2ASNGEOIPPROVIDER_IP2ASNGEOIPPROVIDER_H
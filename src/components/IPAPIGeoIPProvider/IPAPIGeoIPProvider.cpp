@@ -21,18 +21,80 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+
 #include "IPAPIGeoIPProvider.h"
 
-#include "Cache.h"
+#include "GeoIPCache/GeoIPCache.h"
 
+#include <ICore>
+#include <QDateTime>
+#include <QFileInfo>
+#include <QHostAddress>
+#include <QJsonArray>
 #include <QJsonDocument>
+#include <QJsonObject>
 #include <QNetworkAccessManager>
 #include <QNetworkReply>
+#include <QNetworkRequest>
 #include <QObject>
+#include <QThread>
+#include <QTimer>
+#include <QUrlQuery>
+
+constexpr auto DefaultBatchUrl = "http://ip-api.com/batch";
+constexpr auto DefaultFlushWindow = 100;
+constexpr auto MaximumBatchSize = 100;
+constexpr auto BatchFields = "status,message,query,country,countryCode,region,regionName,city,zip,lat,lon,timezone,isp,org,as";
+constexpr auto BatchUrlKey = "batchUrl";
+constexpr auto FlushWindowKey = "flushWindow";
+constexpr auto IPv4PrefixLengthKey = "ipv4PrefixLength";
+constexpr auto IPv6PrefixLengthKey = "ipv6PrefixLength";
+constexpr auto CacheFilenameKey = "cacheFilename";
+constexpr auto DefaultIPv4PrefixLength = 24;
+constexpr auto DefaultIPv6PrefixLength = 48;
+constexpr auto CacheFilename = "ip-api-cache.db";
+constexpr auto CacheCapacity = 4096;
+constexpr auto CacheTimeToLive = 7*24*60*60;
+constexpr auto NegativeCacheTimeToLive = 60*60;
+
+/**
+ * @brief       Returns the canonical text form of an address.
+ *
+ * @details     The same address can be written in more than one way (e.g "2001:DB8::1" and "2001:db8:0::1"), the
+ *              pending lookups and the replies are matched on the text so every host is converted to one form.
+ *
+ * @param[in]   host the address.
+ *
+ * @returns     the canonical form of the address, or host unchanged if it is not an address.
+ */
+static auto normalisedHost(const QString &host) -> QString {
+    auto hostAddress = QHostAddress(host);
+
+    if (hostAddress.isNull()) {
+        return host;
+    }
+
+    return hostAddress.toString();
+}
 
 Nedrysoft::IPAPIGeoIPProvider::IPAPIGeoIPProvider::IPAPIGeoIPProvider() :
-        m_cache(new Nedrysoft::IPAPIGeoIPProvider::Cache()) {
+        m_cacheFilename(
+            QFileInfo(Nedrysoft::Core::ICore::getInstance()->storageFolder(), CacheFilename).absoluteFilePath() ),
+        m_cache(new Nedrysoft::GeoIPCache::GeoIPCache(m_cacheFilename, CacheCapacity)),
+        m_networkManager(new QNetworkAccessManager(this)),
+        m_flushTimer(new QTimer(this)),
+        m_batchUrl(DefaultBatchUrl),
+        m_flushWindow(DefaultFlushWindow),
+        m_ipv4PrefixLength(DefaultIPv4PrefixLength),
+        m_ipv6PrefixLength(DefaultIPv6PrefixLength) {
 
+    m_cache->setDefaultPrefixLength(m_ipv4PrefixLength, m_ipv6PrefixLength);
+
+    m_flushTimer->setSingleShot(true);
+
+    connect(m_flushTimer, &QTimer::timeout, this, [=]() {
+        flush();
+    });
 }
 
 Nedrysoft::IPAPIGeoIPProvider::IPAPIGeoIPProvider::~IPAPIGeoIPProvider() {
@@ -40,60 +102,79 @@ Nedrysoft::IPAPIGeoIPProvider::IPAPIGeoIPProvider::~IPAPIGeoIPProvider() {
 }
 
 auto Nedrysoft::IPAPIGeoIPProvider::IPAPIGeoIPProvider::lookup(
-        const QString host,
+        const QString requestedHost,
         Nedrysoft::Core::GeoFunction function ) -> void {
 
-    auto cacheResultObject = QJsonObject();
+    /**
+     * the network manager and the queue belong to the thread of the provider, a lookup from another thread is
+     * handed over to it.
+     */
 
-    if (m_cache->find(host, cacheResultObject)) {
-        function(host, cacheResultObject.toVariantMap());
-    } else {
-        const auto mapFields =
-                QStringList() << "creationTime" << "country" << "countryCode" << "region" << "regionName" << "city"
-                              << "zip" << "lat" "lon" << "timezone" << "isp" << "org";
-        auto manager = new QNetworkAccessManager();
+    if (QThread::currentThread()!=thread()) {
+        QTimer::singleShot(0, this, [=]() {
+            lookup(requestedHost, function);
+        });
 
-        connect(manager, &QNetworkAccessManager::finished, [=](QNetworkReply *reply) {
-            if (reply->error() == QNetworkReply::NoError) {
-                auto resultMap = QVariantMap();
-                auto jsonDocument = QJsonDocument::fromJson(reply->readAll());
+        return;
+    }
 
-                if (!jsonDocument.isObject()) {
-                    auto requiredFields = QStringList(mapFields) << "as";
-                    auto responseValid = true;
+    auto host = normalisedHost(requestedHost);
 
-                    for (const auto &field : requiredFields) {
-                        if (!jsonDocument.object().contains(field)) {
-                            responseValid = false;
-                            break;
-                        }
-                    }
+    if (Nedrysoft::GeoIPCache::GeoIPCache::isPrivateAddress(host)) {
+        return;
+    }
 
-                    if (responseValid) {
-                        m_cache->add(jsonDocument.object());
+    auto cacheResult = QVariantMap();
+    auto cacheStatus = m_cache->lookup(host, cacheResult);
 
-                        for (const auto &field : mapFields) {
-                            resultMap[field] = jsonDocument.object()[field].toVariant();
-                        }
+    if (cacheStatus==Nedrysoft::GeoIPCache::GeoIPCache::Status::Hit) {
+        function(host, cacheResult);
 
-                        resultMap["creationTime"] = QDateTime::currentDateTimeUtc().toTime_t();
-                        resultMap["asn"] = jsonDocument.object()["as"].toVariant();
+        return;
+    }
 
-                        function(host, resultMap);
-                    }
-                }
-            }
+    if (cacheStatus==Nedrysoft::GeoIPCache::GeoIPCache::Status::NegativeHit) {
+        return;
+    }
 
-            reply->deleteLater();
+    if (m_pendingLookups.contains(host)) {
+        m_pendingLookups[host].append(function);
 
-            auto manager = qobject_cast<QNetworkAccessManager *>(sender());
+        return;
+    }
 
-            if (manager) {
-                manager->deleteLater();
+    m_pendingLookups[host].append(function);
+
+    /**
+     * the host is pending while the database is searched, so that lookups made in the meantime are shared.
+     */
+
+    m_cache->lookup(host, [=](Nedrysoft::GeoIPCache::GeoIPCache::Status status, const QVariantMap &result) {
+        if (status==Nedrysoft::GeoIPCache::GeoIPCache::Status::Miss) {
+            queue(host);
+
+            return;
+        }
+
+        auto functions = m_pendingLookups.take(host);
+
+        if (status==Nedrysoft::GeoIPCache::GeoIPCache::Status::Hit) {
+            for (const auto &pendingFunction : functions) {
+                pendingFunction(host, result);
             }
-        });
+        }
+    });
+}
+
+auto Nedrysoft::IPAPIGeoIPProvider::IPAPIGeoIPProvider::queue(const QString &host) -> void {
+    m_queuedHosts.append(host);
 
-        manager->get(QNetworkRequest(QUrl("http://ip-api.com/json/" + host)));
+    if (m_queuedHosts.count()>=MaximumBatchSize) {
+        m_flushTimer->stop();
+
+        flush();
+    } else if (!m_flushTimer->isActive()) {
+        m_flushTimer->start(m_flushWindow);
     }
 }
 
@@ -103,3 +184,144 @@ auto Nedrysoft::IPAPIGeoIPProvider::IPAPIGeoIPProvider::lookup(const QString hos
     });
 }
 
+auto Nedrysoft::IPAPIGeoIPProvider::IPAPIGeoIPProvider::flush() -> void {
+    while (!m_queuedHosts.isEmpty()) {
+        auto hosts = m_queuedHosts.mid(0, MaximumBatchSize);
+        auto queryArray = QJsonArray();
+
+        m_queuedHosts = m_queuedHosts.mid(hosts.count());
+
+        for (const auto &host : hosts) {
+            queryArray.append(host);
+        }
+
+        auto batchUrl = m_batchUrl;
+        auto urlQuery = QUrlQuery(batchUrl);
+
+        urlQuery.addQueryItem("fields", BatchFields);
+
+        batchUrl.setQuery(urlQuery);
+
+        auto request = QNetworkRequest(batchUrl);
+
+        request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
+
+        auto reply = m_networkManager->post(request, QJsonDocument(queryArray).toJson(QJsonDocument::Compact));
+
+        connect(reply, &QNetworkReply::finished, this, [=]() {
+            processReply(reply, hosts);
+        });
+    }
+}
+
+auto Nedrysoft::IPAPIGeoIPProvider::IPAPIGeoIPProvider::processReply(
+        QNetworkReply *reply,
+        const QStringList &hosts ) -> void {
+
+    const auto mapFields =
+            QStringList() << "country" << "countryCode" << "region" << "regionName" << "city"
+                          << "zip" << "lat" << "lon" << "timezone" << "isp" << "org";
+
+    auto results = QMap<QString, QVariantMap>();
+
+    if (reply->error()==QNetworkReply::NoError) {
+        auto jsonDocument = QJsonDocument::fromJson(reply->readAll());
+
+        for (const auto &value : jsonDocument.array()) {
+            auto object = value.toObject();
+
+            if (object["status"].toString()!="success") {
+                if (object.contains("query")) {
+                    m_cache->addNegative(normalisedHost(object["query"].toString()), NegativeCacheTimeToLive);
+                }
+
+                continue;
+            }
+
+            auto requiredFields = QStringList(mapFields) << "query" << "as";
+            auto responseValid = true;
+
+            for (const auto &field : requiredFields) {
+                if (!object.contains(field)) {
+                    responseValid = false;
+                    break;
+                }
+            }
+
+            if (!responseValid) {
+                continue;
+            }
+
+            auto resultMap = QVariantMap();
+
+            for (const auto &field : mapFields) {
+                resultMap[field] = object[field].toVariant();
+            }
+
+#if (QT_VERSION_MAJOR>=6)
+            resultMap["creationTime"] = QDateTime::currentDateTimeUtc().toSecsSinceEpoch();
+#else
+            resultMap["creationTime"] = QDateTime::currentDateTimeUtc().toTime_t();
+#endif
+            resultMap["asn"] = object["as"].toVariant();
+
+            auto host = normalisedHost(object["query"].toString());
+
+            m_cache->add(host, resultMap, CacheTimeToLive);
+
+            results[host] = resultMap;
+        }
+    }
+
+    reply->deleteLater();
+
+    /**
+     * every host in the request stops being pending whether or not it was answered, an address that ip-api
+     * could not locate has a negative cache entry but a request that failed is sent again the next time that
+     * the address is asked for.
+     */
+
+    for (const auto &host : hosts) {
+        auto functions = m_pendingLookups.take(host);
+
+        if (!results.contains(host)) {
+            continue;
+        }
+
+        for (const auto &function : functions) {
+            function(host, results[host]);
+        }
+    }
+}
+
+auto Nedrysoft::IPAPIGeoIPProvider::IPAPIGeoIPProvider::saveConfiguration() -> QJsonObject {
+    auto configuration = QJsonObject();
+
+    configuration.insert(BatchUrlKey, m_batchUrl.toString());
+    configuration.insert(FlushWindowKey, m_flushWindow);
+    configuration.insert(IPv4PrefixLengthKey, m_ipv4PrefixLength);
+    configuration.insert(IPv6PrefixLengthKey, m_ipv6PrefixLength);
+    configuration.insert(CacheFilenameKey, m_cacheFilename);
+
+    return configuration;
+}
+
+auto Nedrysoft::IPAPIGeoIPProvider::IPAPIGeoIPProvider::loadConfiguration(QJsonObject configuration) -> bool {
+    m_batchUrl = QUrl(configuration.value(BatchUrlKey).toString(DefaultBatchUrl));
+    m_flushWindow = qMax(0, configuration.value(FlushWindowKey).toInt(DefaultFlushWindow));
+    m_ipv4PrefixLength = qBound(0, configuration.value(IPv4PrefixLengthKey).toInt(DefaultIPv4PrefixLength), 32);
+    m_ipv6PrefixLength = qBound(0, configuration.value(IPv6PrefixLengthKey).toInt(DefaultIPv6PrefixLength), 128);
+
+    auto cacheFilename = configuration.value(CacheFilenameKey).toString(m_cacheFilename);
+
+    if (cacheFilename!=m_cacheFilename) {
+        delete m_cache;
+
+        m_cacheFilename = cacheFilename;
+        m_cache = new Nedrysoft::GeoIPCache::GeoIPCache(m_cacheFilename, CacheCapacity);
+    }
+
+    m_cache->setDefaultPrefixLength(m_ipv4PrefixLength, m_ipv6PrefixLength);
+
+    return true;
+}
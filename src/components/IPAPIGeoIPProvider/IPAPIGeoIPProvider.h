@@ -25,23 +25,44 @@
 #define PINGNOO_COMPONENTS_IPAPIGEOIPPROVIDER_IPAPIGEOIPROVIDER_H
 
 #include "ComponentSystem/IInterface.h"
+#include <IConfiguration>
 #include <IGeoIPProvider>
 #include "IPAPIGeoIPProvider.h"
 #include "IPAPIGeoIPProviderSpec.h"
 
+#include <QList>
+#include <QMap>
 #include <QObject>
+#include <QStringList>
+#include <QUrl>
 #include <QVariantMap>
 
+class QNetworkAccessManager;
+class QNetworkReply;
+class QTimer;
+
+namespace Nedrysoft { namespace GeoIPCache {
+    class GeoIPCache;
+}}
+
 namespace Nedrysoft { namespace IPAPIGeoIPProvider {
-    class Cache;
 
     /**
      * @brief       The IPAPIGeoIPProvider provides a ip-api.com geo IP lookup.
      *
      * @details     Uses ip-api.com to lookup an IP address to determine the geo location.
+     *
+     *              Lookups are not sent straight away, they are collected for a short flush window and then sent
+     *              together to the batch endpoint (up to 100 addresses per request) using a single network manager.
+     *              A lookup for an address that is already waiting for an answer does not send another request,
+     *              the answer is delivered to every caller that asked for it.
+     *
+     *              Answers are cached, private and reserved addresses and addresses that ip-api could not locate
+     *              are never sent.  Callers are only called for addresses that were located.
      */
     class IPAPIGeoIPProvider :
-            public Nedrysoft::Core::IGeoIPProvider {
+            public Nedrysoft::Core::IGeoIPProvider,
+            public Nedrysoft::Core::IConfiguration {
 
         private:
             Q_OBJECT
@@ -75,7 +96,8 @@ namespace Nedrysoft { namespace IPAPIGeoIPProvider {
              * @brief       Performs a host lookup using IP address or hostname.
              *
              * @details     This overloaded function uses a std::function to obtain the result, this can be
-             *              a callback function or a lambda function.
+             *              a callback function or a lambda function.  The address is passed to the function in its
+             *              canonical form (as given by QHostAddress::toString).
              *
              * @see         Nedrysoft::Core::IGeoIPProvider::lookup
              *
@@ -84,10 +106,66 @@ namespace Nedrysoft { namespace IPAPIGeoIPProvider {
              */
             auto lookup(const QString host, Nedrysoft::Core::GeoFunction function) -> void override;
 
+        public:
+            /**
+             * @brief       Saves the configuration to a JSON object.
+             *
+             * @returns     the JSON configuration.
+             */
+            auto saveConfiguration() -> QJsonObject override;
+
+            /**
+             * @brief       Loads the configuration.
+             *
+             * @note        The "batchUrl" key sets the batch endpoint and the "flushWindow" key sets the time in
+             *              milliseconds that lookups are collected for before they are sent.  The
+             *              "ipv4PrefixLength" and "ipv6PrefixLength" keys set the size of the network that an
+             *              answer is cached for.  The "cacheFilename" key sets the file that the cache is kept in,
+             *              it should be set before any lookups are made.
+             *
+             * @param[in]   configuration the configuration as JSON object.
+             *
+             * @returns     true if loaded; otherwise false.
+             */
+            auto loadConfiguration(QJsonObject configuration) -> bool override;
+
+        private:
+            /**
+             * @brief       Sends the lookups that are waiting to the batch endpoint.
+             *
+             * @details     At most 100 addresses are sent in a request, if more are waiting the flush is repeated
+             *              until all of them have been sent.
+             */
+            auto flush() -> void;
+
+            /**
+             * @brief       Adds a host that was not found in the cache to the next batch request.
+             *
+             * @param[in]   host the host address to be looked up.
+             */
+            auto queue(const QString &host) -> void;
+
+            /**
+             * @brief       Processes the answer to a batch request.
+             *
+             * @param[in]   reply the network reply.
+             * @param[in]   hosts the hosts that were sent in the request.
+             */
+            auto processReply(QNetworkReply *reply, const QStringList &hosts) -> void;
+
         private:
              //! @cond
 
-            Nedrysoft::IPAPIGeoIPProvider::Cache *m_cache;
+            QString m_cacheFilename;
+            Nedrysoft::GeoIPCache::GeoIPCache *m_cache;
+            QNetworkAccessManager *m_networkManager;
+            QTimer *m_flushTimer;
+            QUrl m_batchUrl;
+            int m_flushWindow;
+            int m_ipv4PrefixLength;
+            int m_ipv6PrefixLength;
+            QStringList m_queuedHosts;
+            QMap<QString, QList<Nedrysoft::Core::GeoFunction> > m_pendingLookups;
 
              //! @endcond
     };
@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 19/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MaxMindGeoIPProvider.h"
+
+#include <ICore>
+#include <QDateTime>
+#include <QFileInfo>
+#include <QHostAddress>
+#include <QJsonObject>
+
+constexpr auto DefaultCityDatabase = "GeoLite2-City.mmdb";
+constexpr auto DefaultAsnDatabase = "GeoLite2-ASN.mmdb";
+constexpr auto CityDatabaseKey = "cityDatabase";
+constexpr auto AsnDatabaseKey = "asnDatabase";
+
+Nedrysoft::MaxMindGeoIPProvider::MaxMindGeoIPProvider::MaxMindGeoIPProvider() {
+    auto storageFolder = Nedrysoft::Core::ICore::getInstance()->storageFolder();
+
+    m_cityDatabaseFilename = QFileInfo(storageFolder, DefaultCityDatabase).absoluteFilePath();
+    m_asnDatabaseFilename = QFileInfo(storageFolder, DefaultAsnDatabase).absoluteFilePath();
+
+    m_cityDatabase.open(m_cityDatabaseFilename);
+    m_asnDatabase.open(m_asnDatabaseFilename);
+}
+
+Nedrysoft::MaxMindGeoIPProvider::MaxMindGeoIPProvider::~MaxMindGeoIPProvider() {
+
+}
+
+auto Nedrysoft::MaxMindGeoIPProvider::MaxMindGeoIPProvider::lookup(
+        const QString host,
+        Nedrysoft::Core::GeoFunction function ) -> void {
+
+    auto hostAddress = QHostAddress();
+
+    if (!hostAddress.setAddress(host)) {
+        return;
+    }
+
+    auto resultMap = QVariantMap();
+    auto entry = Nedrysoft::MaxMindDatabase::MaxMindDatabase::Entry();
+
+    /**
+     * the fields are named to match the other providers.
+     */
+
+    auto setField = [&resultMap](const QString &field, const QVariant &value) {
+        if (value.isValid()) {
+            resultMap[field] = value;
+        }
+    };
+
+    if (m_cityDatabase.find(hostAddress, entry)) {
+        setField("country", m_cityDatabase.value(entry, {"country", "names", "en"}));
+        setField("countryCode", m_cityDatabase.value(entry, {"country", "iso_code"}));
+        setField("region", m_cityDatabase.value(entry, {"subdivisions", "0", "iso_code"}));
+        setField("regionName", m_cityDatabase.value(entry, {"subdivisions", "0", "names", "en"}));
+        setField("city", m_cityDatabase.value(entry, {"city", "names", "en"}));
+        setField("zip", m_cityDatabase.value(entry, {"postal", "code"}));
+        setField("lat", m_cityDatabase.value(entry, {"location", "latitude"}));
+        setField("lon", m_cityDatabase.value(entry, {"location", "longitude"}));
+        setField("timezone", m_cityDatabase.value(entry, {"location", "time_zone"}));
+    }
+
+    if (m_asnDatabase.find(hostAddress, entry)) {
+        auto number = m_asnDatabase.value(entry, {"autonomous_system_number"});
+        auto organisation = m_asnDatabase.value(entry, {"autonomous_system_organization"});
+
+        if (number.isValid()) {
+            resultMap["asn"] = QString("AS%1 %2").arg(number.toULongLong()).arg(organisation.toString()).trimmed();
+        }
+
+        setField("org", organisation);
+        setField("isp", organisation);
+    }
+
+    if (resultMap.isEmpty()) {
+        return;
+    }
+
+#if (QT_VERSION_MAJOR>=6)
+    resultMap["creationTime"] = QDateTime::currentDateTimeUtc().toSecsSinceEpoch();
+#else
+    resultMap["creationTime"] = QDateTime::currentDateTimeUtc().toTime_t();
+#endif
+
+    function(host, resultMap);
+}
+
+auto Nedrysoft::MaxMindGeoIPProvider::MaxMindGeoIPProvider::lookup(const QString host) -> void {
+    lookup(host, [=](const QString &hostAddress, const QVariantMap &result) {
+        Q_EMIT this->result(hostAddress, result);
+    });
+}
+
+auto Nedrysoft::MaxMindGeoIPProvider::MaxMindGeoIPProvider::saveConfiguration() -> QJsonObject {
+    auto configuration = QJsonObject();
+
+    configuration.insert(CityDatabaseKey, m_cityDatabaseFilename);
+    configuration.insert(AsnDatabaseKey, m_asnDatabaseFilename);
+
+    return configuration;
+}
+
+auto Nedrysoft::MaxMindGeoIPProvider::MaxMindGeoIPProvider::loadConfiguration(QJsonObject configuration) -> bool {
+    m_cityDatabaseFilename = configuration.value(CityDatabaseKey).toString(m_cityDatabaseFilename);
+    m_asnDatabaseFilename = configuration.value(AsnDatabaseKey).toString(m_asnDatabaseFilename);
+
+    m_cityDatabase.open(m_cityDatabaseFilename);
+    m_asnDatabase.open(m_asnDatabaseFilename);
+
+    return true;
+}
@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 19/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PINGNOO_COMPONENTS_MAXMINDGEOIPPROVIDER_MAXMINDGEOIPPROVIDER_H
+#define PINGNOO_COMPONENTS_MAXMINDGEOIPPROVIDER_MAXMINDGEOIPPROVIDER_H
+
+#include "ComponentSystem/IInterface.h"
+#include "MaxMindDatabase/MaxMindDatabase.h"
+#include "MaxMindGeoIPProviderSpec.h"
+
+#include <IConfiguration>
+#include <IGeoIPProvider>
+#include <QObject>
+#include <QString>
+#include <QVariantMap>
+
+namespace Nedrysoft { namespace MaxMindGeoIPProvider {
+    /**
+     * @brief       The MaxMindGeoIPProvider provides an offline geo IP lookup from MaxMind databases.
+     *
+     * @details     Reads a city (or country) database and an ASN database in the MaxMind format, such as the
+     *              GeoLite2 databases, from the storage folder.  The databases are memory mapped and searched in
+     *              place so a lookup is answered immediately without any network access.
+     */
+    class MaxMindGeoIPProvider :
+            public Nedrysoft::Core::IGeoIPProvider,
+            public Nedrysoft::Core::IConfiguration {
+
+        private:
+            Q_OBJECT
+
+            Q_INTERFACES(Nedrysoft::Core::IGeoIPProvider)
+
+        public:
+            /**
+             * @brief       Constructs a MaxMindGeoIPProvider.
+             */
+            MaxMindGeoIPProvider();
+
+            /**
+             * @brief       Destroys the MaxMindGeoIPProvider.
+             */
+            ~MaxMindGeoIPProvider();
+
+            /**
+             * @brief       Performs a host lookup using IP address.
+             *
+             * @details     The result is provided via the Nedrysoft::Core::IGeoIPProvider::result signal before
+             *              this returns.
+             *
+             * @see         Nedrysoft::Core::IGeoIPProvider::lookup
+             *
+             * @param[in]   host the host address to be looked up.
+             */
+            auto lookup(const QString host) -> void override;
+
+            /**
+             * @brief       Performs a host lookup using IP address.
+             *
+             * @details     The function is called before this returns if either database has an entry for the
+             *              address, otherwise it is not called.
+             *
+             * @see         Nedrysoft::Core::IGeoIPProvider::lookup
+             *
+             * @param[in]   host the host address to be looked up.
+             * @param[in]   function the function called when a result is available.
+             */
+            auto lookup(const QString host, Nedrysoft::Core::GeoFunction function) -> void override;
+
+        public:
+            /**
+             * @brief       Saves the configuration to a JSON object.
+             *
+             * @returns     the JSON configuration.
+             */
+            auto saveConfiguration() -> QJsonObject override;
+
+            /**
+             * @brief       Loads the configuration.
+             *
+             * @note        The "cityDatabase" and "asnDatabase" keys set the filenames of the databases.
+             *
+             * @param[in]   configuration the configuration as JSON object.
+             *
+             * @returns     true if loaded; otherwise false.
+             */
+            auto loadConfiguration(QJsonObject configuration) -> bool override;
+
+        private:
+            //! @cond
+
+            Nedrysoft::MaxMindDatabase::MaxMindDatabase m_cityDatabase;
+            Nedrysoft::MaxMindDatabase::MaxMindDatabase m_asnDatabase;
+            QString m_cityDatabaseFilename;
+            QString m_asnDatabaseFilename;
+
+            //! @endcond
+    };
+}}
+
+#endif // PINGNOO_COMPONENTS_MAXMINDGEOIPPROVIDER_MAXMINDGEOIPPROVIDER_H
@@ -24,27 +24,37 @@
 #include "PingCommandPingEngine.h"
 
 #include "PingCommandPingTarget.h"
+#include "PingCommand/PingOutputParser.h"
 
+#include <PacketRateGovernor>
 #include <QElapsedTimer>
+#include <QJsonObject>
 #include <QMutex>
 #include <QProcess>
-#include <QRegularExpression>
 #include <QThread>
+#include <cmath>
+#include <cstring>
 
 constexpr auto DefaultReceiveTimeout = 1000;
 constexpr auto DefaultTerminateThreadTimeout = 5000;
 constexpr auto DefaultTTL = 64;
+constexpr auto DefaultInterval = 2500;
+constexpr auto DefaultProgram = "ping";
+constexpr auto ProgramKey = "program";
+constexpr auto PingPacketLength = 64;
 
-constexpr auto PacketLostRegularExpression = R"(100% packet loss)";
-constexpr auto TtlExceededRegularExpression = R"(From\ (?<ip>[\d\.]*)\ .*exceeded)";
+Nedrysoft::PingCommandPingEngine::PingCommandPingEngine::PingCommandPingEngine(Nedrysoft::Core::IPVersion version) :
+        m_interval(DefaultInterval),
+        m_isRunning(false),
+        m_program(DefaultProgram) {
 
-Nedrysoft::PingCommandPingEngine::PingCommandPingEngine::PingCommandPingEngine(Nedrysoft::Core::IPVersion version) {
     Q_UNUSED(version)
-
 }
 
 Nedrysoft::PingCommandPingEngine::PingCommandPingEngine::~PingCommandPingEngine() {
+    m_singleShotPool.waitForDone();
 
+    qDeleteAll(m_pingTargets);
 }
 
 auto Nedrysoft::PingCommandPingEngine::PingCommandPingEngine::addTarget(
@@ -65,28 +75,63 @@ auto Nedrysoft::PingCommandPingEngine::PingCommandPingEngine::addTarget(
 
     m_pingTargets.append(newTarget);
 
+    if (m_isRunning) {
+        newTarget->start();
+    }
+
     return newTarget;
 }
 
 auto Nedrysoft::PingCommandPingEngine::PingCommandPingEngine::removeTarget(
         Nedrysoft::RouteAnalyser::IPingTarget *target ) -> bool {
 
-    Q_UNUSED(target)
+    for (auto pingTarget : m_pingTargets) {
+        if (pingTarget==target) {
+            m_pingTargets.removeOne(pingTarget);
 
-    return true;
+            delete pingTarget;
+
+            return true;
+        }
+    }
+
+    return false;
 }
 
 auto Nedrysoft::PingCommandPingEngine::PingCommandPingEngine::start() -> bool {
+    m_isRunning = true;
+
+    /**
+     * each target runs a single ping process for as long as the engine is running rather than a process per
+     * sample, so the number of processes only depends on the number of targets.
+     */
+
+    for (auto pingTarget : m_pingTargets) {
+        pingTarget->start();
+    }
+
     return true;
 }
 
 auto Nedrysoft::PingCommandPingEngine::PingCommandPingEngine::stop() -> bool {
+    m_isRunning = false;
+
+    for (auto pingTarget : m_pingTargets) {
+        pingTarget->stop();
+    }
+
     return true;
 }
 
 auto Nedrysoft::PingCommandPingEngine::PingCommandPingEngine::setInterval(int interval) -> bool {
     m_interval = interval;
 
+    if (m_isRunning) {
+        for (auto pingTarget : m_pingTargets) {
+            pingTarget->start();
+        }
+    }
+
     return true;
 }
 
@@ -105,15 +150,23 @@ auto Nedrysoft::PingCommandPingEngine::PingCommandPingEngine::epoch() -> QDateTi
 }
 
 auto Nedrysoft::PingCommandPingEngine::PingCommandPingEngine::saveConfiguration() -> QJsonObject {
-   return QJsonObject();
+    auto configuration = QJsonObject();
+
+    configuration.insert(ProgramKey, m_program);
+
+    return configuration;
 }
 
 auto Nedrysoft::PingCommandPingEngine::PingCommandPingEngine::loadConfiguration(QJsonObject configuration) -> bool {
-    Q_UNUSED(configuration)
+    m_program = configuration.value(ProgramKey).toString(DefaultProgram);
 
     return true;
 }
 
+auto Nedrysoft::PingCommandPingEngine::PingCommandPingEngine::program() -> QString {
+    return m_program;
+}
+
 auto Nedrysoft::PingCommandPingEngine::PingCommandPingEngine::emitResult(
         Nedrysoft::RouteAnalyser::PingResult pingResult) -> void {
 
@@ -141,14 +194,22 @@ auto Nedrysoft::PingCommandPingEngine::PingCommandPingEngine::singleShot(
     QElapsedTimer timer;
     QDateTime epoch;
 
+    /**
+     * not every version of ping accepts a fractional wait time, so the adaptive timeout is rounded up to the
+     * nearest whole second.
+     */
+
     auto pingArguments = QStringList() <<
-                                       "-W" << QString("%1").arg(timeout) <<
+                                       "-W" << QString("%1").arg(qMax(1.0, std::ceil(timeout))) <<
+                                       "-n" <<
                                        "-D" <<
                                        "-c" << "1" <<
                                        "-t" << QString("%1").arg(ttl) <<
                                        hostAddress.toString();
 
-    pingProcess.start("ping", pingArguments);
+    Nedrysoft::RouteAnalyser::PacketRateGovernor::getInstance()->acquire(this, PingPacketLength);
+
+    pingProcess.start(m_program, pingArguments);
 
     pingProcess.waitForStarted();
 
@@ -158,51 +219,90 @@ auto Nedrysoft::PingCommandPingEngine::PingCommandPingEngine::singleShot(
 
     pingProcess.waitForFinished();
 
-    auto roundTripTime = timer.elapsed()/1e9;
+    auto roundTripTime = timer.nsecsElapsed()/1e9;
 
     auto commandOutput = pingProcess.readAll();
 
-    QRegularExpression ttlExceededRegEx(TtlExceededRegularExpression);
-    QRegularExpression packetLostRegEx(PacketLostRegularExpression);
-
-    Nedrysoft::RouteAnalyser::PingResult pingResult;
-
-    if (pingProcess.exitCode() == 0) {
-        pingResult = Nedrysoft::RouteAnalyser::PingResult(
-            0,
-            Nedrysoft::RouteAnalyser::PingResult::ResultCode::Ok,
-            hostAddress,
-            epoch,
-            roundTripTime,
-            nullptr
-        );
-
-    } else {
-        auto ttlExceededMatch = ttlExceededRegEx.match(commandOutput);
-        auto packetLostMatch = packetLostRegEx.match(commandOutput);
-
-        if (ttlExceededMatch.hasMatch()) {
-            pingResult = Nedrysoft::RouteAnalyser::PingResult(
-                0,
-                Nedrysoft::RouteAnalyser::PingResult::ResultCode::TimeExceeded,
-                QHostAddress(ttlExceededMatch.captured("ip")),
-                epoch,
-                roundTripTime,
-                nullptr
-            );
-        } else if (packetLostMatch.hasMatch()) {
-            pingResult = Nedrysoft::RouteAnalyser::PingResult(
-                0,
-                Nedrysoft::RouteAnalyser::PingResult::ResultCode::NoReply,
-                QHostAddress(packetLostMatch.captured("ip")),
-                epoch,
-                roundTripTime,
-                nullptr
-            );
-        } else {
-            // some other error
+    Nedrysoft::RouteAnalyser::PingResult pingResult(
+        0,
+        Nedrysoft::RouteAnalyser::PingResult::ResultCode::NoReply,
+        QHostAddress(),
+        epoch,
+        roundTripTime,
+        nullptr,
+        ttl
+    );
+
+    /**
+     * the output is parsed in place a line at a time, the first line that reports a reply gives the result and
+     * if there is none the request was lost.
+     */
+
+    auto lineStart = commandOutput.constData();
+    auto outputEnd = lineStart+commandOutput.length();
+
+    while (lineStart<outputEnd) {
+        auto lineEnd = static_cast<const char *>(memchr(lineStart, '\n', static_cast<size_t>(outputEnd-lineStart)));
+
+        if (!lineEnd) {
+            lineEnd = outputEnd;
         }
+
+        Nedrysoft::PingCommand::PingOutputParser::Line line;
+
+        if (Nedrysoft::PingCommand::PingOutputParser::parse(lineStart, static_cast<int>(lineEnd-lineStart), line)) {
+            auto resultCode = Nedrysoft::RouteAnalyser::PingResult::ResultCode::NoReply;
+
+            switch (line.type) {
+                case Nedrysoft::PingCommand::PingOutputParser::LineType::Reply: {
+                    resultCode = Nedrysoft::RouteAnalyser::PingResult::ResultCode::Ok;
+                    roundTripTime = line.roundTripTime/1000.0;
+                    break;
+                }
+
+                case Nedrysoft::PingCommand::PingOutputParser::LineType::TimeExceeded: {
+                    resultCode = Nedrysoft::RouteAnalyser::PingResult::ResultCode::TimeExceeded;
+                    break;
+                }
+
+                case Nedrysoft::PingCommand::PingOutputParser::LineType::Unreachable: {
+                    resultCode = Nedrysoft::RouteAnalyser::PingResult::ResultCode::Unreachable;
+                    break;
+                }
+
+                case Nedrysoft::PingCommand::PingOutputParser::LineType::NoAnswer:
+                case Nedrysoft::PingCommand::PingOutputParser::LineType::Unknown: {
+                    break;
+                }
+            }
+
+            if (resultCode!=Nedrysoft::RouteAnalyser::PingResult::ResultCode::NoReply) {
+                pingResult = Nedrysoft::RouteAnalyser::PingResult(
+                    0,
+                    resultCode,
+                    Nedrysoft::PingCommand::PingOutputParser::hostAddress(line),
+                    epoch,
+                    roundTripTime,
+                    nullptr,
+                    ttl
+                );
+
+                break;
+            }
+        }
+
+        lineStart = lineEnd+1;
     }
 
     return pingResult;
 }
+
+auto Nedrysoft::PingCommandPingEngine::PingCommandPingEngine::singleShot(
+        const Nedrysoft::RouteAnalyser::SingleShotProbeList &probes,
+        double timeout,
+        uint16_t flowId,
+        Nedrysoft::RouteAnalyser::SingleShotCallback callback )
+            -> std::future<QList<Nedrysoft::RouteAnalyser::PingResult> > {
+
+    return m_singleShotPool.singleShot(this, probes, timeout, flowId, callback);
+}
@@ -27,6 +27,7 @@
 #include <IInterface>
 #include <IPingEngine>
 #include <IPingEngineFactory>
+#include <SingleShotPool>
 
 namespace Nedrysoft { namespace PingCommandPingEngine {
     class PingCommandPingTarget;
@@ -169,6 +170,27 @@ namespace Nedrysoft { namespace PingCommandPingEngine {
                 double timeout
             ) -> Nedrysoft::RouteAnalyser::PingResult override;
 
+            /**
+             * @brief       Transmits a batch of single pings concurrently.
+             *
+             * @details     Each probe is run as a blocking single shot on the pool owned by the engine.
+             *
+             * @see         Nedrysoft::RouteAnalyser::IPingEngine::singleShot
+             *
+             * @param[in]   probes the list of probes to send.
+             * @param[in]   timeout time in seconds to wait for the responses.
+             * @param[in]   flowId the flow identifier to use for the probes, 0 if the engine should choose.
+             * @param[in]   callback called with the index of the probe and its result as each probe completes.
+             *
+             * @returns     a future which holds the results in the same order as the probes.
+             */
+            auto singleShot(
+                const Nedrysoft::RouteAnalyser::SingleShotProbeList &probes,
+                double timeout,
+                uint16_t flowId,
+                Nedrysoft::RouteAnalyser::SingleShotCallback callback
+            ) -> std::future<QList<Nedrysoft::RouteAnalyser::PingResult> > override;
+
         public:
             /**
              * @brief       Saves the configuration to a JSON object.
@@ -184,6 +206,9 @@ namespace Nedrysoft { namespace PingCommandPingEngine {
              *
              * @see         Nedrysoft::Core::IConfiguration::loadConfiguration
              *
+             * @note        The "program" key sets the ping program that is run, which allows a scripted program
+             *              to stand in for the system ping.
+             *
              * @param[in]   configuration the configuration as JSON object.
              *
              * @returns     true if loaded; otherwise false.
@@ -193,6 +218,13 @@ namespace Nedrysoft { namespace PingCommandPingEngine {
         private:
             auto emitResult(Nedrysoft::RouteAnalyser::PingResult pingResult) -> void;
 
+            /**
+             * @brief       Returns the ping program that is run by the targets of the engine.
+             *
+             * @returns     the name or path of the program.
+             */
+            auto program() -> QString;
+
             friend class PingCommandPingTarget;
 
         private:
@@ -201,6 +233,10 @@ namespace Nedrysoft { namespace PingCommandPingEngine {
             QList<PingCommandPingTarget *> m_pingTargets;
 
             int m_interval;
+            bool m_isRunning;
+            QString m_program;
+
+            Nedrysoft::RouteAnalyser::SingleShotPool m_singleShotPool;
 
             //! @endcond
     };
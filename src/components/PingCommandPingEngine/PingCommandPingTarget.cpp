@@ -24,151 +24,96 @@
 #include "PingCommandPingTarget.h"
 
 #include "PingCommandPingEngine.h"
+#include "PingCommand/PingCommand.h"
 
-#include <QElapsedTimer>
+#include <PacketRateGovernor>
 #include <QHostAddress>
-#include <QProcess>
-#include <QRegularExpression>
-#if QT_VERSION >= QT_VERSION_CHECK(5, 10, 0)
-#include <QThread>
-#else
-#include <QTimer>
-#include <thread>
-#endif
-#include <cassert>
-
-constexpr auto ReplyTimeout = 3;
-constexpr auto NanosecondsInMillisecond = 1.0e6;
-constexpr auto PacketLostRegularExpression = R"(100% packet loss)";
-constexpr auto TtlExceededRegularExpression = R"(From\ (?<ip>[\d\.]*)\ .*exceeded)";
+
+constexpr auto PingPacketLength = 64;
 
 Nedrysoft::PingCommandPingEngine::PingCommandPingTarget::PingCommandPingTarget(
         Nedrysoft::PingCommandPingEngine::PingCommandPingEngine *engine,
         QHostAddress hostAddress,
         int ttl) :
+            m_pingCommand(new Nedrysoft::PingCommand::PingCommand(this)),
             m_userdata(nullptr),
-            m_quitThread(false),
             m_engine(engine),
             m_ttl(ttl),
             m_hostAddress(hostAddress) {
 
-#if QT_VERSION >= QT_VERSION_CHECK(5, 10, 0)
-    m_workerThread = QThread::create([=]() {
-#else
-    m_workerThread = new std::thread([=]() {
-#endif
-        auto pingArguments = QStringList() <<
-                "-W" << QString("%1").arg(ReplyTimeout) <<
-                "-D" <<
-                "-c" << "1" <<
-                "-t" << QString("%1").arg(ttl) <<
-                m_hostAddress.toString();
-
-        int sampleNumber = 0;
-
-        while(!m_quitThread) {
-#if QT_VERSION >= QT_VERSION_CHECK(5, 10, 0)
-            QThread *pingThread = QThread::create([sampleNumber, pingArguments, engine, pingThread, this]() {
-#else
-            std::thread *pingThread = new std::thread([sampleNumber, pingArguments, engine, pingThread, this]() {
-#endif
-                QProcess pingProcess;
-                qint64 started, finished;
-                QElapsedTimer timer;
-                QDateTime epoch;
-
-               // pingProcess = new QProcess();
-
-                pingProcess.start("ping", pingArguments);
-
-                pingProcess.waitForStarted();
-
-                timer.restart();
-
-                epoch = QDateTime::currentDateTime();
-
-                pingProcess.waitForFinished();
-
-                finished = timer.nsecsElapsed();
-
-                auto roundTripTime = timer.nsecsElapsed()/1e9;
-
-                auto commandOutput = pingProcess.readAll();
-
-                QRegularExpression ttlExceededRegEx(TtlExceededRegularExpression);
-                QRegularExpression packetLostRegEx(PacketLostRegularExpression);
-
-                if (pingProcess.exitCode() == 0) {
-                    auto pingResult = Nedrysoft::RouteAnalyser::PingResult(
-                        sampleNumber,
-                        Nedrysoft::RouteAnalyser::PingResult::ResultCode::Ok,
-                        m_hostAddress,
-                        epoch,
-                        roundTripTime,
-                        this
-                    );
-
-                    engine->emitResult(pingResult);
-                } else {
-                    auto ttlExceededMatch = ttlExceededRegEx.match(commandOutput);
-                    auto packetLostMatch = packetLostRegEx.match(commandOutput);
-
-                    if (ttlExceededMatch.hasMatch()) {
-                        auto pingResult = Nedrysoft::RouteAnalyser::PingResult(
-                            sampleNumber,
-                            Nedrysoft::RouteAnalyser::PingResult::ResultCode::TimeExceeded,
-                            QHostAddress(ttlExceededMatch.captured("ip")),
-                            epoch,
-                            roundTripTime,
-                            this
-                        );
-
-                        engine->emitResult(pingResult);
-                    } else if (packetLostMatch.hasMatch()) {
-                        auto pingResult = Nedrysoft::RouteAnalyser::PingResult(
-                            sampleNumber,
-                            Nedrysoft::RouteAnalyser::PingResult::ResultCode::NoReply,
-                            QHostAddress(packetLostMatch.captured("ip")),
-                            epoch,
-                            roundTripTime,
-                            this
-                        );
-
-                        engine->emitResult(pingResult);
-                    } else {
-                        // some other error
-                    }
+    connect(
+        m_pingCommand,
+        &Nedrysoft::PingCommand::PingCommand::reply,
+        this,
+        [=](unsigned long sampleNumber,
+            Nedrysoft::PingCommand::PingCommand::ReplyType replyType,
+            const QHostAddress &replyAddress,
+            const QDateTime &requestTime,
+            double roundTripTime) {
+
+            auto resultCode = Nedrysoft::RouteAnalyser::PingResult::ResultCode::NoReply;
+
+            switch (replyType) {
+                case Nedrysoft::PingCommand::PingCommand::ReplyType::Reply: {
+                    resultCode = Nedrysoft::RouteAnalyser::PingResult::ResultCode::Ok;
+                    break;
+                }
+
+                case Nedrysoft::PingCommand::PingCommand::ReplyType::TimeExceeded: {
+                    resultCode = Nedrysoft::RouteAnalyser::PingResult::ResultCode::TimeExceeded;
+                    break;
                 }
-#if QT_VERSION < QT_VERSION_CHECK(5, 10, 0)
-                QTimer::singleShot(0, [=]() {
-                    delete pingThread;
-                });
-#endif
-            });
-#if QT_VERSION >= QT_VERSION_CHECK(5, 10, 0)
-            QObject::connect(pingThread, &QThread::finished, pingThread, &QThread::deleteLater);
-
-            pingThread->start();
-
-            QThread::msleep(engine->interval().count());
-#else
-            std::this_thread::sleep_for(std::chrono::milliseconds(engine->interval()));
-#endif
-            sampleNumber++;
-        }
-    });
 
-#if QT_VERSION >= QT_VERSION_CHECK(5, 10, 0)
-    m_workerThread->start();
-#endif
+                case Nedrysoft::PingCommand::PingCommand::ReplyType::Unreachable: {
+                    resultCode = Nedrysoft::RouteAnalyser::PingResult::ResultCode::Unreachable;
+                    break;
+                }
+
+                case Nedrysoft::PingCommand::PingCommand::ReplyType::NoReply: {
+                    break;
+                }
+            }
+
+            /**
+             * the packets are sent by the ping process so they cannot be held back by the governor, the tokens
+             * are still taken so that the traffic counts against the budget of the other senders.
+             */
+
+            Nedrysoft::RouteAnalyser::PacketRateGovernor::getInstance()->tryAcquire(m_engine, PingPacketLength);
+
+            m_engine->emitResult(Nedrysoft::RouteAnalyser::PingResult(
+                sampleNumber,
+                resultCode,
+                replyAddress,
+                requestTime,
+                roundTripTime,
+                this,
+                m_ttl
+            ));
+        }
+    );
 }
 
 Nedrysoft::PingCommandPingEngine::PingCommandPingTarget::~PingCommandPingTarget() {
+    stop();
+}
+
+auto Nedrysoft::PingCommandPingEngine::PingCommandPingTarget::start() -> void {
+    m_pingCommand->setProgram(m_engine->program());
 
+    m_pingCommand->start(m_hostAddress, m_ttl, m_engine->interval());
+}
+
+auto Nedrysoft::PingCommandPingEngine::PingCommandPingTarget::stop() -> void {
+    m_pingCommand->stop();
 }
 
 auto Nedrysoft::PingCommandPingEngine::PingCommandPingTarget::setHostAddress(QHostAddress hostAddress) -> void {
     m_hostAddress = hostAddress;
+
+    if (m_pingCommand->isRunning()) {
+        start();
+    }
 }
 
 auto Nedrysoft::PingCommandPingEngine::PingCommandPingTarget::hostAddress() -> QHostAddress {
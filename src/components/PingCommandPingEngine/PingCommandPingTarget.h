@@ -25,12 +25,11 @@
 #define PINGNOO_COMPONENTS_PINGCOMMANDPINGENGINE_PINGCOMMANDPINGTARGET_H
 
 #include <IPingTarget>
+#include <PingResult>
 
-#if QT_VERSION >= QT_VERSION_CHECK(5, 10, 0)
-#include <QThread>
-#else
-#include <thread>
-#endif
+namespace Nedrysoft { namespace PingCommand {
+    class PingCommand;
+}}
 
 namespace Nedrysoft { namespace PingCommandPingEngine {
     class PingCommandPingEngine;
@@ -39,6 +38,10 @@ namespace Nedrysoft { namespace PingCommandPingEngine {
      * @brief       Provides an implementation of IPingTarget which uses the system provided
      *              ping binary.  Useful for linux which would otherwise require elevated privileges
      *              to run.
+     *
+     * @details     Each target runs a single ping process for as long as the engine is running, the output of
+     *              the process is parsed as it is written so that the number of processes does not grow with the
+     *              number of samples.
      */
     class PingCommandPingTarget :
             public Nedrysoft::RouteAnalyser::IPingTarget {
@@ -138,15 +141,27 @@ namespace Nedrysoft { namespace PingCommandPingEngine {
              */
             auto loadConfiguration(QJsonObject configuration) -> bool override;
 
+        private:
+            /**
+             * @brief       Starts the ping process for this target.
+             *
+             * @details     If the process is already running it is restarted, so that a change of interval or
+             *              address takes effect.
+             */
+            auto start() -> void;
+
+            /**
+             * @brief       Stops the ping process for this target.
+             */
+            auto stop() -> void;
+
+            friend class PingCommandPingEngine;
+
         private:
             //! @cond
-#if QT_VERSION >= QT_VERSION_CHECK(5, 10, 0)
-            QThread *m_workerThread;
-#else
-            std::thread *m_workerThread;
-#endif
+
+            Nedrysoft::PingCommand::PingCommand *m_pingCommand;
             void *m_userdata;
-            bool m_quitThread;
             PingCommandPingEngine *m_engine;
             int m_ttl;
             QHostAddress m_hostAddress;
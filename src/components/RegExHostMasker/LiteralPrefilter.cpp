@@ -0,0 +1,457 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 19/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "LiteralPrefilter.h"
+
+#include <QQueue>
+
+/**
+ * @brief       Finds the end of a bracketed character class.
+ *
+ * @param[in]   expression the regular expression.
+ * @param[in]   index the index of the opening bracket.
+ *
+ * @returns     the index of the closing bracket, -1 if there is none.
+ */
+static auto skipClass(const QString &expression, int index) -> int {
+    auto length = expression.length();
+
+    index++;
+
+    if ((index<length) && (expression[index]==QChar('^'))) {
+        index++;
+    }
+
+    /**
+     * a closing bracket straight after the opening one is a literal.
+     */
+
+    if ((index<length) && (expression[index]==QChar(']'))) {
+        index++;
+    }
+
+    while (index<length) {
+        auto character = expression[index];
+
+        if (character==QChar('\\')) {
+            index += 2;
+
+            continue;
+        }
+
+        if ((character==QChar('[')) && (index+1<length) && QString(":.=").contains(expression[index+1])) {
+            auto end = expression.indexOf(QString(expression[index+1])+QChar(']'), index+2);
+
+            if (end<0) {
+                return -1;
+            }
+
+            index = end+2;
+
+            continue;
+        }
+
+        if (character==QChar(']')) {
+            return index;
+        }
+
+        index++;
+    }
+
+    return -1;
+}
+
+/**
+ * @brief       Finds the end of a group.
+ *
+ * @param[in]   expression the regular expression.
+ * @param[in]   index the index of the opening parenthesis.
+ *
+ * @returns     the index of the closing parenthesis, -1 if there is none.
+ */
+static auto skipGroup(const QString &expression, int index) -> int {
+    auto length = expression.length();
+    auto depth = 0;
+
+    while (index<length) {
+        auto character = expression[index];
+
+        if (character==QChar('\\')) {
+            index += 2;
+
+            continue;
+        }
+
+        if (character==QChar('[')) {
+            index = skipClass(expression, index);
+
+            if (index<0) {
+                return -1;
+            }
+        } else if (character==QChar('(')) {
+            depth++;
+        } else if (character==QChar(')')) {
+            if (--depth==0) {
+                return index;
+            }
+        }
+
+        index++;
+    }
+
+    return -1;
+}
+
+/**
+ * @brief       Finds the start of the contents of a group that always takes part in a match.
+ *
+ * @param[in]   expression the regular expression.
+ * @param[in]   index the index of the opening parenthesis.
+ *
+ * @returns     the index of the first character inside the group, -1 if the group is a lookaround or is not
+ *              understood.
+ */
+static auto groupContentStart(const QString &expression, int index) -> int {
+    auto length = expression.length();
+
+    if ((index+1>=length) || (expression[index+1]!=QChar('?'))) {
+        return index+1;
+    }
+
+    if (index+2>=length) {
+        return -1;
+    }
+
+    auto groupType = expression[index+2];
+
+    if (groupType==QChar(':')) {
+        return index+3;
+    }
+
+    if (groupType==QChar('\'')) {
+        auto end = expression.indexOf(QChar('\''), index+3);
+
+        return (end<0) ? -1 : end+1;
+    }
+
+    if (groupType==QChar('P')) {
+        if ((index+3>=length) || (expression[index+3]!=QChar('<'))) {
+            return -1;
+        }
+
+        auto end = expression.indexOf(QChar('>'), index+4);
+
+        return (end<0) ? -1 : end+1;
+    }
+
+    if ((groupType==QChar('<')) && (index+3<length) && (!QString("=!").contains(expression[index+3]))) {
+        auto end = expression.indexOf(QChar('>'), index+3);
+
+        return (end<0) ? -1 : end+1;
+    }
+
+    return -1;
+}
+
+/**
+ * @brief       Returns whether the contents of a group have an alternation that is not inside a nested group.
+ *
+ * @param[in]   expression the regular expression.
+ * @param[in]   start the index of the first character inside the group.
+ * @param[in]   end the index of the closing parenthesis of the group.
+ *
+ * @returns     true if the group has a top level alternation; otherwise false.
+ */
+static auto hasAlternation(const QString &expression, int start, int end) -> bool {
+    auto depth = 0;
+
+    for (auto index = start; index<end; index++) {
+        auto character = expression[index];
+
+        if (character==QChar('\\')) {
+            index++;
+        } else if (character==QChar('[')) {
+            index = skipClass(expression, index);
+
+            if (index<0) {
+                return true;
+            }
+        } else if (character==QChar('(')) {
+            depth++;
+        } else if (character==QChar(')')) {
+            depth--;
+        } else if ((character==QChar('|')) && (depth==0)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief       Returns whether the item that ends before an index may be left out of a match.
+ *
+ * @param[in]   expression the regular expression.
+ * @param[in]   index the index of the character after the item.
+ *
+ * @returns     true if the item is followed by a ?, * or {0,...} quantifier; otherwise false.
+ */
+static auto isOptional(const QString &expression, int index) -> bool {
+    if (index>=expression.length()) {
+        return false;
+    }
+
+    auto character = expression[index];
+
+    if ((character==QChar('?')) || (character==QChar('*'))) {
+        return true;
+    }
+
+    if (character==QChar('{')) {
+        auto end = expression.indexOf(QChar('}'), index);
+        auto minimum = expression.mid(index+1, end-index-1).section(QChar(','), 0, 0);
+
+        return (end<0) || (minimum.isEmpty()) || (minimum.toInt()==0);
+    }
+
+    return false;
+}
+
+Nedrysoft::RegExHostMasker::LiteralPrefilter::LiteralPrefilter() {
+    clear();
+}
+
+auto Nedrysoft::RegExHostMasker::LiteralPrefilter::clear() -> void {
+    m_nodes.clear();
+    m_nodes.append(Node{QHash<QChar, int>(), 0, QVector<int>()});
+    m_alwaysCandidates.clear();
+    m_ruleCount = 0;
+}
+
+auto Nedrysoft::RegExHostMasker::LiteralPrefilter::add(const QString &expression) -> void {
+    auto rule = m_ruleCount++;
+    auto literal = requiredLiteral(expression);
+
+    m_alwaysCandidates.resize(m_ruleCount);
+
+    if (literal.isEmpty()) {
+        m_alwaysCandidates.setBit(rule);
+
+        return;
+    }
+
+    auto node = 0;
+
+    for (auto character : literal) {
+        auto transition = m_nodes[node].m_transitions.constFind(character);
+
+        if (transition==m_nodes[node].m_transitions.constEnd()) {
+            m_nodes.append(Node{QHash<QChar, int>(), 0, QVector<int>()});
+            m_nodes[node].m_transitions.insert(character, m_nodes.count()-1);
+
+            node = m_nodes.count()-1;
+        } else {
+            node = transition.value();
+        }
+    }
+
+    m_nodes[node].m_rules.append(rule);
+}
+
+auto Nedrysoft::RegExHostMasker::LiteralPrefilter::build() -> void {
+    auto queue = QQueue<int>();
+
+    /**
+     * the failure link of a node is the longest proper suffix of its string that is also in the automaton, the
+     * nodes are visited in breadth first order so that the links of shorter strings are known first.  The rules
+     * of the failure node are copied so that a search only needs to look at the node that it is in.
+     */
+
+    for (auto child : m_nodes[0].m_transitions) {
+        m_nodes[child].m_failure = 0;
+
+        queue.enqueue(child);
+    }
+
+    while (!queue.isEmpty()) {
+        auto node = queue.dequeue();
+
+        for (auto transition = m_nodes[node].m_transitions.constBegin();
+             transition!=m_nodes[node].m_transitions.constEnd();
+             transition++) {
+
+            auto character = transition.key();
+            auto child = transition.value();
+            auto failure = m_nodes[node].m_failure;
+
+            while ((failure!=0) && (!m_nodes[failure].m_transitions.contains(character))) {
+                failure = m_nodes[failure].m_failure;
+            }
+
+            m_nodes[child].m_failure = m_nodes[failure].m_transitions.value(character, 0);
+
+            for (auto rule : m_nodes[m_nodes[child].m_failure].m_rules) {
+                if (!m_nodes[child].m_rules.contains(rule)) {
+                    m_nodes[child].m_rules.append(rule);
+                }
+            }
+
+            queue.enqueue(child);
+        }
+    }
+}
+
+auto Nedrysoft::RegExHostMasker::LiteralPrefilter::candidates(const QString &text) const -> QBitArray {
+    auto ruleCandidates = m_alwaysCandidates;
+    auto node = 0;
+
+    for (auto character : text) {
+        while ((node!=0) && (!m_nodes[node].m_transitions.contains(character))) {
+            node = m_nodes[node].m_failure;
+        }
+
+        node = m_nodes[node].m_transitions.value(character, 0);
+
+        for (auto rule : m_nodes[node].m_rules) {
+            ruleCandidates.setBit(rule);
+        }
+    }
+
+    return ruleCandidates;
+}
+
+auto Nedrysoft::RegExHostMasker::LiteralPrefilter::requiredLiteral(const QString &expression) -> QString {
+    auto longestLiteral = QString();
+    auto currentLiteral = QString();
+    auto length = expression.length();
+
+    /**
+     * ends the current run of literal characters, keeping it if it is the longest so far.
+     */
+
+    auto endLiteral = [&]() {
+        if (currentLiteral.length()>longestLiteral.length()) {
+            longestLiteral = currentLiteral;
+        }
+
+        currentLiteral.clear();
+    };
+
+    for (auto index = 0; index<length; index++) {
+        auto character = expression[index];
+
+        if (character==QChar('\\')) {
+            if (index+1>=length) {
+                return QString();
+            }
+
+            auto escaped = expression[++index];
+
+            if (!escaped.isLetterOrNumber()) {
+                currentLiteral.append(escaped);
+            } else if (QString("dDwWsSbBAzZ").contains(escaped)) {
+                endLiteral();
+            } else {
+                /**
+                 * back references, character codes, properties and quoting are not understood.
+                 */
+
+                return QString();
+            }
+        } else if (character==QChar('[')) {
+            endLiteral();
+
+            index = skipClass(expression, index);
+
+            if (index<0) {
+                return QString();
+            }
+        } else if (character==QChar('(')) {
+            /**
+             * a group is searched for its own literal if it always takes part in a match, that is, it is not a
+             * lookaround, has no alternation of its own and is not optional.  Other groups are skipped, except
+             * for those that set options that would apply to the rest of the expression.
+             */
+
+            if ((index+1<length) && (expression[index+1]==QChar('?'))) {
+                if ((index+2>=length) || (!QString(":=!<>P'").contains(expression[index+2]))) {
+                    return QString();
+                }
+            }
+
+            endLiteral();
+
+            auto groupStart = groupContentStart(expression, index);
+            auto groupEnd = skipGroup(expression, index);
+
+            if (groupEnd<0) {
+                return QString();
+            }
+
+            if ((groupStart>=0) &&
+                (!hasAlternation(expression, groupStart, groupEnd)) &&
+                (!isOptional(expression, groupEnd+1))) {
+
+                currentLiteral = requiredLiteral(expression.mid(groupStart, groupEnd-groupStart));
+
+                endLiteral();
+            }
+
+            index = groupEnd;
+        } else if ((character==QChar('*')) || (character==QChar('+')) || (character==QChar('?'))) {
+            /**
+             * the character before a quantifier may not be in the match.
+             */
+
+            currentLiteral.chop(1);
+
+            endLiteral();
+        } else if (character==QChar('{')) {
+            currentLiteral.chop(1);
+
+            endLiteral();
+
+            index = expression.indexOf(QChar('}'), index);
+
+            if (index<0) {
+                return QString();
+            }
+        } else if (character==QChar('|')) {
+            /**
+             * any one of the alternatives can match, so there is no literal that must be present.
+             */
+
+            return QString();
+        } else if ((character==QChar('.')) || (character==QChar('^')) || (character==QChar('$')) ||
+                   (character==QChar(')'))) {
+
+            endLiteral();
+        } else {
+            currentLiteral.append(character);
+        }
+    }
+
+    endLiteral();
+
+    return longestLiteral;
+}
@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 19/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PINGNOO_COMPONENTS_REGEXHOSTMASKER_LITERALPREFILTER_H
+#define PINGNOO_COMPONENTS_REGEXHOSTMASKER_LITERALPREFILTER_H
+
+#include <QBitArray>
+#include <QChar>
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+namespace Nedrysoft { namespace RegExHostMasker {
+    /**
+     * @brief       The LiteralPrefilter class finds the rules that could match a string in a single pass.
+     *
+     * @details     Each rule is reduced to the longest run of literal characters that every match of its
+     *              expression must contain, and the literals of all of the rules are combined into one
+     *              Aho-Corasick automaton.  Searching a string with the automaton visits each character once,
+     *              however many rules there are, and marks the rules whose literal it contains.  Only those rules
+     *              can match, so only their expressions need to be run.
+     *
+     *              A rule whose expression has no such literal, or uses syntax that the prefilter does not
+     *              understand, is always a candidate.  The literals are case sensitive, as are the expressions.
+     */
+    class LiteralPrefilter {
+        public:
+            /**
+             * @brief       Constructs an empty LiteralPrefilter.
+             */
+            LiteralPrefilter();
+
+            /**
+             * @brief       Removes all of the rules.
+             */
+            auto clear() -> void;
+
+            /**
+             * @brief       Adds a rule, rules are numbered in the order that they are added.
+             *
+             * @param[in]   expression the regular expression of the rule.
+             */
+            auto add(const QString &expression) -> void;
+
+            /**
+             * @brief       Prepares the automaton for searching, must be called after the rules have been added.
+             */
+            auto build() -> void;
+
+            /**
+             * @brief       Finds the rules that could match a string.
+             *
+             * @param[in]   text the string to search.
+             *
+             * @returns     a bit for each rule, set if the rule could match the string.
+             */
+            auto candidates(const QString &text) const -> QBitArray;
+
+            /**
+             * @brief       Returns the longest literal that every match of an expression contains.
+             *
+             * @param[in]   expression the regular expression.
+             *
+             * @returns     the literal, empty if the expression has none that can be found safely.
+             */
+            static auto requiredLiteral(const QString &expression) -> QString;
+
+        private:
+            //! @cond
+
+            struct Node {
+                QHash<QChar, int> m_transitions;
+                int m_failure;
+                QVector<int> m_rules;
+            };
+
+            QVector<Node> m_nodes;
+            QBitArray m_alwaysCandidates;
+            int m_ruleCount;
+
+            //! @endcond
+    };
+}}
+
+#endif // PINGNOO_COMPONENTS_REGEXHOSTMASKER_LITERALPREFILTER_H
@@ -32,8 +32,99 @@
 
 constexpr auto ConfigurationPath = "Components";
 constexpr auto ConfigurationFilename = "RegExHostMasker.json";
+constexpr auto MaximumCachedMasks = 4096;
+
+/**
+ * @brief       Parses the capture group tokens out of a replacement string.
+ *
+ * @param[in]   replacementString the replacement string.
+ *
+ * @returns     the tokens, the values are filled in when a match is made.
+ */
+static auto compileTokens(const QString &replacementString) -> QList<Nedrysoft::RegExHostMasker::TokenReplacement> {
+    static const auto tokenExpression =
+            QRegularExpression(R"(\$\{\s*(?<named>.*)\s*\}|(?<dollar>\$\$)|\$(?<number>\d+))");
+    static const auto tokenTypes = QStringList() << "named" << "dollar" << "number";
+
+    auto tokenReplacementList = QList<Nedrysoft::RegExHostMasker::TokenReplacement>();
+    auto tokenIterator = tokenExpression.globalMatch(replacementString);
+
+    while (tokenIterator.hasNext()) {
+        auto match = tokenIterator.next();
+
+        if (match.hasMatch()) {
+            for (const auto &tokenType : tokenTypes) {
+                auto identifier = match.captured(tokenType);
+
+                if (!identifier.isNull()) {
+                    Nedrysoft::RegExHostMasker::TokenReplacement tokenReplacement;
+
+                    tokenReplacement.type = tokenType;
+                    tokenReplacement.identifier = identifier;
+
+                    if (tokenType=="named") {
+                        tokenReplacement.format = "${%1}";
+                    } else if (tokenType=="number") {
+                        tokenReplacement.format = "$%1";
+                    } else if (tokenType=="dollar") {
+                        // we catch $$ regardless, so just ignore it here.
+                        continue;
+                    } else {
+                        // ruh roh!
+                        continue;
+                    }
+
+                    tokenReplacementList.append(tokenReplacement);
+                }
+            }
+        }
+    }
+
+    return tokenReplacementList;
+}
+
+/**
+ * @brief       Generates the masked output for a match from a compiled replacement string.
+ *
+ * @param[in]   expressionMatch the match of the host name or address.
+ * @param[in]   replacementString the replacement string.
+ * @param[in]   tokenReplacementList the tokens parsed from the replacement string.
+ * @param[out]  outputString the masked output.
+ *
+ * @returns     true if the output was replaced; otherwise false.
+ */
+static auto replaceTokens(
+        const QRegularExpressionMatch &expressionMatch,
+        const QString &replacementString,
+        const QList<Nedrysoft::RegExHostMasker::TokenReplacement> &tokenReplacementList,
+        QString &outputString ) -> bool {
+
+    if (replacementString.isEmpty()) {
+        return false;
+    }
+
+    outputString = replacementString;
+
+    for (const auto &token : tokenReplacementList) {
+        auto value = QString();
+
+        if (token.type=="named") {
+            value = expressionMatch.captured(token.identifier);
+        } else {
+            value = expressionMatch.captured(token.identifier.toInt());
+        }
+
+        outputString.replace(token.format.arg(token.identifier), value);
+    }
+
+    outputString.replace("$$", "$");
+
+    return true;
+}
+
+Nedrysoft::RegExHostMasker::RegExHostMasker::RegExHostMasker() :
+        m_compiled(false) {
 
-Nedrysoft::RegExHostMasker::RegExHostMasker::RegExHostMasker() {
     loadFromFile();
 }
 
@@ -57,6 +148,8 @@ auto Nedrysoft::RegExHostMasker::RegExHostMasker::loadFromFile(QString filename,
         if (jsonDocument.isObject()) {
             if (!append) {
                 m_maskList.clear();
+
+                invalidate();
             }
 
             loadConfiguration(jsonDocument.object());
@@ -109,117 +202,150 @@ auto Nedrysoft::RegExHostMasker::RegExHostMasker::applyMask(
 
     Q_UNUSED(hop)
 
-    auto expressionMatch = QRegularExpressionMatch();
-    auto tokenExpression = QRegularExpression(R"(\$\{\s*(?<named>.*)\s*\}|(?<dollar>\$\$)|\$(?<number>\d+))");
-    auto tokenTypes = QStringList() << "named" << "dollar" << "number";
-    auto searchList = QList<unsigned int>() << static_cast<int>(MatchFlags::MatchHost) << static_cast<int>(MatchFlags::MatchAddress);
-    QString *outputString = nullptr;
     bool returnValue = false;
 
+    if (!m_compiled) {
+        compile();
+    }
+
+    /**
+     * the hop does not take part in matching, so the result only depends on the host name and address.
+     */
+
+    auto cacheKey = qMakePair(hostName, hostAddress);
+    auto cacheIterator = m_maskCache.constFind(cacheKey);
+
+    if (cacheIterator!=m_maskCache.constEnd()) {
+        maskedHostName = cacheIterator->m_maskedHostName;
+        maskedHostAddress = cacheIterator->m_maskedHostAddress;
+
+        return cacheIterator->m_masked;
+    }
+
     maskedHostName = hostName;
     maskedHostAddress = hostAddress;
 
-    auto maskFlags = QList<MatchFlags>() << MatchFlags::MaskHost << MatchFlags::MaskAddress;
+    /**
+     * a single pass over the host name and the address finds the rules that could match them, the expressions
+     * of only those rules are run in order.  The host name and the address are masked separately, each by the
+     * first matching rule that has a replacement for it, so a rule that only masks one of them does not stop a
+     * later rule from masking the other.
+     */
 
-    for (auto matchFlag : searchList) {
-        for (const auto &maskItem : m_maskList) {
-            if (!maskItem.m_enabled) {
-                continue;
-            }
+    auto hostCandidates = m_prefilter.candidates(hostName);
+    auto addressCandidates = m_prefilter.candidates(hostAddress);
+    auto hostMasked = false;
+    auto addressMasked = false;
 
-            if (!( maskItem.m_matchFlags & matchFlag )) {
-                continue;
-            }
+    for (auto ruleIndex = 0; ruleIndex<m_compiledMaskList.count(); ruleIndex++) {
+        const auto &compiledItem = m_compiledMaskList.at(ruleIndex);
+        QRegularExpressionMatch expressionMatch;
 
-            auto matchExpression = QRegularExpression(maskItem.m_matchExpression);
+        if ((compiledItem.m_matchFlags & static_cast<unsigned int>(MatchFlags::MatchHost)) &&
+            (hostCandidates.testBit(ruleIndex))) {
 
-            if (!(static_cast<int>(maskItem.m_matchFlags) & static_cast<int>(matchFlag))) {
-                continue;
-            }
+            expressionMatch = compiledItem.m_expression.match(hostName);
+        }
 
-            if (matchFlag==static_cast<int>(MatchFlags::MatchHost)) {
-                expressionMatch = matchExpression.match(hostName);
-            } else {
-                expressionMatch = matchExpression.match(hostAddress);
-            }
+        if ((!expressionMatch.hasMatch()) &&
+            (compiledItem.m_matchFlags & static_cast<unsigned int>(MatchFlags::MatchAddress)) &&
+            (addressCandidates.testBit(ruleIndex))) {
 
-            QString replacementString;
-
-            for (auto maskFlag : maskFlags) {
-                if (maskFlag == MatchFlags::MaskHost) {
-                    outputString = &maskedHostName;
-                    replacementString = maskItem.m_hostReplacementString;
-                } else if (maskFlag==MatchFlags::MaskAddress) {
-                    outputString = &maskedHostAddress;
-                    replacementString = maskItem.m_addressReplacementString;
-                } else {
-                    continue;
-                }
+            expressionMatch = compiledItem.m_expression.match(hostAddress);
+        }
 
-                if (replacementString.isEmpty()) {
-                    continue;
-                }
+        if (!expressionMatch.hasMatch()) {
+            continue;
+        }
 
-                if (expressionMatch.hasMatch()) {
-                    auto tokenIterator = tokenExpression.globalMatch(replacementString);
-                    QList<TokenReplacement> tokenReplacementList;
+        if ((!hostMasked) && (replaceTokens(
+                expressionMatch,
+                compiledItem.m_hostReplacementString,
+                compiledItem.m_hostTokens,
+                maskedHostName))) {
 
-                    if (!tokenIterator.hasNext()) {
-                        *outputString = replacementString;
+            hostMasked = true;
+        }
 
-                        returnValue = true;
+        if ((!addressMasked) && (replaceTokens(
+                expressionMatch,
+                compiledItem.m_addressReplacementString,
+                compiledItem.m_addressTokens,
+                maskedHostAddress))) {
 
-                        continue;
-                    }
+            addressMasked = true;
+        }
 
-                    while (tokenIterator.hasNext()) {
-                        auto match = tokenIterator.next();
-
-                        if (match.hasMatch()) {
-                            for (auto tokenType : tokenTypes) {
-                                auto identifier = match.captured(tokenType);
-
-                                if (!identifier.isNull()) {
-                                    TokenReplacement tokenReplacement;
-
-                                    tokenReplacement.type = tokenType;
-                                    tokenReplacement.identifier = identifier;
-
-                                    if (tokenType=="named") {
-                                        tokenReplacement.value = expressionMatch.captured(identifier);
-                                        tokenReplacement.format = "${%1}";
-                                    } else if (tokenType=="number") {
-                                        tokenReplacement.value  = expressionMatch.captured(identifier.toInt());
-                                        tokenReplacement.format = "$%1";
-                                    } else if (tokenType=="dollar") {
-                                        // we catch $$ regardless, so just ignore it here.
-                                        continue;
-                                    } else {
-                                        // ruh roh!
-                                        continue;
-                                    }
-
-                                    tokenReplacementList.append(tokenReplacement);
-                                }
-                            }
-                        }
-                    }
+        if ((hostMasked) && (addressMasked)) {
+            break;
+        }
+    }
 
-                    *outputString = replacementString;
+    returnValue = (hostMasked) || (addressMasked);
 
-                    for (const auto &token : tokenReplacementList) {
-                        (*outputString).replace(token.format.arg(token.identifier), token.value);
-                    }
+    if (m_maskCache.count()>=MaximumCachedMasks) {
+        m_maskCache.clear();
+    }
 
-                    (*outputString).replace("$$", "$");
+    m_maskCache.insert(cacheKey, MaskResult{returnValue, maskedHostName, maskedHostAddress});
 
-                    returnValue = true;
-                }
-            }
+    return returnValue;
+}
+
+auto Nedrysoft::RegExHostMasker::RegExHostMasker::compile() -> void {
+    m_compiledMaskList.clear();
+    m_maskCache.clear();
+    m_prefilter.clear();
+
+    for (const auto &maskItem : m_maskList) {
+        if (!maskItem.m_enabled) {
+            continue;
+        }
+
+        /**
+         * a rule that replaces nothing would stop the rules after it from being applied.
+         */
+
+        if (maskItem.m_hostReplacementString.isEmpty() && maskItem.m_addressReplacementString.isEmpty()) {
+            continue;
+        }
+
+        CompiledItem compiledItem;
+
+        compiledItem.m_expression = QRegularExpression(maskItem.m_matchExpression);
+
+        /**
+         * an invalid expression can never match, so it is left out rather than warning on every use.
+         */
+
+        if (!compiledItem.m_expression.isValid()) {
+            continue;
         }
+
+        compiledItem.m_expression.optimize();
+
+        compiledItem.m_matchFlags = maskItem.m_matchFlags;
+        compiledItem.m_hostReplacementString = maskItem.m_hostReplacementString;
+        compiledItem.m_addressReplacementString = maskItem.m_addressReplacementString;
+        compiledItem.m_hostTokens = compileTokens(maskItem.m_hostReplacementString);
+        compiledItem.m_addressTokens = compileTokens(maskItem.m_addressReplacementString);
+
+        m_compiledMaskList.append(compiledItem);
+
+        m_prefilter.add(maskItem.m_matchExpression);
     }
 
-    return returnValue;
+    m_prefilter.build();
+
+    m_compiled = true;
+}
+
+auto Nedrysoft::RegExHostMasker::RegExHostMasker::invalidate() -> void {
+    m_compiled = false;
+
+    m_compiledMaskList.clear();
+    m_maskCache.clear();
+    m_prefilter.clear();
 }
 
 auto Nedrysoft::RegExHostMasker::RegExHostMasker::mask(
@@ -251,6 +377,8 @@ auto Nedrysoft::RegExHostMasker::RegExHostMasker::add(
     item.m_enabled = enabled;
 
     m_maskList.append(item);
+
+    invalidate();
 }
 
 auto Nedrysoft::RegExHostMasker::RegExHostMasker::saveConfiguration() -> QJsonObject {
@@ -297,6 +425,8 @@ auto Nedrysoft::RegExHostMasker::RegExHostMasker::loadConfiguration(QJsonObject
             item["enabled"].toBool(true) );
     }
 
+    compile();
+
     return true;
 }
 
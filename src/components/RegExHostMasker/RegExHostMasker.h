@@ -24,10 +24,14 @@
 #ifndef PINGNOO_COMPONENTS_REGEXHOSTMASKER_REGEXHOSTMASKER_H
 #define PINGNOO_COMPONENTS_REGEXHOSTMASKER_REGEXHOSTMASKER_H
 
+#include "LiteralPrefilter.h"
 #include "RegExHostMaskerSpec.h"
 
 #include <IHostMasker>
 #include <IInterface>
+#include <QHash>
+#include <QPair>
+#include <QRegularExpression>
 #include <QSet>
 
 namespace Nedrysoft { namespace RegExHostMasker {
@@ -74,6 +78,13 @@ namespace Nedrysoft { namespace RegExHostMasker {
      *
      * @details     This host marker accepts a regular expression to match the host name or address and allows the
      *              masked output to be generated using capture groups.
+     *
+     *              The rules are tried in the order that they were added and the first rule that matches is the
+     *              only one applied.  A literal prefilter finds the rules that could match in a single pass, so
+     *              only their expressions are run.
+     *
+     *              The expressions and replacement strings are compiled once when the configuration changes, and
+     *              the result of masking each host name and address pair is remembered until it changes again.
      */
     class RegExHostMasker :
             public Nedrysoft::Core::IHostMasker {
@@ -150,7 +161,8 @@ namespace Nedrysoft { namespace RegExHostMasker {
              * @details     A IHostMasker can redact the hostname and/or host address based of a combination of
              *              host name, host address and the hop number.
              *
-             *              If there is no match, then the original values are returned.
+             *              The first rule that matches the host name, or failing that the host address, is
+             *              applied.  If there is no match, then the original values are returned.
              *
              * @see         Nedrysoft::Core::IHostMasker
              *
@@ -209,12 +221,47 @@ namespace Nedrysoft { namespace RegExHostMasker {
                     QString &maskedHostName,
                     QString &maskedHostAddress ) -> bool;
 
+            /**
+             * @brief       Compiles the enabled expressions and replacement strings.
+             *
+             * @details     The expressions are optimised when they are compiled rather than on first use, and the
+             *              remembered results are discarded.
+             */
+            auto compile() -> void;
+
+            /**
+             * @brief       Marks the compiled expressions as out of date after the mask list has changed.
+             *
+             * @details     The expressions are compiled again on the next use and the remembered results are
+             *              discarded.
+             */
+            auto invalidate() -> void;
+
             friend class RegExHostMaskerSettingsPageWidget;
 
         private:
             //! @cond
 
+            struct CompiledItem {
+                QRegularExpression m_expression;
+                unsigned int m_matchFlags;
+                QString m_hostReplacementString;
+                QString m_addressReplacementString;
+                QList<TokenReplacement> m_hostTokens;
+                QList<TokenReplacement> m_addressTokens;
+            };
+
+            struct MaskResult {
+                bool m_masked;
+                QString m_maskedHostName;
+                QString m_maskedHostAddress;
+            };
+
             QList<RegExHostMaskerItem> m_maskList;
+            QList<CompiledItem> m_compiledMaskList;
+            Nedrysoft::RegExHostMasker::LiteralPrefilter m_prefilter;
+            QHash<QPair<QString, QString>, MaskResult> m_maskCache;
+            bool m_compiled;
 
             //! @endcond
 
@@ -416,6 +416,8 @@ auto Nedrysoft::RegExHostMasker::RegExHostMaskerSettingsPageWidget::acceptSettin
 
     hostMasker->m_maskList = itemList;
 
+    hostMasker->compile();
+
     hostMasker->saveToFile();
 }
 
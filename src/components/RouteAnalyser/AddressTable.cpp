@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 19/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "AddressTable.h"
+
+Nedrysoft::RouteAnalyser::AddressTable::AddressTable() {
+    /**
+     * index 0 is reserved for the null address so that an identifier can be used directly as an index.
+     */
+
+    m_addresses.append(QHostAddress());
+}
+
+auto Nedrysoft::RouteAnalyser::AddressTable::intern(
+        const QHostAddress &address ) -> Nedrysoft::RouteAnalyser::AddressId {
+
+    if (address.isNull()) {
+        return NullAddressId;
+    }
+
+    auto it = m_addressIds.constFind(address);
+
+    if (it!=m_addressIds.constEnd()) {
+        return it.value();
+    }
+
+    auto addressId = static_cast<Nedrysoft::RouteAnalyser::AddressId>(m_addresses.count());
+
+    m_addresses.append(address);
+    m_addressIds.insert(address, addressId);
+
+    return addressId;
+}
+
+auto Nedrysoft::RouteAnalyser::AddressTable::address(
+        Nedrysoft::RouteAnalyser::AddressId addressId ) const -> QHostAddress {
+
+    if (addressId>=static_cast<Nedrysoft::RouteAnalyser::AddressId>(m_addresses.count())) {
+        return QHostAddress();
+    }
+
+    return m_addresses.at(static_cast<int>(addressId));
+}
+
+auto Nedrysoft::RouteAnalyser::AddressTable::count() const -> int {
+    return m_addresses.count()-1;
+}
+
+auto Nedrysoft::RouteAnalyser::AddressTable::clear() -> void {
+    m_addressIds.clear();
+    m_addresses.resize(1);
+}
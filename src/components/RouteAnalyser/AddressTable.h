@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 19/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PINGNOO_COMPONENTS_ROUTEANALYSER_ADDRESSTABLE_H
+#define PINGNOO_COMPONENTS_ROUTEANALYSER_ADDRESSTABLE_H
+
+#include "RouteAnalyserSpec.h"
+
+#include <QHash>
+#include <QHostAddress>
+#include <QVector>
+#include <cstdint>
+
+namespace Nedrysoft { namespace RouteAnalyser {
+    /**
+     * @brief       A compact identifier for an interned address.
+     */
+    typedef uint32_t AddressId;
+
+    /**
+     * @brief       The identifier of the null address.
+     */
+    constexpr AddressId NullAddressId = 0;
+
+    /**
+     * @brief       The AddressTable class provides a table of interned addresses.
+     *
+     * @details     Every unique address is stored once and given a 32 bit identifier, two identifiers from the
+     *              same table are equal if and only if the addresses are equal, so hops can be compared and hashed
+     *              as integers instead of as addresses.  A table belongs to a single discovery or monitoring
+     *              session and only holds the addresses seen by that session, it is not thread safe and should
+     *              only be used by the thread that owns it.
+     *
+     * @class       Nedrysoft::RouteAnalyser::AddressTable AddressTable.h <AddressTable>
+     */
+    class NEDRYSOFT_ROUTEANALYSER_DLLSPEC AddressTable {
+        public:
+            /**
+             * @brief       Constructs a new empty AddressTable.
+             */
+            AddressTable();
+
+            /**
+             * @brief       Returns the identifier of an address, adding the address to the table if required.
+             *
+             * @param[in]   address the address.
+             *
+             * @returns     the identifier of the address, NullAddressId if the address is null.
+             */
+            auto intern(const QHostAddress &address) -> Nedrysoft::RouteAnalyser::AddressId;
+
+            /**
+             * @brief       Returns the address of an identifier.
+             *
+             * @param[in]   addressId the identifier returned by intern().
+             *
+             * @returns     the address; a null address if the identifier is not known.
+             */
+            auto address(Nedrysoft::RouteAnalyser::AddressId addressId) const -> QHostAddress;
+
+            /**
+             * @brief       Returns the number of addresses held in the table.
+             *
+             * @returns     the number of addresses.
+             */
+            auto count() const -> int;
+
+            /**
+             * @brief       Removes all addresses from the table.
+             *
+             * @note        Identifiers returned before the table was cleared are no longer valid.
+             */
+            auto clear() -> void;
+
+        private:
+            //! @cond
+
+            QVector<QHostAddress> m_addresses;
+            QHash<QHostAddress, Nedrysoft::RouteAnalyser::AddressId> m_addressIds;
+
+            //! @endcond
+    };
+}}
+
+#endif // PINGNOO_COMPONENTS_ROUTEANALYSER_ADDRESSTABLE_H
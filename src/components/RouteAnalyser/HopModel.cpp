@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 19/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "HopModel.h"
+
+#include <utility>
+
+Nedrysoft::RouteAnalyser::HopModel::HopModel() = default;
+
+auto Nedrysoft::RouteAnalyser::HopModel::intern(const QHostAddress &address) -> Nedrysoft::RouteAnalyser::AddressId {
+    return m_addressTable.intern(address);
+}
+
+auto Nedrysoft::RouteAnalyser::HopModel::address(
+        Nedrysoft::RouteAnalyser::AddressId addressId ) const -> QHostAddress {
+
+    return m_addressTable.address(addressId);
+}
+
+auto Nedrysoft::RouteAnalyser::HopModel::addResponse(int hop, Nedrysoft::RouteAnalyser::AddressId addressId) -> bool {
+    if ((hop<1) || (addressId==NullAddressId)) {
+        return false;
+    }
+
+    if (hop>m_hops.count()) {
+        m_hops.resize(hop);
+    }
+
+    auto &responders = m_hops[hop-1];
+
+    for (int index=0;index<responders.count();index++) {
+        if (responders[index].addressId!=addressId) {
+            continue;
+        }
+
+        responders[index].hitCount++;
+
+        /**
+         * the responders are kept ordered by hit count, a responder only ever moves up by swapping with the
+         * entries above it that it has now overtaken.
+         */
+
+        while ((index>0) && (responders[index].hitCount>responders[index-1].hitCount)) {
+            std::swap(responders[index], responders[index-1]);
+
+            index--;
+        }
+
+        return false;
+    }
+
+    responders.append(Nedrysoft::RouteAnalyser::HopResponder{addressId, 1});
+
+    return true;
+}
+
+auto Nedrysoft::RouteAnalyser::HopModel::addResponse(int hop, const QHostAddress &address) -> bool {
+    return addResponse(hop, m_addressTable.intern(address));
+}
+
+auto Nedrysoft::RouteAnalyser::HopModel::addRoute(const Nedrysoft::RouteAnalyser::RouteList &route) -> void {
+    for (int hop=0;hop<route.count();hop++) {
+        addResponse(hop+1, route.at(hop));
+    }
+}
+
+auto Nedrysoft::RouteAnalyser::HopModel::responders(int hop) const -> QVector<Nedrysoft::RouteAnalyser::HopResponder> {
+    if ((hop<1) || (hop>m_hops.count())) {
+        return QVector<Nedrysoft::RouteAnalyser::HopResponder>();
+    }
+
+    return m_hops.at(hop-1);
+}
+
+auto Nedrysoft::RouteAnalyser::HopModel::responderCount(int hop) const -> int {
+    if ((hop<1) || (hop>m_hops.count())) {
+        return 0;
+    }
+
+    return m_hops.at(hop-1).count();
+}
+
+auto Nedrysoft::RouteAnalyser::HopModel::primaryResponder(int hop) const -> Nedrysoft::RouteAnalyser::AddressId {
+    if ((hop<1) || (hop>m_hops.count()) || (m_hops.at(hop-1).isEmpty())) {
+        return NullAddressId;
+    }
+
+    return m_hops.at(hop-1).first().addressId;
+}
+
+auto Nedrysoft::RouteAnalyser::HopModel::isLoadBalanced(int hop) const -> bool {
+    return responderCount(hop)>1;
+}
+
+auto Nedrysoft::RouteAnalyser::HopModel::hopCount() const -> int {
+    return m_hops.count();
+}
+
+auto Nedrysoft::RouteAnalyser::HopModel::route() const -> Nedrysoft::RouteAnalyser::RouteList {
+    auto route = Nedrysoft::RouteAnalyser::RouteList();
+
+    for (int hop=1;hop<=m_hops.count();hop++) {
+        route.append(m_addressTable.address(primaryResponder(hop)));
+    }
+
+    return route;
+}
+
+auto Nedrysoft::RouteAnalyser::HopModel::clear() -> void {
+    m_hops.clear();
+    m_addressTable.clear();
+}
@@ -0,0 +1,171 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 19/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PINGNOO_COMPONENTS_ROUTEANALYSER_HOPMODEL_H
+#define PINGNOO_COMPONENTS_ROUTEANALYSER_HOPMODEL_H
+
+#include "AddressTable.h"
+#include "IRouteEngine.h"
+#include "RouteAnalyserSpec.h"
+
+#include <QVector>
+
+namespace Nedrysoft { namespace RouteAnalyser {
+    /**
+     * @brief       The HopResponder structure holds a responder seen at a hop and the number of times it replied.
+     */
+    struct HopResponder {
+        Nedrysoft::RouteAnalyser::AddressId addressId;
+        unsigned long hitCount;
+    };
+
+    /**
+     * @brief       The HopModel class records every distinct responder seen at each hop of a route.
+     *
+     * @details     Routes that pass through load balancers are answered by different routers at the same TTL,
+     *              rather than keeping a single address per hop the model keeps each responder along with the
+     *              number of replies that it has sent.  Responders are held as identifiers interned in a table
+     *              owned by the model, so recording a reply is an integer comparison against the few responders
+     *              of the hop and the table only grows with the addresses seen by this route.
+     *
+     * @class       Nedrysoft::RouteAnalyser::HopModel HopModel.h <HopModel>
+     */
+    class NEDRYSOFT_ROUTEANALYSER_DLLSPEC HopModel {
+        public:
+            /**
+             * @brief       Constructs a new empty HopModel.
+             */
+            HopModel();
+
+            /**
+             * @brief       Returns the identifier of an address in the address table of the model.
+             *
+             * @param[in]   address the address.
+             *
+             * @returns     the identifier of the address, NullAddressId if the address is null.
+             */
+            auto intern(const QHostAddress &address) -> Nedrysoft::RouteAnalyser::AddressId;
+
+            /**
+             * @brief       Returns the address of an identifier returned by intern().
+             *
+             * @param[in]   addressId the identifier.
+             *
+             * @returns     the address; a null address if the identifier is not known.
+             */
+            auto address(Nedrysoft::RouteAnalyser::AddressId addressId) const -> QHostAddress;
+
+            /**
+             * @brief       Records a reply from a responder.
+             *
+             * @param[in]   hop the hop number. (1 based)
+             * @param[in]   addressId the identifier of the responder returned by intern(), replies from the null
+             *              address are ignored.
+             *
+             * @returns     true if this is the first reply from the responder at the hop; otherwise false.
+             */
+            auto addResponse(int hop, Nedrysoft::RouteAnalyser::AddressId addressId) -> bool;
+
+            /**
+             * @brief       Records a reply from a responder.
+             *
+             * @param[in]   hop the hop number. (1 based)
+             * @param[in]   address the address of the responder, replies from a null address are ignored.
+             *
+             * @returns     true if this is the first reply from the responder at the hop; otherwise false.
+             */
+            auto addResponse(int hop, const QHostAddress &address) -> bool;
+
+            /**
+             * @brief       Records a reply from every hop of a route.
+             *
+             * @param[in]   route the route, the first entry being hop 1.
+             */
+            auto addRoute(const Nedrysoft::RouteAnalyser::RouteList &route) -> void;
+
+            /**
+             * @brief       Returns the responders seen at a hop.
+             *
+             * @param[in]   hop the hop number. (1 based)
+             *
+             * @returns     the responders ordered by the number of replies, most replies first.
+             */
+            auto responders(int hop) const -> QVector<Nedrysoft::RouteAnalyser::HopResponder>;
+
+            /**
+             * @brief       Returns the number of distinct responders seen at a hop.
+             *
+             * @param[in]   hop the hop number. (1 based)
+             *
+             * @returns     the number of responders.
+             */
+            auto responderCount(int hop) const -> int;
+
+            /**
+             * @brief       Returns the responder that has sent the most replies at a hop.
+             *
+             * @param[in]   hop the hop number. (1 based)
+             *
+             * @returns     the identifier of the responder; NullAddressId if the hop has not replied.
+             */
+            auto primaryResponder(int hop) const -> Nedrysoft::RouteAnalyser::AddressId;
+
+            /**
+             * @brief       Returns whether more than one responder has been seen at a hop.
+             *
+             * @param[in]   hop the hop number. (1 based)
+             *
+             * @returns     true if the hop is load balanced; otherwise false.
+             */
+            auto isLoadBalanced(int hop) const -> bool;
+
+            /**
+             * @brief       Returns the number of hops held in the model.
+             *
+             * @returns     the highest hop number that has been recorded.
+             */
+            auto hopCount() const -> int;
+
+            /**
+             * @brief       Returns the route made up of the primary responder of each hop.
+             *
+             * @returns     the route, hops that have not replied are null addresses.
+             */
+            auto route() const -> Nedrysoft::RouteAnalyser::RouteList;
+
+            /**
+             * @brief       Removes all responders and interned addresses from the model.
+             */
+            auto clear() -> void;
+
+        private:
+            //! @cond
+
+            Nedrysoft::RouteAnalyser::AddressTable m_addressTable;
+            QVector<QVector<Nedrysoft::RouteAnalyser::HopResponder> > m_hops;
+
+            //! @endcond
+    };
+}}
+
+#endif // PINGNOO_COMPONENTS_ROUTEANALYSER_HOPMODEL_H
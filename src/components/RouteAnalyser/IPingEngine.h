@@ -30,11 +30,19 @@
 #include <IConfiguration>
 #include <IInterface>
 #include <QHostAddress>
+#include <QList>
+#include <QPair>
 #include <chrono>
+#include <functional>
+#include <future>
 
 namespace Nedrysoft { namespace RouteAnalyser {
     class IPingTarget;
 
+    typedef QPair<QHostAddress, int> SingleShotProbe;
+    typedef QList<Nedrysoft::RouteAnalyser::SingleShotProbe> SingleShotProbeList;
+    typedef std::function<void(int, const Nedrysoft::RouteAnalyser::PingResult &)> SingleShotCallback;
+
     /**
      * @brief       The IPingEngine interface describes a ping engine.
      *
@@ -135,6 +143,80 @@ namespace Nedrysoft { namespace RouteAnalyser {
                 double timeout
             ) -> Nedrysoft::RouteAnalyser::PingResult = 0;
 
+            /**
+             * @brief       Transmits a single ping on a given flow.
+             *
+             * @details     Engines which are able to control the flow identifier of a probe send every probe
+             *              with the same flow identifier along the same path through load balancers, engines
+             *              which cannot control the flow fall back to a plain single shot.
+             *
+             * @note        This is a blocking function.
+             *
+             * @param[in]   hostAddress the target host address.
+             * @param[in]   ttl time to live for this packet.
+             * @param[in]   timeout time in seconds to wait for response.
+             * @param[in]   flowId the flow identifier to use for the probe.
+             *
+             * @returns     the result of the ping.
+             */
+            virtual auto singleShot(
+                QHostAddress hostAddress,
+                int ttl,
+                double timeout,
+                uint16_t flowId
+            ) -> Nedrysoft::RouteAnalyser::PingResult {
+
+                Q_UNUSED(flowId)
+
+                return singleShot(hostAddress, ttl, timeout);
+            }
+
+            /**
+             * @brief       Transmits a batch of single pings concurrently.
+             *
+             * @details     All of the probes are sent at once and the results are delivered to the callback as
+             *              they arrive, so the batch takes as long as the slowest probe rather than the sum of them.
+             *              Each probe is a host address and the ttl to send it with.
+             *
+             *              Engines which cannot multiplex requests can run the batch with a SingleShotPool that
+             *              they own.
+             *
+             * @note        This function does not block.  The callback is called from engine owned threads,
+             *              possibly concurrently, and must be thread safe.  The engine must not be destroyed until
+             *              the returned future is ready.
+             *
+             * @param[in]   probes the list of probes to send.
+             * @param[in]   timeout time in seconds to wait for the responses.
+             * @param[in]   flowId the flow identifier to use for the probes, 0 if the engine should choose.
+             * @param[in]   callback called with the index of the probe and its result as each probe completes,
+             *              may be empty.
+             *
+             * @returns     a future which holds the results in the same order as the probes once all of them
+             *              have completed.
+             */
+            virtual auto singleShot(
+                const Nedrysoft::RouteAnalyser::SingleShotProbeList &probes,
+                double timeout,
+                uint16_t flowId,
+                Nedrysoft::RouteAnalyser::SingleShotCallback callback
+            ) -> std::future<QList<Nedrysoft::RouteAnalyser::PingResult> > = 0;
+
+            /**
+             * @brief       Sets the flow identifier used for targets that are monitored by this engine.
+             *
+             * @details     Keeping the flow identifier constant means that the monitored hops stay on the path
+             *              that was found by a flow stable route discovery.
+             *
+             * @param[in]   flowId the flow identifier, 0 allocates a flow per target.
+             *
+             * @returns     true if the engine supports flow identifiers; otherwise false.
+             */
+            virtual auto setFlowId(uint16_t flowId) -> bool {
+                Q_UNUSED(flowId)
+
+                return false;
+            }
+
             /**
              * @brief       Removes a ping target from this engine instance.
              *
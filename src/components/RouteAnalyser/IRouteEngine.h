@@ -28,11 +28,14 @@
 
 #include <ICore>
 #include <IInterface>
+#include <QDateTime>
 #include <QHostAddress>
 #include <QObject>
+#include <QStringList>
 
 namespace Nedrysoft { namespace RouteAnalyser {
     typedef QList<QHostAddress> RouteList;
+    typedef QList<Nedrysoft::RouteAnalyser::RouteList> MultipathRouteList;
     class IPingEngineFactory;
 
     /**
@@ -49,16 +52,61 @@ namespace Nedrysoft { namespace RouteAnalyser {
             Q_INTERFACES(Nedrysoft::ComponentSystem::IInterface)
 
         public:
+            /**
+             * @brief       The method used to discover the route.
+             *
+             * @details     Classic probes may each take a different path through load balancers, FlowStable probes
+             *              share a flow identifier so they follow a single path and Multipath performs a flow
+             *              stable discovery and then enumerates every responder at each hop.
+             */
+            enum class DiscoveryMode {
+                Classic,
+                FlowStable,
+                Multipath
+            };
+
             /**
              * @brief       Destroys the IRouteEngine.
              */
             virtual ~IRouteEngine() = default;
 
+            /**
+             * @brief       Sets the discovery mode to be used by findRoute.
+             *
+             * @param[in]   mode the discovery mode.
+             */
+            virtual auto setDiscoveryMode(DiscoveryMode mode) -> void = 0;
+
+            /**
+             * @brief       Returns the flow identifier used for flow stable discovery.
+             *
+             * @details     A ping engine that monitors the discovered hops should use the same flow identifier so
+             *              that its probes follow the discovered path.
+             *
+             * @returns     the flow identifier.
+             */
+            virtual auto flowId() -> uint16_t = 0;
+
+            /**
+             * @brief       Sets the interval between background re-traces of a discovered route.
+             *
+             * @details     Once the route has been discovered it is traced again at this interval using small,
+             *              paced waves of probes.  The routeChanged signal is emitted whenever a re-trace differs
+             *              from the current route, an interval of 0 stops re-tracing and allows the discovery to
+             *              finish.
+             *
+             * @note        The interval may be changed while the route is being re-traced.
+             *
+             * @param[in]   interval the interval in milliseconds, 0 to disable re-tracing.
+             */
+            virtual auto setRetraceInterval(int interval) -> void = 0;
+
             /**
              * @brief       Starts route discovery for a host.
              *
              * @note        Route discovery is a asynchronous operation, the result signal is emitted when the
-             *              discovery is completed.
+             *              discovery is completed.  An engine may report a previously discovered route straight
+             *              away and then validate it in the background, emitting routeChanged if it differs.
              *
              * @param[in]   engineFactory the ping engine to be used for discovery.
              * @param[in]   host the target host name or address.
@@ -69,6 +117,24 @@ namespace Nedrysoft { namespace RouteAnalyser {
                     QString host,
                     Nedrysoft::Core::IPVersion ipVersion ) -> void = 0;
 
+            /**
+             * @brief       Starts route discovery for a list of hosts.
+             *
+             * @details     The routes are discovered by a bounded pool of workers, each route found is shared with
+             *              the other workers so that the hops that routes have in common are only probed once.
+             *
+             * @note        Route discovery is a asynchronous operation, the bulkResult signal is emitted for each
+             *              host as its route is discovered, with completed set to true once the route is known.
+             *
+             * @param[in]   engineFactory the ping engine to be used for discovery.
+             * @param[in]   hosts the target host names or addresses.
+             * @param[in]   ipVersion the IP version to be used for discovery.
+             */
+            virtual auto findRoutes(
+                    Nedrysoft::RouteAnalyser::IPingEngineFactory *engineFactory,
+                    QStringList hosts,
+                    Nedrysoft::Core::IPVersion ipVersion ) -> void = 0;
+
             /**
              * @brief       Signal emitted when the route discovery is completed.
              *
@@ -86,6 +152,67 @@ namespace Nedrysoft { namespace RouteAnalyser {
                 const int totalHops,
                 const int maximumHops
             );
+
+            /**
+             * @brief       Signal emitted when the route to one of the hosts passed to findRoutes is discovered.
+             *
+             * @details     The requested host is included so that a listener can tell which host a result
+             *              belongs to, even when the host could not be resolved and hostAddress is null.
+             *
+             * @param[in]   host the host name or address that was requested.
+             * @param[in]   hostAddress the address of the host that was the target, null if it could not be resolved.
+             * @param[in]   result the discovered route to the host.
+             * @param[in]   completed is true if the route has been discovered; otherwise false.
+             * @param[in]   totalHops is the number of hops to the target if available; otherwise -1.
+             * @param[in]   maximumHops is the maximum number of hops to consider, if the TTL exceeds this then
+             *              the route has failed.
+             */
+            Q_SIGNAL void bulkResult(
+                const QString host,
+                const QHostAddress hostAddress,
+                const Nedrysoft::RouteAnalyser::RouteList result,
+                const bool completed,
+                const int totalHops,
+                const int maximumHops
+            );
+
+            /**
+             * @brief       Signal emitted when multipath discovery has enumerated the responders for a hop.
+             *
+             * @details     Only emitted when the discovery mode is Multipath, each entry in the result holds every
+             *              address that was seen responding at that hop ordered by the number of replies, most
+             *              replies first.
+             *
+             * @param[in]   hostAddress the address of the host that was the target.
+             * @param[in]   result the responders for each hop that has been enumerated so far.
+             * @param[in]   completed true if every hop has been enumerated; otherwise false.
+             */
+            Q_SIGNAL void multipathResult(
+                const QHostAddress hostAddress,
+                const Nedrysoft::RouteAnalyser::MultipathRouteList result,
+                const bool completed
+            );
+
+            /**
+             * @brief       Signal emitted when a background re-trace finds that the route has changed.
+             *
+             * @details     A hop that did not reply during a re-trace keeps its previous address, so the route
+             *              only changes when a hop is answered by a different responder, a silent hop starts
+             *              responding or the number of hops to the target changes.  The route also changes if
+             *              the host now resolves to a different address, in which case hostAddress is the new
+             *              address.
+             *
+             * @param[in]   hostAddress the address of the host that is the target.
+             * @param[in]   previousRoute the route before the change.
+             * @param[in]   route the route after the change.
+             * @param[in]   changedTime the time that the change was detected.
+             */
+            Q_SIGNAL void routeChanged(
+                const QHostAddress hostAddress,
+                const Nedrysoft::RouteAnalyser::RouteList previousRoute,
+                const Nedrysoft::RouteAnalyser::RouteList route,
+                const QDateTime changedTime
+            );
     };
 }}
 
@@ -0,0 +1,239 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 19/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "PacketRateGovernor.h"
+
+#include <QtGlobal>
+#include <cmath>
+
+constexpr auto BurstDuration = 0.1;
+constexpr auto MinimumByteBurst = 1500.0;
+constexpr auto MaximumWaitTime = 100;
+constexpr auto ThrottleSmoothing = 0.05;
+constexpr auto ThrottleReportThreshold = 0.05;
+
+Nedrysoft::RouteAnalyser::PacketRateGovernor::PacketRateGovernor() :
+        m_packetRate(0),
+        m_byteRate(0),
+        m_packetTokens(0),
+        m_byteTokens(0),
+        m_throttleLevel(0),
+        m_reportedThrottleLevel(0) {
+
+    m_refillTimer.start();
+}
+
+auto Nedrysoft::RouteAnalyser::PacketRateGovernor::getInstance() -> Nedrysoft::RouteAnalyser::PacketRateGovernor * {
+    static auto instance = new Nedrysoft::RouteAnalyser::PacketRateGovernor;
+
+    return instance;
+}
+
+auto Nedrysoft::RouteAnalyser::PacketRateGovernor::setPacketRate(double packetsPerSecond) -> void {
+    QMutexLocker locker(&m_mutex);
+
+    refill();
+
+    m_packetRate = qMax(0.0, packetsPerSecond);
+    m_packetTokens = qMax(1.0, m_packetRate*BurstDuration);
+
+    m_tokensAvailable.wakeAll();
+}
+
+auto Nedrysoft::RouteAnalyser::PacketRateGovernor::packetRate() -> double {
+    QMutexLocker locker(&m_mutex);
+
+    return m_packetRate;
+}
+
+auto Nedrysoft::RouteAnalyser::PacketRateGovernor::setByteRate(double bytesPerSecond) -> void {
+    QMutexLocker locker(&m_mutex);
+
+    refill();
+
+    m_byteRate = qMax(0.0, bytesPerSecond);
+    m_byteTokens = qMax(MinimumByteBurst, m_byteRate*BurstDuration);
+
+    m_tokensAvailable.wakeAll();
+}
+
+auto Nedrysoft::RouteAnalyser::PacketRateGovernor::byteRate() -> double {
+    QMutexLocker locker(&m_mutex);
+
+    return m_byteRate;
+}
+
+auto Nedrysoft::RouteAnalyser::PacketRateGovernor::refill() -> void {
+    auto elapsedTime = static_cast<double>(m_refillTimer.nsecsElapsed())/1e9;
+
+    m_refillTimer.restart();
+
+    if (m_packetRate>0) {
+        m_packetTokens = qMin(qMax(1.0, m_packetRate*BurstDuration), m_packetTokens+elapsedTime*m_packetRate);
+    }
+
+    if (m_byteRate>0) {
+        m_byteTokens = qMin(qMax(MinimumByteBurst, m_byteRate*BurstDuration), m_byteTokens+elapsedTime*m_byteRate);
+    }
+}
+
+auto Nedrysoft::RouteAnalyser::PacketRateGovernor::timeUntilAvailable(int bytes) -> int {
+    auto waitTime = 0.0;
+
+    if ((m_packetRate>0) && (m_packetTokens<1)) {
+        waitTime = (1-m_packetTokens)/m_packetRate;
+    }
+
+    if (m_byteRate>0) {
+        /**
+         * a packet larger than the bucket can hold is allowed through once the bucket is full, the bucket then
+         * goes into debt so the long term byte rate is still honoured.
+         */
+
+        auto requiredTokens = qMin(static_cast<double>(bytes), qMax(MinimumByteBurst, m_byteRate*BurstDuration));
+
+        if (m_byteTokens<requiredTokens) {
+            waitTime = qMax(waitTime, (requiredTokens-m_byteTokens)/m_byteRate);
+        }
+    }
+
+    if (waitTime<=0) {
+        return 0;
+    }
+
+    return qMax(1, static_cast<int>(std::ceil(waitTime*1000.0)));
+}
+
+auto Nedrysoft::RouteAnalyser::PacketRateGovernor::acquire(const void *session, int bytes) -> void {
+    auto throttled = false;
+
+    m_mutex.lock();
+
+    if ((m_packetRate>0) || (m_byteRate>0)) {
+        if (!m_waitingRequests.contains(session)) {
+            m_sessionQueue.append(session);
+        }
+
+        m_waitingRequests[session]++;
+
+        /**
+         * sessions take turns at the head of the queue, a session that still has packets waiting after being
+         * granted goes to the back so that every session gets an equal share of the budget.
+         */
+
+        Q_FOREVER {
+            refill();
+
+            auto waitTime = timeUntilAvailable(bytes);
+
+            if (m_sessionQueue.first()==session) {
+                if (waitTime==0) {
+                    break;
+                }
+            } else {
+                waitTime = MaximumWaitTime;
+            }
+
+            throttled = true;
+
+            m_tokensAvailable.wait(&m_mutex, static_cast<unsigned long>(qMin(waitTime, MaximumWaitTime)));
+        }
+
+        m_packetTokens -= 1;
+        m_byteTokens -= bytes;
+
+        m_sessionQueue.removeFirst();
+
+        if (--m_waitingRequests[session]) {
+            m_sessionQueue.append(session);
+        } else {
+            m_waitingRequests.remove(session);
+        }
+
+        m_tokensAvailable.wakeAll();
+    }
+
+    auto reportChange = updateThrottleLevel(throttled);
+    auto throttleLevel = m_throttleLevel;
+
+    m_mutex.unlock();
+
+    if (reportChange) {
+        Q_EMIT throttleLevelChanged(throttleLevel);
+    }
+}
+
+auto Nedrysoft::RouteAnalyser::PacketRateGovernor::tryAcquire(const void *session, int bytes) -> bool {
+    m_mutex.lock();
+
+    if ((m_packetRate>0) || (m_byteRate>0)) {
+        refill();
+
+        /**
+         * a packet may only jump the queue when no other session is waiting, otherwise the round robin order
+         * would be broken.
+         */
+
+        auto queueIsFree = m_sessionQueue.isEmpty() || (
+            (m_sessionQueue.count()==1) && (m_sessionQueue.first()==session) );
+
+        if ((!queueIsFree) || (timeUntilAvailable(bytes)!=0)) {
+            m_mutex.unlock();
+
+            return false;
+        }
+
+        m_packetTokens -= 1;
+        m_byteTokens -= bytes;
+    }
+
+    auto reportChange = updateThrottleLevel(false);
+    auto throttleLevel = m_throttleLevel;
+
+    m_mutex.unlock();
+
+    if (reportChange) {
+        Q_EMIT throttleLevelChanged(throttleLevel);
+    }
+
+    return true;
+}
+
+auto Nedrysoft::RouteAnalyser::PacketRateGovernor::updateThrottleLevel(bool throttled) -> bool {
+    m_throttleLevel = (1.0-ThrottleSmoothing)*m_throttleLevel + (throttled ? ThrottleSmoothing : 0);
+
+    if (std::fabs(m_throttleLevel-m_reportedThrottleLevel)>=ThrottleReportThreshold) {
+        m_reportedThrottleLevel = m_throttleLevel;
+
+        return true;
+    }
+
+    return false;
+}
+
+auto Nedrysoft::RouteAnalyser::PacketRateGovernor::throttleLevel() -> double {
+    QMutexLocker locker(&m_mutex);
+
+    return m_throttleLevel;
+}
@@ -0,0 +1,195 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 19/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef PINGNOO_COMPONENTS_ROUTEANALYSER_PACKETRATEGOVERNOR_H
+#define PINGNOO_COMPONENTS_ROUTEANALYSER_PACKETRATEGOVERNOR_H
+
+#include "RouteAnalyserSpec.h"
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QMap>
+#include <QMutex>
+#include <QObject>
+#include <QWaitCondition>
+
+namespace Nedrysoft { namespace RouteAnalyser {
+    /**
+     * @brief       The PacketRateGovernor class limits the rate at which packets are sent by the application.
+     *
+     * @details     A process wide token bucket governor that every ping engine transmit path and route discovery
+     *              draws from before a packet is sent.  Budgets can be set in packets per second and bytes per
+     *              second, a budget of 0 is unlimited.  Senders are grouped into sessions (normally a ping
+     *              engine), and when more than one session is waiting for tokens they are granted in round robin
+     *              order so that a busy session cannot starve the others.
+     *
+     * @class       Nedrysoft::RouteAnalyser::PacketRateGovernor PacketRateGovernor.h <PacketRateGovernor>
+     */
+    class NEDRYSOFT_ROUTEANALYSER_DLLSPEC PacketRateGovernor :
+            public QObject {
+
+        private:
+            Q_OBJECT
+
+        private:
+            /**
+             * @brief       Constructs a new PacketRateGovernor.
+             *
+             * @note        Hidden as this is a singleton class and should be accessed through getInstance().
+             */
+            PacketRateGovernor();
+
+        public:
+            /**
+             * @brief       Returns the global instance of the governor.
+             *
+             * @returns     the governor.
+             */
+            static auto getInstance() -> Nedrysoft::RouteAnalyser::PacketRateGovernor *;
+
+            /**
+             * @brief       Sets the maximum number of packets per second that may be sent.
+             *
+             * @param[in]   packetsPerSecond the packet budget, 0 for unlimited.
+             */
+            auto setPacketRate(double packetsPerSecond) -> void;
+
+            /**
+             * @brief       Returns the maximum number of packets per second that may be sent.
+             *
+             * @returns     the packet budget, 0 if unlimited.
+             */
+            auto packetRate() -> double;
+
+            /**
+             * @brief       Sets the maximum number of bytes per second that may be sent.
+             *
+             * @param[in]   bytesPerSecond the byte budget, 0 for unlimited.
+             */
+            auto setByteRate(double bytesPerSecond) -> void;
+
+            /**
+             * @brief       Returns the maximum number of bytes per second that may be sent.
+             *
+             * @returns     the byte budget, 0 if unlimited.
+             */
+            auto byteRate() -> double;
+
+            /**
+             * @brief       Waits until a packet may be sent.
+             *
+             * @details     Blocks the calling thread until the budget allows the packet to be sent and it is the
+             *              turn of the session, the tokens for the packet are consumed on return.
+             *
+             * @param[in]   session the session the packet belongs to, normally the ping engine sending it.
+             * @param[in]   bytes the size of the packet in bytes.
+             */
+            auto acquire(const void *session, int bytes) -> void;
+
+            /**
+             * @brief       Takes the tokens for a packet if it may be sent without waiting.
+             *
+             * @details     Used by senders that batch packets so that the batch can be flushed before the sender
+             *              blocks in acquire().
+             *
+             * @param[in]   session the session the packet belongs to, normally the ping engine sending it.
+             * @param[in]   bytes the size of the packet in bytes.
+             *
+             * @returns     true if the tokens were taken and the packet may be sent; otherwise false.
+             */
+            auto tryAcquire(const void *session, int bytes) -> bool;
+
+            /**
+             * @brief       Returns the current throttle level.
+             *
+             * @details     The throttle level is a moving average of the proportion of packets that had to wait
+             *              for the budget, 0 means packets are being sent unhindered and 1 means every packet is
+             *              being delayed.
+             *
+             * @returns     the throttle level between 0 and 1.
+             */
+            auto throttleLevel() -> double;
+
+            /**
+             * @brief       This signal is emitted when the throttle level changes.
+             *
+             * @note        The signal is emitted from the thread that sent the packet.
+             *
+             * @param[in]   level the new throttle level between 0 and 1.
+             */
+            Q_SIGNAL void throttleLevelChanged(double level);
+
+        private:
+            /**
+             * @brief       Adds the tokens accumulated since the last refill to the buckets.
+             *
+             * @note        The caller must hold m_mutex.
+             */
+            auto refill() -> void;
+
+            /**
+             * @brief       Returns the number of milliseconds until the buckets hold enough tokens for a packet.
+             *
+             * @note        The caller must hold m_mutex.
+             *
+             * @param[in]   bytes the size of the packet in bytes.
+             *
+             * @returns     the time in milliseconds, 0 if the packet can be sent now.
+             */
+            auto timeUntilAvailable(int bytes) -> int;
+
+            /**
+             * @brief       Updates the throttle level with the outcome of a request.
+             *
+             * @note        The caller must hold m_mutex.
+             *
+             * @param[in]   throttled true if the request had to wait; otherwise false.
+             *
+             * @returns     true if the change should be reported; otherwise false.
+             */
+            auto updateThrottleLevel(bool throttled) -> bool;
+
+        private:
+            //! @cond
+
+            QMutex m_mutex;
+            QWaitCondition m_tokensAvailable;
+            QElapsedTimer m_refillTimer;
+
+            double m_packetRate;
+            double m_byteRate;
+            double m_packetTokens;
+            double m_byteTokens;
+
+            QList<const void *> m_sessionQueue;
+            QMap<const void *, int> m_waitingRequests;
+
+            double m_throttleLevel;
+            double m_reportedThrottleLevel;
+
+            //! @endcond
+    };
+}}
+
+#endif // PINGNOO_COMPONENTS_ROUTEANALYSER_PACKETRATEGOVERNOR_H
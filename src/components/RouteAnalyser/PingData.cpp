@@ -43,6 +43,8 @@ Nedrysoft::RouteAnalyser::PingData::PingData(QStandardItemModel *tableModel, int
         m_hop(hop),
         m_hopValid(hopValid),
         m_count(0),
+        m_responderCount(0),
+        m_responderAddressId(Nedrysoft::RouteAnalyser::NullAddressId),
         m_currentLatency(-1),
         m_maximumLatency(-1),
         m_minimumLatency(-1),
@@ -87,6 +89,10 @@ auto Nedrysoft::RouteAnalyser::PingData::plotTitle() -> QString {
         titleString = QString(QObject::tr("Hop %1")).arg(m_hop) + " " + m_hostName + " (" + m_hostAddress + ")";
     }
 
+    if (m_responderCount>1) {
+        titleString += " " + QString(QObject::tr("[%1 responders]")).arg(m_responderCount);
+    }
+
     return titleString;
 }
 
@@ -138,7 +144,8 @@ auto Nedrysoft::RouteAnalyser::PingData::packetLoss() -> double {
 auto Nedrysoft::RouteAnalyser::PingData::updateItem(Nedrysoft::RouteAnalyser::PingResult result) -> void {
     m_count = result.sampleNumber();
 
-    if (result.code() == Nedrysoft::RouteAnalyser::PingResult::ResultCode::NoReply) {
+    if ((result.code() == Nedrysoft::RouteAnalyser::PingResult::ResultCode::NoReply) ||
+        (result.code() == Nedrysoft::RouteAnalyser::PingResult::ResultCode::Unreachable)) {
         m_timeoutPacketCount++;
 
         if (m_tableModel) {
@@ -319,6 +326,22 @@ auto Nedrysoft::RouteAnalyser::PingData::maskedHostAddress() -> QString {
     return m_maskedHostAddress;
 }
 
+auto Nedrysoft::RouteAnalyser::PingData::setResponderCount(int responderCount) -> void {
+    m_responderCount = responderCount;
+}
+
+auto Nedrysoft::RouteAnalyser::PingData::responderCount() -> int {
+    return m_responderCount;
+}
+
+auto Nedrysoft::RouteAnalyser::PingData::setResponderAddressId(Nedrysoft::RouteAnalyser::AddressId addressId) -> void {
+    m_responderAddressId = addressId;
+}
+
+auto Nedrysoft::RouteAnalyser::PingData::responderAddressId() -> Nedrysoft::RouteAnalyser::AddressId {
+    return m_responderAddressId;
+}
+
 auto Nedrysoft::RouteAnalyser::PingData::setMaskedHostName(const QString &maskedHostName) -> void {
     m_maskedHostName = maskedHostName;
 
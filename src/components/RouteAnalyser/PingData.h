@@ -24,6 +24,7 @@
 #ifndef PINGNOO_COMPONENTS_ROUTEANALYSER_PINGDATA_H
 #define PINGNOO_COMPONENTS_ROUTEANALYSER_PINGDATA_H
 
+#include "AddressTable.h"
 #include "PingResult.h"
 
 #include <QPersistentModelIndex>
@@ -173,6 +174,37 @@ namespace Nedrysoft { namespace RouteAnalyser {
              */
             auto maskedHostAddress() -> QString;
 
+            /**
+             * @brief       Sets the number of distinct responders that have replied at this hop.
+             *
+             * @details     A hop with more than one responder is load balanced, the number of responders is shown
+             *              in the plot title.
+             *
+             * @param[in]   responderCount the number of responders.
+             */
+            auto setResponderCount(int responderCount) -> void;
+
+            /**
+             * @brief       Returns the number of distinct responders that have replied at this hop.
+             *
+             * @returns     the number of responders.
+             */
+            auto responderCount() -> int;
+
+            /**
+             * @brief       Sets the interned identifier of the address that last responded at this hop.
+             *
+             * @param[in]   addressId the identifier of the responder.
+             */
+            auto setResponderAddressId(Nedrysoft::RouteAnalyser::AddressId addressId) -> void;
+
+            /**
+             * @brief       Returns the interned identifier of the address that last responded at this hop.
+             *
+             * @returns     the identifier of the responder, NullAddressId if there is no responder.
+             */
+            auto responderAddressId() -> Nedrysoft::RouteAnalyser::AddressId;
+
             /**
              * @brief       Sets the masked host name for this route item.
              *
@@ -323,6 +355,8 @@ namespace Nedrysoft { namespace RouteAnalyser {
             int m_hop;
             bool m_hopValid;
             unsigned long m_count;
+            int m_responderCount;
+            Nedrysoft::RouteAnalyser::AddressId m_responderAddressId;
 
             QString m_hostAddress;
             QString m_hostName;
@@ -47,11 +47,15 @@ namespace Nedrysoft { namespace RouteAnalyser {
 
             /**
              * @brief       The result codes for a ping.
+             *
+             * @details     Unreachable is reported when a router or the target returns a destination unreachable
+             *              message for the request, the host address is the address of the sender of the message.
              */
             enum class ResultCode {
                 Ok,
                 NoReply,
-                TimeExceeded
+                TimeExceeded,
+                Unreachable
             };
 
             /**
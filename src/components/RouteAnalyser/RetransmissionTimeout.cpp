@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 19/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "RetransmissionTimeout.h"
+
+#include <QtGlobal>
+#include <cmath>
+
+constexpr auto SmoothingGain = 1.0/8.0;
+constexpr auto VariationGain = 1.0/4.0;
+constexpr auto VariationMultiplier = 4.0;
+constexpr auto MaximumBackoff = 6;
+
+Nedrysoft::RouteAnalyser::RetransmissionTimeout::RetransmissionTimeout(
+        double initialTimeout,
+        double minimumTimeout,
+        double maximumTimeout) :
+
+            m_initialTimeout(initialTimeout),
+            m_minimumTimeout(minimumTimeout),
+            m_maximumTimeout(maximumTimeout),
+            m_smoothedRoundTripTime(-1),
+            m_roundTripTimeVariation(0),
+            m_backoff(0) {
+
+}
+
+auto Nedrysoft::RouteAnalyser::RetransmissionTimeout::addSample(double roundTripTime) -> void {
+    if (roundTripTime < 0) {
+        return;
+    }
+
+    if (m_smoothedRoundTripTime < 0) {
+        m_smoothedRoundTripTime = roundTripTime;
+        m_roundTripTimeVariation = roundTripTime/2.0;
+    } else {
+        m_roundTripTimeVariation = (1.0-VariationGain)*m_roundTripTimeVariation +
+                                   VariationGain*std::fabs(m_smoothedRoundTripTime-roundTripTime);
+
+        m_smoothedRoundTripTime = (1.0-SmoothingGain)*m_smoothedRoundTripTime + SmoothingGain*roundTripTime;
+    }
+
+    m_backoff = 0;
+}
+
+auto Nedrysoft::RouteAnalyser::RetransmissionTimeout::addLoss() -> void {
+    m_backoff = qMin(m_backoff+1, MaximumBackoff);
+}
+
+auto Nedrysoft::RouteAnalyser::RetransmissionTimeout::timeout() const -> double {
+    auto timeout = m_initialTimeout;
+
+    if (m_smoothedRoundTripTime >= 0) {
+        timeout = m_smoothedRoundTripTime + VariationMultiplier*m_roundTripTimeVariation;
+    }
+
+    timeout *= (1 << m_backoff);
+
+    return qBound(m_minimumTimeout, timeout, m_maximumTimeout);
+}
+
+auto Nedrysoft::RouteAnalyser::RetransmissionTimeout::smoothedRoundTripTime() const -> double {
+    return m_smoothedRoundTripTime;
+}
+
+auto Nedrysoft::RouteAnalyser::RetransmissionTimeout::setInitialTimeout(double initialTimeout) -> void {
+    m_initialTimeout = initialTimeout;
+}
@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 19/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef PINGNOO_COMPONENTS_ROUTEANALYSER_RETRANSMISSIONTIMEOUT_H
+#define PINGNOO_COMPONENTS_ROUTEANALYSER_RETRANSMISSIONTIMEOUT_H
+
+#include "RouteAnalyserSpec.h"
+
+namespace Nedrysoft { namespace RouteAnalyser {
+    /**
+     * @brief       The RetransmissionTimeout class provides an adaptive reply timeout for a target.
+     *
+     * @details     The smoothed round trip time and its variation are tracked using the Jacobson/Karels
+     *              estimator, the timeout is srtt+4*rttvar clamped to the minimum and maximum.  Until the first
+     *              sample is added the initial timeout is used, and each loss doubles the timeout until the next
+     *              reply is received.
+     *
+     * @note        This class is not thread safe, callers must serialise access to an instance.
+     *
+     * @class       Nedrysoft::RouteAnalyser::RetransmissionTimeout RetransmissionTimeout.h <RetransmissionTimeout>
+     */
+    class NEDRYSOFT_ROUTEANALYSER_DLLSPEC RetransmissionTimeout {
+        public:
+            /**
+             * @brief       Constructs a RetransmissionTimeout.
+             *
+             * @param[in]   initialTimeout the timeout in seconds to use until a round trip time is known.
+             * @param[in]   minimumTimeout the smallest timeout in seconds that will be returned.
+             * @param[in]   maximumTimeout the largest timeout in seconds that will be returned.
+             */
+            RetransmissionTimeout(
+                double initialTimeout = 1.0,
+                double minimumTimeout = 0.05,
+                double maximumTimeout = 10.0
+            );
+
+            /**
+             * @brief       Adds a round trip time measurement.
+             *
+             * @param[in]   roundTripTime the round trip time in seconds.
+             */
+            auto addSample(double roundTripTime) -> void;
+
+            /**
+             * @brief       Records that a request was not replied to within the timeout.
+             */
+            auto addLoss() -> void;
+
+            /**
+             * @brief       Returns the current timeout.
+             *
+             * @returns     the timeout in seconds.
+             */
+            auto timeout() const -> double;
+
+            /**
+             * @brief       Returns the smoothed round trip time.
+             *
+             * @returns     the smoothed round trip time in seconds if a sample has been added; otherwise -1.
+             */
+            auto smoothedRoundTripTime() const -> double;
+
+            /**
+             * @brief       Sets the timeout to be used until a round trip time is known.
+             *
+             * @param[in]   initialTimeout the initial timeout in seconds.
+             */
+            auto setInitialTimeout(double initialTimeout) -> void;
+
+        private:
+            //! @cond
+
+            double m_initialTimeout;
+            double m_minimumTimeout;
+            double m_maximumTimeout;
+            double m_smoothedRoundTripTime;
+            double m_roundTripTimeVariation;
+            int m_backoff;
+
+            //! @endcond
+    };
+}}
+
+#endif // PINGNOO_COMPONENTS_ROUTEANALYSER_RETRANSMISSIONTIMEOUT_H
@@ -92,6 +92,7 @@ RouteAnalyserComponent::~RouteAnalyserComponent() {
 auto RouteAnalyserComponent::initialiseEvent() -> void {
     qRegisterMetaType<Nedrysoft::RouteAnalyser::PingResult>("Nedrysoft::RouteAnalyser::PingResult");
     qRegisterMetaType<Nedrysoft::RouteAnalyser::RouteList>("Nedrysoft::RouteAnalyser::RouteList");
+    qRegisterMetaType<Nedrysoft::RouteAnalyser::MultipathRouteList>("Nedrysoft::RouteAnalyser::MultipathRouteList");
     qRegisterMetaType<Nedrysoft::RouteAnalyser::IPingEngineFactory *>("Nedrysoft::RouteAnalyser::IPingEngineFactory *");
 }
 
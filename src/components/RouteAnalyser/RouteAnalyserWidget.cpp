@@ -26,6 +26,7 @@
 #include "BarChart.h"
 #include "CPAxisTickerMS.h"
 #include "GraphLatencyLayer.h"
+#include "HostResolver/HostResolver.h"
 #include "IPingEngine.h"
 #include "IPingEngineFactory.h"
 #include "IPingTarget.h"
@@ -37,6 +38,7 @@
 #include "RouteAnalyser.h"
 #include "RouteDiscoveryWidget.h"
 #include "RouteTableItemDelegate.h"
+#include "TargetSettings.h"
 
 #include <CoreConstants>
 #include <ICommand>
@@ -47,7 +49,6 @@
 #include "IHostMaskerManager"
 #include <QDateTime>
 #include <QHostAddress>
-#include <QHostInfo>
 #include <QTimer>
 #include <cassert>
 #include <spdlog/spdlog.h>
@@ -59,6 +60,8 @@ constexpr auto DefaultGraphHeight = 300;
 constexpr auto TableRowHeight = 20;
 constexpr auto NoReplyColour = qRgb(255,0,0);
 constexpr auto PlotMargins = QMargins(80, 20, 40, 40);
+constexpr auto DefaultRetraceInterval = 5*60*1000;
+constexpr auto RouteChangeColour = qRgb(255,140,0);
 
 QMap< Nedrysoft::RouteAnalyser::PingData::Fields, QPair<QString, QString> > &Nedrysoft::RouteAnalyser::RouteAnalyserWidget::headerMap() {
     static QMap<Nedrysoft::RouteAnalyser::PingData::Fields, QPair<QString, QString> > map = QMap<Nedrysoft::RouteAnalyser::PingData::Fields, QPair<QString, QString> >
@@ -94,6 +97,7 @@ Nedrysoft::RouteAnalyser::RouteAnalyserWidget::RouteAnalyserWidget(
             m_startPoint(-1),
             m_endPoint(0),
             m_interval(1000),
+            m_multipathHopCount(0),
             m_routeDiscoveryWidget(new Nedrysoft::RouteAnalyser::RouteDiscoveryWidget) {
 
     auto latencySettings = Nedrysoft::RouteAnalyser::LatencySettings::getInstance();
@@ -115,6 +119,8 @@ Nedrysoft::RouteAnalyser::RouteAnalyserWidget::RouteAnalyserWidget(
     auto routeEngine = sortedRouteEngines.first()->createEngine();
 
     if (routeEngine) {
+        m_routeEngine = routeEngine;
+
         connect(
             routeEngine,
             &Nedrysoft::RouteAnalyser::IRouteEngine::result,
@@ -122,6 +128,28 @@ Nedrysoft::RouteAnalyser::RouteAnalyserWidget::RouteAnalyserWidget(
             &RouteAnalyserWidget::onRouteResult
         );
 
+        connect(
+            routeEngine,
+            &Nedrysoft::RouteAnalyser::IRouteEngine::routeChanged,
+            this,
+            &RouteAnalyserWidget::onRouteChanged
+        );
+
+        connect(
+            routeEngine,
+            &Nedrysoft::RouteAnalyser::IRouteEngine::multipathResult,
+            this,
+            &RouteAnalyserWidget::onMultipathResult
+        );
+
+        auto targetSettings = Nedrysoft::ComponentSystem::getObject<Nedrysoft::RouteAnalyser::TargetSettings>();
+
+        if (targetSettings) {
+            routeEngine->setDiscoveryMode(targetSettings->discoveryMode());
+        }
+
+        routeEngine->setRetraceInterval(DefaultRetraceInterval);
+
         m_routeDiscoveryWidget->setTarget(targetHost);
 
         routeEngine->findRoute(pingEngineFactory, targetHost, ipVersion);
@@ -236,6 +264,15 @@ Nedrysoft::RouteAnalyser::RouteAnalyserWidget::RouteAnalyserWidget(
 }
 
 Nedrysoft::RouteAnalyser::RouteAnalyserWidget::~RouteAnalyserWidget() {
+    /**
+     * the route engine belongs to its factory and outlives the widget, so re-tracing must be stopped here or the
+     * route would continue to be probed in the background.
+     */
+
+    if (m_routeEngine) {
+        m_routeEngine->setRetraceInterval(0);
+    }
+
     if (m_tableView) {
         delete m_tableView;
     }
@@ -290,6 +327,32 @@ auto Nedrysoft::RouteAnalyser::RouteAnalyserWidget::onPingResult(Nedrysoft::Rout
 
             pingData->updateItem(result);
 
+            /**
+             * every hop is monitored with a ttl limited ping to the target, so a hop behind a load balancer is
+             * answered by different routers, the title of the hop shows how many have been seen.
+             */
+
+            /**
+             * the responder is interned when the hop is set up and only again when a different router answers,
+             * so the address is not hashed for every sample.
+             */
+
+            auto responderAddressId = pingData->responderAddressId();
+
+            if (m_hopModel.address(responderAddressId)!=result.hostAddress()) {
+                responderAddressId = m_hopModel.intern(result.hostAddress());
+
+                pingData->setResponderAddressId(responderAddressId);
+            }
+
+            if (m_hopModel.addResponse(pingData->hop(), responderAddressId)) {
+                pingData->setResponderCount(m_hopModel.responderCount(pingData->hop()));
+
+                if ((pingData->responderCount()>1) && (m_plotTitles.contains(customPlot))) {
+                    m_plotTitles[customPlot]->setText(pingData->plotTitle());
+                }
+            }
+
             switch(m_graphScaleMode) {
                 case ScaleMode::None: {
                     if (result.roundTripTime()> graphRange.upper) {
@@ -347,7 +410,8 @@ auto Nedrysoft::RouteAnalyser::RouteAnalyserWidget::onPingResult(Nedrysoft::Rout
             break;
         }
 
-        case Nedrysoft::RouteAnalyser::PingResult::ResultCode::NoReply: {
+        case Nedrysoft::RouteAnalyser::PingResult::ResultCode::NoReply:
+        case Nedrysoft::RouteAnalyser::PingResult::ResultCode::Unreachable: {
             auto requestTime = static_cast<double>(result.requestTime().toSecsSinceEpoch());
 
             QCPBars *barChart = m_barCharts[customPlot];
@@ -371,15 +435,8 @@ auto Nedrysoft::RouteAnalyser::RouteAnalyserWidget::onRouteResult(
     Nedrysoft::RouteAnalyser::IRouteEngine *routeEngine =
         qobject_cast<Nedrysoft::RouteAnalyser::IRouteEngine *>(this->sender());
 
-    auto hop = 1;
-    auto geoIP = Nedrysoft::ComponentSystem::getObject<Nedrysoft::Core::IGeoIPProvider>();
-
     SPDLOG_TRACE("Got route result");
 
-    auto latencySettings = Nedrysoft::RouteAnalyser::LatencySettings::getInstance();
-
-    assert(latencySettings!=nullptr);
-
     if ((completed) && (routeEngine)) {
         disconnect(
             routeEngine,
@@ -393,359 +450,406 @@ auto Nedrysoft::RouteAnalyser::RouteAnalyserWidget::onRouteResult(
         return;
     }
 
-    if (!completed) {
-        for (int hop=m_tableModel->rowCount();hop<route.count();hop++) {
-            auto host = route.at(hop);
+    /**
+     * the ping engine is started as soon as the first hop is reported and each responding hop is added to it as
+     * it is discovered, this means that sampling of the early hops begins while the rest of the route is still
+     * being discovered.
+     */
 
-            auto hostAddress = host.toString();
-            auto hostName = QHostInfo::fromName(host.toString()).hostName();
+    if ((!m_pingEngine) && (!route.isEmpty())) {
+        startPingEngine(routeHostAddress, routeEngine ? routeEngine->flowId() : 0);
+    }
 
-            auto maskedHostName = hostName;
-            auto maskedHostAddress = hostAddress;
+    m_routeHostAddress = routeHostAddress;
 
-            auto pingData = new Nedrysoft::RouteAnalyser::PingData(m_tableModel, hop+1, !host.isNull());
+    for (int hop=m_tableModel->rowCount();hop<route.count();hop++) {
+        auto host = route.at(hop);
 
-            m_pingData.append(pingData);
+        setRouteAddressId(hop, m_hopModel.intern(host));
 
-            for (auto masker : Nedrysoft::ComponentSystem::getObjects<Nedrysoft::Core::IHostMasker>()) {
-                masker->mask(hop, hostName, hostAddress, maskedHostName, maskedHostAddress);
-            }
+        auto maskedHostName = addHopRow(hop, host);
 
-            auto tableItem = new QStandardItem(1, headerMap().count());
+        if ((!host.isNull()) && (m_pingEngine)) {
+            addHopPlot(m_pingData.at(hop), routeHostAddress, hop+1, maskedHostName);
+        }
+    }
 
-            tableItem->setData(QVariant::fromValue<Nedrysoft::RouteAnalyser::PingData *>(pingData));
+    m_routeDiscoveryWidget->setProgress(m_tableModel->rowCount(), totalHops, maximumHops);
+    m_routeDiscoveryWidget->update();
 
-            if (host.isNull()) {
-                pingData->setHostAddress("*");
-                pingData->setHostName("*");
-                pingData->setMaskedHostAddress("*");
-                pingData->setMaskedHostName("*");
-            } else {
-                pingData->setHostName(hostName);
-                pingData->setHostAddress(hostAddress);
-                pingData->setMaskedHostName(maskedHostName);
-                pingData->setMaskedHostAddress(maskedHostAddress);
-            }
+    if (!completed) {
+        return;
+    }
 
-            if (geoIP) {
-                geoIP->lookup(hostAddress, [pingData](const QString &, const QVariantMap &result) mutable {
-                    pingData->setLocation(result["country"].toString());
-                });
-            }
+    auto hostResolver = Nedrysoft::HostResolver::HostResolver::getInstance();
+
+    SPDLOG_DEBUG(QString("Reverse lookup cache, %1 hits, %2 misses.")
+                         .arg(hostResolver->reverseLookupHits())
+                         .arg(hostResolver->reverseLookupMisses())
+                         .toStdString() );
 
-            m_tableModel->appendRow(tableItem);
+    m_routeDiscoveryWidget->setVisible(false);
+    m_scrollArea->setVisible(true);
 
-            m_tableView->setRowHeight(tableItem->index().row(), TableRowHeight);
+    update();
+}
 
-            connect(m_tableView, &QObject::destroyed, [pingData](QObject *) {
-                delete pingData;
-            });
-        }
+auto Nedrysoft::RouteAnalyser::RouteAnalyserWidget::onRouteChanged(
+        const QHostAddress routeHostAddress,
+        const Nedrysoft::RouteAnalyser::RouteList previousRoute,
+        const Nedrysoft::RouteAnalyser::RouteList route,
+        const QDateTime changedTime ) -> void {
 
-        m_routeDiscoveryWidget->setProgress(m_tableModel->rowCount(), totalHops, maximumHops);
-        m_routeDiscoveryWidget->update();
+    Q_UNUSED(previousRoute)
 
+    if (!m_pingEngine) {
         return;
     }
 
-    if (routeHostAddress.protocol() == QAbstractSocket::IPv4Protocol) {
-        m_pingEngine = m_pingEngineFactory->createEngine(Nedrysoft::Core::IPVersion::V4);
-    } else if (routeHostAddress.protocol() == QAbstractSocket::IPv6Protocol) {
-        m_pingEngine = m_pingEngineFactory->createEngine(Nedrysoft::Core::IPVersion::V6);
-    } else {
-        return;
+    auto changedTimePoint = static_cast<double>(changedTime.toSecsSinceEpoch());
+
+    SPDLOG_TRACE("Got route change");
+
+    /**
+     * if the host now resolves to a different address then the hops that were monitored by pinging the old
+     * address are moved to the new one, a responder that is pinged directly is left as it is.
+     */
+
+    if (routeHostAddress!=m_routeHostAddress) {
+        for (auto pingTarget : m_pingEngine->targets()) {
+            if (pingTarget->hostAddress()!=m_routeHostAddress) {
+                continue;
+            }
+
+            auto userData = pingTarget->userData();
+            auto ttl = pingTarget->ttl();
+
+            m_pingEngine->removeTarget(pingTarget);
+
+            auto newTarget = m_pingEngine->addTarget(routeHostAddress, ttl);
+
+            newTarget->setUserData(userData);
+        }
+
+        m_routeHostAddress = routeHostAddress;
     }
 
-    m_pingEngine->setInterval(m_interval);
+    /**
+     * each hop is monitored by a ttl limited ping to the target rather than by the address of the hop, so a hop
+     * that is now answered by a different router carries on being monitored without losing its history, only
+     * the host information shown for it needs to be changed.  The new route is compared against the interned
+     * route that is being shown rather than the previous route reported by the engine, so each hop is compared
+     * as an integer.
+     */
 
-    connect(
-        m_pingEngine,
-        &Nedrysoft::RouteAnalyser::IPingEngine::result,
-        this,
-        &RouteAnalyserWidget::onPingResult
-    );
+    for (int hop=0;hop<route.count();hop++) {
+        auto host = route.at(hop);
+        auto hostAddressId = m_hopModel.intern(host);
+        auto previousAddressId = routeAddressId(hop);
 
-    auto verticalLayout = new QVBoxLayout();
+        setRouteAddressId(hop, hostAddressId);
 
-    //for (const QHostAddress &host : route) {
-    for (auto hop=1;hop<=route.count();hop++) {
-        auto host = route.at(hop-1);
+        if (hop>=m_tableModel->rowCount()) {
+            auto maskedHostName = addHopRow(hop, host);
+
+            if (!host.isNull()) {
+                addHopPlot(m_pingData.at(hop), routeHostAddress, hop+1, maskedHostName);
+            }
 
-        if (host.isNull()) {
             continue;
         }
 
-        auto hostAddress = host.toString();
-        auto hostName = QHostInfo::fromName(host.toString()).hostName();
+        if (previousAddressId==hostAddressId) {
+            continue;
+        }
 
-        auto maskedHostName = hostName;
-        auto maskedHostAddress = hostAddress;
+        auto pingData = m_pingData.at(hop);
+        auto maskedHostName = setHopHost(pingData, hop, host);
+        auto customPlot = pingData->customPlot();
 
-        for (auto masker : Nedrysoft::ComponentSystem::getObjects<Nedrysoft::Core::IHostMasker>()) {
-            masker->mask(hop, hostName, hostAddress, maskedHostName, maskedHostAddress);
-        }
+        if (!customPlot) {
+            if (!host.isNull()) {
+                addHopPlot(pingData, routeHostAddress, hop+1, maskedHostName);
+            }
 
-        auto customPlot = new QCustomPlot();
+            continue;
+        }
 
-        customPlot->addLayer("newBackground", customPlot->layer("grid"), QCustomPlot::limBelow);
+        /**
+         * a hop that had been dropped by an earlier change has its monitoring restarted.
+         */
 
-        auto latencyLayer = new GraphLatencyLayer(customPlot);
+        auto isMonitored = false;
 
-        m_backgroundLayers.append(latencyLayer);
+        for (auto pingTarget : m_pingEngine->targets()) {
+            if (pingTarget->userData()==pingData) {
+                isMonitored = true;
 
-        connect(
-            latencySettings,
-            &Nedrysoft::RouteAnalyser::LatencySettings::gradientChanged,
-            [=](bool /*useGradient*/) {
-                latencyLayer->invalidate();
+                break;
             }
-        );
+        }
 
-        customPlot->setCurrentLayer("main");
+        if (!isMonitored) {
+            auto pingTarget = m_pingEngine->addTarget(routeHostAddress, hop+1);
 
-        customPlot->setMinimumHeight(DefaultGraphHeight);
+            pingTarget->setUserData(pingData);
+        }
 
-        customPlot->addGraph();
+        pingData->setHopValid(true);
 
-        // the timeout bar chart uses axis 2 which is a unit axis.  This means it will always draw to the top
-        // of the axis independently of the main axis which may scale up/down depending on latency.
+        if (m_plotTitles.contains(customPlot)) {
+            m_plotTitles[customPlot]->setText(pingData->plotTitle());
+        }
 
-        customPlot->yAxis2->setRange(0,1);
-        customPlot->yAxis2->setVisible(true);
+        auto changeLine = new QCPItemStraightLine(customPlot);
 
-        auto barChart = new BarChart(customPlot->xAxis, customPlot->yAxis2);
+        changeLine->setPen(QPen(QColor(RouteChangeColour), 1, Qt::DashLine));
+        changeLine->point1->setCoords(changedTimePoint, 0);
+        changeLine->point2->setCoords(changedTimePoint, 1);
 
-        barChart->setWidthType(QCPBars::wtPlotCoords);
-        barChart->setBrush(QColor(NoReplyColour));
-        barChart->setPen(QPen(QColor(NoReplyColour)));
+        customPlot->replot();
+    }
 
-        m_barCharts[customPlot] = barChart;
+    if (m_routeAddressIds.count()>route.count()) {
+        m_routeAddressIds.resize(route.count());
+    }
 
-        customPlot->yAxis->ticker()->setTickCount(1);
+    /**
+     * hops beyond the end of the new route would now be answered by the target itself, they stop being monitored
+     * but are left in place so that their history can still be viewed.
+     */
 
-        QSharedPointer<CPAxisTickerMS> msTicker(new CPAxisTickerMS);
+    for (auto pingTarget : m_pingEngine->targets()) {
+        auto pingData = static_cast<PingData *>(pingTarget->userData());
 
-        customPlot->yAxis->setTicker(msTicker);
-        customPlot->yAxis->setLabel(tr("Latency (ms)"));
-        customPlot->yAxis->setRange(0, DefaultMaxLatency);
+        if ((!pingData) || (pingData->hop()<=route.count())) {
+            continue;
+        }
 
-        QSharedPointer<QCPAxisTickerDateTime> dateTicker(new QCPAxisTickerDateTime);
+        m_pingEngine->removeTarget(pingTarget);
 
-        auto locale = QLocale::system();
+        pingData->setHopValid(false);
+    }
 
-        dateTicker->setDateTimeFormat(
-            locale.timeFormat(QLocale::LongFormat).remove("t").trimmed() +
-            "\n" +
-            locale.dateFormat(QLocale::ShortFormat)
-        );
+    m_tableView->viewport()->update();
+}
 
-#if QT_VERSION >= QT_VERSION_CHECK(5, 8, 0)
-        auto secondsSinceEpoch = QDateTime::currentSecsSinceEpoch();
-#else
-        auto secondsSinceEpoch = abs(QDateTime::currentDateTime().secsTo(QDateTime(QDate(1970,1,1), QTime(0, 0))));
-#endif
+auto Nedrysoft::RouteAnalyser::RouteAnalyserWidget::onMultipathResult(
+        const QHostAddress routeHostAddress,
+        const Nedrysoft::RouteAnalyser::MultipathRouteList result,
+        const bool completed ) -> void {
 
-        customPlot->xAxis->setTicker(dateTicker);
-        customPlot->xAxis->setRange(
-            static_cast<double>(secondsSinceEpoch),
-            static_cast<double>(secondsSinceEpoch + m_viewportSize)
-        );
+    Q_UNUSED(routeHostAddress)
+    Q_UNUSED(completed)
 
-        customPlot->graph(RoundTripGraph)->setLineStyle(QCPGraph::lsStepCenter);
+    if (!m_pingEngine) {
+        return;
+    }
 
-        customPlot->setBackground(this->palette().brush(QPalette::Base));
-        customPlot->xAxis->setLabelColor(this->palette().color(QPalette::Text));
-        customPlot->yAxis->setLabelColor(this->palette().color(QPalette::Text));
-        customPlot->xAxis->setTickLabelColor(this->palette().color(QPalette::Text));
-        customPlot->yAxis->setTickLabelColor(this->palette().color(QPalette::Text));
+    auto hopCount = qMin(result.count(), m_pingData.count());
 
-        customPlot->replot();
+    /**
+     * a hop keeps being monitored by a ttl limited ping along the discovered flow, every other responder found
+     * at that hop is pinged directly and given its own graph so that the interfaces on the other paths are
+     * monitored without mixing their latency into the graph of the hop.
+     */
 
-        /**
-         * scroll wheel events, by default QCustomPlot does not propagate these so this code ensures that they cause
-         * the scroll area to scroll.
-         */
+    for (int hop=m_multipathHopCount;hop<hopCount;hop++) {
+        auto pingData = m_pingData.at(hop);
 
-        connect(customPlot, &QCustomPlot::mouseWheel, [this](QWheelEvent *event) {
-            m_scrollArea->verticalScrollBar()->setValue(
-                m_scrollArea->verticalScrollBar()->value() - event->angleDelta().y()
-            );
-        });
+        for (auto responder : result.at(hop)) {
+            if (responder.isNull()) {
+                continue;
+            }
 
-        /**
-         *  mouse over event
-         */
+            m_hopModel.addResponse(hop+1, responder);
 
-        auto graphLine = new QCPItemStraightLine(customPlot);
+            if (responder==QHostAddress(pingData->hostAddress())) {
+                continue;
+            }
 
-        graphLine->setPen(QPen(Qt::darkGray, 2, Qt::DotLine));
+            auto responderData = new Nedrysoft::RouteAnalyser::PingData(m_tableModel, hop+1, true);
 
-        m_graphLines[customPlot] = graphLine;
+            connect(m_tableView, &QObject::destroyed, [responderData](QObject *) {
+                delete responderData;
+            });
 
-        connect(
-            customPlot,
-            &QCustomPlot::mouseMove,
-            [this, customPlot, graphLine, maskedHostName](QMouseEvent *event) {
-                auto x = customPlot->xAxis->pixelToCoord(event->pos().x());
-                auto foundRange = false;
+            auto maskedHostName = setHopHost(responderData, hop, responder);
 
-                auto data = customPlot->graph(RoundTripGraph)->data();
+            addHopPlot(responderData, responder, 0, maskedHostName);
+        }
 
-                if (!data) {
-                    return;
-                }
+        pingData->setResponderCount(m_hopModel.responderCount(hop+1));
 
-                auto dataRange = data->keyRange(foundRange);
+        auto customPlot = pingData->customPlot();
 
-                graphLine->point1->setCoords(x, 0);
-                graphLine->point2->setCoords(x, 1);
+        if ((customPlot) && (m_plotTitles.contains(customPlot))) {
+            m_plotTitles[customPlot]->setText(pingData->plotTitle());
+        }
+    }
 
-                customPlot->replot();
+    m_multipathHopCount = qMax(m_multipathHopCount, hopCount);
 
-                if (( foundRange ) &&
-                    ( x >= dataRange.lower ) &&
-                    ( x <= dataRange.upper )) {
-                    auto valueString = QString();
-                    /*auto valueResultRange = customPlot->graph(RoundTripGraph)->data()->valueRange(
-                            foundRange,
-                            QCP::sdBoth,
-                            QCPRange(x - 1, x +1) );*/
+    m_tableView->viewport()->update();
+}
 
-                    for (auto currentItem = 0; currentItem < m_tableModel->rowCount(); currentItem++) {
-                        auto pingData = m_tableModel->item(
-                                currentItem,
-                                0
-                        )->data().value<Nedrysoft::RouteAnalyser::PingData *>();
+auto Nedrysoft::RouteAnalyser::RouteAnalyserWidget::routeAddressId(
+        int hop ) const -> Nedrysoft::RouteAnalyser::AddressId {
 
-                        auto valueRange = QCPRange(x - 1, x + 1);
+    if ((hop<0) || (hop>=m_routeAddressIds.count())) {
+        return Nedrysoft::RouteAnalyser::NullAddressId;
+    }
 
-                        if (pingData->customPlot()) {
-                            auto tempResultRange = pingData->customPlot()->graph(
-                                    RoundTripGraph)->data()->valueRange(foundRange, QCP::sdBoth, valueRange);
+    return m_routeAddressIds.at(hop);
+}
 
-                            pingData->setHistoricalLatency(tempResultRange.upper);
-                        } else {
-                            pingData->setHistoricalLatency(-1);
+auto Nedrysoft::RouteAnalyser::RouteAnalyserWidget::setRouteAddressId(
+        int hop,
+        Nedrysoft::RouteAnalyser::AddressId addressId ) -> void {
 
-                            auto topLeft = m_tableModel->index(0, 0);
-                            auto bottomRight = topLeft.sibling(m_tableModel->rowCount() - 1,
-                                                               m_tableModel->columnCount() - 1);
+    if (hop<0) {
+        return;
+    }
 
-                            m_tableModel->dataChanged(topLeft, bottomRight);
-                        }
-                    }
+    if (hop>=m_routeAddressIds.count()) {
+        m_routeAddressIds.resize(hop+1);
+    }
 
-                    this->m_tableModel->setProperty("showHistorical", true);
+    m_routeAddressIds[hop] = addressId;
+}
 
-                    /*
-                    auto seconds = std::chrono::duration<double>(valueResultRange.upper);
+auto Nedrysoft::RouteAnalyser::RouteAnalyserWidget::addHopRow(int hop, const QHostAddress &host) -> QString {
+    auto pingData = new Nedrysoft::RouteAnalyser::PingData(m_tableModel, hop+1, !host.isNull());
 
-                    if (seconds < std::chrono::seconds(1)) {
-                        auto milliseconds =
-                            std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(seconds);
+    m_pingData.append(pingData);
 
-                        valueString = QString(tr("%1ms")).arg(milliseconds.count(), 0, 'f', 2);
-                    } else {
-                        valueString = QString(tr("%1s")).arg(seconds.count(), 0, 'f', 2);
-                    }
+    auto tableItem = new QStandardItem(1, headerMap().count());
 
-                    auto dateTime = QDateTime::fromSecsSinceEpoch(static_cast<qint64>(x));
+    tableItem->setData(QVariant::fromValue<Nedrysoft::RouteAnalyser::PingData *>(pingData));
 
-                    m_pointInfoLabel->setText(FontAwesome::richText(QString("[fas fa-stopwatch] %1").arg(valueString)));
-                    m_hopInfoLabel->setText(FontAwesome::richText(QString("[fas fa-project-diagram] %1 %2").arg(tr("hop")).arg(hop)));
-                    m_hostInfoLabel->setText(FontAwesome::richText(QString("[fas fa-server] %1").arg(maskedHostName)));
-                    m_timeInfoLabel->setText(FontAwesome::richText(QString("[far fa-calendar-alt] %1").arg(dateTime.toString())));
-                    */
-                } else {
-                    /*
-                    m_pointInfoLabel->setText("");
-                    m_hopInfoLabel->setText("");
-                    m_hostInfoLabel->setText("");
-                    m_timeInfoLabel->setText("");
-                    */
+    auto maskedHostName = setHopHost(pingData, hop, host);
 
-                    this->m_tableModel->setProperty("showHistorical", false);
+    m_tableModel->appendRow(tableItem);
 
-                    auto topLeft = m_tableModel->index(0, 0);
-                    auto bottomRight = topLeft.sibling(
-                            m_tableModel->rowCount() - 1,
-                            m_tableModel->columnCount() - 1 );
+    m_tableView->setRowHeight(tableItem->index().row(), TableRowHeight);
 
-                    m_tableModel->dataChanged(topLeft, bottomRight);
-                }
-            }
-        );
+    connect(m_tableView, &QObject::destroyed, [pingData](QObject *) {
+        delete pingData;
+    });
 
-        customPlot->installEventFilter(this);
+    return maskedHostName;
+}
 
-        m_plotList.append(customPlot);
+auto Nedrysoft::RouteAnalyser::RouteAnalyserWidget::setHopHost(
+        Nedrysoft::RouteAnalyser::PingData *pingData,
+        int hop,
+        const QHostAddress &host ) -> QString {
 
-        auto plotTitleLabel = new QLabel;
+    auto geoIP = Nedrysoft::ComponentSystem::getObject<Nedrysoft::Core::IGeoIPProvider>();
 
-        QFont labelFont = plotTitleLabel->font();
+    auto hostAddress = host.toString();
 
-        labelFont.setPointSize(16);
+    pingData->setResponderAddressId(m_hopModel.intern(host));
 
-        plotTitleLabel->setFont(labelFont);
+    if (host.isNull()) {
+        pingData->setHostAddress("*");
+        pingData->setHostName("*");
+        pingData->setMaskedHostAddress("*");
+        pingData->setMaskedHostName("*");
+        pingData->setLocation(QString());
 
-        plotTitleLabel->setAlignment(Qt::AlignHCenter);
+        return QString();
+    }
 
-        verticalLayout->addWidget(plotTitleLabel);
+    pingData->setHostAddress(hostAddress);
 
-        // add any pre-plots.
+    /**
+     * the address is shown in place of the host name until the reverse lookup completes, the lookup never
+     * blocks the gui thread, a cached name is applied straight away and any other is filled in when it arrives.
+     */
 
-        auto plotFactories = ComponentSystem::getObjects<Nedrysoft::RouteAnalyser::IPlotFactory>();
+    auto maskedHostName = setHopHostName(pingData, hop, hostAddress);
 
-        QList<Nedrysoft::RouteAnalyser::IPlot *> plots;
+    Nedrysoft::HostResolver::HostResolver::getInstance()->lookupHostName(
+        host,
+        m_tableView,
+        [this, pingData, hop, hostAddress](const QString &hostName) {
+            if ((hostName.isEmpty()) || (pingData->hostAddress()!=hostAddress)) {
+                return;
+            }
 
-        for (auto plotFactory : plotFactories) {
-            auto plot = plotFactory->createPlot(PlotMargins);
+            setHopHostName(pingData, hop, hostName);
 
-            m_extraPlots.append(plot);
+            auto customPlot = pingData->customPlot();
 
-            plots.append(plot);
+            if ((customPlot) && (m_plotTitles.contains(customPlot))) {
+                m_plotTitles[customPlot]->setText(pingData->plotTitle());
+            }
 
-            verticalLayout->addWidget(plot->widget());
+            m_tableView->viewport()->update();
         }
+    );
 
-        customPlot->axisRect()->setAutoMargins(QCP::msNone);
-        customPlot->axisRect()->setMargins(PlotMargins);
+    if (geoIP) {
+        geoIP->lookup(hostAddress, [pingData](const QString &, const QVariantMap &result) mutable {
+            pingData->setLocation(result["country"].toString());
+        });
+    }
 
-        // add the main plot
+    return maskedHostName;
+}
 
-        verticalLayout->addWidget(customPlot);
+auto Nedrysoft::RouteAnalyser::RouteAnalyserWidget::setHopHostName(
+        Nedrysoft::RouteAnalyser::PingData *pingData,
+        int hop,
+        const QString &hostName ) -> QString {
 
-        auto pingTarget = m_pingEngine->addTarget(routeHostAddress, hop);
+    auto hostAddress = pingData->hostAddress();
 
-        auto pingData = m_pingData.at(hop-1);
+    auto maskedHostName = hostName;
+    auto maskedHostAddress = hostAddress;
 
-        pingData->setHopValid(true);
-        pingData->setPlots(plots);
-        pingData->setCustomPlot(customPlot);
+    for (auto masker : Nedrysoft::ComponentSystem::getObjects<Nedrysoft::Core::IHostMasker>()) {
+        masker->mask(hop, hostName, hostAddress, maskedHostName, maskedHostAddress);
+    }
 
-        pingTarget->setUserData(pingData);
+    pingData->setHostName(hostName);
+    pingData->setMaskedHostName(maskedHostName);
+    pingData->setMaskedHostAddress(maskedHostAddress);
 
-        if (geoIP) {
-            geoIP->lookup(hostAddress, [pingData](const QString &, const QVariantMap &result) mutable {
-                pingData->setLocation(result["country"].toString());
-            });
-        }
+    return maskedHostName;
+}
 
-        auto hostMaskerManager = Nedrysoft::Core::IHostMaskerManager::getInstance();
+auto Nedrysoft::RouteAnalyser::RouteAnalyserWidget::startPingEngine(
+        const QHostAddress &routeHostAddress,
+        uint16_t flowId) -> bool {
 
-        if (hostMaskerManager) {
-            connect(
-                hostMaskerManager,
-                &Nedrysoft::Core::IHostMaskerManager::maskStateChanged,
-                [pingData, plotTitleLabel](Nedrysoft::Core::HostMaskType type, bool state) {
-                    pingData->updateModel();
-                    plotTitleLabel->setText(pingData->plotTitle());
-            });
-        }
+    if (routeHostAddress.protocol() == QAbstractSocket::IPv4Protocol) {
+        m_pingEngine = m_pingEngineFactory->createEngine(Nedrysoft::Core::IPVersion::V4);
+    } else if (routeHostAddress.protocol() == QAbstractSocket::IPv6Protocol) {
+        m_pingEngine = m_pingEngineFactory->createEngine(Nedrysoft::Core::IPVersion::V6);
+    } else {
+        return false;
+    }
+
+    m_pingEngine->setInterval(m_interval);
 
-        plotTitleLabel->setText(pingData->plotTitle());
+    /**
+     * the hops are monitored on the same flow that was used to discover them, so that load balancers send the
+     * monitoring probes along the discovered path.
+     */
+
+    if (flowId) {
+        m_pingEngine->setFlowId(flowId);
     }
 
+    connect(
+        m_pingEngine,
+        &Nedrysoft::RouteAnalyser::IPingEngine::result,
+        this,
+        &RouteAnalyserWidget::onPingResult
+    );
+
     connect(
         this,
         &Nedrysoft::RouteAnalyser::RouteAnalyserWidget::filteredEvent,
@@ -794,14 +898,280 @@ auto Nedrysoft::RouteAnalyser::RouteAnalyserWidget::onRouteResult(
         }
     );
 
-    m_scrollArea->widget()->setLayout(verticalLayout);
+    m_scrollArea->widget()->setLayout(new QVBoxLayout());
 
-    m_routeDiscoveryWidget->setVisible(false);
-    m_scrollArea->setVisible(true);
+    m_pingEngine->start();
 
-    update();
+    return true;
+}
 
-    m_pingEngine->start();
+auto Nedrysoft::RouteAnalyser::RouteAnalyserWidget::addHopPlot(
+        Nedrysoft::RouteAnalyser::PingData *pingData,
+        const QHostAddress &targetAddress,
+        int ttl,
+        const QString &maskedHostName) -> void {
+
+    auto latencySettings = Nedrysoft::RouteAnalyser::LatencySettings::getInstance();
+
+    assert(latencySettings!=nullptr);
+
+    auto verticalLayout = qobject_cast<QVBoxLayout *>(m_scrollArea->widget()->layout());
+
+    assert(verticalLayout!=nullptr);
+
+    auto customPlot = new QCustomPlot();
+
+    customPlot->addLayer("newBackground", customPlot->layer("grid"), QCustomPlot::limBelow);
+
+    auto latencyLayer = new GraphLatencyLayer(customPlot);
+
+    m_backgroundLayers.append(latencyLayer);
+
+    connect(
+        latencySettings,
+        &Nedrysoft::RouteAnalyser::LatencySettings::gradientChanged,
+        [=](bool /*useGradient*/) {
+            latencyLayer->invalidate();
+        }
+    );
+
+    customPlot->setCurrentLayer("main");
+
+    customPlot->setMinimumHeight(DefaultGraphHeight);
+
+    customPlot->addGraph();
+
+    // the timeout bar chart uses axis 2 which is a unit axis.  This means it will always draw to the top
+    // of the axis independently of the main axis which may scale up/down depending on latency.
+
+    customPlot->yAxis2->setRange(0,1);
+    customPlot->yAxis2->setVisible(true);
+
+    auto barChart = new BarChart(customPlot->xAxis, customPlot->yAxis2);
+
+    barChart->setWidthType(QCPBars::wtPlotCoords);
+    barChart->setBrush(QColor(NoReplyColour));
+    barChart->setPen(QPen(QColor(NoReplyColour)));
+
+    m_barCharts[customPlot] = barChart;
+
+    customPlot->yAxis->ticker()->setTickCount(1);
+
+    QSharedPointer<CPAxisTickerMS> msTicker(new CPAxisTickerMS);
+
+    customPlot->yAxis->setTicker(msTicker);
+    customPlot->yAxis->setLabel(tr("Latency (ms)"));
+    customPlot->yAxis->setRange(0, DefaultMaxLatency);
+
+    QSharedPointer<QCPAxisTickerDateTime> dateTicker(new QCPAxisTickerDateTime);
+
+    auto locale = QLocale::system();
+
+    dateTicker->setDateTimeFormat(
+        locale.timeFormat(QLocale::LongFormat).remove("t").trimmed() +
+        "\n" +
+        locale.dateFormat(QLocale::ShortFormat)
+    );
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 8, 0)
+    auto secondsSinceEpoch = QDateTime::currentSecsSinceEpoch();
+#else
+    auto secondsSinceEpoch = abs(QDateTime::currentDateTime().secsTo(QDateTime(QDate(1970,1,1), QTime(0, 0))));
+#endif
+
+    customPlot->xAxis->setTicker(dateTicker);
+    customPlot->xAxis->setRange(
+        static_cast<double>(secondsSinceEpoch),
+        static_cast<double>(secondsSinceEpoch + m_viewportSize)
+    );
+
+    customPlot->graph(RoundTripGraph)->setLineStyle(QCPGraph::lsStepCenter);
+
+    customPlot->setBackground(this->palette().brush(QPalette::Base));
+    customPlot->xAxis->setLabelColor(this->palette().color(QPalette::Text));
+    customPlot->yAxis->setLabelColor(this->palette().color(QPalette::Text));
+    customPlot->xAxis->setTickLabelColor(this->palette().color(QPalette::Text));
+    customPlot->yAxis->setTickLabelColor(this->palette().color(QPalette::Text));
+
+    customPlot->replot();
+
+    /**
+     * scroll wheel events, by default QCustomPlot does not propagate these so this code ensures that they cause
+     * the scroll area to scroll.
+     */
+
+    connect(customPlot, &QCustomPlot::mouseWheel, [this](QWheelEvent *event) {
+        m_scrollArea->verticalScrollBar()->setValue(
+            m_scrollArea->verticalScrollBar()->value() - event->angleDelta().y()
+        );
+    });
+
+    /**
+     *  mouse over event
+     */
+
+    auto graphLine = new QCPItemStraightLine(customPlot);
+
+    graphLine->setPen(QPen(Qt::darkGray, 2, Qt::DotLine));
+
+    m_graphLines[customPlot] = graphLine;
+
+    connect(
+        customPlot,
+        &QCustomPlot::mouseMove,
+        [this, customPlot, graphLine, maskedHostName](QMouseEvent *event) {
+            auto x = customPlot->xAxis->pixelToCoord(event->pos().x());
+            auto foundRange = false;
+
+            auto data = customPlot->graph(RoundTripGraph)->data();
+
+            if (!data) {
+                return;
+            }
+
+            auto dataRange = data->keyRange(foundRange);
+
+            graphLine->point1->setCoords(x, 0);
+            graphLine->point2->setCoords(x, 1);
+
+            customPlot->replot();
+
+            if (( foundRange ) &&
+                ( x >= dataRange.lower ) &&
+                ( x <= dataRange.upper )) {
+                auto valueString = QString();
+                /*auto valueResultRange = customPlot->graph(RoundTripGraph)->data()->valueRange(
+                        foundRange,
+                        QCP::sdBoth,
+                        QCPRange(x - 1, x +1) );*/
+
+                for (auto currentItem = 0; currentItem < m_tableModel->rowCount(); currentItem++) {
+                    auto pingData = m_tableModel->item(
+                            currentItem,
+                            0
+                    )->data().value<Nedrysoft::RouteAnalyser::PingData *>();
+
+                    auto valueRange = QCPRange(x - 1, x + 1);
+
+                    if (pingData->customPlot()) {
+                        auto tempResultRange = pingData->customPlot()->graph(
+                                RoundTripGraph)->data()->valueRange(foundRange, QCP::sdBoth, valueRange);
+
+                        pingData->setHistoricalLatency(tempResultRange.upper);
+                    } else {
+                        pingData->setHistoricalLatency(-1);
+
+                        auto topLeft = m_tableModel->index(0, 0);
+                        auto bottomRight = topLeft.sibling(m_tableModel->rowCount() - 1,
+                                                           m_tableModel->columnCount() - 1);
+
+                        m_tableModel->dataChanged(topLeft, bottomRight);
+                    }
+                }
+
+                this->m_tableModel->setProperty("showHistorical", true);
+
+                /*
+                auto seconds = std::chrono::duration<double>(valueResultRange.upper);
+
+                if (seconds < std::chrono::seconds(1)) {
+                    auto milliseconds =
+                        std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(seconds);
+
+                    valueString = QString(tr("%1ms")).arg(milliseconds.count(), 0, 'f', 2);
+                } else {
+                    valueString = QString(tr("%1s")).arg(seconds.count(), 0, 'f', 2);
+                }
+
+                auto dateTime = QDateTime::fromSecsSinceEpoch(static_cast<qint64>(x));
+
+                m_pointInfoLabel->setText(FontAwesome::richText(QString("[fas fa-stopwatch] %1").arg(valueString)));
+                m_hopInfoLabel->setText(FontAwesome::richText(QString("[fas fa-project-diagram] %1 %2").arg(tr("hop")).arg(hop)));
+                m_hostInfoLabel->setText(FontAwesome::richText(QString("[fas fa-server] %1").arg(maskedHostName)));
+                m_timeInfoLabel->setText(FontAwesome::richText(QString("[far fa-calendar-alt] %1").arg(dateTime.toString())));
+                */
+            } else {
+                /*
+                m_pointInfoLabel->setText("");
+                m_hopInfoLabel->setText("");
+                m_hostInfoLabel->setText("");
+                m_timeInfoLabel->setText("");
+                */
+
+                this->m_tableModel->setProperty("showHistorical", false);
+
+                auto topLeft = m_tableModel->index(0, 0);
+                auto bottomRight = topLeft.sibling(
+                        m_tableModel->rowCount() - 1,
+                        m_tableModel->columnCount() - 1 );
+
+                m_tableModel->dataChanged(topLeft, bottomRight);
+            }
+        }
+    );
+
+    customPlot->installEventFilter(this);
+
+    m_plotList.append(customPlot);
+
+    auto plotTitleLabel = new QLabel;
+
+    QFont labelFont = plotTitleLabel->font();
+
+    labelFont.setPointSize(16);
+
+    plotTitleLabel->setFont(labelFont);
+
+    plotTitleLabel->setAlignment(Qt::AlignHCenter);
+
+    m_plotTitles[customPlot] = plotTitleLabel;
+
+    verticalLayout->addWidget(plotTitleLabel);
+
+    // add any pre-plots.
+
+    auto plotFactories = ComponentSystem::getObjects<Nedrysoft::RouteAnalyser::IPlotFactory>();
+
+    QList<Nedrysoft::RouteAnalyser::IPlot *> plots;
+
+    for (auto plotFactory : plotFactories) {
+        auto plot = plotFactory->createPlot(PlotMargins);
+
+        m_extraPlots.append(plot);
+
+        plots.append(plot);
+
+        verticalLayout->addWidget(plot->widget());
+    }
+
+    customPlot->axisRect()->setAutoMargins(QCP::msNone);
+    customPlot->axisRect()->setMargins(PlotMargins);
+
+    // add the main plot
+
+    verticalLayout->addWidget(customPlot);
+
+    auto pingTarget = ttl ? m_pingEngine->addTarget(targetAddress, ttl) : m_pingEngine->addTarget(targetAddress);
+
+    pingData->setHopValid(true);
+    pingData->setPlots(plots);
+    pingData->setCustomPlot(customPlot);
+
+    pingTarget->setUserData(pingData);
+
+    auto hostMaskerManager = Nedrysoft::Core::IHostMaskerManager::getInstance();
+
+    if (hostMaskerManager) {
+        connect(
+            hostMaskerManager,
+            &Nedrysoft::Core::IHostMaskerManager::maskStateChanged,
+            [pingData, plotTitleLabel](Nedrysoft::Core::HostMaskType type, bool state) {
+                pingData->updateModel();
+                plotTitleLabel->setText(pingData->plotTitle());
+        });
+    }
+
+    plotTitleLabel->setText(pingData->plotTitle());
 }
 
 auto Nedrysoft::RouteAnalyser::RouteAnalyserWidget::eventFilter(QObject *watched, QEvent *event) -> bool {
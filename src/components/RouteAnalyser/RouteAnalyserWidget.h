@@ -27,6 +27,7 @@
 #pragma warning(push)
 #pragma warning(disable : 4996)
 
+#include "HopModel.h"
 #include "IRouteEngine.h"
 #include "PingData.h"
 #include "PingResult.h"
@@ -42,6 +43,7 @@ namespace Nedrysoft { namespace Core {
     class IHostMasker;
 }}
 
+class QLabel;
 class QTableView;
 class QStandardItemModel;
 class QSplitter;
@@ -126,6 +128,41 @@ namespace Nedrysoft { namespace RouteAnalyser {
                 const int maximumHops
             );
 
+            /**
+             * @brief       Called when a background re-trace finds that the route has changed.
+             *
+             * @details     The hops are updated in place so that the history of every hop is kept, hops that are
+             *              new to the route are added and hops that are no longer part of it stop being monitored.
+             *              The time of the change is marked on the graph of each hop that changed.
+             *
+             * @param[in]   routeHostAddress the intended target of the route analysis.
+             * @param[in]   previousRoute the route before the change.
+             * @param[in]   route the route after the change.
+             * @param[in]   changedTime the time that the change was detected.
+             */
+            Q_SLOT void onRouteChanged(
+                const QHostAddress routeHostAddress,
+                const Nedrysoft::RouteAnalyser::RouteList previousRoute,
+                const Nedrysoft::RouteAnalyser::RouteList route,
+                const QDateTime changedTime
+            );
+
+            /**
+             * @brief       Called when multipath discovery has enumerated the responders for a hop.
+             *
+             * @details     Each responder other than the one on the discovered path is pinged directly and
+             *              shown in its own graph, the responder count of the hop includes every responder.
+             *
+             * @param[in]   routeHostAddress the intended target of the route analysis.
+             * @param[in]   result the responders for each hop that has been enumerated so far.
+             * @param[in]   completed true if every hop has been enumerated; otherwise false.
+             */
+            Q_SLOT void onMultipathResult(
+                const QHostAddress routeHostAddress,
+                const Nedrysoft::RouteAnalyser::MultipathRouteList result,
+                const bool completed
+            );
+
             /**
              * @brief       This signal is emitted when a watched event on a child fires.
              *
@@ -220,6 +257,97 @@ namespace Nedrysoft { namespace RouteAnalyser {
             QMap<Nedrysoft::RouteAnalyser::PingData::Fields, QPair<QString, QString> > &headerMap();
 
             friend class Nedrysoft::RouteAnalyser::RouteAnalyserEditor;
+
+        private:
+            /**
+             * @brief       Creates and starts the ping engine used to monitor the hops of the route.
+             *
+             * @details     The engine is started without any targets, hops are added to it using live target
+             *              add as the route engine reports them.
+             *
+             * @param[in]   routeHostAddress the intended target of the route analysis.
+             * @param[in]   flowId the flow identifier used to discover the route, 0 if unknown.
+             *
+             * @returns     true if the engine was started; otherwise false.
+             */
+            auto startPingEngine(const QHostAddress &routeHostAddress, uint16_t flowId) -> bool;
+
+            /**
+             * @brief       Adds the table row for a discovered hop.
+             *
+             * @param[in]   hop the hop index. (0 based)
+             * @param[in]   host the address of the hop, a null address if the hop did not respond.
+             *
+             * @returns     the masked host name of the hop.
+             */
+            auto addHopRow(int hop, const QHostAddress &host) -> QString;
+
+            /**
+             * @brief       Returns the interned address of a hop of the route that is being shown.
+             *
+             * @param[in]   hop the hop index. (0 based)
+             *
+             * @returns     the identifier of the hop address; NullAddressId if the hop is not known.
+             */
+            auto routeAddressId(int hop) const -> Nedrysoft::RouteAnalyser::AddressId;
+
+            /**
+             * @brief       Sets the interned address of a hop of the route that is being shown.
+             *
+             * @param[in]   hop the hop index. (0 based)
+             * @param[in]   addressId the identifier of the hop address returned by the hop model.
+             */
+            auto setRouteAddressId(int hop, Nedrysoft::RouteAnalyser::AddressId addressId) -> void;
+
+            /**
+             * @brief       Sets the host information that is displayed for a hop.
+             *
+             * @details     Starts an asynchronous lookup of the host name, applies the host maskers and requests
+             *              the location of the hop.  The address is used as the host name until the lookup
+             *              completes.
+             *
+             * @param[in]   pingData the data for the hop.
+             * @param[in]   hop the hop index. (0 based)
+             * @param[in]   host the address of the hop, a null address if the hop did not respond.
+             *
+             * @returns     the masked host name of the hop.
+             */
+            auto setHopHost(
+                Nedrysoft::RouteAnalyser::PingData *pingData,
+                int hop,
+                const QHostAddress &host
+            ) -> QString;
+
+            /**
+             * @brief       Sets the host name of a hop and applies the host maskers to it.
+             *
+             * @param[in]   pingData the data for the hop.
+             * @param[in]   hop the hop index. (0 based)
+             * @param[in]   hostName the host name of the hop.
+             *
+             * @returns     the masked host name of the hop.
+             */
+            auto setHopHostName(
+                Nedrysoft::RouteAnalyser::PingData *pingData,
+                int hop,
+                const QString &hostName
+            ) -> QString;
+
+            /**
+             * @brief       Creates the plot for a discovered hop and starts monitoring it.
+             *
+             * @param[in]   pingData the data for the hop.
+             * @param[in]   targetAddress the address that is pinged to monitor the hop.
+             * @param[in]   ttl the ttl of the pings, the hop number (1 based) or 0 to ping the address directly.
+             * @param[in]   maskedHostName the masked host name of the hop.
+             */
+            auto addHopPlot(
+                Nedrysoft::RouteAnalyser::PingData *pingData,
+                const QHostAddress &targetAddress,
+                int ttl,
+                const QString &maskedHostName
+            ) -> void;
+
         private:
             //! @cond
 
@@ -227,7 +355,10 @@ namespace Nedrysoft { namespace RouteAnalyser {
             QList<QCustomPlot *> m_plotList;
             QMap<QCustomPlot *, QCPItemStraightLine *> m_graphLines;
             QMap<QCustomPlot *, QCPBars *> m_barCharts;
+            QMap<QCustomPlot *, QLabel *> m_plotTitles;
+            Nedrysoft::RouteAnalyser::IRouteEngine *m_routeEngine = {};
             Nedrysoft::RouteAnalyser::IPingEngine *m_pingEngine = {};
+            QHostAddress m_routeHostAddress;
             QStandardItemModel *m_tableModel;
             QTableView *m_tableView;
             QSplitter *m_splitter;
@@ -235,11 +366,14 @@ namespace Nedrysoft { namespace RouteAnalyser {
             Nedrysoft::RouteAnalyser::RouteDiscoveryWidget *m_routeDiscoveryWidget;
             Nedrysoft::RouteAnalyser::IPingEngineFactory *m_pingEngineFactory;
             int m_interval;
+            int m_multipathHopCount;
             QList<Nedrysoft::RouteAnalyser::GraphLatencyLayer *> m_backgroundLayers;
             Nedrysoft::RouteAnalyser::RouteTableItemDelegate *m_routeGraphDelegate;
             ScaleMode m_graphScaleMode;
             QTimer *m_layerCleanupTimer;
             QList<PingData *> m_pingData;
+            Nedrysoft::RouteAnalyser::HopModel m_hopModel;
+            QVector<Nedrysoft::RouteAnalyser::AddressId> m_routeAddressIds;
 
             QList<Nedrysoft::RouteAnalyser::IPlot *> m_extraPlots;
 
@@ -0,0 +1,143 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 19/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SingleShotPool.h"
+
+#include <QMutex>
+#include <QRunnable>
+#include <QVector>
+#include <memory>
+
+constexpr auto MaximumSingleShotThreads = 32;
+
+/**
+ * @brief       The SingleShotTask class wraps a function so that it can be run by a QThreadPool.
+ */
+class Nedrysoft::RouteAnalyser::SingleShotTask :
+        public QRunnable {
+
+    public:
+        /**
+         * @brief       Constructs a new SingleShotTask.
+         *
+         * @param[in]   task the function to run.
+         */
+        explicit SingleShotTask(std::function<void()> task) :
+                m_task(std::move(task)) {
+
+        }
+
+        /**
+         * @brief       Runs the task.
+         */
+        auto run() -> void override {
+            m_task();
+        }
+
+    private:
+        std::function<void()> m_task;
+};
+
+Nedrysoft::RouteAnalyser::SingleShotPool::SingleShotPool() {
+    m_threadPool.setMaxThreadCount(MaximumSingleShotThreads);
+}
+
+Nedrysoft::RouteAnalyser::SingleShotPool::~SingleShotPool() {
+    waitForDone();
+}
+
+auto Nedrysoft::RouteAnalyser::SingleShotPool::start(std::function<void()> task) -> void {
+    m_threadPool.start(new Nedrysoft::RouteAnalyser::SingleShotTask(std::move(task)));
+}
+
+auto Nedrysoft::RouteAnalyser::SingleShotPool::singleShot(
+        Nedrysoft::RouteAnalyser::IPingEngine *engine,
+        const Nedrysoft::RouteAnalyser::SingleShotProbeList &probes,
+        double timeout,
+        uint16_t flowId,
+        Nedrysoft::RouteAnalyser::SingleShotCallback callback )
+            -> std::future<QList<Nedrysoft::RouteAnalyser::PingResult> > {
+
+    struct BatchState {
+        QMutex mutex;
+        QVector<Nedrysoft::RouteAnalyser::PingResult> results;
+        int pendingCount;
+        std::promise<QList<Nedrysoft::RouteAnalyser::PingResult> > promise;
+    };
+
+    auto batchState = std::make_shared<BatchState>();
+    auto batchFuture = batchState->promise.get_future();
+
+    if (probes.isEmpty()) {
+        batchState->promise.set_value(QList<Nedrysoft::RouteAnalyser::PingResult>());
+
+        return batchFuture;
+    }
+
+    batchState->results.resize(probes.count());
+    batchState->pendingCount = probes.count();
+
+    /**
+     * the last probe to complete delivers the results, so no thread is left blocked waiting for the batch.
+     */
+
+    for (auto index = 0; index < probes.count(); index++) {
+        auto probe = probes.at(index);
+
+        start([engine, probe, timeout, flowId, callback, batchState, index]() {
+            auto pingResult = Nedrysoft::RouteAnalyser::PingResult();
+
+            if (flowId) {
+                pingResult = engine->singleShot(probe.first, probe.second, timeout, flowId);
+            } else {
+                pingResult = engine->singleShot(probe.first, probe.second, timeout);
+            }
+
+            if (callback) {
+                callback(index, pingResult);
+            }
+
+            QMutexLocker locker(&batchState->mutex);
+
+            batchState->results[index] = pingResult;
+
+            if (--batchState->pendingCount) {
+                return;
+            }
+
+            auto resultList = QList<Nedrysoft::RouteAnalyser::PingResult>();
+
+            for (auto &result : batchState->results) {
+                resultList.append(result);
+            }
+
+            batchState->promise.set_value(resultList);
+        });
+    }
+
+    return batchFuture;
+}
+
+auto Nedrysoft::RouteAnalyser::SingleShotPool::waitForDone() -> void {
+    m_threadPool.waitForDone();
+}
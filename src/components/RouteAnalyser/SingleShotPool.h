@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 19/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PINGNOO_COMPONENTS_ROUTEANALYSER_SINGLESHOTPOOL_H
+#define PINGNOO_COMPONENTS_ROUTEANALYSER_SINGLESHOTPOOL_H
+
+#include "IPingEngine.h"
+#include "RouteAnalyserSpec.h"
+
+#include <QThreadPool>
+#include <functional>
+#include <future>
+
+namespace Nedrysoft { namespace RouteAnalyser {
+    class SingleShotTask;
+
+    /**
+     * @brief       The SingleShotPool class runs the single shot batches of a ping engine.
+     *
+     * @details     Each engine owns a pool so that its batches share a bounded number of threads rather than
+     *              starting a thread per batch or per probe.  Destroying the pool waits for the tasks that are
+     *              running, an engine should call waitForDone before anything that the tasks use is destroyed.
+     *
+     * @class       Nedrysoft::RouteAnalyser::SingleShotPool SingleShotPool.h <SingleShotPool>
+     */
+    class NEDRYSOFT_ROUTEANALYSER_DLLSPEC SingleShotPool {
+        public:
+            /**
+             * @brief       Constructs a new SingleShotPool.
+             */
+            SingleShotPool();
+
+            /**
+             * @brief       Destroys the SingleShotPool.
+             *
+             * @note        Blocks until every task has finished.
+             */
+            ~SingleShotPool();
+
+            /**
+             * @brief       Runs a task on the pool.
+             *
+             * @param[in]   task the task to run.
+             */
+            auto start(std::function<void()> task) -> void;
+
+            /**
+             * @brief       Runs a batch of probes using the blocking single shot of an engine.
+             *
+             * @details     Each probe is run as a separate task, so the probes in the batch are in flight at the
+             *              same time up to the size of the pool.  This is intended for engines which cannot
+             *              multiplex requests themselves.
+             *
+             * @param[in]   engine the engine that sends the probes.
+             * @param[in]   probes the list of probes to send.
+             * @param[in]   timeout time in seconds to wait for each response.
+             * @param[in]   flowId the flow identifier to use for the probes, 0 if the engine should choose.
+             * @param[in]   callback called with the index of the probe and its result as each probe completes,
+             *              may be empty.
+             *
+             * @returns     a future which holds the results in the same order as the probes.
+             */
+            auto singleShot(
+                Nedrysoft::RouteAnalyser::IPingEngine *engine,
+                const Nedrysoft::RouteAnalyser::SingleShotProbeList &probes,
+                double timeout,
+                uint16_t flowId,
+                Nedrysoft::RouteAnalyser::SingleShotCallback callback
+            ) -> std::future<QList<Nedrysoft::RouteAnalyser::PingResult> >;
+
+            /**
+             * @brief       Waits until every task that has been started has finished.
+             */
+            auto waitForDone() -> void;
+
+        private:
+            //! @cond
+
+            QThreadPool m_threadPool;
+
+            //! @endcond
+    };
+}}
+
+#endif // PINGNOO_COMPONENTS_ROUTEANALYSER_SINGLESHOTPOOL_H
@@ -24,6 +24,7 @@
 #include "TargetSettings.h"
 
 #include "IPingEngineFactory.h"
+#include "PacketRateGovernor.h"
 
 #include <QDir>
 #include <QJsonArray>
@@ -36,13 +37,23 @@ constexpr auto ConfigurationFilename = "TargetSettings.json";
 constexpr auto DefaultHostTarget = "1.1.1.1";
 constexpr auto DefaultIPVersion = Nedrysoft::Core::IPVersion::V4;
 constexpr auto DefaultPingInterval = 2.5;
+constexpr auto DefaultPacketRateLimit = 200;
+constexpr auto DefaultByteRateLimit = 0;
+constexpr auto DefaultDiscoveryMode = Nedrysoft::RouteAnalyser::IRouteEngine::DiscoveryMode::FlowStable;
 
 Nedrysoft::RouteAnalyser::TargetSettings::TargetSettings() :
         m_defaultPingEngine(QString()),
         m_defaultHostTarget(DefaultHostTarget),
         m_defaultPingInterval(DefaultPingInterval),
-        m_defaultIPVersion(DefaultIPVersion) {
+        m_defaultIPVersion(DefaultIPVersion),
+        m_packetRateLimit(DefaultPacketRateLimit),
+        m_byteRateLimit(DefaultByteRateLimit),
+        m_discoveryMode(DefaultDiscoveryMode) {
 
+    auto packetRateGovernor = Nedrysoft::RouteAnalyser::PacketRateGovernor::getInstance();
+
+    packetRateGovernor->setPacketRate(m_packetRateLimit);
+    packetRateGovernor->setByteRate(m_byteRateLimit);
 }
 
 Nedrysoft::RouteAnalyser::TargetSettings::~TargetSettings() {
@@ -60,6 +71,9 @@ auto Nedrysoft::RouteAnalyser::TargetSettings::saveConfiguration() -> QJsonObjec
     targetObject.insert("defaultPingEngine", m_defaultPingEngine);
     targetObject.insert("pingInterval", m_defaultPingInterval);
     targetObject.insert("ipVersion", static_cast<int>(m_defaultIPVersion));
+    targetObject.insert("packetRateLimit", m_packetRateLimit);
+    targetObject.insert("byteRateLimit", m_byteRateLimit);
+    targetObject.insert("discoveryMode", static_cast<int>(m_discoveryMode));
 
     rootObject.insert("target", targetObject);
 
@@ -89,6 +103,22 @@ auto Nedrysoft::RouteAnalyser::TargetSettings::loadConfiguration(QJsonObject con
         if (targetObject.contains("ipVersion")) {
             m_defaultIPVersion = static_cast<Nedrysoft::Core::IPVersion>(targetObject["ipVersion"].toInt());
         }
+
+        if (targetObject.contains("packetRateLimit")) {
+            setPacketRateLimit(targetObject["packetRateLimit"].toInt());
+        }
+
+        if (targetObject.contains("byteRateLimit")) {
+            setByteRateLimit(targetObject["byteRateLimit"].toInt());
+        }
+
+        if (targetObject.contains("discoveryMode")) {
+            setDiscoveryMode(
+                static_cast<Nedrysoft::RouteAnalyser::IRouteEngine::DiscoveryMode>(
+                    targetObject["discoveryMode"].toInt()
+                )
+            );
+        }
     }
 
     return true;
@@ -222,3 +252,49 @@ auto Nedrysoft::RouteAnalyser::TargetSettings::setDefaultIPVersion(Nedrysoft::Co
 auto Nedrysoft::RouteAnalyser::TargetSettings::defaultIPVersion() -> Nedrysoft::Core::IPVersion {
     return m_defaultIPVersion;
 }
+
+auto Nedrysoft::RouteAnalyser::TargetSettings::setPacketRateLimit(int packetsPerSecond) -> void {
+    m_packetRateLimit = qMax(0, packetsPerSecond);
+
+    Nedrysoft::RouteAnalyser::PacketRateGovernor::getInstance()->setPacketRate(m_packetRateLimit);
+}
+
+auto Nedrysoft::RouteAnalyser::TargetSettings::packetRateLimit() -> int {
+    return m_packetRateLimit;
+}
+
+auto Nedrysoft::RouteAnalyser::TargetSettings::setByteRateLimit(int bytesPerSecond) -> void {
+    m_byteRateLimit = qMax(0, bytesPerSecond);
+
+    Nedrysoft::RouteAnalyser::PacketRateGovernor::getInstance()->setByteRate(m_byteRateLimit);
+}
+
+auto Nedrysoft::RouteAnalyser::TargetSettings::byteRateLimit() -> int {
+    return m_byteRateLimit;
+}
+
+auto Nedrysoft::RouteAnalyser::TargetSettings::setDiscoveryMode(
+        Nedrysoft::RouteAnalyser::IRouteEngine::DiscoveryMode mode) -> void {
+
+    switch (mode) {
+        case Nedrysoft::RouteAnalyser::IRouteEngine::DiscoveryMode::Classic:
+        case Nedrysoft::RouteAnalyser::IRouteEngine::DiscoveryMode::FlowStable:
+        case Nedrysoft::RouteAnalyser::IRouteEngine::DiscoveryMode::Multipath: {
+            m_discoveryMode = mode;
+
+            break;
+        }
+
+        default: {
+            m_discoveryMode = DefaultDiscoveryMode;
+
+            break;
+        }
+    }
+}
+
+auto Nedrysoft::RouteAnalyser::TargetSettings::discoveryMode()
+        -> Nedrysoft::RouteAnalyser::IRouteEngine::DiscoveryMode {
+
+    return m_discoveryMode;
+}
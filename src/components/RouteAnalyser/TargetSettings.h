@@ -24,6 +24,8 @@
 #ifndef PINGNOO_COMPONENTS_ROUTEANALYSER_TARGETSETTINGS_H
 #define PINGNOO_COMPONENTS_ROUTEANALYSER_TARGETSETTINGS_H
 
+#include "IRouteEngine.h"
+
 #include <ICore>
 #include <IConfiguration>
 
@@ -129,6 +131,55 @@ namespace Nedrysoft { namespace RouteAnalyser {
              */
              auto defaultIPVersion() -> Nedrysoft::Core::IPVersion;
 
+            /**
+             * @brief       Sets the maximum number of packets per second sent by all targets combined.
+             *
+             * @note        The limit is applied to the packet rate governor immediately.
+             *
+             * @param[in]   packetsPerSecond the packet rate limit, 0 for unlimited.
+             */
+            auto setPacketRateLimit(int packetsPerSecond) -> void;
+
+            /**
+             * @brief       Returns the maximum number of packets per second sent by all targets combined.
+             *
+             * @returns     the packet rate limit, 0 if unlimited.
+             */
+            auto packetRateLimit() -> int;
+
+            /**
+             * @brief       Sets the maximum number of bytes per second sent by all targets combined.
+             *
+             * @note        The limit is applied to the packet rate governor immediately.
+             *
+             * @param[in]   bytesPerSecond the byte rate limit, 0 for unlimited.
+             */
+            auto setByteRateLimit(int bytesPerSecond) -> void;
+
+            /**
+             * @brief       Returns the maximum number of bytes per second sent by all targets combined.
+             *
+             * @returns     the byte rate limit, 0 if unlimited.
+             */
+            auto byteRateLimit() -> int;
+
+            /**
+             * @brief       Sets the method used to discover the route to a new target.
+             *
+             * @details     In Multipath mode every responder found at a hop is monitored, not only the responder
+             *              on the path that was discovered.
+             *
+             * @param[in]   mode the discovery mode.
+             */
+            auto setDiscoveryMode(Nedrysoft::RouteAnalyser::IRouteEngine::DiscoveryMode mode) -> void;
+
+            /**
+             * @brief       Returns the method used to discover the route to a new target.
+             *
+             * @returns     the discovery mode.
+             */
+            auto discoveryMode() -> Nedrysoft::RouteAnalyser::IRouteEngine::DiscoveryMode;
+
         public:
             /**
               * @brief       Saves the configuration to a JSON object.
@@ -153,6 +204,9 @@ namespace Nedrysoft { namespace RouteAnalyser {
             QString m_defaultHostTarget;
             double m_defaultPingInterval;
             Nedrysoft::Core::IPVersion m_defaultIPVersion;
+            int m_packetRateLimit;
+            int m_byteRateLimit;
+            Nedrysoft::RouteAnalyser::IRouteEngine::DiscoveryMode m_discoveryMode;
 
             //! @endcond
 
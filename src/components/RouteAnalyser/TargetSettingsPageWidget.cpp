@@ -24,6 +24,7 @@
 #include "TargetSettingsPageWidget.h"
 
 #include "IPingEngineFactory.h"
+#include "PacketRateGovernor.h"
 #include "TargetSettings.h"
 #include "Utils.h"
 
@@ -32,6 +33,8 @@
 #include <IComponentManager>
 #include <cassert>
 
+constexpr auto ThrottleDisplayThreshold = 0.01;
+
 Nedrysoft::RouteAnalyser::TargetSettingsPageWidget::TargetSettingsPageWidget(QWidget *parent) :
         QWidget(parent),
         ui(new Ui::TargetSettingsPageWidget) {
@@ -50,6 +53,18 @@ Nedrysoft::RouteAnalyser::TargetSettingsPageWidget::TargetSettingsPageWidget(QWi
         sortedPingEngines.insert(1-factory->priority(), factory);
     }
 
+    ui->discoveryModeComboBox->addItem(
+            tr("Classic"),
+            static_cast<int>(Nedrysoft::RouteAnalyser::IRouteEngine::DiscoveryMode::Classic) );
+
+    ui->discoveryModeComboBox->addItem(
+            tr("Flow Stable"),
+            static_cast<int>(Nedrysoft::RouteAnalyser::IRouteEngine::DiscoveryMode::FlowStable) );
+
+    ui->discoveryModeComboBox->addItem(
+            tr("Multipath"),
+            static_cast<int>(Nedrysoft::RouteAnalyser::IRouteEngine::DiscoveryMode::Multipath) );
+
     if (targetSettings) {
         ui->defaultTargetLineEdit->setText(targetSettings->defaultHost());
         ui->defaultIntervalLineEdit->setText(Nedrysoft::Utils::intervalToString(targetSettings->defaultPingInterval()));
@@ -71,7 +86,27 @@ Nedrysoft::RouteAnalyser::TargetSettingsPageWidget::TargetSettingsPageWidget(QWi
         }
 
         ui->defaultEngineComboBox->setCurrentIndex(selectionIndex);
+
+        ui->packetRateLimitSpinBox->setValue(targetSettings->packetRateLimit());
+        ui->byteRateLimitSpinBox->setValue(targetSettings->byteRateLimit());
+
+        ui->discoveryModeComboBox->setCurrentIndex(
+                ui->discoveryModeComboBox->findData(static_cast<int>(targetSettings->discoveryMode())) );
     }
+
+    auto packetRateGovernor = Nedrysoft::RouteAnalyser::PacketRateGovernor::getInstance();
+
+    /**
+     * the governor reports changes from the thread that sent the packet, the connection is queued to this widget.
+     */
+
+    connect(packetRateGovernor,
+            &Nedrysoft::RouteAnalyser::PacketRateGovernor::throttleLevelChanged,
+            this,
+            &Nedrysoft::RouteAnalyser::TargetSettingsPageWidget::updateThrottleLevel,
+            Qt::QueuedConnection);
+
+    updateThrottleLevel(packetRateGovernor->throttleLevel());
 }
 
 Nedrysoft::RouteAnalyser::TargetSettingsPageWidget::~TargetSettingsPageWidget() {
@@ -96,6 +131,20 @@ auto Nedrysoft::RouteAnalyser::TargetSettingsPageWidget::acceptSettings() -> voi
     targetSettings->setDefaultPingEngine(ui->defaultEngineComboBox->currentData().toString());
     targetSettings->setDefaultIPVersion(
             ui->ipV4RadioButton->isChecked() ? Nedrysoft::Core::IPVersion::V4 : Nedrysoft::Core::IPVersion::V6);
+    targetSettings->setPacketRateLimit(ui->packetRateLimitSpinBox->value());
+    targetSettings->setByteRateLimit(ui->byteRateLimitSpinBox->value());
+    targetSettings->setDiscoveryMode(
+            static_cast<Nedrysoft::RouteAnalyser::IRouteEngine::DiscoveryMode>(
+                    ui->discoveryModeComboBox->currentData().toInt() ) );
 
     targetSettings->saveToFile();
 }
+
+auto Nedrysoft::RouteAnalyser::TargetSettingsPageWidget::updateThrottleLevel(double level) -> void {
+    if (level<ThrottleDisplayThreshold) {
+        ui->throttleLevelValueLabel->setText(tr("None"));
+    } else {
+        ui->throttleLevelValueLabel->setText(
+                tr("%1% of packets delayed by the rate limits").arg(qRound(level*100.0)) );
+    }
+}
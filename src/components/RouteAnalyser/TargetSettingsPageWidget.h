@@ -67,6 +67,14 @@ namespace Nedrysoft { namespace RouteAnalyser {
              */
             auto acceptSettings() -> void;
 
+        private:
+            /**
+             * @brief       Updates the throttle label with the current throttle level of the packet rate governor.
+             *
+             * @param[in]   level the throttle level between 0 and 1.
+             */
+            auto updateThrottleLevel(double level) -> void;
+
         private:
             //! @cond
 
@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 19/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BulkRouteDiscovery.h"
+
+Nedrysoft::RouteEngine::BulkRouteDiscovery::BulkRouteDiscovery(const QStringList &hosts) :
+        m_hosts(hosts),
+        m_probeCount(0) {
+
+}
+
+auto Nedrysoft::RouteEngine::BulkRouteDiscovery::takeTarget(QString &host) -> bool {
+    QMutexLocker locker(&m_mutex);
+
+    if (m_hosts.isEmpty()) {
+        return false;
+    }
+
+    host = m_hosts.takeFirst();
+
+    return true;
+}
+
+auto Nedrysoft::RouteEngine::BulkRouteDiscovery::findRoute(
+        const QHostAddress &hostAddress,
+        int hop,
+        Nedrysoft::RouteAnalyser::RouteList &route ) -> bool {
+
+    QMutexLocker locker(&m_mutex);
+
+    auto stopSetIterator = m_stopSet.constFind(qMakePair(hostAddress.toString(), hop));
+
+    if (stopSetIterator==m_stopSet.constEnd()) {
+        return false;
+    }
+
+    route = stopSetIterator.value();
+
+    return true;
+}
+
+auto Nedrysoft::RouteEngine::BulkRouteDiscovery::addRoute(const Nedrysoft::RouteAnalyser::RouteList &route) -> void {
+    QMutexLocker locker(&m_mutex);
+
+    /**
+     * the first route seen through an interface is kept, so routes that are found later share their early hops
+     * with it rather than replacing it.
+     */
+
+    for (int hop=0;hop<route.count();hop++) {
+        if (route.at(hop).isNull()) {
+            continue;
+        }
+
+        auto key = qMakePair(route.at(hop).toString(), hop+1);
+
+        if (!m_stopSet.contains(key)) {
+            m_stopSet.insert(key, route.mid(0, hop+1));
+        }
+    }
+}
+
+auto Nedrysoft::RouteEngine::BulkRouteDiscovery::addProbes(int probeCount) -> void {
+    QMutexLocker locker(&m_mutex);
+
+    m_probeCount += probeCount;
+}
+
+auto Nedrysoft::RouteEngine::BulkRouteDiscovery::probeCount() -> int {
+    QMutexLocker locker(&m_mutex);
+
+    return m_probeCount;
+}
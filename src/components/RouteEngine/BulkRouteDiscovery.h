@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 19/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PINGNOO_COMPONENTS_ROUTEENGINE_BULKROUTEDISCOVERY_H
+#define PINGNOO_COMPONENTS_ROUTEENGINE_BULKROUTEDISCOVERY_H
+
+#include <IRouteEngine>
+
+#include <QHash>
+#include <QHostAddress>
+#include <QMutex>
+#include <QPair>
+#include <QStringList>
+
+namespace Nedrysoft { namespace RouteEngine {
+    /**
+     * @brief       The BulkRouteDiscovery class holds the state shared by the workers of a bulk route discovery.
+     *
+     * @details     The workers take targets from a shared queue so that a fixed number of workers can discover
+     *              the routes to any number of targets.  The routes they find are added to a Doubletree stop set,
+     *              which records every interface seen at each hop along with the route leading to it.  When a
+     *              later trace probing backwards from the middle of its route reaches an interface that is in the
+     *              stop set, the rest of the route is already known and backward probing stops.
+     */
+    class BulkRouteDiscovery {
+        public:
+            /**
+             * @brief       Constructs a BulkRouteDiscovery for a list of targets.
+             *
+             * @param[in]   hosts the host names or addresses of the targets.
+             */
+            explicit BulkRouteDiscovery(const QStringList &hosts);
+
+            /**
+             * @brief       Takes the next target from the queue.
+             *
+             * @param[out]  host the host name or address of the target.
+             *
+             * @returns     true if a target was taken; false if the queue is empty.
+             */
+            auto takeTarget(QString &host) -> bool;
+
+            /**
+             * @brief       Finds the route that leads to an interface at a hop.
+             *
+             * @param[in]   hostAddress the address of the interface.
+             * @param[in]   hop the hop that the interface was seen at. (1 based)
+             * @param[out]  route the route up to and including the interface.
+             *
+             * @returns     true if the interface is in the stop set; otherwise false.
+             */
+            auto findRoute(
+                const QHostAddress &hostAddress,
+                int hop,
+                Nedrysoft::RouteAnalyser::RouteList &route
+            ) -> bool;
+
+            /**
+             * @brief       Adds the interfaces of a discovered route to the stop set.
+             *
+             * @param[in]   route the discovered route.
+             */
+            auto addRoute(const Nedrysoft::RouteAnalyser::RouteList &route) -> void;
+
+            /**
+             * @brief       Adds to the number of probes that have been sent by the workers.
+             *
+             * @param[in]   probeCount the number of probes sent.
+             */
+            auto addProbes(int probeCount) -> void;
+
+            /**
+             * @brief       Returns the number of probes that have been sent by the workers.
+             *
+             * @returns     the number of probes.
+             */
+            auto probeCount() -> int;
+
+        private:
+            //! @cond
+
+            QMutex m_mutex;
+            QStringList m_hosts;
+            QHash<QPair<QString, int>, Nedrysoft::RouteAnalyser::RouteList> m_stopSet;
+            int m_probeCount;
+
+            //! @endcond
+    };
+}}
+
+#endif // PINGNOO_COMPONENTS_ROUTEENGINE_BULKROUTEDISCOVERY_H
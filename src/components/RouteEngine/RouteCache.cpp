@@ -0,0 +1,249 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 19/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "RouteCache.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QNetworkInterface>
+#include <QSaveFile>
+#include <QUdpSocket>
+
+constexpr auto ConfigurationPath = "Nedrysoft/Pingnoo/Components/RouteEngine";
+constexpr auto ConfigurationFilename = "RouteCache.json";
+constexpr auto MaximumCachedRoutes = 256;
+constexpr auto MaximumRouteAge = 30*24*60*60;
+constexpr auto DiscardPort = 9;
+constexpr auto ConnectTimeout = 100;
+
+Nedrysoft::RouteEngine::RouteCache::RouteCache() {
+    auto storageFolder = Nedrysoft::Core::ICore::getInstance()->storageFolder();
+
+    m_filename = QDir::cleanPath(
+        QString("%1/%2/%3")
+            .arg(storageFolder)
+            .arg(ConfigurationPath)
+            .arg(ConfigurationFilename)
+    );
+
+    QFile cacheFile(m_filename);
+
+    if (!cacheFile.open(QFile::ReadOnly)) {
+        return;
+    }
+
+    auto jsonDocument = QJsonDocument::fromJson(cacheFile.readAll());
+
+    if (!jsonDocument.isObject()) {
+        return;
+    }
+
+    for (auto routeValue : jsonDocument.object()["routes"].toArray()) {
+        auto routeObject = routeValue.toObject();
+
+        auto key = QString("%1|%2|%3")
+            .arg(routeObject["host"].toString())
+            .arg(routeObject["ipVersion"].toInt())
+            .arg(routeObject["interface"].toString());
+
+        m_routes[key] = routeObject;
+    }
+}
+
+auto Nedrysoft::RouteEngine::RouteCache::getInstance() -> Nedrysoft::RouteEngine::RouteCache * {
+    static auto instance = new Nedrysoft::RouteEngine::RouteCache;
+
+    return instance;
+}
+
+auto Nedrysoft::RouteEngine::RouteCache::find(
+        const QString &host,
+        Nedrysoft::Core::IPVersion ipVersion,
+        QHostAddress &targetAddress,
+        Nedrysoft::RouteAnalyser::RouteList &route ) -> bool {
+
+    auto oldestUpdate = QDateTime::currentSecsSinceEpoch()-MaximumRouteAge;
+    auto candidateRoutes = QList<QJsonObject>();
+
+    m_mutex.lock();
+
+    for (auto routeObject : m_routes) {
+        if ((routeObject["host"].toString()!=host) ||
+            (routeObject["ipVersion"].toInt()!=static_cast<int>(ipVersion))) {
+
+            continue;
+        }
+
+        if (static_cast<qint64>(routeObject["updated"].toDouble())<oldestUpdate) {
+            continue;
+        }
+
+        candidateRoutes.append(routeObject);
+    }
+
+    m_mutex.unlock();
+
+    if (candidateRoutes.isEmpty()) {
+        return false;
+    }
+
+    /**
+     * an entry is only used if the target is still reached through the same interface, otherwise the route
+     * almost certainly belongs to another network.  Finding the interface opens a socket, so it is found once
+     * without the lock held, every candidate is for the same host so they share the outgoing interface.
+     */
+
+    auto currentInterface = interfaceName(QHostAddress(candidateRoutes.first()["target"].toString()));
+    auto foundRoute = QJsonObject();
+
+    for (auto routeObject : candidateRoutes) {
+        if (routeObject["interface"].toString()!=currentInterface) {
+            continue;
+        }
+
+        if ((!foundRoute.isEmpty()) && (routeObject["updated"].toDouble()<=foundRoute["updated"].toDouble())) {
+            continue;
+        }
+
+        foundRoute = routeObject;
+    }
+
+    if (foundRoute.isEmpty()) {
+        return false;
+    }
+
+    targetAddress = QHostAddress(foundRoute["target"].toString());
+
+    route.clear();
+
+    for (auto hopValue : foundRoute["route"].toArray()) {
+        route.append(QHostAddress(hopValue.toString()));
+    }
+
+    return (!targetAddress.isNull()) && (!route.isEmpty());
+}
+
+auto Nedrysoft::RouteEngine::RouteCache::add(
+        const QString &host,
+        Nedrysoft::Core::IPVersion ipVersion,
+        const QHostAddress &targetAddress,
+        const Nedrysoft::RouteAnalyser::RouteList &route ) -> void {
+
+    if ((targetAddress.isNull()) || (route.isEmpty())) {
+        return;
+    }
+
+    auto routeInterface = interfaceName(targetAddress);
+    auto hops = QJsonArray();
+
+    /**
+     * hops that did not respond are stored as empty strings, which are read back as null addresses.
+     */
+
+    for (auto hop : route) {
+        hops.append(hop.isNull() ? QString() : hop.toString());
+    }
+
+    auto routeObject = QJsonObject();
+
+    routeObject["host"] = host;
+    routeObject["ipVersion"] = static_cast<int>(ipVersion);
+    routeObject["interface"] = routeInterface;
+    routeObject["target"] = targetAddress.toString();
+    routeObject["route"] = hops;
+    routeObject["updated"] = static_cast<double>(QDateTime::currentSecsSinceEpoch());
+
+    QMutexLocker locker(&m_mutex);
+
+    m_routes[QString("%1|%2|%3").arg(host).arg(static_cast<int>(ipVersion)).arg(routeInterface)] = routeObject;
+
+    while (m_routes.count()>MaximumCachedRoutes) {
+        auto oldestRoute = m_routes.begin();
+
+        for (auto routeIterator = m_routes.begin();routeIterator!=m_routes.end();routeIterator++) {
+            if (routeIterator.value()["updated"].toDouble()<oldestRoute.value()["updated"].toDouble()) {
+                oldestRoute = routeIterator;
+            }
+        }
+
+        m_routes.erase(oldestRoute);
+    }
+
+    save();
+}
+
+auto Nedrysoft::RouteEngine::RouteCache::interfaceName(const QHostAddress &hostAddress) -> QString {
+    QUdpSocket socket;
+
+    socket.connectToHost(hostAddress, DiscardPort);
+
+    if (!socket.waitForConnected(ConnectTimeout)) {
+        return QString();
+    }
+
+    auto localAddress = socket.localAddress();
+
+    for (auto networkInterface : QNetworkInterface::allInterfaces()) {
+        for (auto addressEntry : networkInterface.addressEntries()) {
+            if (addressEntry.ip().isEqual(localAddress)) {
+                return networkInterface.name();
+            }
+        }
+    }
+
+    return QString();
+}
+
+auto Nedrysoft::RouteEngine::RouteCache::save() -> void {
+    auto routes = QJsonArray();
+
+    for (auto routeObject : m_routes) {
+        routes.append(routeObject);
+    }
+
+    auto cacheObject = QJsonObject();
+
+    cacheObject["routes"] = routes;
+
+    QDir dir(QFileInfo(m_filename).absolutePath());
+
+    if (!dir.exists()) {
+        dir.mkpath(dir.absolutePath());
+    }
+
+    /**
+     * the cache is written to a temporary file and then renamed, so a crash part way through a write never
+     * leaves a truncated cache behind.
+     */
+
+    QSaveFile cacheFile(m_filename);
+
+    if (cacheFile.open(QFile::WriteOnly)) {
+        cacheFile.write(QJsonDocument(cacheObject).toJson(QJsonDocument::Compact));
+        cacheFile.commit();
+    }
+}
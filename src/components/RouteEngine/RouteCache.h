@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 19/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PINGNOO_COMPONENTS_ROUTEENGINE_ROUTECACHE_H
+#define PINGNOO_COMPONENTS_ROUTEENGINE_ROUTECACHE_H
+
+#include <ICore>
+#include <IRouteEngine>
+
+#include <QHostAddress>
+#include <QJsonObject>
+#include <QMap>
+#include <QMutex>
+
+namespace Nedrysoft { namespace RouteEngine {
+    /**
+     * @brief       The RouteCache class stores the last known route to each target on disk.
+     *
+     * @details     Routes are stored per target, IP version and the network interface that is used to reach the
+     *              target, so that moving between networks does not reuse a route from another network.  The
+     *              cache allows a target to be monitored as soon as it is opened while the route is validated in
+     *              the background.
+     */
+    class RouteCache {
+        public:
+            /**
+             * @brief       Returns the RouteCache instance.
+             *
+             * @returns     the route cache.
+             */
+            static auto getInstance() -> Nedrysoft::RouteEngine::RouteCache *;
+
+            /**
+             * @brief       Finds the last known route to a host.
+             *
+             * @details     Only an entry that was stored for the interface that the target is currently reached
+             *              through is returned, if more than one matches then the most recent is used.
+             *
+             * @param[in]   host the host name or address of the target.
+             * @param[in]   ipVersion the IP version used for discovery.
+             * @param[out]  targetAddress the address of the target when the route was stored.
+             * @param[out]  route the route to the target.
+             *
+             * @returns     true if a route was found; otherwise false.
+             */
+            auto find(
+                const QString &host,
+                Nedrysoft::Core::IPVersion ipVersion,
+                QHostAddress &targetAddress,
+                Nedrysoft::RouteAnalyser::RouteList &route
+            ) -> bool;
+
+            /**
+             * @brief       Stores the route to a host, replacing any route stored for the same interface.
+             *
+             * @param[in]   host the host name or address of the target.
+             * @param[in]   ipVersion the IP version used for discovery.
+             * @param[in]   targetAddress the address of the target.
+             * @param[in]   route the route to the target.
+             */
+            auto add(
+                const QString &host,
+                Nedrysoft::Core::IPVersion ipVersion,
+                const QHostAddress &targetAddress,
+                const Nedrysoft::RouteAnalyser::RouteList &route
+            ) -> void;
+
+        private:
+            /**
+             * @brief       Constructs a RouteCache and loads the stored routes.
+             */
+            RouteCache();
+
+            /**
+             * @brief       Returns the name of the network interface that is used to reach an address.
+             *
+             * @details     A UDP socket is connected to the address, which selects the outgoing interface without
+             *              sending any packets.
+             *
+             * @param[in]   hostAddress the address to be reached.
+             *
+             * @returns     the name of the interface if found; otherwise an empty string.
+             */
+            static auto interfaceName(const QHostAddress &hostAddress) -> QString;
+
+            /**
+             * @brief       Writes the stored routes to disk.
+             *
+             * @note        The mutex must be held by the caller.
+             */
+            auto save() -> void;
+
+        private:
+            //! @cond
+
+            QMutex m_mutex;
+            QMap<QString, QJsonObject> m_routes;
+            QString m_filename;
+
+            //! @endcond
+    };
+}}
+
+#endif // PINGNOO_COMPONENTS_ROUTEENGINE_ROUTECACHE_H
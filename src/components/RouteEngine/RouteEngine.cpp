@@ -26,6 +26,7 @@
 #include <IPingEngine>
 #include <IPingEngineFactory>
 #include <IPingTarget>
+#include "BulkRouteDiscovery.h"
 #include "RouteEngineWorker.h"
 
 #include <QThread>
@@ -33,10 +34,34 @@
 
 #include <cassert>
 
+constexpr auto BulkDiscoveryWorkers = 8;
+
 Nedrysoft::RouteEngine::RouteEngine::RouteEngine() :
         m_routeWorkerThread(nullptr),
-        m_routeWorker(nullptr) {
+        m_routeWorker(nullptr),
+        m_discoveryMode(Nedrysoft::RouteAnalyser::IRouteEngine::DiscoveryMode::FlowStable),
+        m_flowId(Nedrysoft::Core::ICore::getInstance()->random(1.0, UINT16_MAX-1)),
+        m_retraceInterval(std::make_shared<std::atomic<int> >(0)) {
+
+}
+
+auto Nedrysoft::RouteEngine::RouteEngine::setDiscoveryMode(
+        Nedrysoft::RouteAnalyser::IRouteEngine::DiscoveryMode mode) -> void {
+
+    m_discoveryMode = mode;
+}
+
+auto Nedrysoft::RouteEngine::RouteEngine::flowId() -> uint16_t {
+    return m_flowId;
+}
 
+auto Nedrysoft::RouteEngine::RouteEngine::setRetraceInterval(int interval) -> void {
+    /**
+     * the interval is shared with the worker rather than passed to it, the worker may already have finished and
+     * deleted itself so it must never be referenced after it has been started.
+     */
+
+    m_retraceInterval->store(qMax(0, interval));
 }
 
 auto Nedrysoft::RouteEngine::RouteEngine::findRoute(
@@ -44,7 +69,15 @@ auto Nedrysoft::RouteEngine::RouteEngine::findRoute(
         QString host,
         Nedrysoft::Core::IPVersion ipVersion) -> void {
 
-    m_routeWorker = new Nedrysoft::RouteEngine::RouteEngineWorker(host, engineFactory, ipVersion);
+    m_routeWorker = new Nedrysoft::RouteEngine::RouteEngineWorker(
+        host,
+        engineFactory,
+        ipVersion,
+        m_discoveryMode,
+        m_flowId
+    );
+
+    m_routeWorker->setRetraceInterval(m_retraceInterval);
 
     m_routeWorkerThread = new QThread();
 
@@ -68,5 +101,64 @@ auto Nedrysoft::RouteEngine::RouteEngine::findRoute(
             this,
             &Nedrysoft::RouteEngine::RouteEngine::result );
 
+    connect(m_routeWorker,
+            &Nedrysoft::RouteEngine::RouteEngineWorker::multipathResult,
+            this,
+            &Nedrysoft::RouteEngine::RouteEngine::multipathResult );
+
+    connect(m_routeWorker,
+            &Nedrysoft::RouteEngine::RouteEngineWorker::routeChanged,
+            this,
+            &Nedrysoft::RouteEngine::RouteEngine::routeChanged );
+
     m_routeWorkerThread->start();
 }
+
+auto Nedrysoft::RouteEngine::RouteEngine::findRoutes(
+        Nedrysoft::RouteAnalyser::IPingEngineFactory *engineFactory,
+        QStringList hosts,
+        Nedrysoft::Core::IPVersion ipVersion) -> void {
+
+    auto bulkDiscovery = std::make_shared<Nedrysoft::RouteEngine::BulkRouteDiscovery>(hosts);
+
+    /**
+     * the number of workers is fixed no matter how many hosts there are, each worker takes the next host from
+     * the shared queue when it finishes a route.
+     */
+
+    for (int workerIndex=0;workerIndex<qMin(BulkDiscoveryWorkers, hosts.count());workerIndex++) {
+        auto routeWorker = new Nedrysoft::RouteEngine::RouteEngineWorker(
+            QString(),
+            engineFactory,
+            ipVersion,
+            m_discoveryMode,
+            m_flowId
+        );
+
+        routeWorker->setBulkDiscovery(bulkDiscovery);
+
+        auto routeWorkerThread = new QThread();
+
+        routeWorker->moveToThread(routeWorkerThread);
+
+        connect(routeWorkerThread,
+            &QThread::started,
+            routeWorker,
+            &Nedrysoft::RouteEngine::RouteEngineWorker::doBulkWork
+        );
+
+        connect(
+            routeWorkerThread,
+            &QThread::finished,
+            routeWorkerThread,
+            &QObject::deleteLater
+        );
+
+        connect(routeWorker,
+                &Nedrysoft::RouteEngine::RouteEngineWorker::bulkResult,
+                this,
+                &Nedrysoft::RouteEngine::RouteEngine::bulkResult );
+
+        routeWorkerThread->start();
+    }
+}
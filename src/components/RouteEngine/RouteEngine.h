@@ -31,6 +31,8 @@
 #include <QHostAddress>
 #include <QHostInfo>
 #include <QList>
+#include <atomic>
+#include <memory>
 
 class QThread;
 
@@ -78,11 +80,56 @@ namespace Nedrysoft { namespace RouteEngine {
                     Nedrysoft::Core::IPVersion ipVersion = Nedrysoft::Core::IPVersion::V4
             ) -> void override;
 
+            /**
+             * @brief       Starts route discovery for a list of hosts.
+             *
+             * @see         Nedrysoft::RouteAnalyser::IRouteEngine::findRoutes
+             *
+             * @param[in]   engineFactory the ping engine to be used for route discovery.
+             * @param[in]   hosts the target host names or addresses.
+             * @param[in]   ipVersion the IP version to be used for discovery.
+             */
+            auto findRoutes(
+                    Nedrysoft::RouteAnalyser::IPingEngineFactory *engineFactory,
+                    QStringList hosts,
+                    Nedrysoft::Core::IPVersion ipVersion = Nedrysoft::Core::IPVersion::V4
+            ) -> void override;
+
+            /**
+             * @brief       Sets the discovery mode to be used by findRoute.
+             *
+             * @see         Nedrysoft::RouteAnalyser::IRouteEngine::setDiscoveryMode
+             *
+             * @param[in]   mode the discovery mode.
+             */
+            auto setDiscoveryMode(Nedrysoft::RouteAnalyser::IRouteEngine::DiscoveryMode mode) -> void override;
+
+            /**
+             * @brief       Returns the flow identifier used for flow stable discovery.
+             *
+             * @see         Nedrysoft::RouteAnalyser::IRouteEngine::flowId
+             *
+             * @returns     the flow identifier.
+             */
+            auto flowId() -> uint16_t override;
+
+            /**
+             * @brief       Sets the interval between background re-traces of a discovered route.
+             *
+             * @see         Nedrysoft::RouteAnalyser::IRouteEngine::setRetraceInterval
+             *
+             * @param[in]   interval the interval in milliseconds, 0 to disable re-tracing.
+             */
+            auto setRetraceInterval(int interval) -> void override;
+
         private:
             //! @cond
 
             Nedrysoft::RouteEngine::RouteEngineWorker *m_routeWorker;
             QThread *m_routeWorkerThread;
+            Nedrysoft::RouteAnalyser::IRouteEngine::DiscoveryMode m_discoveryMode;
+            uint16_t m_flowId;
+            std::shared_ptr<std::atomic<int> > m_retraceInterval;
 
             //! @endcond
     };
@@ -23,24 +23,55 @@
 
 #include "RouteEngineWorker.h"
 
+#include "BulkRouteDiscovery.h"
+#include "HostResolver/HostResolver.h"
+#include "RouteCache.h"
+#include <HopModel>
 #include <IPingEngine>
 #include <IPingEngineFactory>
 #include "spdlog.h"
 
-#include <QHostInfo>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QVector>
+#include <QWaitCondition>
+#include <future>
+#include <vector>
 
 constexpr auto DefaultDiscoveryTimeout = 1.0;
+constexpr auto MinimumDiscoveryTimeout = 0.05;
+constexpr auto MaximumDiscoveryTimeout = 5.0;
+constexpr auto DefaultDiscoveryWaveSize = 16;
 constexpr auto MaxRouteHops = 64;
+constexpr auto ResolveTimeout = 10000;
+constexpr auto RetraceWaveSize = 4;
+constexpr auto RetraceSleepInterval = 100;
+constexpr auto DoubletreeStartHop = 10;
+constexpr auto BackwardWaveSize = 4;
+
+/**
+ * the number of probes that must be sent to a hop which has shown k responders (index k-1) before a further
+ * responder can be ruled out with 95% confidence, from the Multipath Detection Algorithm.
+ */
+
+constexpr int MultipathProbeCount[] = {6, 11, 16, 21, 27, 33, 38, 44, 51, 57, 63, 70, 76, 83, 90, 96};
+constexpr int MaxMultipathResponders = sizeof(MultipathProbeCount)/sizeof(MultipathProbeCount[0]);
 
 Nedrysoft::RouteEngine::RouteEngineWorker::RouteEngineWorker(
         QString host,
         Nedrysoft::RouteAnalyser::IPingEngineFactory *pingEngineFactory,
-        Nedrysoft::Core::IPVersion ipVersion ) :
+        Nedrysoft::Core::IPVersion ipVersion,
+        Nedrysoft::RouteAnalyser::IRouteEngine::DiscoveryMode discoveryMode,
+        uint16_t flowId ) :
             m_host(host),
             m_ipVersion(ipVersion),
+            m_discoveryMode(discoveryMode),
+            m_flowId(flowId),
             m_pingEngineFactory(pingEngineFactory),
             m_isRunning(false),
-            m_maximumHops(MaxRouteHops) {
+            m_maximumHops(MaxRouteHops),
+            m_waveSize(DefaultDiscoveryWaveSize) {
 
 }
 
@@ -52,73 +83,749 @@ Nedrysoft::RouteEngine::RouteEngineWorker::~RouteEngineWorker() {
     }
 }
 
+auto Nedrysoft::RouteEngine::RouteEngineWorker::setWaveSize(int waveSize) -> void {
+    m_waveSize = qBound(1, waveSize, MaxRouteHops);
+}
+
+auto Nedrysoft::RouteEngine::RouteEngineWorker::setRetraceInterval(
+        const std::shared_ptr<std::atomic<int> > &retraceInterval ) -> void {
+
+    m_retraceInterval = retraceInterval;
+}
+
+auto Nedrysoft::RouteEngine::RouteEngineWorker::setBulkDiscovery(
+        const std::shared_ptr<Nedrysoft::RouteEngine::BulkRouteDiscovery> &bulkDiscovery ) -> void {
+
+    m_bulkDiscovery = bulkDiscovery;
+}
+
 auto Nedrysoft::RouteEngine::RouteEngineWorker::doWork() -> void {
-    int totalHops = -1;
     m_isRunning = true;
 
     auto pingEngine = m_pingEngineFactory->createEngine(m_ipVersion);
+    auto routeCache = Nedrysoft::RouteEngine::RouteCache::getInstance();
 
-    auto targetAddresses = QHostInfo::fromName(m_host).addresses();
+    auto targetAddress = QHostAddress();
+    auto route = Nedrysoft::RouteAnalyser::RouteList();
+    auto totalHops = -1;
+    auto routeComplete = false;
 
-    if (!targetAddresses.count()) {
-        Q_EMIT result(QHostAddress(), Nedrysoft::RouteAnalyser::RouteList(), true, -1, m_maximumHops);
+    if (routeCache->find(m_host, m_ipVersion, targetAddress, route)) {
+        /**
+         * the last known route is reported straight away so that its hops can be monitored immediately, it is
+         * then traced again in the background and replaced only if it has changed.
+         */
 
-        SPDLOG_ERROR(QString("Failed to find address for %1.").arg(m_host).toStdString());
+        SPDLOG_TRACE(QString("Route to %1 (%2) found in cache, %3 hops.")
+                             .arg(m_host)
+                             .arg(targetAddress.toString())
+                             .arg(route.length())
+                             .toStdString() );
 
-        this->deleteLater();
+        Q_EMIT result(targetAddress, route, false, route.count(), m_maximumHops);
+        Q_EMIT result(targetAddress, route, true, route.count(), m_maximumHops);
 
-        return;
-    }
+        /**
+         * the host is still resolved, if it no longer resolves to the cached address then the new address is
+         * traced and replaces the cached route as a route change.
+         */
 
-    auto route = Nedrysoft::RouteAnalyser::RouteList();
+        auto targetAddresses = resolveHost(m_host);
 
-    auto pingResult = pingEngine->singleShot(
-        targetAddresses.at(0),
-        m_maximumHops,
-        DefaultDiscoveryTimeout
-    );
+        if ((!targetAddresses.isEmpty()) && (!targetAddresses.contains(targetAddress))) {
+            auto resolvedAddress = targetAddresses.at(0);
+
+            SPDLOG_TRACE(QString("%1 now resolves to %2, was %3.")
+                                 .arg(m_host)
+                                 .arg(resolvedAddress.toString())
+                                 .arg(targetAddress.toString())
+                                 .toStdString() );
+
+            auto tracedRoute = traceRoute(pingEngine, resolvedAddress, m_waveSize, false, totalHops, routeComplete);
+
+            if (!m_isRunning) {
+                m_pingEngineFactory->deleteEngine(pingEngine);
 
-    if (pingResult.code()==Nedrysoft::RouteAnalyser::PingResult::ResultCode::Ok) {
-        totalHops = pingResult.hops();
+                return;
+            }
+
+            Q_EMIT routeChanged(resolvedAddress, route, tracedRoute, QDateTime::currentDateTime());
+
+            targetAddress = resolvedAddress;
+            route = tracedRoute;
+
+            if (routeComplete) {
+                routeCache->add(m_host, m_ipVersion, targetAddress, route);
+            }
+        } else {
+            auto tracedRoute = traceRoute(pingEngine, targetAddress, m_waveSize, false, totalHops, routeComplete);
+
+            if (!m_isRunning) {
+                m_pingEngineFactory->deleteEngine(pingEngine);
+
+                return;
+            }
+
+            if (routeComplete) {
+                auto validatedRoute = mergeRoute(route, tracedRoute);
+
+                if (validatedRoute!=route) {
+                    Q_EMIT routeChanged(targetAddress, route, validatedRoute, QDateTime::currentDateTime());
+
+                    route = validatedRoute;
+                }
+
+                routeCache->add(m_host, m_ipVersion, targetAddress, route);
+            }
+        }
+    } else {
+        auto targetAddresses = resolveHost(m_host);
+
+        if (!targetAddresses.count()) {
+            Q_EMIT result(QHostAddress(), Nedrysoft::RouteAnalyser::RouteList(), true, -1, m_maximumHops);
+
+            SPDLOG_ERROR(QString("Failed to find address for %1.").arg(m_host).toStdString());
+
+            m_pingEngineFactory->deleteEngine(pingEngine);
+
+            this->deleteLater();
+
+            return;
+        }
+
+        targetAddress = targetAddresses.at(0);
+
+        route = traceRoute(pingEngine, targetAddress, m_waveSize, true, totalHops, routeComplete);
+
+        if (!m_isRunning) {
+            m_pingEngineFactory->deleteEngine(pingEngine);
+
+            return;
+        }
+
+        SPDLOG_TRACE(QString("Route to %1 (%2) completed, total of %3 hops.")
+                             .arg(m_host)
+                             .arg(targetAddress.toString())
+                             .arg(route.length())
+                             .toStdString() );
+
+        /**
+         * we emit the final hop twice, oncce with completed set to false then true, this ensures that the
+         * behaviour to listeners is the same for each hop, i.e every hop gets a result signal with completed
+         * set to false, without the extra emit the final hop would behave differently.
+         */
+
+        Q_EMIT result(targetAddress, route, false, totalHops, m_maximumHops);
+        Q_EMIT result(targetAddress, route, true, totalHops, m_maximumHops);
+
+        if (routeComplete) {
+            routeCache->add(m_host, m_ipVersion, targetAddress, route);
+        }
     }
 
-    for (int hop=1;hop<MaxRouteHops;hop++) {
+    if (m_discoveryMode==Nedrysoft::RouteAnalyser::IRouteEngine::DiscoveryMode::Multipath) {
+        discoverMultipath(pingEngine, targetAddress, route);
+    }
+
+    retraceRoute(pingEngine, targetAddress, route);
+
+    m_pingEngineFactory->deleteEngine(pingEngine);
+
+    this->deleteLater();
+}
+
+auto Nedrysoft::RouteEngine::RouteEngineWorker::doBulkWork() -> void {
+    m_isRunning = true;
+
+    auto pingEngine = m_pingEngineFactory->createEngine(m_ipVersion);
+    auto host = QString();
+
+    while ((m_isRunning) && (m_bulkDiscovery->takeTarget(host))) {
+        auto targetAddresses = resolveHost(host);
+
+        if (!targetAddresses.count()) {
+            Q_EMIT bulkResult(host, QHostAddress(), Nedrysoft::RouteAnalyser::RouteList(), true, -1, m_maximumHops);
+
+            SPDLOG_ERROR(QString("Failed to find address for %1.").arg(host).toStdString());
+
+            continue;
+        }
+
+        auto targetAddress = targetAddresses.at(0);
+        auto routeComplete = false;
+
+        auto route = traceRouteDoubletree(pingEngine, targetAddress, routeComplete);
+
         if (!m_isRunning) {
             m_pingEngineFactory->deleteEngine(pingEngine);
 
             return;
         }
 
-        pingResult = pingEngine->singleShot(targetAddresses.at(0), hop, DefaultDiscoveryTimeout);
+        if (routeComplete) {
+            m_bulkDiscovery->addRoute(route);
 
-        if (pingResult.code()==Nedrysoft::RouteAnalyser::PingResult::ResultCode::Ok) {
-            route.append(pingResult.hostAddress());
-            break;
-        } else  if (pingResult.code()==Nedrysoft::RouteAnalyser::PingResult::ResultCode::TimeExceeded) {
-            route.append(pingResult.hostAddress());
-        } else  {
-            route.append(QHostAddress());
+            Nedrysoft::RouteEngine::RouteCache::getInstance()->add(host, m_ipVersion, targetAddress, route);
         }
 
-        Q_EMIT result(targetAddresses[0], route, false, totalHops, m_maximumHops);
+        SPDLOG_TRACE(QString("Route to %1 (%2) completed, total of %3 hops, %4 probes sent so far.")
+                             .arg(host)
+                             .arg(targetAddress.toString())
+                             .arg(route.length())
+                             .arg(m_bulkDiscovery->probeCount())
+                             .toStdString() );
+
+        Q_EMIT bulkResult(host, targetAddress, route, false, routeComplete ? route.count() : -1, m_maximumHops);
+        Q_EMIT bulkResult(host, targetAddress, route, true, routeComplete ? route.count() : -1, m_maximumHops);
+    }
+
+    m_pingEngineFactory->deleteEngine(pingEngine);
+
+    this->deleteLater();
+}
+
+auto Nedrysoft::RouteEngine::RouteEngineWorker::traceRouteDoubletree(
+        Nedrysoft::RouteAnalyser::IPingEngine *pingEngine,
+        const QHostAddress &targetAddress,
+        bool &routeComplete ) -> Nedrysoft::RouteAnalyser::RouteList {
+
+    auto startHop = qMin(DoubletreeStartHop, m_maximumHops);
+    auto totalHops = -1;
+
+    /**
+     * the forward probes start part way along the route, where paths to different targets have usually already
+     * diverged, and continue until the target is reached.
+     */
+
+    auto forwardRoute = traceRoute(pingEngine, targetAddress, m_waveSize, false, totalHops, routeComplete, startHop);
+
+    if (!m_isRunning) {
+        return forwardRoute;
+    }
+
+    /**
+     * the backward probes work towards the source and stop at the first interface that is in the stop set, the
+     * route from the source to that interface is already known from an earlier trace.  A target that is closer
+     * than the start hop replies to the backward probes too, the lowest hop that it replies at ends the route.
+     */
+
+    auto backwardHops = QVector<QHostAddress>(startHop-1);
+    auto knownRoute = Nedrysoft::RouteAnalyser::RouteList();
+    auto knownHop = 0;
+    auto routeEnd = 0;
+
+    for (int lastHop=startHop-1;(lastHop>=1) && (!knownHop);lastHop-=BackwardWaveSize) {
+        auto firstHop = qMax(1, lastHop-BackwardWaveSize+1);
+
+        auto probeResults = probeHops(pingEngine, targetAddress, firstHop, lastHop-firstHop+1);
+
+        if (!m_isRunning) {
+            return forwardRoute;
+        }
+
+        for (int hop=lastHop;hop>=firstHop;hop--) {
+            auto pingResult = probeResults.at(hop-firstHop);
+
+            switch (pingResult.code()) {
+                case Nedrysoft::RouteAnalyser::PingResult::ResultCode::Ok:
+                case Nedrysoft::RouteAnalyser::PingResult::ResultCode::Unreachable: {
+                    backwardHops[hop-1] = pingResult.hostAddress();
+
+                    routeEnd = hop;
+
+                    break;
+                }
+
+                case Nedrysoft::RouteAnalyser::PingResult::ResultCode::TimeExceeded: {
+                    backwardHops[hop-1] = pingResult.hostAddress();
+
+                    if (m_bulkDiscovery->findRoute(pingResult.hostAddress(), hop, knownRoute)) {
+                        knownHop = hop;
+                    }
+
+                    break;
+                }
+
+                default: {
+                    backwardHops[hop-1] = QHostAddress();
+
+                    break;
+                }
+            }
+
+            if (knownHop) {
+                break;
+            }
+        }
+    }
+
+    auto route = knownRoute;
+
+    for (int hop=knownHop+1;hop<startHop;hop++) {
+        route.append(backwardHops.at(hop-1));
+    }
+
+    if (routeEnd) {
+        routeComplete = true;
+
+        return route.mid(0, routeEnd);
+    }
+
+    return route+forwardRoute;
+}
+
+auto Nedrysoft::RouteEngine::RouteEngineWorker::probeHops(
+        Nedrysoft::RouteAnalyser::IPingEngine *pingEngine,
+        const QHostAddress &targetAddress,
+        int firstHop,
+        int hopCount ) -> QList<Nedrysoft::RouteAnalyser::PingResult> {
+
+    auto probes = Nedrysoft::RouteAnalyser::SingleShotProbeList();
+    auto batchFlowId = m_flowId;
+
+    if (m_discoveryMode==Nedrysoft::RouteAnalyser::IRouteEngine::DiscoveryMode::Classic) {
+        batchFlowId = 0;
+    }
+
+    for (int hop=firstHop;hop<firstHop+hopCount;hop++) {
+        probes.append(qMakePair(targetAddress, hop));
+    }
+
+    auto probeBatch = pingEngine->singleShot(
+        probes,
+        probeTimeout(targetAddress, firstHop, hopCount),
+        batchFlowId,
+        [this, targetAddress, firstHop](int index, const Nedrysoft::RouteAnalyser::PingResult &pingResult) {
+            addProbeResult(targetAddress, firstHop+index, pingResult);
+        }
+    );
+
+    auto probeResults = probeBatch.get();
+
+    addProbeLosses(targetAddress, firstHop, probeResults.toVector());
+
+    return probeResults;
+}
+
+auto Nedrysoft::RouteEngine::RouteEngineWorker::mergeRoute(
+        const Nedrysoft::RouteAnalyser::RouteList &currentRoute,
+        const Nedrysoft::RouteAnalyser::RouteList &tracedRoute ) -> Nedrysoft::RouteAnalyser::RouteList {
+
+    auto mergedRoute = Nedrysoft::RouteAnalyser::RouteList();
+
+    /**
+     * a hop that did not reply this time is assumed to be unchanged, otherwise a single lost probe would be
+     * reported as a route change.
+     */
+
+    for (int hop=0;hop<tracedRoute.count();hop++) {
+        if ((tracedRoute.at(hop).isNull()) && (hop<currentRoute.count())) {
+            mergedRoute.append(currentRoute.at(hop));
+        } else {
+            mergedRoute.append(tracedRoute.at(hop));
+        }
+    }
+
+    return mergedRoute;
+}
+
+auto Nedrysoft::RouteEngine::RouteEngineWorker::traceRoute(
+        Nedrysoft::RouteAnalyser::IPingEngine *pingEngine,
+        const QHostAddress &targetAddress,
+        int waveSize,
+        bool reportProgress,
+        int &totalHops,
+        bool &routeComplete,
+        int startHop ) -> Nedrysoft::RouteAnalyser::RouteList {
+
+    auto route = Nedrysoft::RouteAnalyser::RouteList();
+
+    totalHops = -1;
+    routeComplete = false;
+
+    /**
+     * each wave is sent as a single batch so that all of the TTLs in a wave are in flight at the same time, the
+     * probe used to find the hop count is sent alongside the first wave.  The hops are streamed in order as
+     * their replies arrive, so a silent hop only holds back the hops after it until its timeout expires.
+     */
+
+    QMutex probeMutex;
+    QWaitCondition probeCondition;
+    std::vector<std::future<QList<Nedrysoft::RouteAnalyser::PingResult> > > probeBatches;
+
+    auto batchFlowId = m_flowId;
+
+    if (m_discoveryMode==Nedrysoft::RouteAnalyser::IRouteEngine::DiscoveryMode::Classic) {
+        batchFlowId = 0;
+    }
+
+    auto startProbes = [&](
+            const Nedrysoft::RouteAnalyser::SingleShotProbeList &probes,
+            Nedrysoft::RouteAnalyser::PingResult *probeResults,
+            bool *probeCompleted ) {
+
+        probeBatches.push_back(pingEngine->singleShot(
+            probes,
+            probeTimeout(targetAddress, probes.first().second, probes.count()),
+            batchFlowId,
+            [=, &probeMutex, &probeCondition](int index, const Nedrysoft::RouteAnalyser::PingResult &pingResult) {
+                addProbeResult(targetAddress, probes.at(index).second, pingResult);
+
+                QMutexLocker locker(&probeMutex);
+
+                probeResults[index] = pingResult;
+                probeCompleted[index] = true;
+
+                probeCondition.wakeAll();
+            }
+        ));
+    };
+
+    auto waitForProbes = [&]() {
+        for (auto &probeBatch : probeBatches) {
+            probeBatch.wait();
+        }
+
+        probeBatches.clear();
     };
 
-    SPDLOG_TRACE(QString("Route to %1 (%2) completed, total of %3 hops.")
-                         .arg(m_host)
-                         .arg(m_targetAddresses[0].toString())
-                         .arg(route.length())
-                         .toStdString() );
+    Nedrysoft::RouteAnalyser::PingResult hopCountResult;
+    bool hopCountCompleted = false;
+
+    startProbes(
+        Nedrysoft::RouteAnalyser::SingleShotProbeList() << qMakePair(targetAddress, m_maximumHops),
+        &hopCountResult,
+        &hopCountCompleted );
+
+    for (int firstHop=startHop;(firstHop<=m_maximumHops) && (!routeComplete);firstHop+=waveSize) {
+        auto currentWaveSize = qMin(waveSize, m_maximumHops-firstHop+1);
+        auto waveResults = QVector<Nedrysoft::RouteAnalyser::PingResult>(currentWaveSize);
+        auto waveCompleted = QVector<bool>(currentWaveSize, false);
+
+        auto waveProbes = Nedrysoft::RouteAnalyser::SingleShotProbeList();
+
+        for (int waveHop=0;waveHop<currentWaveSize;waveHop++) {
+            waveProbes.append(qMakePair(targetAddress, firstHop+waveHop));
+        }
+
+        startProbes(waveProbes, waveResults.data(), waveCompleted.data());
+
+        for (int waveHop=0;(waveHop<currentWaveSize) && (!routeComplete);waveHop++) {
+            probeMutex.lock();
+
+            while (!waveCompleted[waveHop]) {
+                probeCondition.wait(&probeMutex);
+            }
+
+            auto pingResult = waveResults[waveHop];
+
+            if ((hopCountCompleted) &&
+                (hopCountResult.code()==Nedrysoft::RouteAnalyser::PingResult::ResultCode::Ok)) {
+
+                totalHops = hopCountResult.hops();
+            }
+
+            probeMutex.unlock();
+
+            if (!m_isRunning) {
+                waitForProbes();
+
+                return route;
+            }
+
+            /**
+             * a destination unreachable reply means that no probe with a larger ttl can get any further, so the
+             * sender of the message becomes the final hop and the discovery finishes early.
+             */
+
+            if ((pingResult.code()==Nedrysoft::RouteAnalyser::PingResult::ResultCode::Ok) ||
+                (pingResult.code()==Nedrysoft::RouteAnalyser::PingResult::ResultCode::Unreachable)) {
+
+                route.append(pingResult.hostAddress());
+
+                routeComplete = true;
+
+                break;
+            } else  if (pingResult.code()==Nedrysoft::RouteAnalyser::PingResult::ResultCode::TimeExceeded) {
+                route.append(pingResult.hostAddress());
+            } else  {
+                route.append(QHostAddress());
+            }
+
+            if (reportProgress) {
+                Q_EMIT result(targetAddress, route, false, totalHops, m_maximumHops);
+            }
+        }
+
+        /**
+         * the probes beyond the target reference this waves results, so they must finish before the next wave.
+         */
+
+        waitForProbes();
+
+        addProbeLosses(targetAddress, firstHop, waveResults);
+    }
+
+    if (hopCountResult.code()==Nedrysoft::RouteAnalyser::PingResult::ResultCode::Ok) {
+        totalHops = hopCountResult.hops();
+    }
+
+    return route;
+}
+
+auto Nedrysoft::RouteEngine::RouteEngineWorker::retraceRoute(
+        Nedrysoft::RouteAnalyser::IPingEngine *pingEngine,
+        const QHostAddress &targetAddress,
+        const Nedrysoft::RouteAnalyser::RouteList &route ) -> void {
+
+    auto currentRoute = route;
+    QElapsedTimer retraceTimer;
+
+    retraceTimer.start();
+
+    while (m_isRunning) {
+        auto retraceInterval = m_retraceInterval ? m_retraceInterval->load() : 0;
+
+        if (retraceInterval<=0) {
+            break;
+        }
+
+        if (retraceTimer.elapsed()<retraceInterval) {
+            QThread::msleep(RetraceSleepInterval);
+
+            continue;
+        }
+
+        /**
+         * re-traces run alongside the monitoring of the route, so they use a small wave to keep the burst of
+         * probes low, the packet rate governor spaces the probes out further if the process is busy.
+         */
+
+        auto totalHops = -1;
+        auto routeComplete = false;
+
+        auto tracedRoute = traceRoute(pingEngine, targetAddress, RetraceWaveSize, false, totalHops, routeComplete);
+
+        retraceTimer.restart();
+
+        if ((!m_isRunning) || (!routeComplete)) {
+            continue;
+        }
+
+        auto newRoute = mergeRoute(currentRoute, tracedRoute);
+
+        if (newRoute==currentRoute) {
+            continue;
+        }
+
+        SPDLOG_TRACE(QString("Route to %1 (%2) has changed, now %3 hops.")
+                             .arg(m_host)
+                             .arg(targetAddress.toString())
+                             .arg(newRoute.length())
+                             .toStdString() );
+
+        Q_EMIT routeChanged(targetAddress, currentRoute, newRoute, QDateTime::currentDateTime());
+
+        Nedrysoft::RouteEngine::RouteCache::getInstance()->add(m_host, m_ipVersion, targetAddress, newRoute);
+
+        currentRoute = newRoute;
+    }
+}
+
+auto Nedrysoft::RouteEngine::RouteEngineWorker::resolveHost(const QString &host) -> QList<QHostAddress> {
+    auto protocol = QAbstractSocket::IPv4Protocol;
+
+    if (m_ipVersion==Nedrysoft::Core::IPVersion::V6) {
+        protocol = QAbstractSocket::IPv6Protocol;
+    }
 
     /**
-     * we emit the final hop twice, oncce with completed set to false then true, this ensures that the
-     * behaviour to listeners is the same for each hop, i.e every hop gets a result signal with completed
-     * set to false, without the extra emit the final hop would behave differently.
+     * the resolver looks up both address types at once and caches the answers, so this returns as soon as the
+     * addresses for the ip version being traced are known and re-opening a target does not resolve it again.
      */
 
-    Q_EMIT result(targetAddresses[0], route, false, totalHops, m_maximumHops);
-    Q_EMIT result(targetAddresses[0], route, true, totalHops, m_maximumHops);
+    return Nedrysoft::HostResolver::HostResolver::getInstance()->resolve(host, protocol, ResolveTimeout);
+}
 
-    m_pingEngineFactory->deleteEngine(pingEngine);
+auto Nedrysoft::RouteEngine::RouteEngineWorker::probeTimeout(
+        const QHostAddress &targetAddress,
+        int firstHop,
+        int hopCount ) -> double {
 
-    this->deleteLater();
+    QMutexLocker locker(&m_retransmissionTimeoutMutex);
+
+    auto timeout = MinimumDiscoveryTimeout;
+
+    /**
+     * a hop that has not answered yet has no estimate, it uses the initial timeout until it does.
+     */
+
+    for (int hop=firstHop;hop<firstHop+hopCount;hop++) {
+        auto timeoutIterator = m_retransmissionTimeouts.constFind(qMakePair(targetAddress, hop));
+
+        if (timeoutIterator==m_retransmissionTimeouts.constEnd()) {
+            timeout = qMax(timeout, DefaultDiscoveryTimeout);
+        } else {
+            timeout = qMax(timeout, timeoutIterator->timeout());
+        }
+    }
+
+    return timeout;
+}
+
+auto Nedrysoft::RouteEngine::RouteEngineWorker::addProbeResult(
+        const QHostAddress &targetAddress,
+        int hop,
+        const Nedrysoft::RouteAnalyser::PingResult &pingResult ) -> void {
+
+    if (m_bulkDiscovery) {
+        m_bulkDiscovery->addProbes(1);
+    }
+
+    /**
+     * many routers never answer probes, so a missing reply on its own says nothing about the path, losses are
+     * only counted by addProbeLosses once the rest of the wave is known.
+     */
+
+    if (pingResult.code()==Nedrysoft::RouteAnalyser::PingResult::ResultCode::NoReply) {
+        return;
+    }
+
+    QMutexLocker locker(&m_retransmissionTimeoutMutex);
+
+    auto timeoutKey = qMakePair(targetAddress, hop);
+
+    if (!m_retransmissionTimeouts.contains(timeoutKey)) {
+        m_retransmissionTimeouts.insert(
+            timeoutKey,
+            Nedrysoft::RouteAnalyser::RetransmissionTimeout(
+                DefaultDiscoveryTimeout,
+                MinimumDiscoveryTimeout,
+                MaximumDiscoveryTimeout )
+        );
+    }
+
+    m_retransmissionTimeouts[timeoutKey].addSample(pingResult.roundTripTime());
+}
+
+auto Nedrysoft::RouteEngine::RouteEngineWorker::addProbeLosses(
+        const QHostAddress &targetAddress,
+        int firstHop,
+        const QVector<Nedrysoft::RouteAnalyser::PingResult> &probeResults ) -> void {
+
+    auto deepestReply = -1;
+
+    for (int index=0;index<probeResults.count();index++) {
+        if (probeResults.at(index).code()!=Nedrysoft::RouteAnalyser::PingResult::ResultCode::NoReply) {
+            deepestReply = index;
+        }
+    }
+
+    QMutexLocker locker(&m_retransmissionTimeoutMutex);
+
+    for (int index=0;index<deepestReply;index++) {
+        if (probeResults.at(index).code()!=Nedrysoft::RouteAnalyser::PingResult::ResultCode::NoReply) {
+            continue;
+        }
+
+        auto timeoutIterator = m_retransmissionTimeouts.find(qMakePair(targetAddress, firstHop+index));
+
+        if (timeoutIterator!=m_retransmissionTimeouts.end()) {
+            timeoutIterator->addLoss();
+        }
+    }
+}
+
+auto Nedrysoft::RouteEngine::RouteEngineWorker::discoverMultipath(
+        Nedrysoft::RouteAnalyser::IPingEngine *pingEngine,
+        const QHostAddress &targetAddress,
+        const Nedrysoft::RouteAnalyser::RouteList &route ) -> void {
+
+    auto multipathRoute = Nedrysoft::RouteAnalyser::MultipathRouteList();
+    auto hopModel = Nedrysoft::RouteAnalyser::HopModel();
+    uint16_t nextFlowId = m_flowId;
+
+    if (route.isEmpty()) {
+        Q_EMIT multipathResult(targetAddress, multipathRoute, true);
+
+        return;
+    }
+
+    /**
+     * the final hop is the target itself so only the hops before it are enumerated, the hop found by the flow
+     * stable discovery counts as the first probe of each hop.
+     */
+
+    for (int hop=1;hop<route.count();hop++) {
+        auto probesSent = 1;
+
+        hopModel.addResponse(hop, route.at(hop-1));
+
+        while (m_isRunning) {
+            auto responderCount = hopModel.responderCount(hop);
+            auto responderIndex = qBound(0, responderCount-1, MaxMultipathResponders-1);
+            auto probesRequired = MultipathProbeCount[responderIndex];
+
+            if ((probesSent>=probesRequired) || (responderCount>=MaxMultipathResponders)) {
+                break;
+            }
+
+            auto probeCount = probesRequired-probesSent;
+            auto probeBatches = std::vector<std::future<QList<Nedrysoft::RouteAnalyser::PingResult> > >();
+            auto probeResults = QList<Nedrysoft::RouteAnalyser::PingResult>();
+
+            /**
+             * every probe needs its own flow identifier, so each is sent as a batch of one, the batches are run
+             * by the engine so the probes are in flight together without a thread being started for each.
+             */
+
+            for (int probeIndex=0;probeIndex<probeCount;probeIndex++) {
+                do {
+                    nextFlowId++;
+                } while ((nextFlowId==0) || (nextFlowId==m_flowId));
+
+                probeBatches.push_back(pingEngine->singleShot(
+                    Nedrysoft::RouteAnalyser::SingleShotProbeList() << qMakePair(targetAddress, hop),
+                    probeTimeout(targetAddress, hop, 1),
+                    nextFlowId,
+                    [this, targetAddress, hop](int, const Nedrysoft::RouteAnalyser::PingResult &pingResult) {
+                        addProbeResult(targetAddress, hop, pingResult);
+                    }
+                ));
+            }
+
+            for (auto &probeBatch : probeBatches) {
+                probeResults.append(probeBatch.get());
+            }
+
+            /**
+             * each reply is interned once as it is recorded, the model then compares responders as integers and
+             * ignores a null address. (no reply)
+             */
+
+            for (auto probeResult : probeResults) {
+                hopModel.addResponse(hop, probeResult.hostAddress());
+            }
+
+            probesSent += probeCount;
+        }
+
+        if (!m_isRunning) {
+            return;
+        }
+
+        auto responders = Nedrysoft::RouteAnalyser::RouteList();
+
+        for (auto responder : hopModel.responders(hop)) {
+            responders.append(hopModel.address(responder.addressId));
+        }
+
+        multipathRoute.append(responders);
+
+        Q_EMIT multipathResult(targetAddress, multipathRoute, false);
+    }
+
+    multipathRoute.append(Nedrysoft::RouteAnalyser::RouteList() << route.last());
+
+    Q_EMIT multipathResult(targetAddress, multipathRoute, true);
 }
@@ -27,15 +27,30 @@
 #include <ICore>
 #include <IRouteEngine>
 
+#include <QDateTime>
+#include <QHash>
 #include <QHostAddress>
+#include <QMutex>
 #include <QObject>
+#include <QPair>
 #include <QThread>
+#include <QVector>
+#include <RetransmissionTimeout>
+#include <atomic>
+#include <memory>
 
 namespace Nedrysoft { namespace Core {
     class IPingEngineFactory;
 }}
 
+namespace Nedrysoft { namespace RouteAnalyser {
+    class IPingEngine;
+    class PingResult;
+}}
+
 namespace Nedrysoft { namespace RouteEngine {
+    class BulkRouteDiscovery;
+
     /**
      * @brief       The worker object for route discovery.
      */
@@ -48,10 +63,18 @@ namespace Nedrysoft { namespace RouteEngine {
     public:
         /**
          * @brief       Constructs a RouteEngineWorker.
+         *
+         * @param[in]   target the host name or address of the target.
+         * @param[in]   pingEngineFactory the factory used to create the ping engine for discovery.
+         * @param[in]   ipVersion the IP version to be used for discovery.
+         * @param[in]   discoveryMode the discovery mode.
+         * @param[in]   flowId the flow identifier used for flow stable probes.
          */
         RouteEngineWorker(QString target,
                           Nedrysoft::RouteAnalyser::IPingEngineFactory *pingEngineFactory,
-                          Nedrysoft::Core::IPVersion ipVersion );
+                          Nedrysoft::Core::IPVersion ipVersion,
+                          Nedrysoft::RouteAnalyser::IRouteEngine::DiscoveryMode discoveryMode,
+                          uint16_t flowId );
 
         /**
          * @brief       Destroys the RouteEngineWorker.
@@ -63,6 +86,50 @@ namespace Nedrysoft { namespace RouteEngine {
          */
         auto doWork() -> void;
 
+        /**
+         * @brief       The worker thread for bulk route discovery.
+         *
+         * @details     Takes targets from the shared bulk discovery until none remain, each route is traced
+         *              using Doubletree and the result signal is emitted for every target.
+         *
+         * @see         Nedrysoft::RouteEngine::RouteEngineWorker::setBulkDiscovery
+         */
+        auto doBulkWork() -> void;
+
+        /**
+         * @brief       Sets the shared state used for bulk route discovery.
+         *
+         * @note        This must be called before the worker is started with doBulkWork.
+         *
+         * @param[in]   bulkDiscovery the shared bulk discovery.
+         */
+        auto setBulkDiscovery(const std::shared_ptr<Nedrysoft::RouteEngine::BulkRouteDiscovery> &bulkDiscovery) -> void;
+
+        /**
+         * @brief       Sets the number of hops that are probed in parallel during discovery.
+         *
+         * @details     Every TTL in a wave is probed at the same time and the replies are collected as they
+         *              arrive, so a wave takes roughly one round trip plus the discovery timeout no matter how
+         *              many of its hops are silent.  A wave size of 1 probes a single hop at a time.
+         *
+         * @note        This must be called before the worker is started.
+         *
+         * @param[in]   waveSize the number of hops to probe in each wave.
+         */
+        auto setWaveSize(int waveSize) -> void;
+
+        /**
+         * @brief       Sets the interval used to re-trace the route once it has been discovered.
+         *
+         * @details     The interval is shared with the route engine so that it can be changed while the worker
+         *              is running, the worker finishes when the interval is set to 0.
+         *
+         * @note        This must be called before the worker is started.
+         *
+         * @param[in]   retraceInterval the shared interval in milliseconds.
+         */
+        auto setRetraceInterval(const std::shared_ptr<std::atomic<int> > &retraceInterval) -> void;
+
         /**
          * @brief       This signal is emitted when a route has finished discovery.
          *
@@ -81,16 +148,239 @@ namespace Nedrysoft { namespace RouteEngine {
             const int maximumHops
         );
 
+        /**
+         * @brief       This signal is emitted when a bulk discovery worker has finished a route.
+         *
+         * @param[in]   host the host name or address that was requested.
+         * @param[in]   hostAddress the address that the host resolved to, null if the host could not be resolved.
+         * @param[in]   result the route list.
+         * @param[in]   completed true if the route has been fully discovered; otherwise false.
+         * @param[in]   totalHops is the total number of hops to the target is available; otherwise -1.
+         * @param[in]   maximumHops is the maximum number of hops to consider, if the TTL exceeds this then
+         *              the route has failed.
+         */
+        Q_SIGNAL void bulkResult(
+            const QString host,
+            const QHostAddress hostAddress,
+            const Nedrysoft::RouteAnalyser::RouteList result,
+            const bool completed,
+            const int totalHops,
+            const int maximumHops
+        );
+
+        /**
+         * @brief       This signal is emitted as multipath discovery enumerates the responders for each hop.
+         *
+         * @param[in]   hostAddress the target that was requested.
+         * @param[in]   result the responders for each hop that has been enumerated so far.
+         * @param[in]   completed true if every hop has been enumerated; otherwise false.
+         */
+        Q_SIGNAL void multipathResult(
+            const QHostAddress hostAddress,
+            const Nedrysoft::RouteAnalyser::MultipathRouteList result,
+            const bool completed
+        );
+
+        /**
+         * @brief       This signal is emitted when a re-trace finds that the route has changed.
+         *
+         * @param[in]   hostAddress the target that was requested.
+         * @param[in]   previousRoute the route before the change.
+         * @param[in]   route the route after the change.
+         * @param[in]   changedTime the time that the change was detected.
+         */
+        Q_SIGNAL void routeChanged(
+            const QHostAddress hostAddress,
+            const Nedrysoft::RouteAnalyser::RouteList previousRoute,
+            const Nedrysoft::RouteAnalyser::RouteList route,
+            const QDateTime changedTime
+        );
+
+    private:
+        /**
+         * @brief       Resolves the addresses of a host for the IP version being used for discovery.
+         *
+         * @param[in]   host the host name or address.
+         *
+         * @returns     the addresses of the host, empty if it could not be resolved.
+         */
+        auto resolveHost(const QString &host) -> QList<QHostAddress>;
+
+        /**
+         * @brief       Traces the route to the target.
+         *
+         * @details     The hops are probed in waves of up to waveSize TTLs, each wave being sent as a single
+         *              batch, and the trace finishes as soon as the target or a destination unreachable reply
+         *              is seen.
+         *
+         * @param[in]   pingEngine the engine to send the probes with.
+         * @param[in]   targetAddress the address of the target.
+         * @param[in]   waveSize the maximum number of hops to probe in parallel.
+         * @param[in]   reportProgress true if the result signal should be emitted as each hop is found.
+         * @param[out]  totalHops the number of hops to the target if known; otherwise -1.
+         * @param[out]  routeComplete true if the trace reached the end of the route; otherwise false.
+         * @param[in]   startHop the first hop to probe, the returned route begins at this hop.
+         *
+         * @returns     the traced route.
+         */
+        auto traceRoute(
+            Nedrysoft::RouteAnalyser::IPingEngine *pingEngine,
+            const QHostAddress &targetAddress,
+            int waveSize,
+            bool reportProgress,
+            int &totalHops,
+            bool &routeComplete,
+            int startHop = 1
+        ) -> Nedrysoft::RouteAnalyser::RouteList;
+
+        /**
+         * @brief       Traces the route to the target using Doubletree.
+         *
+         * @details     Probes forwards from a hop part way along the route until the target is reached, then
+         *              backwards towards the source until an interface in the stop set of the bulk discovery is
+         *              found, the remainder of the route is then taken from the stop set.
+         *
+         * @param[in]   pingEngine the engine to send the probes with.
+         * @param[in]   targetAddress the address of the target.
+         * @param[out]  routeComplete true if the trace reached the end of the route; otherwise false.
+         *
+         * @returns     the traced route.
+         */
+        auto traceRouteDoubletree(
+            Nedrysoft::RouteAnalyser::IPingEngine *pingEngine,
+            const QHostAddress &targetAddress,
+            bool &routeComplete
+        ) -> Nedrysoft::RouteAnalyser::RouteList;
+
+        /**
+         * @brief       Probes a range of hops in a single batch and waits for the results.
+         *
+         * @param[in]   pingEngine the engine to send the probes with.
+         * @param[in]   targetAddress the address of the target.
+         * @param[in]   firstHop the first hop to probe.
+         * @param[in]   hopCount the number of hops to probe.
+         *
+         * @returns     the results in hop order.
+         */
+        auto probeHops(
+            Nedrysoft::RouteAnalyser::IPingEngine *pingEngine,
+            const QHostAddress &targetAddress,
+            int firstHop,
+            int hopCount
+        ) -> QList<Nedrysoft::RouteAnalyser::PingResult>;
+
+        /**
+         * @brief       Merges a newly traced route with the current route.
+         *
+         * @details     Hops that did not reply to the new trace keep their address from the current route.
+         *
+         * @param[in]   currentRoute the current route.
+         * @param[in]   tracedRoute the newly traced route.
+         *
+         * @returns     the merged route.
+         */
+        static auto mergeRoute(
+            const Nedrysoft::RouteAnalyser::RouteList &currentRoute,
+            const Nedrysoft::RouteAnalyser::RouteList &tracedRoute
+        ) -> Nedrysoft::RouteAnalyser::RouteList;
+
+        /**
+         * @brief       Re-traces a discovered route at the retrace interval until re-tracing is disabled.
+         *
+         * @details     A re-trace which does not reach the end of the route is discarded, otherwise it is
+         *              compared with the current route and the routeChanged signal emitted if they differ.
+         *
+         * @param[in]   pingEngine the engine to send the probes with.
+         * @param[in]   targetAddress the address of the target.
+         * @param[in]   route the discovered route.
+         */
+        auto retraceRoute(
+            Nedrysoft::RouteAnalyser::IPingEngine *pingEngine,
+            const QHostAddress &targetAddress,
+            const Nedrysoft::RouteAnalyser::RouteList &route
+        ) -> void;
+
+        /**
+         * @brief       Returns the adaptive timeout to use for a batch of probes to a target.
+         *
+         * @details     Each ttl of each target has its own estimate, as a near hop can answer in well under a
+         *              millisecond while a distant one takes far longer.  The batch shares a single timeout so
+         *              the largest timeout of the hops in the batch is used.
+         *
+         * @param[in]   targetAddress the address of the target.
+         * @param[in]   firstHop the first ttl in the batch.
+         * @param[in]   hopCount the number of ttls in the batch.
+         *
+         * @returns     the timeout in seconds.
+         */
+        auto probeTimeout(const QHostAddress &targetAddress, int firstHop, int hopCount) -> double;
+
+        /**
+         * @brief       Updates the adaptive timeout of a hop with the result of a probe.
+         *
+         * @param[in]   targetAddress the address of the target.
+         * @param[in]   hop the ttl of the probe.
+         * @param[in]   pingResult the result of the probe.
+         */
+        auto addProbeResult(
+            const QHostAddress &targetAddress,
+            int hop,
+            const Nedrysoft::RouteAnalyser::PingResult &pingResult
+        ) -> void;
+
+        /**
+         * @brief       Backs off the adaptive timeout of the hops in a wave that timed out too early.
+         *
+         * @details     A hop that has answered before but did not answer while a deeper hop in the same wave did
+         *              is most likely answering after the deadline, so its timeout is doubled.  A hop that has
+         *              never answered is a silent router and is left alone.
+         *
+         * @param[in]   targetAddress the address of the target.
+         * @param[in]   firstHop the ttl of the first result.
+         * @param[in]   probeResults the results of the wave, ordered by ttl.
+         */
+        auto addProbeLosses(
+            const QHostAddress &targetAddress,
+            int firstHop,
+            const QVector<Nedrysoft::RouteAnalyser::PingResult> &probeResults
+        ) -> void;
+
+        /**
+         * @brief       Enumerates the responders at each hop of a discovered route.
+         *
+         * @details     Implements the Multipath Detection Algorithm, probes with different flow identifiers are
+         *              sent to a hop until enough have been sent to rule out a further responder with 95%
+         *              confidence, so single path hops cost only a handful of probes.
+         *
+         * @param[in]   pingEngine the engine to send the probes with.
+         * @param[in]   targetAddress the address of the target.
+         * @param[in]   route the route found by flow stable discovery.
+         */
+        auto discoverMultipath(
+            Nedrysoft::RouteAnalyser::IPingEngine *pingEngine,
+            const QHostAddress &targetAddress,
+            const Nedrysoft::RouteAnalyser::RouteList &route
+        ) -> void;
+
     private:
         //! @cond
 
         Nedrysoft::RouteAnalyser::IPingEngineFactory *m_pingEngineFactory;
         Nedrysoft::Core::IPVersion m_ipVersion;
+        Nedrysoft::RouteAnalyser::IRouteEngine::DiscoveryMode m_discoveryMode;
         QString m_host;
+        uint16_t m_flowId;
+
+        QHash<QPair<QHostAddress, int>, Nedrysoft::RouteAnalyser::RetransmissionTimeout> m_retransmissionTimeouts;
+        QMutex m_retransmissionTimeoutMutex;
 
         int m_maximumHops;
+        int m_waveSize;
         bool m_isRunning;
 
+        std::shared_ptr<std::atomic<int> > m_retraceInterval;
+        std::shared_ptr<Nedrysoft::RouteEngine::BulkRouteDiscovery> m_bulkDiscovery;
+
         //! @endcond
     };
 }}
@@ -0,0 +1,493 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 19/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "GeoIPCache.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QHostAddress>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QList>
+#include <QPair>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QStringList>
+#include <QThread>
+#include <QTimer>
+#include <spdlog/spdlog.h>
+
+constexpr auto MillisecondsPerSecond = 1000;
+constexpr auto DefaultIPv4PrefixLength = 24;
+constexpr auto DefaultIPv6PrefixLength = 48;
+
+/**
+ * @brief       Returns the key of an address.
+ *
+ * @param[in]   host the host address string.
+ * @param[out]  key the key of the address.
+ * @param[out]  isIPv4 true if the address is an IPv4 address; otherwise false.
+ *
+ * @returns     true if the host is an IPv4 or IPv6 address; otherwise false.
+ */
+static auto addressKey(const QString &host, Nedrysoft::GeoIPCache::PrefixKey &key, bool &isIPv4) -> bool {
+    auto hostAddress = QHostAddress();
+
+    if (!hostAddress.setAddress(host)) {
+        return false;
+    }
+
+    isIPv4 = hostAddress.protocol()==QAbstractSocket::IPv4Protocol;
+
+    return Nedrysoft::GeoIPCache::PrefixKey::fromAddress(hostAddress, key);
+}
+
+/**
+ * @brief       Returns the name of a network as it is stored in the database.
+ *
+ * @param[in]   key the network key.
+ * @param[in]   keyPrefixLength the prefix length of the network key.
+ *
+ * @returns     the network name.
+ */
+static auto networkName(const Nedrysoft::GeoIPCache::PrefixKey &key, int keyPrefixLength) -> QString {
+    auto networkKey = key.masked(keyPrefixLength);
+    auto bytes = QByteArray(reinterpret_cast<const char *>(networkKey.m_bytes), sizeof(networkKey.m_bytes));
+
+    return QString("%1/%2").arg(QString::fromLatin1(bytes.toHex())).arg(keyPrefixLength);
+}
+
+/**
+ * @brief       Returns the database connection for the calling thread, opening it on first use.
+ *
+ * @param[in]   connectionName the name of the connection.
+ * @param[in]   filename the filename of the database.
+ *
+ * @returns     the database connection, invalid if it could not be opened.
+ */
+static auto cacheDatabase(const QString &connectionName, const QString &filename) -> QSqlDatabase {
+    if (QSqlDatabase::contains(connectionName)) {
+        return QSqlDatabase::database(connectionName);
+    }
+
+    auto database = QSqlDatabase::addDatabase("QSQLITE", connectionName);
+    auto dbFileInfo = QFileInfo(filename);
+
+    database.setDatabaseName(dbFileInfo.absoluteFilePath());
+
+    if (!dbFileInfo.dir().exists()) {
+        auto dir = QDir();
+
+        if (!dir.mkpath(dbFileInfo.dir().absolutePath())) {
+            SPDLOG_ERROR(
+                QString("error creating database folder. (%1)").arg(dbFileInfo.dir().absolutePath()).toStdString()
+            );
+
+            return database;
+        }
+    }
+
+    if (!database.open()) {
+        SPDLOG_ERROR(QString("error opening database. (%1)").arg(database.lastError().text()).toStdString());
+
+        return database;
+    }
+
+    /**
+     * the write ahead log lets lookups continue while a result is being written, the table is keyed on the network
+     * so that a lookup is a few index searches rather than a scan.  the tables used by earlier versions were keyed
+     * on the address and are removed.
+     */
+
+    auto statements = QStringList() <<
+            "PRAGMA journal_mode=WAL" <<
+            "PRAGMA synchronous=NORMAL" <<
+            "DROP TABLE IF EXISTS ip" <<
+            "DROP TABLE IF EXISTS geoip" <<
+            R"(CREATE TABLE IF NOT EXISTS network (
+                   network TEXT PRIMARY KEY NOT NULL,
+                   prefixLength INTEGER NOT NULL,
+                   expiryTime INTEGER NOT NULL,
+                   negative INTEGER NOT NULL,
+                   result TEXT
+            ))";
+
+    auto query = QSqlQuery(database);
+
+    for (const auto &statement : statements) {
+        if (!query.exec(statement)) {
+            SPDLOG_WARN(QString("error preparing database. (%1)").arg(query.lastError().text()).toStdString());
+        }
+    }
+
+    query.prepare("DELETE FROM network WHERE expiryTime<=:now");
+    query.bindValue(":now", QDateTime::currentMSecsSinceEpoch());
+
+    if (!query.exec()) {
+        SPDLOG_WARN(QString("error removing expired records. (%1)").arg(query.lastError().text()).toStdString());
+    }
+
+    query.finish();
+
+    return database;
+}
+
+Nedrysoft::GeoIPCache::GeoIPCache::GeoIPCache(const QString &filename, int capacity, QObject *parent) :
+        QObject(parent),
+        m_capacity(qMax(1, capacity)),
+        m_ipv4PrefixLength(DefaultIPv4PrefixLength),
+        m_ipv6PrefixLength(DefaultIPv6PrefixLength),
+        m_databaseThread(new QThread),
+        m_databaseContext(new QObject),
+        m_filename(filename),
+        m_connectionName(QString("Nedrysoft::GeoIPCache::GeoIPCache(%1)").arg(reinterpret_cast<quintptr>(this))) {
+
+    /**
+     * the connection is only used by the database thread, every query is posted to it so that the caller never
+     * waits for the disk.
+     */
+
+    m_databaseContext->moveToThread(m_databaseThread);
+
+    m_databaseThread->start();
+}
+
+Nedrysoft::GeoIPCache::GeoIPCache::~GeoIPCache() {
+    auto connectionName = m_connectionName;
+    auto databaseThread = m_databaseThread;
+
+    /**
+     * the thread is stopped from its own queue so that any writes that are still waiting are made first.
+     */
+
+    QTimer::singleShot(0, m_databaseContext, [connectionName, databaseThread]() {
+        if (QSqlDatabase::contains(connectionName)) {
+            QSqlDatabase::database(connectionName, false).close();
+
+            QSqlDatabase::removeDatabase(connectionName);
+        }
+
+        databaseThread->quit();
+    });
+
+    m_databaseThread->wait();
+
+    delete m_databaseContext;
+    delete m_databaseThread;
+}
+
+auto Nedrysoft::GeoIPCache::GeoIPCache::lookup(
+        const QString &host,
+        QVariantMap &result ) -> Nedrysoft::GeoIPCache::GeoIPCache::Status {
+
+    auto key = Nedrysoft::GeoIPCache::PrefixKey();
+    auto isIPv4 = false;
+
+    if (!addressKey(host, key, isIPv4)) {
+        return Status::Miss;
+    }
+
+    auto currentTime = QDateTime::currentMSecsSinceEpoch();
+
+    /**
+     * an expired entry is removed and the search repeated, a shorter prefix that contains the address may still
+     * be valid.
+     */
+
+    while (auto match = m_trie.longestMatch(key)) {
+        auto entry = *match;
+
+        if (entry->m_expiryTime<=currentTime) {
+            m_trie.remove(entry->m_key, entry->m_prefixLength);
+            m_entries.erase(entry);
+
+            continue;
+        }
+
+        m_entries.splice(m_entries.begin(), m_entries, entry);
+
+        if (entry->m_negative) {
+            return Status::NegativeHit;
+        }
+
+        result = entry->m_result;
+
+        return Status::Hit;
+    }
+
+    return Status::Miss;
+}
+
+auto Nedrysoft::GeoIPCache::GeoIPCache::lookup(const QString &host, LookupFunction function) -> void {
+    auto result = QVariantMap();
+    auto status = lookup(host, result);
+    auto key = Nedrysoft::GeoIPCache::PrefixKey();
+    auto isIPv4 = false;
+
+    if ((status!=Status::Miss) || (!addressKey(host, key, isIPv4))) {
+        function(status, result);
+
+        return;
+    }
+
+    /**
+     * the database is asked for every network that could contain the address and the longest one that has not
+     * expired is used.
+     */
+
+    auto networks = QStringList();
+    auto minimumPrefixLength = isIPv4 ? Nedrysoft::GeoIPCache::PrefixKey::IPv4Offset : 0;
+
+    for (auto keyPrefixLength = minimumPrefixLength; keyPrefixLength<=PrefixKey::Bits; keyPrefixLength++) {
+        networks.append(networkName(key, keyPrefixLength));
+    }
+
+    auto connectionName = m_connectionName;
+    auto filename = m_filename;
+
+    QTimer::singleShot(0, m_databaseContext, [this, connectionName, filename, host, key, networks, function]() {
+        auto database = cacheDatabase(connectionName, filename);
+        auto query = QSqlQuery(database);
+        auto found = false;
+        auto negative = false;
+        auto expiryTime = qint64(0);
+        auto keyPrefixLength = 0;
+        auto storedResult = QVariantMap();
+        auto placeholders = QStringList();
+
+        for (auto index = 0; index<networks.count(); index++) {
+            placeholders.append("?");
+        }
+
+        query.prepare(
+            QString("SELECT prefixLength, expiryTime, negative, result FROM network "
+                    "WHERE network IN (%1) AND expiryTime>? ORDER BY prefixLength DESC LIMIT 1").
+                    arg(placeholders.join(","))
+        );
+
+        for (const auto &network : networks) {
+            query.addBindValue(network);
+        }
+
+        query.addBindValue(QDateTime::currentMSecsSinceEpoch());
+
+        if (query.exec()) {
+            if (query.next()) {
+                keyPrefixLength = query.value(0).toInt();
+                expiryTime = query.value(1).toLongLong();
+                negative = query.value(2).toBool();
+                storedResult = QJsonDocument::fromJson(query.value(3).toByteArray()).object().toVariantMap();
+
+                found = true;
+            }
+        } else {
+            SPDLOG_WARN(QString("error finding record. (%1)").arg(query.lastError().text()).toStdString());
+        }
+
+        query.finish();
+
+        /**
+         * the result is handed back to the thread of the cache, the destructor waits for this thread so the
+         * cache still exists here.
+         */
+
+        QTimer::singleShot(0, this, [=]() {
+            auto result = QVariantMap();
+
+            /**
+             * a result that was added while the database was being searched is newer than the stored one.
+             */
+
+            auto status = lookup(host, result);
+
+            if ((status==Status::Miss) && found) {
+                insert(key, keyPrefixLength, storedResult, expiryTime, negative);
+
+                result = storedResult;
+                status = negative ? Status::NegativeHit : Status::Hit;
+            }
+
+            function(status, result);
+        });
+    });
+}
+
+auto Nedrysoft::GeoIPCache::GeoIPCache::add(
+        const QString &host,
+        const QVariantMap &result,
+        int timeToLive,
+        int prefixLength ) -> void {
+
+    addEntry(host, result, timeToLive, prefixLength, false);
+}
+
+auto Nedrysoft::GeoIPCache::GeoIPCache::addNegative(const QString &host, int timeToLive, int prefixLength) -> void {
+    addEntry(host, QVariantMap(), timeToLive, prefixLength, true);
+}
+
+auto Nedrysoft::GeoIPCache::GeoIPCache::setDefaultPrefixLength(int ipv4PrefixLength, int ipv6PrefixLength) -> void {
+    m_ipv4PrefixLength = qBound(0, ipv4PrefixLength, 32);
+    m_ipv6PrefixLength = qBound(0, ipv6PrefixLength, 128);
+}
+
+auto Nedrysoft::GeoIPCache::GeoIPCache::count() -> int {
+    return static_cast<int>(m_entries.size());
+}
+
+auto Nedrysoft::GeoIPCache::GeoIPCache::addEntry(
+        const QString &host,
+        const QVariantMap &result,
+        int timeToLive,
+        int prefixLength,
+        bool negative ) -> void {
+
+    auto key = Nedrysoft::GeoIPCache::PrefixKey();
+    auto isIPv4 = false;
+
+    if (!addressKey(host, key, isIPv4)) {
+        return;
+    }
+
+    auto addressLength = isIPv4 ? 32 : 128;
+
+    if (prefixLength<0) {
+        prefixLength = negative ? addressLength : (isIPv4 ? m_ipv4PrefixLength : m_ipv6PrefixLength);
+    }
+
+    auto keyOffset = isIPv4 ? Nedrysoft::GeoIPCache::PrefixKey::IPv4Offset : 0;
+    auto keyPrefixLength = qMin(prefixLength, addressLength)+keyOffset;
+    auto expiryTime = QDateTime::currentMSecsSinceEpoch()+static_cast<qint64>(timeToLive)*MillisecondsPerSecond;
+
+    insert(key, keyPrefixLength, result, expiryTime, negative);
+    store(key, keyPrefixLength, result, expiryTime, negative);
+}
+
+auto Nedrysoft::GeoIPCache::GeoIPCache::insert(
+        const Nedrysoft::GeoIPCache::PrefixKey &key,
+        int keyPrefixLength,
+        const QVariantMap &result,
+        qint64 expiryTime,
+        bool negative ) -> void {
+
+    auto networkKey = key.masked(keyPrefixLength);
+    auto existingEntry = m_trie.find(networkKey, keyPrefixLength);
+
+    if (existingEntry) {
+        m_entries.erase(*existingEntry);
+    }
+
+    m_entries.push_front(Entry{networkKey, keyPrefixLength, result, expiryTime, negative});
+    m_trie.insert(networkKey, keyPrefixLength, m_entries.begin());
+
+    while (static_cast<int>(m_entries.size())>m_capacity) {
+        m_trie.remove(m_entries.back().m_key, m_entries.back().m_prefixLength);
+        m_entries.pop_back();
+    }
+}
+
+auto Nedrysoft::GeoIPCache::GeoIPCache::store(
+        const Nedrysoft::GeoIPCache::PrefixKey &key,
+        int keyPrefixLength,
+        const QVariantMap &result,
+        qint64 expiryTime,
+        bool negative ) -> void {
+
+    auto connectionName = m_connectionName;
+    auto filename = m_filename;
+    auto network = networkName(key, keyPrefixLength);
+    auto resultText = QString();
+
+    if (!negative) {
+        auto resultDocument = QJsonDocument(QJsonObject::fromVariantMap(result));
+
+        resultText = QString::fromUtf8(resultDocument.toJson(QJsonDocument::Compact));
+    }
+
+    QTimer::singleShot(0, m_databaseContext, [=]() {
+        auto database = cacheDatabase(connectionName, filename);
+        auto query = QSqlQuery(database);
+
+        query.prepare(
+                "INSERT OR REPLACE INTO network (network, prefixLength, expiryTime, negative, result) "
+                "VALUES (:network, :prefixLength, :expiryTime, :negative, :result)");
+
+        query.bindValue(":network", network);
+        query.bindValue(":prefixLength", keyPrefixLength);
+        query.bindValue(":expiryTime", expiryTime);
+        query.bindValue(":negative", negative ? 1 : 0);
+        query.bindValue(":result", resultText);
+
+        if (!query.exec()) {
+            SPDLOG_WARN(QString("error adding record. (%1)").arg(query.lastError().text()).toStdString());
+        }
+
+        query.finish();
+    });
+}
+
+auto Nedrysoft::GeoIPCache::GeoIPCache::isPrivateAddress(const QString &host) -> bool {
+    static const auto privateSubnets = QList<QPair<QHostAddress, int> >() <<
+            QHostAddress::parseSubnet("0.0.0.0/8") <<
+            QHostAddress::parseSubnet("10.0.0.0/8") <<
+            QHostAddress::parseSubnet("100.64.0.0/10") <<
+            QHostAddress::parseSubnet("127.0.0.0/8") <<
+            QHostAddress::parseSubnet("169.254.0.0/16") <<
+            QHostAddress::parseSubnet("172.16.0.0/12") <<
+            QHostAddress::parseSubnet("192.168.0.0/16") <<
+            QHostAddress::parseSubnet("224.0.0.0/4") <<
+            QHostAddress::parseSubnet("240.0.0.0/4") <<
+            QHostAddress::parseSubnet("::/128") <<
+            QHostAddress::parseSubnet("::1/128") <<
+            QHostAddress::parseSubnet("fc00::/7") <<
+            QHostAddress::parseSubnet("fe80::/10") <<
+            QHostAddress::parseSubnet("ff00::/8");
+
+    auto hostAddress = QHostAddress();
+
+    if (!hostAddress.setAddress(host)) {
+        return false;
+    }
+
+    /**
+     * an IPv4 address mapped into IPv6 is checked as the IPv4 address.
+     */
+
+    if (hostAddress.protocol()==QAbstractSocket::IPv6Protocol) {
+        auto isMapped = false;
+        auto ipv4Address = hostAddress.toIPv4Address(&isMapped);
+
+        if (isMapped) {
+            hostAddress = QHostAddress(ipv4Address);
+        }
+    }
+
+    for (const auto &subnet : privateSubnets) {
+        if (hostAddress.isInSubnet(subnet)) {
+            return true;
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,249 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 19/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NEDRYSOFT_GEOIPCACHE_GEOIPCACHE_H
+#define NEDRYSOFT_GEOIPCACHE_GEOIPCACHE_H
+
+#include "PrefixTrie.h"
+
+#include <QObject>
+#include <QString>
+#include <QVariantMap>
+#include <functional>
+#include <list>
+
+#if ( defined(NEDRYSOFT_LIBRARY_GEOIPCACHE_EXPORT))
+#define NEDRYSOFT_GEOIPCACHE_DLLSPEC Q_DECL_EXPORT
+#else
+#define NEDRYSOFT_GEOIPCACHE_DLLSPEC Q_DECL_IMPORT
+#endif
+
+class QThread;
+
+namespace Nedrysoft { namespace GeoIPCache {
+    /**
+     * @brief       The GeoIPCache class provides a persistent cache for geo ip lookup results.
+     *
+     * @details     Results are stored against the network that contains the address rather than the address
+     *              itself, so every address in a network is answered by one entry.  The network is the prefix
+     *              given when the result is added, or the default prefix length for the protocol.
+     *
+     *              Results are held in a bounded in-memory cache which evicts the least recently used entry, a
+     *              lookup finds the longest cached prefix that contains the address in a radix trie.  Every
+     *              result is also written to an SQLite database so that it survives a restart, the database is
+     *              only ever accessed from a thread of its own and the table is indexed on the network.
+     *
+     *              Every entry has a time to live, a host that a provider could not locate can be stored as a
+     *              negative entry so that it is not looked up again until that entry expires.
+     *
+     *              Only IPv4 and IPv6 addresses are cached, any other host is always a miss.  The cache is not
+     *              thread safe, it must only be used from the thread that it belongs to and the results of
+     *              asynchronous lookups are delivered on that thread.
+     */
+    class NEDRYSOFT_GEOIPCACHE_DLLSPEC GeoIPCache :
+            public QObject {
+
+        private:
+            Q_OBJECT
+
+        public:
+            /**
+             * @brief       The result of a cache lookup.
+             */
+            enum class Status {
+                Miss,                       /**< the host is not in the cache. */
+                Hit,                        /**< the host is in the cache. */
+                NegativeHit                 /**< the host is in the cache as one that could not be located. */
+            };
+
+            /**
+             * @brief       The callback used to deliver the result of an asynchronous lookup.
+             */
+            typedef std::function<void(Nedrysoft::GeoIPCache::GeoIPCache::Status status, const QVariantMap &result)>
+                    LookupFunction;
+
+            /**
+             * @brief       Constructs a GeoIPCache.
+             *
+             * @param[in]   filename the filename of the database, the folder is created if it does not exist.
+             * @param[in]   capacity the maximum number of entries that are held in memory.
+             * @param[in]   parent the parent object.
+             */
+            explicit GeoIPCache(const QString &filename, int capacity = 4096, QObject *parent = nullptr);
+
+            /**
+             * @brief       Destroys the GeoIPCache.
+             *
+             * @details     Waits for any outstanding writes to be made to the database.
+             */
+            ~GeoIPCache() override;
+
+            /**
+             * @brief       Looks up a host in memory.
+             *
+             * @param[in]   host the host address string.
+             * @param[out]  result the cached result if the host was found.
+             *
+             * @returns     the status of the host in the cache.
+             */
+            auto lookup(const QString &host, QVariantMap &result) -> Nedrysoft::GeoIPCache::GeoIPCache::Status;
+
+            /**
+             * @brief       Looks up a host in memory and then in the database.
+             *
+             * @details     If the host is held in memory then the function is called before this returns,
+             *              otherwise the database is queried on its thread and the function is called later on
+             *              the thread of the cache.
+             *
+             * @param[in]   host the host address string.
+             * @param[in]   function the function to call with the result.
+             */
+            auto lookup(const QString &host, LookupFunction function) -> void;
+
+            /**
+             * @brief       Adds a result to the cache.
+             *
+             * @param[in]   host the host address string.
+             * @param[in]   result the result of the lookup.
+             * @param[in]   timeToLive the number of seconds that the result is valid for.
+             * @param[in]   prefixLength the prefix length of the network that the result applies to, -1 to use
+             *              the default prefix length for the protocol.
+             */
+            auto add(const QString &host, const QVariantMap &result, int timeToLive, int prefixLength = -1) -> void;
+
+            /**
+             * @brief       Adds a negative entry for a host that could not be located.
+             *
+             * @param[in]   host the host address string.
+             * @param[in]   timeToLive the number of seconds until the host may be looked up again.
+             * @param[in]   prefixLength the prefix length of the network that could not be located, -1 for only
+             *              the address itself.
+             */
+            auto addNegative(const QString &host, int timeToLive, int prefixLength = -1) -> void;
+
+            /**
+             * @brief       Sets the prefix lengths used for results that are added without one.
+             *
+             * @param[in]   ipv4PrefixLength the IPv4 prefix length. (0-32)
+             * @param[in]   ipv6PrefixLength the IPv6 prefix length. (0-128)
+             */
+            auto setDefaultPrefixLength(int ipv4PrefixLength, int ipv6PrefixLength) -> void;
+
+            /**
+             * @brief       Returns the number of entries held in memory.
+             *
+             * @returns     the number of entries.
+             */
+            auto count() -> int;
+
+            /**
+             * @brief       Checks whether an address can never be located by a geo ip provider.
+             *
+             * @details     Loopback, private, shared, link local, multicast and reserved addresses are never
+             *              routed on the internet, providers can answer these without making a request.
+             *
+             * @param[in]   host the host address string.
+             *
+             * @returns     true if the address is private or reserved; otherwise false.
+             */
+            static auto isPrivateAddress(const QString &host) -> bool;
+
+        private:
+            /**
+             * @brief       Adds an entry for a host to both the memory and the database.
+             *
+             * @param[in]   host the host address string.
+             * @param[in]   result the result of the lookup, empty if negative.
+             * @param[in]   timeToLive the number of seconds that the entry is valid for.
+             * @param[in]   prefixLength the prefix length for the protocol of the host.
+             * @param[in]   negative true if the entry is negative; otherwise false.
+             */
+            auto addEntry(
+                const QString &host,
+                const QVariantMap &result,
+                int timeToLive,
+                int prefixLength,
+                bool negative
+            ) -> void;
+
+            /**
+             * @brief       Adds an entry to the front of the in-memory cache, evicting the oldest if it is full.
+             *
+             * @param[in]   key the network key.
+             * @param[in]   keyPrefixLength the prefix length of the network key.
+             * @param[in]   result the result of the lookup, empty if negative.
+             * @param[in]   expiryTime the time that the entry expires. (msecs since epoch)
+             * @param[in]   negative true if the entry is negative; otherwise false.
+             */
+            auto insert(
+                const Nedrysoft::GeoIPCache::PrefixKey &key,
+                int keyPrefixLength,
+                const QVariantMap &result,
+                qint64 expiryTime,
+                bool negative
+            ) -> void;
+
+            /**
+             * @brief       Writes an entry to the database on the database thread.
+             *
+             * @param[in]   key the network key.
+             * @param[in]   keyPrefixLength the prefix length of the network key.
+             * @param[in]   result the result of the lookup, empty if negative.
+             * @param[in]   expiryTime the time that the entry expires. (msecs since epoch)
+             * @param[in]   negative true if the entry is negative; otherwise false.
+             */
+            auto store(
+                const Nedrysoft::GeoIPCache::PrefixKey &key,
+                int keyPrefixLength,
+                const QVariantMap &result,
+                qint64 expiryTime,
+                bool negative
+            ) -> void;
+
+        private:
+            //! @cond
+
+            struct Entry {
+                Nedrysoft::GeoIPCache::PrefixKey m_key;
+                int m_prefixLength;
+                QVariantMap m_result;
+                qint64 m_expiryTime;
+                bool m_negative;
+            };
+
+            std::list<Entry> m_entries;
+            Nedrysoft::GeoIPCache::PrefixTrie<std::list<Entry>::iterator> m_trie;
+            int m_capacity;
+            int m_ipv4PrefixLength;
+            int m_ipv6PrefixLength;
+
+            QThread *m_databaseThread;
+            QObject *m_databaseContext;
+            QString m_filename;
+            QString m_connectionName;
+
+            //! @endcond
+    };
+}}
+
+#endif // NEDRYSOFT_GEOIPCACHE_GEOIPCACHE_H
@@ -0,0 +1,359 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 19/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NEDRYSOFT_GEOIPCACHE_PREFIXTRIE_H
+#define NEDRYSOFT_GEOIPCACHE_PREFIXTRIE_H
+
+#include <QHostAddress>
+#include <QtGlobal>
+#include <cstring>
+#include <memory>
+
+namespace Nedrysoft { namespace GeoIPCache {
+    /**
+     * @brief       The PrefixKey class holds an address as the 128 bit key of a PrefixTrie.
+     *
+     * @details     IPv4 addresses are stored as IPv4 mapped IPv6 addresses (::ffff:a.b.c.d) so that both
+     *              protocols share one trie, an IPv4 prefix length of n is a key prefix length of 96+n.
+     */
+    struct PrefixKey {
+        static constexpr int Bits = 128;
+        static constexpr int IPv4Offset = 96;
+
+        quint8 m_bytes[16];
+
+        /**
+         * @brief       Creates the key for an address.
+         *
+         * @param[in]   address the address.
+         * @param[out]  key the key.
+         *
+         * @returns     true if the address is an IPv4 or IPv6 address; otherwise false.
+         */
+        static auto fromAddress(const QHostAddress &address, PrefixKey &key) -> bool {
+            if (address.protocol()==QAbstractSocket::IPv4Protocol) {
+                auto ipv4Address = address.toIPv4Address();
+
+                memset(key.m_bytes, 0, 10);
+
+                key.m_bytes[10] = 0xFF;
+                key.m_bytes[11] = 0xFF;
+                key.m_bytes[12] = static_cast<quint8>(ipv4Address>>24);
+                key.m_bytes[13] = static_cast<quint8>(ipv4Address>>16);
+                key.m_bytes[14] = static_cast<quint8>(ipv4Address>>8);
+                key.m_bytes[15] = static_cast<quint8>(ipv4Address);
+
+                return true;
+            }
+
+            if (address.protocol()==QAbstractSocket::IPv6Protocol) {
+                auto ipv6Address = address.toIPv6Address();
+
+                memcpy(key.m_bytes, &ipv6Address, sizeof(key.m_bytes));
+
+                return true;
+            }
+
+            return false;
+        }
+
+        /**
+         * @brief       Returns the value of a bit of the key.
+         *
+         * @param[in]   bit the bit number, 0 is the most significant bit.
+         *
+         * @returns     the value of the bit.
+         */
+        auto bit(int bit) const -> int {
+            return (m_bytes[bit>>3]>>(7-(bit&7))) & 1;
+        }
+
+        /**
+         * @brief       Returns a copy of the key with every bit after the prefix cleared.
+         *
+         * @param[in]   prefixLength the number of bits to keep.
+         *
+         * @returns     the masked key.
+         */
+        auto masked(int prefixLength) const -> PrefixKey {
+            auto key = *this;
+
+            for (auto byte = 0; byte<16; byte++) {
+                auto keep = qBound(0, prefixLength-byte*8, 8);
+
+                key.m_bytes[byte] &= static_cast<quint8>(0xFF00>>keep);
+            }
+
+            return key;
+        }
+
+        /**
+         * @brief       Returns the number of leading bits that two keys have in common.
+         *
+         * @param[in]   other the key to compare with.
+         * @param[in]   maximumLength the maximum number of bits to compare.
+         *
+         * @returns     the length of the common prefix.
+         */
+        auto commonPrefixLength(const PrefixKey &other, int maximumLength) const -> int {
+            for (auto byte = 0; byte*8<maximumLength; byte++) {
+                auto difference = m_bytes[byte] ^ other.m_bytes[byte];
+
+                if (difference) {
+                    auto length = byte*8;
+
+                    while (!(difference & 0x80)) {
+                        difference <<= 1;
+                        length++;
+                    }
+
+                    return qMin(length, maximumLength);
+                }
+            }
+
+            return maximumLength;
+        }
+    };
+
+    /**
+     * @brief       The PrefixTrie class maps network prefixes to values and finds the longest prefix that contains
+     *              an address.
+     *
+     * @details     A path compressed binary radix trie, a node is only created where a prefix is stored or where
+     *              two stored prefixes diverge, so a lookup visits at most one node per stored prefix on the path
+     *              rather than one node per bit.
+     */
+    template <typename T>
+    class PrefixTrie {
+        public:
+            /**
+             * @brief       Stores a value for a prefix, replacing any value already stored for it.
+             *
+             * @param[in]   key the key, bits after the prefix are ignored.
+             * @param[in]   prefixLength the prefix length. (0-128)
+             * @param[in]   value the value.
+             */
+            auto insert(const PrefixKey &key, int prefixLength, const T &value) -> void {
+                insertNode(m_root, key.masked(prefixLength), prefixLength, value);
+            }
+
+            /**
+             * @brief       Removes the value stored for a prefix.
+             *
+             * @param[in]   key the key, bits after the prefix are ignored.
+             * @param[in]   prefixLength the prefix length. (0-128)
+             *
+             * @returns     true if a value was removed; otherwise false.
+             */
+            auto remove(const PrefixKey &key, int prefixLength) -> bool {
+                return removeNode(m_root, key, prefixLength);
+            }
+
+            /**
+             * @brief       Finds the value stored for a prefix.
+             *
+             * @param[in]   key the key, bits after the prefix are ignored.
+             * @param[in]   prefixLength the prefix length. (0-128)
+             *
+             * @returns     the value if the prefix is stored; otherwise nullptr.
+             */
+            auto find(const PrefixKey &key, int prefixLength) const -> const T * {
+                auto node = m_root.get();
+
+                while ((node) && (node->m_prefixLength<=prefixLength)) {
+                    if (key.commonPrefixLength(node->m_key, node->m_prefixLength)!=node->m_prefixLength) {
+                        return nullptr;
+                    }
+
+                    if (node->m_prefixLength==prefixLength) {
+                        return node->m_hasValue ? &node->m_value : nullptr;
+                    }
+
+                    node = node->m_children[key.bit(node->m_prefixLength)].get();
+                }
+
+                return nullptr;
+            }
+
+            /**
+             * @brief       Finds the value of the longest stored prefix that contains a key.
+             *
+             * @param[in]   key the key to find.
+             * @param[out]  prefixLength the length of the prefix that was found, may be nullptr.
+             *
+             * @returns     the value if a prefix was found; otherwise nullptr.
+             */
+            auto longestMatch(const PrefixKey &key, int *prefixLength = nullptr) const -> const T * {
+                const Node *bestNode = nullptr;
+                auto node = m_root.get();
+
+                while (node) {
+                    if (key.commonPrefixLength(node->m_key, node->m_prefixLength)!=node->m_prefixLength) {
+                        break;
+                    }
+
+                    if (node->m_hasValue) {
+                        bestNode = node;
+                    }
+
+                    if (node->m_prefixLength==PrefixKey::Bits) {
+                        break;
+                    }
+
+                    node = node->m_children[key.bit(node->m_prefixLength)].get();
+                }
+
+                if (!bestNode) {
+                    return nullptr;
+                }
+
+                if (prefixLength) {
+                    *prefixLength = bestNode->m_prefixLength;
+                }
+
+                return &bestNode->m_value;
+            }
+
+            /**
+             * @brief       Removes every prefix.
+             */
+            auto clear() -> void {
+                m_root.reset();
+            }
+
+        private:
+            //! @cond
+
+            struct Node {
+                PrefixKey m_key;
+                int m_prefixLength;
+                bool m_hasValue;
+                T m_value;
+                std::unique_ptr<Node> m_children[2];
+            };
+
+            static auto createNode(const PrefixKey &key, int prefixLength) -> std::unique_ptr<Node> {
+                auto node = std::unique_ptr<Node>(new Node);
+
+                node->m_key = key;
+                node->m_prefixLength = prefixLength;
+                node->m_hasValue = false;
+                node->m_value = T();
+
+                return node;
+            }
+
+            static auto insertNode(
+                    std::unique_ptr<Node> &slot,
+                    const PrefixKey &key,
+                    int prefixLength,
+                    const T &value ) -> void {
+
+                if (!slot) {
+                    slot = createNode(key, prefixLength);
+
+                    slot->m_hasValue = true;
+                    slot->m_value = value;
+
+                    return;
+                }
+
+                auto commonLength = key.commonPrefixLength(slot->m_key, qMin(prefixLength, slot->m_prefixLength));
+
+                /**
+                 * the prefix diverges from this node (or is shorter than it), a node is inserted above it at the
+                 * point where they diverge.
+                 */
+
+                if (commonLength<slot->m_prefixLength) {
+                    auto parent = createNode(key.masked(commonLength), commonLength);
+                    auto existingBit = slot->m_key.bit(commonLength);
+
+                    parent->m_children[existingBit] = std::move(slot);
+
+                    if (commonLength==prefixLength) {
+                        parent->m_hasValue = true;
+                        parent->m_value = value;
+                    } else {
+                        insertNode(parent->m_children[key.bit(commonLength)], key, prefixLength, value);
+                    }
+
+                    slot = std::move(parent);
+
+                    return;
+                }
+
+                if (prefixLength==slot->m_prefixLength) {
+                    slot->m_hasValue = true;
+                    slot->m_value = value;
+
+                    return;
+                }
+
+                insertNode(slot->m_children[key.bit(slot->m_prefixLength)], key, prefixLength, value);
+            }
+
+            static auto removeNode(std::unique_ptr<Node> &slot, const PrefixKey &key, int prefixLength) -> bool {
+                if ((!slot) || (slot->m_prefixLength>prefixLength)) {
+                    return false;
+                }
+
+                if (key.commonPrefixLength(slot->m_key, slot->m_prefixLength)!=slot->m_prefixLength) {
+                    return false;
+                }
+
+                if (slot->m_prefixLength==prefixLength) {
+                    if (!slot->m_hasValue) {
+                        return false;
+                    }
+
+                    slot->m_hasValue = false;
+                    slot->m_value = T();
+                } else if (!removeNode(slot->m_children[key.bit(slot->m_prefixLength)], key, prefixLength)) {
+                    return false;
+                }
+
+                /**
+                 * a node without a value is only kept while it joins two branches.
+                 */
+
+                if (!slot->m_hasValue) {
+                    if ((!slot->m_children[0]) && (!slot->m_children[1])) {
+                        slot.reset();
+                    } else if (!slot->m_children[0]) {
+                        slot = std::move(slot->m_children[1]);
+                    } else if (!slot->m_children[1]) {
+                        slot = std::move(slot->m_children[0]);
+                    }
+                }
+
+                return true;
+            }
+
+            std::unique_ptr<Node> m_root;
+
+            //! @endcond
+    };
+}}
+
+#endif // NEDRYSOFT_GEOIPCACHE_PREFIXTRIE_H
@@ -0,0 +1,458 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 19/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "HostResolver.h"
+
+#include <QDnsLookup>
+#include <QHostInfo>
+#include <QMetaObject>
+#include <QThread>
+
+constexpr auto DefaultNegativeTimeToLive = 30;
+constexpr auto FallbackTimeToLive = 60;
+constexpr auto MaximumTimeToLive = 24*60*60;
+constexpr auto DefaultMaximumReverseLookups = 8;
+
+auto Nedrysoft::HostResolver::DnsResolverBackend::lookup(
+        const QString &host,
+        QAbstractSocket::NetworkLayerProtocol protocol,
+        Callback callback ) -> void {
+
+    auto dnsLookup = new QDnsLookup(
+        protocol==QAbstractSocket::IPv6Protocol ? QDnsLookup::AAAA : QDnsLookup::A,
+        host
+    );
+
+    QObject::connect(dnsLookup, &QDnsLookup::finished, [dnsLookup, host, protocol, callback]() {
+        if (dnsLookup->error()==QDnsLookup::NoError) {
+            auto addresses = QList<QHostAddress>();
+            auto timeToLive = MaximumTimeToLive;
+
+            for (auto hostAddressRecord : dnsLookup->hostAddressRecords()) {
+                addresses.append(hostAddressRecord.value());
+
+                timeToLive = qMin(timeToLive, static_cast<int>(hostAddressRecord.timeToLive()));
+            }
+
+            if (!addresses.isEmpty()) {
+                callback(addresses, timeToLive);
+
+                dnsLookup->deleteLater();
+
+                return;
+            }
+        }
+
+        /**
+         * a name that is not in DNS may still be known to the system resolver, for example from the hosts file,
+         * so the lookup falls back to it.  The system resolver does not report a time to live so a fixed one is
+         * used.
+         */
+
+        QHostInfo::lookupHost(host, dnsLookup, [dnsLookup, protocol, callback](const QHostInfo &hostInfo) {
+            auto addresses = QList<QHostAddress>();
+
+            for (auto address : hostInfo.addresses()) {
+                if (address.protocol()==protocol) {
+                    addresses.append(address);
+                }
+            }
+
+            callback(addresses, FallbackTimeToLive);
+
+            dnsLookup->deleteLater();
+        });
+    });
+
+    dnsLookup->lookup();
+}
+
+auto Nedrysoft::HostResolver::DnsResolverBackend::reverseLookup(
+        const QHostAddress &hostAddress,
+        ReverseCallback callback ) -> void {
+
+    auto pointerName = QString();
+
+    /**
+     * the pointer record name is the address reversed, by octet for IPv4 and by nibble for IPv6, under the
+     * reverse lookup domain for the protocol.
+     */
+
+    if (hostAddress.protocol()==QAbstractSocket::IPv4Protocol) {
+        auto ipv4Address = hostAddress.toIPv4Address();
+
+        pointerName = QString("%1.%2.%3.%4.in-addr.arpa")
+            .arg(ipv4Address & 0xff)
+            .arg((ipv4Address >> 8) & 0xff)
+            .arg((ipv4Address >> 16) & 0xff)
+            .arg((ipv4Address >> 24) & 0xff);
+    } else {
+        auto ipv6Address = hostAddress.toIPv6Address();
+
+        for (int byteIndex=15;byteIndex>=0;byteIndex--) {
+            pointerName += QString("%1.%2.")
+                .arg(ipv6Address[byteIndex] & 0x0f, 0, 16)
+                .arg((ipv6Address[byteIndex] >> 4) & 0x0f, 0, 16);
+        }
+
+        pointerName += "ip6.arpa";
+    }
+
+    auto dnsLookup = new QDnsLookup(QDnsLookup::PTR, pointerName);
+
+    QObject::connect(dnsLookup, &QDnsLookup::finished, [dnsLookup, hostAddress, callback]() {
+        if (dnsLookup->error()==QDnsLookup::NoError) {
+            auto pointerRecords = dnsLookup->pointerRecords();
+
+            if (!pointerRecords.isEmpty()) {
+                auto hostName = pointerRecords.first().value();
+
+                if (hostName.endsWith(".")) {
+                    hostName.chop(1);
+                }
+
+                callback(hostName, static_cast<int>(pointerRecords.first().timeToLive()));
+
+                dnsLookup->deleteLater();
+
+                return;
+            }
+        }
+
+        /**
+         * an address with no pointer record is a definite answer, any other failure falls back to the system
+         * resolver which may know the name from another source.
+         */
+
+        if (dnsLookup->error()==QDnsLookup::NotFoundError) {
+            callback(QString(), 0);
+
+            dnsLookup->deleteLater();
+
+            return;
+        }
+
+        QHostInfo::lookupHost(hostAddress.toString(), dnsLookup, [dnsLookup, hostAddress, callback](const QHostInfo &hostInfo) {
+            auto hostName = hostInfo.hostName();
+
+            if (hostName==hostAddress.toString()) {
+                hostName.clear();
+            }
+
+            callback(hostName, FallbackTimeToLive);
+
+            dnsLookup->deleteLater();
+        });
+    });
+
+    dnsLookup->lookup();
+}
+
+Nedrysoft::HostResolver::HostResolver::HostResolver(Nedrysoft::HostResolver::ResolverBackend *backend) :
+        m_backend(backend ? backend : new Nedrysoft::HostResolver::DnsResolverBackend),
+        m_thread(new QThread),
+        m_negativeTimeToLive(DefaultNegativeTimeToLive),
+        m_activeReverseLookups(0),
+        m_maximumReverseLookups(DefaultMaximumReverseLookups),
+        m_reverseLookupHits(0),
+        m_reverseLookupMisses(0) {
+
+    m_clock.start();
+
+    /**
+     * the lookups are run on a thread of their own with an event loop, so that callers on threads without one
+     * can still wait for an answer.
+     */
+
+    connect(
+        this,
+        &Nedrysoft::HostResolver::HostResolver::lookupRequested,
+        this,
+        &Nedrysoft::HostResolver::HostResolver::onLookupRequested,
+        Qt::QueuedConnection
+    );
+
+    connect(
+        this,
+        &Nedrysoft::HostResolver::HostResolver::reverseLookupRequested,
+        this,
+        &Nedrysoft::HostResolver::HostResolver::onReverseLookupRequested,
+        Qt::QueuedConnection
+    );
+
+    moveToThread(m_thread);
+
+    m_thread->start();
+}
+
+Nedrysoft::HostResolver::HostResolver::~HostResolver() {
+    m_thread->quit();
+    m_thread->wait();
+
+    delete m_thread;
+    delete m_backend;
+}
+
+auto Nedrysoft::HostResolver::HostResolver::getInstance() -> Nedrysoft::HostResolver::HostResolver * {
+    static auto instance = new Nedrysoft::HostResolver::HostResolver;
+
+    return instance;
+}
+
+auto Nedrysoft::HostResolver::HostResolver::resolve(
+        const QString &host,
+        QAbstractSocket::NetworkLayerProtocol protocol,
+        int timeout ) -> QList<QHostAddress> {
+
+    auto hostAddress = QHostAddress();
+
+    if (hostAddress.setAddress(host)) {
+        if (hostAddress.protocol()==protocol) {
+            return QList<QHostAddress>() << hostAddress;
+        }
+
+        return QList<QHostAddress>();
+    }
+
+    QElapsedTimer waitTimer;
+
+    waitTimer.start();
+
+    QMutexLocker locker(&m_mutex);
+
+    startLookups(host);
+
+    auto key = qMakePair(host.toLower(), static_cast<int>(protocol));
+
+    while (m_cache[key].m_pending) {
+        auto remainingTime = timeout-waitTimer.elapsed();
+
+        if (remainingTime<=0) {
+            return QList<QHostAddress>();
+        }
+
+        m_resolved.wait(&m_mutex, static_cast<unsigned long>(remainingTime));
+    }
+
+    return m_cache[key].m_addresses;
+}
+
+auto Nedrysoft::HostResolver::HostResolver::lookupHostName(
+        const QHostAddress &hostAddress,
+        QObject *context,
+        std::function<void(const QString &hostName)> callback ) -> void {
+
+    if (hostAddress.isNull()) {
+        callback(QString());
+
+        return;
+    }
+
+    QMutexLocker locker(&m_mutex);
+
+    auto key = hostAddress.toString();
+    auto &cacheEntry = m_reverseCache[key];
+
+    if ((!cacheEntry.m_pending) && (cacheEntry.m_expiryTime>m_clock.elapsed())) {
+        auto hostName = cacheEntry.m_hostName;
+
+        m_reverseLookupHits++;
+
+        locker.unlock();
+
+        callback(hostName);
+
+        return;
+    }
+
+    m_reverseLookupMisses++;
+
+    cacheEntry.m_callbacks.append(qMakePair(QPointer<QObject>(context), callback));
+
+    if (cacheEntry.m_pending) {
+        return;
+    }
+
+    cacheEntry.m_pending = true;
+
+    m_reverseQueue.append(key);
+
+    Q_EMIT reverseLookupRequested();
+}
+
+auto Nedrysoft::HostResolver::HostResolver::setMaximumReverseLookups(int maximumLookups) -> void {
+    QMutexLocker locker(&m_mutex);
+
+    m_maximumReverseLookups = qMax(1, maximumLookups);
+
+    Q_EMIT reverseLookupRequested();
+}
+
+auto Nedrysoft::HostResolver::HostResolver::reverseLookupHits() -> quint64 {
+    QMutexLocker locker(&m_mutex);
+
+    return m_reverseLookupHits;
+}
+
+auto Nedrysoft::HostResolver::HostResolver::reverseLookupMisses() -> quint64 {
+    QMutexLocker locker(&m_mutex);
+
+    return m_reverseLookupMisses;
+}
+
+auto Nedrysoft::HostResolver::HostResolver::setNegativeTimeToLive(int timeToLive) -> void {
+    QMutexLocker locker(&m_mutex);
+
+    m_negativeTimeToLive = qMax(0, timeToLive);
+}
+
+auto Nedrysoft::HostResolver::HostResolver::clear() -> void {
+    QMutexLocker locker(&m_mutex);
+
+    auto cacheIterator = m_cache.begin();
+
+    /**
+     * lookups that are in progress are kept so that their answers can still be delivered to the waiting callers.
+     */
+
+    while (cacheIterator!=m_cache.end()) {
+        if (cacheIterator.value().m_pending) {
+            cacheIterator++;
+        } else {
+            cacheIterator = m_cache.erase(cacheIterator);
+        }
+    }
+
+    auto reverseCacheIterator = m_reverseCache.begin();
+
+    while (reverseCacheIterator!=m_reverseCache.end()) {
+        if (reverseCacheIterator.value().m_pending) {
+            reverseCacheIterator++;
+        } else {
+            reverseCacheIterator = m_reverseCache.erase(reverseCacheIterator);
+        }
+    }
+}
+
+auto Nedrysoft::HostResolver::HostResolver::startLookups(const QString &host) -> void {
+    auto currentTime = m_clock.elapsed();
+
+    for (auto protocol : {QAbstractSocket::IPv4Protocol, QAbstractSocket::IPv6Protocol}) {
+        auto &cacheEntry = m_cache[qMakePair(host.toLower(), static_cast<int>(protocol))];
+
+        if ((cacheEntry.m_pending) || (cacheEntry.m_expiryTime>currentTime)) {
+            continue;
+        }
+
+        cacheEntry.m_pending = true;
+
+        Q_EMIT lookupRequested(host.toLower(), static_cast<int>(protocol));
+    }
+}
+
+auto Nedrysoft::HostResolver::HostResolver::onLookupRequested(const QString host, int protocol) -> void {
+    m_backend->lookup(
+        host,
+        static_cast<QAbstractSocket::NetworkLayerProtocol>(protocol),
+        [this, host, protocol](const QList<QHostAddress> &addresses, int timeToLive) {
+            QMutexLocker locker(&m_mutex);
+
+            auto &cacheEntry = m_cache[qMakePair(host, protocol)];
+
+            if (addresses.isEmpty()) {
+                timeToLive = m_negativeTimeToLive;
+            }
+
+            cacheEntry.m_addresses = addresses;
+            cacheEntry.m_expiryTime = m_clock.elapsed()+static_cast<qint64>(qBound(0, timeToLive, MaximumTimeToLive))*1000;
+            cacheEntry.m_pending = false;
+
+            m_resolved.wakeAll();
+        }
+    );
+}
+
+auto Nedrysoft::HostResolver::HostResolver::onReverseLookupRequested() -> void {
+    auto startedLookups = QStringList();
+
+    m_mutex.lock();
+
+    while ((m_activeReverseLookups<m_maximumReverseLookups) && (!m_reverseQueue.isEmpty())) {
+        startedLookups.append(m_reverseQueue.takeFirst());
+
+        m_activeReverseLookups++;
+    }
+
+    m_mutex.unlock();
+
+    /**
+     * the backend is called without the lock held as it may deliver its answer straight away.
+     */
+
+    for (auto key : startedLookups) {
+        m_backend->reverseLookup(QHostAddress(key), [this, key](const QString &hostName, int timeToLive) {
+            m_mutex.lock();
+
+            auto &cacheEntry = m_reverseCache[key];
+
+            if (hostName.isEmpty()) {
+                timeToLive = m_negativeTimeToLive;
+            }
+
+            cacheEntry.m_hostName = hostName;
+            cacheEntry.m_expiryTime = m_clock.elapsed()+static_cast<qint64>(qBound(0, timeToLive, MaximumTimeToLive))*1000;
+            cacheEntry.m_pending = false;
+
+            auto callbacks = cacheEntry.m_callbacks;
+
+            cacheEntry.m_callbacks.clear();
+
+            m_activeReverseLookups--;
+
+            m_mutex.unlock();
+
+            for (auto callback : callbacks) {
+                auto context = callback.first;
+                auto function = callback.second;
+
+                if (!context) {
+                    continue;
+                }
+
+                /**
+                 * the call is queued to the context so that it is run on the context's thread, a queued call is
+                 * discarded if the context is destroyed before it is delivered and the context is checked again on
+                 * its own thread, so the callback can never be run on the resolver thread.
+                 */
+
+                QMetaObject::invokeMethod(context.data(), [context, function, hostName]() {
+                    if (context) {
+                        function(hostName);
+                    }
+                }, Qt::QueuedConnection);
+            }
+
+            Q_EMIT reverseLookupRequested();
+        });
+    }
+}
@@ -0,0 +1,327 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 19/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NEDRYSOFT_HOSTRESOLVER_HOSTRESOLVER_H
+#define NEDRYSOFT_HOSTRESOLVER_HOSTRESOLVER_H
+
+#include <QAbstractSocket>
+#include <QElapsedTimer>
+#include <QHostAddress>
+#include <QList>
+#include <QMap>
+#include <QMutex>
+#include <QObject>
+#include <QPair>
+#include <QPointer>
+#include <QStringList>
+#include <QWaitCondition>
+#include <functional>
+
+#if ( defined(NEDRYSOFT_LIBRARY_HOSTRESOLVER_EXPORT))
+#define NEDRYSOFT_HOSTRESOLVER_DLLSPEC Q_DECL_EXPORT
+#else
+#define NEDRYSOFT_HOSTRESOLVER_DLLSPEC Q_DECL_IMPORT
+#endif
+
+class QThread;
+
+namespace Nedrysoft { namespace HostResolver {
+    /**
+     * @brief       The ResolverBackend class performs the name lookups for a HostResolver.
+     *
+     * @details     The default backend queries DNS, a backend can be replaced to resolve names from another source,
+     *              such as a stub resolver under test.
+     */
+    class NEDRYSOFT_HOSTRESOLVER_DLLSPEC ResolverBackend {
+        public:
+            /**
+             * @brief       The callback used to deliver the result of a lookup.
+             *
+             * @details     The addresses are empty if the name does not exist, the time to live is the number of
+             *              seconds that the answer may be cached for.
+             */
+            typedef std::function<void(const QList<QHostAddress> &addresses, int timeToLive)> Callback;
+
+            /**
+             * @brief       The callback used to deliver the result of a reverse lookup.
+             *
+             * @details     The host name is empty if the address has no name, the time to live is the number of
+             *              seconds that the answer may be cached for.
+             */
+            typedef std::function<void(const QString &hostName, int timeToLive)> ReverseCallback;
+
+            /**
+             * @brief       Destroys the ResolverBackend.
+             */
+            virtual ~ResolverBackend() = default;
+
+            /**
+             * @brief       Looks up the addresses of a host.
+             *
+             * @note        This is called on the thread of the resolver, which runs an event loop so that the
+             *              lookup can be asynchronous.  The callback must be called exactly once.
+             *
+             * @param[in]   host the host name to look up.
+             * @param[in]   protocol the protocol of the addresses to look up, IPv4 (A) or IPv6 (AAAA).
+             * @param[in]   callback the callback to deliver the result to.
+             */
+            virtual auto lookup(
+                const QString &host,
+                QAbstractSocket::NetworkLayerProtocol protocol,
+                Callback callback
+            ) -> void = 0;
+
+            /**
+             * @brief       Looks up the host name of an address.
+             *
+             * @note        This is called on the thread of the resolver, which runs an event loop so that the
+             *              lookup can be asynchronous.  The callback must be called exactly once.
+             *
+             * @param[in]   hostAddress the address to look up.
+             * @param[in]   callback the callback to deliver the result to.
+             */
+            virtual auto reverseLookup(
+                const QHostAddress &hostAddress,
+                ReverseCallback callback
+            ) -> void = 0;
+    };
+
+    /**
+     * @brief       The DnsResolverBackend class looks up host addresses in DNS.
+     *
+     * @details     DNS answers carry their time to live, if DNS does not answer the lookup falls back to the system
+     *              resolver so that names from the hosts file or local name services are still found.
+     */
+    class NEDRYSOFT_HOSTRESOLVER_DLLSPEC DnsResolverBackend :
+            public Nedrysoft::HostResolver::ResolverBackend {
+
+        public:
+            /**
+             * @brief       Looks up the addresses of a host.
+             *
+             * @see         Nedrysoft::HostResolver::ResolverBackend::lookup
+             *
+             * @param[in]   host the host name to look up.
+             * @param[in]   protocol the protocol of the addresses to look up, IPv4 (A) or IPv6 (AAAA).
+             * @param[in]   callback the callback to deliver the result to.
+             */
+            auto lookup(
+                const QString &host,
+                QAbstractSocket::NetworkLayerProtocol protocol,
+                Callback callback
+            ) -> void override;
+
+            /**
+             * @brief       Looks up the host name of an address.
+             *
+             * @see         Nedrysoft::HostResolver::ResolverBackend::reverseLookup
+             *
+             * @param[in]   hostAddress the address to look up.
+             * @param[in]   callback the callback to deliver the result to.
+             */
+            auto reverseLookup(
+                const QHostAddress &hostAddress,
+                ReverseCallback callback
+            ) -> void override;
+    };
+
+    /**
+     * @brief       The HostResolver class provides cached name resolution.
+     *
+     * @details     The IPv4 and IPv6 addresses of a host are always looked up at the same time, so a caller can
+     *              continue as soon as the answer for the protocol it needs arrives while the other answer is
+     *              cached for later.  Answers are cached for their time to live and names that do not exist are
+     *              cached for the negative time to live, lookups for the same name are shared between callers.
+     *
+     *              Reverse lookups are asynchronous, their results are delivered on the thread of the object that
+     *              requested them and only a limited number are in progress at a time so that a long route does
+     *              not flood the name server.
+     */
+    class NEDRYSOFT_HOSTRESOLVER_DLLSPEC HostResolver :
+            public QObject {
+
+        private:
+            Q_OBJECT
+
+        public:
+            /**
+             * @brief       Constructs a HostResolver.
+             *
+             * @param[in]   backend the backend to perform lookups with, the resolver takes ownership.  If nullptr
+             *              then a DnsResolverBackend is used.
+             */
+            explicit HostResolver(Nedrysoft::HostResolver::ResolverBackend *backend = nullptr);
+
+            /**
+             * @brief       Destroys the HostResolver.
+             */
+            ~HostResolver() override;
+
+            /**
+             * @brief       Returns the shared HostResolver instance.
+             *
+             * @returns     the resolver.
+             */
+            static auto getInstance() -> Nedrysoft::HostResolver::HostResolver *;
+
+            /**
+             * @brief       Resolves the addresses of a host.
+             *
+             * @details     Returns immediately if the host is an address or the answer is cached, otherwise
+             *              blocks until the answer for the requested protocol arrives or the timeout expires.
+             *
+             * @param[in]   host the host name or address.
+             * @param[in]   protocol the protocol of the addresses required.
+             * @param[in]   timeout the maximum time to wait in milliseconds.
+             *
+             * @returns     the addresses of the host, empty if it could not be resolved.
+             */
+            auto resolve(
+                const QString &host,
+                QAbstractSocket::NetworkLayerProtocol protocol,
+                int timeout
+            ) -> QList<QHostAddress>;
+
+            /**
+             * @brief       Looks up the host name of an address.
+             *
+             * @details     If the host name is cached the callback is called before this returns, otherwise it is
+             *              called on the thread of the context once the lookup completes.  The callback is not
+             *              called if the context has been destroyed.
+             *
+             * @param[in]   hostAddress the address to look up.
+             * @param[in]   context the object whose thread the callback is called on.
+             * @param[in]   callback the callback, the host name is empty if the address has no name.
+             */
+            auto lookupHostName(
+                const QHostAddress &hostAddress,
+                QObject *context,
+                std::function<void(const QString &hostName)> callback
+            ) -> void;
+
+            /**
+             * @brief       Sets the maximum number of reverse lookups that are in progress at a time.
+             *
+             * @param[in]   maximumLookups the maximum number of lookups.
+             */
+            auto setMaximumReverseLookups(int maximumLookups) -> void;
+
+            /**
+             * @brief       Returns the number of reverse lookups that were answered from the cache.
+             *
+             * @returns     the number of cache hits.
+             */
+            auto reverseLookupHits() -> quint64;
+
+            /**
+             * @brief       Returns the number of reverse lookups that were not answered from the cache.
+             *
+             * @returns     the number of cache misses.
+             */
+            auto reverseLookupMisses() -> quint64;
+
+            /**
+             * @brief       Sets how long a name that could not be resolved is remembered for.
+             *
+             * @param[in]   timeToLive the time in seconds.
+             */
+            auto setNegativeTimeToLive(int timeToLive) -> void;
+
+            /**
+             * @brief       Removes every answer from the cache.
+             */
+            auto clear() -> void;
+
+        private:
+            /**
+             * @brief       Starts the lookups for a host that are not cached or already in progress.
+             *
+             * @note        The mutex must be held by the caller.
+             *
+             * @param[in]   host the host name.
+             */
+            auto startLookups(const QString &host) -> void;
+
+            /**
+             * @brief       Signal emitted to start a lookup on the thread of the resolver.
+             *
+             * @param[in]   host the host name.
+             * @param[in]   protocol the protocol to look up.
+             */
+            Q_SIGNAL void lookupRequested(const QString host, int protocol);
+
+            /**
+             * @brief       Performs a lookup that was requested with lookupRequested.
+             *
+             * @param[in]   host the host name.
+             * @param[in]   protocol the protocol to look up.
+             */
+            Q_SLOT void onLookupRequested(const QString host, int protocol);
+
+            /**
+             * @brief       Signal emitted to start any queued reverse lookups on the thread of the resolver.
+             */
+            Q_SIGNAL void reverseLookupRequested();
+
+            /**
+             * @brief       Starts queued reverse lookups until the maximum number are in progress.
+             */
+            Q_SLOT void onReverseLookupRequested();
+
+        private:
+            //! @cond
+
+            struct CacheEntry {
+                QList<QHostAddress> m_addresses;
+                qint64 m_expiryTime = 0;
+                bool m_pending = false;
+            };
+
+            struct ReverseCacheEntry {
+                QString m_hostName;
+                qint64 m_expiryTime = 0;
+                bool m_pending = false;
+                QList<QPair<QPointer<QObject>, std::function<void(const QString &)> > > m_callbacks;
+            };
+
+            Nedrysoft::HostResolver::ResolverBackend *m_backend;
+            QThread *m_thread;
+            QElapsedTimer m_clock;
+
+            QMutex m_mutex;
+            QWaitCondition m_resolved;
+            QMap<QPair<QString, int>, CacheEntry> m_cache;
+            int m_negativeTimeToLive;
+
+            QMap<QString, ReverseCacheEntry> m_reverseCache;
+            QStringList m_reverseQueue;
+            int m_activeReverseLookups;
+            int m_maximumReverseLookups;
+            quint64 m_reverseLookupHits;
+            quint64 m_reverseLookupMisses;
+
+            //! @endcond
+    };
+}}
+
+#endif // NEDRYSOFT_HOSTRESOLVER_HOSTRESOLVER_H
@@ -87,6 +87,7 @@ struct icmp_v6 {
     struct icmp icmp;
 };
 
+constexpr auto ICMP6_DST_UNREACH = 1;
 constexpr auto ICMP6_ECHO = 128;
 constexpr auto ICMP6_ECHO_REPLY = 129;
 
@@ -146,32 +147,54 @@ auto Nedrysoft::ICMPPacket::ICMPPacket::fromData_v4(const QByteArray &dataBuffer
 
     auto icmp_response = reinterpret_cast<const struct icmp *>(responseSpan.data());
 
-    if (icmp_response->icmp_code == ICMP_ECHOREPLY) {
-        if (icmp_response->icmp_type == ICMP_ECHOREPLY) {
-            auto ip_response = reinterpret_cast<const struct ip *>(dataBuffer.data());
+    if (( icmp_response->icmp_code == ICMP_ECHOREPLY ) && ( icmp_response->icmp_type == ICMP_ECHOREPLY )) {
+        auto ip_response = reinterpret_cast<const struct ip *>(dataBuffer.data());
 
-            received_id = qFromBigEndian<uint16_t>(icmp_response->icmp_hun.ih_idseq.icd_id);
-            received_sequence = qFromBigEndian<uint16_t>(icmp_response->icmp_hun.ih_idseq.icd_seq);
+        received_id = qFromBigEndian<uint16_t>(icmp_response->icmp_hun.ih_idseq.icd_id);
+        received_sequence = qFromBigEndian<uint16_t>(icmp_response->icmp_hun.ih_idseq.icd_seq);
+
+        return ICMPPacket(received_id, received_sequence, EchoReply, V4, ip_response->ip_ttl);
+    }
+
+    /**
+     * time exceeded and destination unreachable messages both quote the ip header and the first 8 bytes of the
+     * original request, which is enough to recover the id and sequence of the probe that caused them.  Any
+     * unreachable code (net, host, port, administratively prohibited...) is reported so that the probe can be
+     * completed immediately rather than waiting for it to time out.
+     */
+
+    if ((( icmp_response->icmp_code == 0 ) && ( icmp_response->icmp_type == ICMP_TIMXCEED )) ||
+        ( icmp_response->icmp_type == ICMP_UNREACH )) {
+
+        constexpr unsigned int IP_HEADER_OFFSET = 0x08;
+        constexpr unsigned int QUOTED_ICMP_LENGTH = 0x08;
 
-            return ICMPPacket(received_id, received_sequence, EchoReply, V4, ip_response->ip_ttl);
+        if (static_cast<unsigned int>(mainSpan.size()) <= ip_header_size + IP_HEADER_OFFSET) {
+            return ICMPPacket();
         }
 
-        if (icmp_response->icmp_type == ICMP_TIMXCEED) {
-            constexpr unsigned int IP_HEADER_OFFSET = 0x08;
+        ip_vhl_tx = mainSpan[ip_header_size + IP_HEADER_OFFSET];
+        ip_header_size_tx = ( ip_vhl_tx & IP_HEADER_LENGTH_MASK ) * sizeof(uint32_t);
 
-            ip_vhl_tx = mainSpan[ip_header_size + IP_HEADER_OFFSET];
-            ip_header_size_tx = ( ip_vhl_tx & IP_HEADER_LENGTH_MASK ) * sizeof(uint32_t);
+        auto quotedLength = ip_header_size + IP_HEADER_OFFSET + ip_header_size_tx + QUOTED_ICMP_LENGTH;
 
-            auto receivedRequestSpan = mainSpan.subspan(ip_header_size + IP_HEADER_OFFSET + ip_header_size_tx);
+        if (static_cast<unsigned int>(mainSpan.size()) < quotedLength) {
+            return ICMPPacket();
+        }
+
+        auto receivedRequestSpan = mainSpan.subspan(ip_header_size + IP_HEADER_OFFSET + ip_header_size_tx);
 
-            auto received_icmp_request = reinterpret_cast<const struct icmp *>(receivedRequestSpan.data());
+        auto received_icmp_request = reinterpret_cast<const struct icmp *>(receivedRequestSpan.data());
 
-            received_id = qFromBigEndian<uint16_t>(received_icmp_request->icmp_hun.ih_idseq.icd_id);
+        received_id = qFromBigEndian<uint16_t>(received_icmp_request->icmp_hun.ih_idseq.icd_id);
 
-            received_sequence = qFromBigEndian<uint16_t>(received_icmp_request->icmp_hun.ih_idseq.icd_seq);
+        received_sequence = qFromBigEndian<uint16_t>(received_icmp_request->icmp_hun.ih_idseq.icd_seq);
 
-            return ICMPPacket(received_id, received_sequence, TimeExceeded, V4, -1);
+        if (icmp_response->icmp_type == ICMP_UNREACH) {
+            return ICMPPacket(received_id, received_sequence, DestinationUnreachable, V4, -1);
         }
+
+        return ICMPPacket(received_id, received_sequence, TimeExceeded, V4, -1);
     }
 
     return ICMPPacket();
@@ -208,6 +231,23 @@ auto Nedrysoft::ICMPPacket::ICMPPacket::fromData_v6(const QByteArray &dataBuffer
         }
     }
 
+    if (icmp_response->icmp_type == ICMP6_DST_UNREACH) {
+        auto quotedLength = sizeof(icmp_header) + sizeof(ipv6_header) + sizeof(icmp_header);
+
+        if (static_cast<size_t>(responseSpan.size()) < quotedLength) {
+            return ICMPPacket();
+        }
+
+        auto request_icmp_header = responseSpan.subspan(sizeof(icmp_header) + sizeof(ipv6_header));
+
+        auto rx_icmp_request = reinterpret_cast<const struct icmp *>(request_icmp_header.data());
+
+        received_id = qFromBigEndian<uint16_t>(rx_icmp_request->icmp_hun.ih_idseq.icd_id);
+        received_sequence = qFromBigEndian<uint16_t>(rx_icmp_request->icmp_hun.ih_idseq.icd_seq);
+
+        return ICMPPacket(received_id, received_sequence, DestinationUnreachable, V6, -1);
+    }
+
     return ICMPPacket();
 }
 
@@ -247,12 +287,13 @@ auto Nedrysoft::ICMPPacket::ICMPPacket::pingPacket(
         uint16_t sequence,
         int payloadLength,
         const QHostAddress &destinationAddress,
-        Nedrysoft::ICMPPacket::IPVersion version) -> QByteArray {
+        Nedrysoft::ICMPPacket::IPVersion version,
+        bool flowStable) -> QByteArray {
 
     if (version == Nedrysoft::ICMPPacket::V4) {
-        return pingPacket_v4(id, sequence, payloadLength, destinationAddress);
+        return pingPacket_v4(id, sequence, payloadLength, destinationAddress, flowStable);
     } else if (version == Nedrysoft::ICMPPacket::V6) {
-        return pingPacket_v6(id, sequence, payloadLength, destinationAddress);
+        return pingPacket_v6(id, sequence, payloadLength, destinationAddress, flowStable);
     } else {
         return QByteArray();
     }
@@ -262,7 +303,8 @@ auto Nedrysoft::ICMPPacket::ICMPPacket::pingPacket_v6(
         uint16_t id,
         uint16_t sequence,
         int payloadLength,
-        const QHostAddress &destinationAddress) -> QByteArray {
+        const QHostAddress &destinationAddress,
+        bool flowStable) -> QByteArray {
 
     QByteArray echoRequestBuffer(payloadLength + sizeof(icmp_v6), 0);
     auto echoRequestLength = static_cast<int>(echoRequestBuffer.size());
@@ -286,6 +328,10 @@ auto Nedrysoft::ICMPPacket::ICMPPacket::pingPacket_v6(
     icmp_request->icmp_hun.ih_idseq.icd_id = qToBigEndian<uint16_t>(id);
     icmp_request->icmp_hun.ih_idseq.icd_seq = qToBigEndian<uint16_t>(sequence);
 
+    if ((flowStable) && (payloadLength>=static_cast<int>(sizeof(uint16_t)))) {
+        qToBigEndian<uint16_t>(~sequence, reinterpret_cast<uint8_t *>(icmp_request)+sizeof(icmp));
+    }
+
     icmp_request->icmp_cksum = Nedrysoft::ICMPPacket::ICMPPacket::checksum(icmp_v6, echoRequestLength);
 
     return QByteArray(reinterpret_cast<char *>(icmp_request), icmp_v6->header.packetLength);
@@ -295,7 +341,8 @@ auto Nedrysoft::ICMPPacket::ICMPPacket::pingPacket_v4(
         uint16_t id,
         uint16_t sequence,
         int payloadLength,
-        const QHostAddress &destinationAddress) -> QByteArray {
+        const QHostAddress &destinationAddress,
+        bool flowStable) -> QByteArray {
 
     Q_UNUSED(destinationAddress)
 
@@ -309,6 +356,15 @@ auto Nedrysoft::ICMPPacket::ICMPPacket::pingPacket_v4(
     icmp_request->icmp_hun.ih_idseq.icd_id = qToBigEndian<uint16_t>(id);
     icmp_request->icmp_hun.ih_idseq.icd_seq = qToBigEndian<uint16_t>(sequence);
 
+    /**
+     * the ones complement of the sequence is placed in the first word of the payload, the two words always sum
+     * to 0xffff so the checksum only depends on the id, which keeps the flow constant across sequence numbers.
+     */
+
+    if ((flowStable) && (payloadLength>=static_cast<int>(sizeof(uint16_t)))) {
+        qToBigEndian<uint16_t>(~sequence, reinterpret_cast<uint8_t *>(icmp_request)+sizeof(icmp));
+    }
+
     icmp_request->icmp_cksum = Nedrysoft::ICMPPacket::ICMPPacket::checksum(icmp_request, echoRequestLength);
 
     return QByteArray(reinterpret_cast<const char *>(icmp_request), echoRequestLength);
@@ -350,6 +406,11 @@ Nedrysoft::ICMPPacket::ICMPPacket::operator std::string() {
             break;
         }
 
+        case DestinationUnreachable: {
+            resultCodeString = "Destination Unreachable";
+            break;
+        }
+
         default: {
             resultCodeString = QString("Unknown (%1)").arg(m_resultCode);
             break;
@@ -51,7 +51,8 @@ namespace Nedrysoft { namespace ICMPPacket {
     enum ResultCode {
         Invalid = 0,
         EchoReply = 1,
-        TimeExceeded = 2
+        TimeExceeded = 2,
+        DestinationUnreachable = 3
     };
 
     /**
@@ -89,6 +90,9 @@ namespace Nedrysoft { namespace ICMPPacket {
              * @param[in]   payloadLength the length of the payload.
              * @param[in]   destinationAddress the address of the target.
              * @param[in]   version the ip version of the icmp packet.
+             * @param[in]   flowStable if true the first word of the payload compensates for the sequence so that
+             *              packets with the same id always have the same checksum, load balancers which hash on
+             *              the icmp header then send every packet with that id along the same path.
              *
              * @returns     a QByteArray containing the created raw packet.
              */
@@ -97,7 +101,8 @@ namespace Nedrysoft { namespace ICMPPacket {
                 uint16_t sequence,
                 int payloadLength,
                 const QHostAddress &destinationAddress,
-                Nedrysoft::ICMPPacket::IPVersion version
+                Nedrysoft::ICMPPacket::IPVersion version,
+                bool flowStable = false
             ) -> QByteArray;
 
             /**
@@ -177,6 +182,7 @@ namespace Nedrysoft { namespace ICMPPacket {
              * @param[in]   sequence  the sequence to be used in the packet.
              * @param[in]   payLoadLength the payLoadLength to be used in the packet.
              * @param[in]   destinationAddress the destination address of the ping.
+             * @param[in]   flowStable true if the checksum should be kept constant for the id; otherwise false.
              *
              * @returns     a QByteArray containing the raw ipv4 icmp packet.
              */
@@ -184,7 +190,8 @@ namespace Nedrysoft { namespace ICMPPacket {
                 uint16_t id,
                 uint16_t sequence,
                 int payLoadLength,
-                const QHostAddress &destinationAddress
+                const QHostAddress &destinationAddress,
+                bool flowStable
             ) -> QByteArray;
 
             /**
@@ -194,6 +201,7 @@ namespace Nedrysoft { namespace ICMPPacket {
              * @param[in]   sequence the sequence to be used in the packet.
              * @param[in]   payLoadLength the payLoadLength to be used in the packet.
              * @param[in]   destinationAddress the destination address of the ping.
+             * @param[in]   flowStable true if the checksum should be kept constant for the id; otherwise false.
              *
              * @returns     a QByteArray containing the raw ipv6 icmp packet.
              */
@@ -201,7 +209,8 @@ namespace Nedrysoft { namespace ICMPPacket {
                 uint16_t id,
                 uint16_t sequence,
                 int payLoadLength,
-                const QHostAddress &destinationAddress
+                const QHostAddress &destinationAddress,
+                bool flowStable
             ) -> QByteArray;
 
             /**
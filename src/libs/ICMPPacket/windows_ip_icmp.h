@@ -97,6 +97,7 @@ struct icmp {
 };
 
 #define ICMP_ECHOREPLY          0
+#define ICMP_UNREACH            3
 #define ICMP_ECHO               8
 #define ICMP_TIMXCEED           11
 
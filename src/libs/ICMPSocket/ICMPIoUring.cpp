@@ -0,0 +1,371 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 19/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "ICMPIoUring.h"
+
+#if defined(NEDRYSOFT_ICMPSOCKET_IO_URING)
+
+#include <QtGlobal>
+#include <cerrno>
+#include <cstring>
+#include <memory>
+
+constexpr auto ReceiveRingEntries = 8;
+constexpr auto ReceiveBufferCount = 256;
+constexpr auto ReceiveBufferGroup = 0;
+constexpr auto ReceiveBufferSize = 4096;
+constexpr auto SendQueueDepth = 256;
+
+Nedrysoft::ICMPSocket::ICMPIoUringReceiver::ICMPIoUringReceiver(int socketDescriptor) :
+        m_socketDescriptor(socketDescriptor),
+        m_ring({}),
+        m_bufferRing(nullptr),
+        m_messageHeader({}),
+        m_initialised(false),
+        m_failed(false) {
+
+    if (io_uring_queue_init(ReceiveRingEntries, &m_ring, 0) != 0) {
+        return;
+    }
+
+    int result = 0;
+
+    m_bufferRing = io_uring_setup_buf_ring(&m_ring, ReceiveBufferCount, ReceiveBufferGroup, 0, &result);
+
+    if (!m_bufferRing) {
+        io_uring_queue_exit(&m_ring);
+
+        return;
+    }
+
+    m_buffers.resize(ReceiveBufferCount*ReceiveBufferSize);
+
+    for (auto bufferId = 0; bufferId < ReceiveBufferCount; bufferId++) {
+        io_uring_buf_ring_add(
+            m_bufferRing,
+            m_buffers.data()+bufferId*ReceiveBufferSize,
+            ReceiveBufferSize,
+            bufferId,
+            io_uring_buf_ring_mask(ReceiveBufferCount),
+            bufferId
+        );
+    }
+
+    io_uring_buf_ring_advance(m_bufferRing, ReceiveBufferCount);
+
+    /**
+     * the message header is only used as a template by multishot recvmsg, the kernel writes the source address
+     * into the selected buffer ahead of the payload.
+     */
+
+    m_messageHeader.msg_namelen = sizeof(sockaddr_storage);
+
+    m_initialised = true;
+
+    if (!arm()) {
+        m_failed = true;
+    }
+}
+
+Nedrysoft::ICMPSocket::ICMPIoUringReceiver::~ICMPIoUringReceiver() {
+    if (m_initialised) {
+        io_uring_free_buf_ring(&m_ring, m_bufferRing, ReceiveBufferCount, ReceiveBufferGroup);
+        io_uring_queue_exit(&m_ring);
+    }
+}
+
+auto Nedrysoft::ICMPSocket::ICMPIoUringReceiver::create(
+        int socketDescriptor ) -> Nedrysoft::ICMPSocket::ICMPIoUringReceiver * {
+
+    auto receiver = new Nedrysoft::ICMPSocket::ICMPIoUringReceiver(socketDescriptor);
+
+    if ((!receiver->m_initialised) || (receiver->m_failed)) {
+        delete receiver;
+
+        return nullptr;
+    }
+
+    return receiver;
+}
+
+auto Nedrysoft::ICMPSocket::ICMPIoUringReceiver::arm() -> bool {
+    auto submissionEntry = io_uring_get_sqe(&m_ring);
+
+    if (!submissionEntry) {
+        return false;
+    }
+
+    io_uring_prep_recvmsg_multishot(submissionEntry, m_socketDescriptor, &m_messageHeader, 0);
+
+    submissionEntry->flags |= IOSQE_BUFFER_SELECT;
+    submissionEntry->buf_group = ReceiveBufferGroup;
+
+    return io_uring_submit(&m_ring) == 1;
+}
+
+auto Nedrysoft::ICMPSocket::ICMPIoUringReceiver::recycle(int bufferId) -> void {
+    io_uring_buf_ring_add(
+        m_bufferRing,
+        m_buffers.data()+bufferId*ReceiveBufferSize,
+        ReceiveBufferSize,
+        bufferId,
+        io_uring_buf_ring_mask(ReceiveBufferCount),
+        0
+    );
+
+    io_uring_buf_ring_advance(m_bufferRing, 1);
+}
+
+auto Nedrysoft::ICMPSocket::ICMPIoUringReceiver::hasFailed() -> bool {
+    return m_failed;
+}
+
+auto Nedrysoft::ICMPSocket::ICMPIoUringReceiver::recvfrom(
+        QByteArray &buffer,
+        QHostAddress &receiveAddress,
+        int timeout ) -> int {
+
+    struct io_uring_cqe *completionEntry = nullptr;
+
+    /**
+     * packets that have already arrived are waiting in the completion queue, they are collected without
+     * entering the kernel and a system call is only made when we have to wait.
+     */
+
+    auto result = io_uring_peek_cqe(&m_ring, &completionEntry);
+
+    if (result != 0) {
+        struct __kernel_timespec waitTime = {};
+
+        waitTime.tv_sec = timeout/1000;
+        waitTime.tv_nsec = (timeout%1000)*1000000LL;
+
+        result = io_uring_wait_cqe_timeout(&m_ring, &completionEntry, &waitTime);
+    }
+
+    if (result != 0) {
+        return -1;
+    }
+
+    auto completionResult = completionEntry->res;
+    auto completionFlags = completionEntry->flags;
+
+    io_uring_cqe_seen(&m_ring, completionEntry);
+
+    if ((completionResult == -EINVAL) || (completionResult == -EOPNOTSUPP)) {
+        m_failed = true;
+
+        return -1;
+    }
+
+    if (!(completionFlags & IORING_CQE_F_MORE)) {
+        /**
+         * the kernel ends a multishot request when it runs out of buffers or on error, so it is posted again.
+         */
+
+        if (!arm()) {
+            m_failed = true;
+        }
+    }
+
+    if ((completionResult < 0) || (!(completionFlags & IORING_CQE_F_BUFFER))) {
+        return -1;
+    }
+
+    auto bufferId = static_cast<int>(completionFlags >> IORING_CQE_BUFFER_SHIFT);
+    auto bufferData = m_buffers.data()+bufferId*ReceiveBufferSize;
+    auto bytesRead = -1;
+
+    auto messageOut = io_uring_recvmsg_validate(bufferData, completionResult, &m_messageHeader);
+
+    if (messageOut) {
+        auto payloadLength = io_uring_recvmsg_payload_length(messageOut, completionResult, &m_messageHeader);
+
+        if (messageOut->namelen > 0) {
+            receiveAddress = QHostAddress(reinterpret_cast<sockaddr *>(io_uring_recvmsg_name(messageOut)));
+        }
+
+        buffer.resize(static_cast<int>(payloadLength));
+
+        memcpy(buffer.data(), io_uring_recvmsg_payload(messageOut, &m_messageHeader), payloadLength);
+
+        bytesRead = static_cast<int>(payloadLength);
+    }
+
+    recycle(bufferId);
+
+    return bytesRead;
+}
+
+Nedrysoft::ICMPSocket::ICMPIoUringSender::ICMPIoUringSender() :
+        m_ring({}),
+        m_queuedCount(0),
+        m_sentCount(0),
+        m_initialised(false) {
+
+    if (io_uring_queue_init(SendQueueDepth, &m_ring, 0) != 0) {
+        return;
+    }
+
+    m_requests.resize(SendQueueDepth);
+
+    m_initialised = true;
+}
+
+Nedrysoft::ICMPSocket::ICMPIoUringSender::~ICMPIoUringSender() {
+    if (m_initialised) {
+        submit();
+
+        io_uring_queue_exit(&m_ring);
+    }
+}
+
+auto Nedrysoft::ICMPSocket::ICMPIoUringSender::forCurrentThread() -> Nedrysoft::ICMPSocket::ICMPIoUringSender * {
+    thread_local std::unique_ptr<Nedrysoft::ICMPSocket::ICMPIoUringSender> sender;
+    thread_local auto created = false;
+
+    if (!created) {
+        created = true;
+
+        sender.reset(new Nedrysoft::ICMPSocket::ICMPIoUringSender);
+
+        if (!sender->m_initialised) {
+            sender.reset();
+        }
+    }
+
+    return sender.get();
+}
+
+auto Nedrysoft::ICMPSocket::ICMPIoUringSender::isSupported() -> bool {
+    static auto supported = []() -> bool {
+        struct io_uring ring = {};
+
+        if (io_uring_queue_init(2, &ring, 0) != 0) {
+            return false;
+        }
+
+        io_uring_queue_exit(&ring);
+
+        return true;
+    }();
+
+    return supported;
+}
+
+auto Nedrysoft::ICMPSocket::ICMPIoUringSender::queue(
+        int socketDescriptor,
+        const QByteArray &buffer,
+        const sockaddr_storage &socketAddress,
+        socklen_t socketAddressLength ) -> bool {
+
+    if (m_queuedCount == SendQueueDepth) {
+        submit();
+    }
+
+    auto submissionEntry = io_uring_get_sqe(&m_ring);
+
+    if (!submissionEntry) {
+        submit();
+
+        submissionEntry = io_uring_get_sqe(&m_ring);
+
+        if (!submissionEntry) {
+            return false;
+        }
+    }
+
+    /**
+     * the kernel reads the message header, address and data when the request is submitted, so they are held
+     * in the request slot until the batch has completed.
+     */
+
+    auto &request = m_requests[m_queuedCount++];
+
+    request.data = buffer;
+    request.socketAddress = socketAddress;
+
+    request.ioVector.iov_base = request.data.data();
+    request.ioVector.iov_len = static_cast<size_t>(request.data.length());
+
+    request.messageHeader = {};
+    request.messageHeader.msg_name = &request.socketAddress;
+    request.messageHeader.msg_namelen = socketAddressLength;
+    request.messageHeader.msg_iov = &request.ioVector;
+    request.messageHeader.msg_iovlen = 1;
+
+    io_uring_prep_sendmsg(submissionEntry, socketDescriptor, &request.messageHeader, 0);
+
+    return true;
+}
+
+auto Nedrysoft::ICMPSocket::ICMPIoUringSender::submit() -> void {
+    if (!m_queuedCount) {
+        return;
+    }
+
+    auto outstandingCount = static_cast<unsigned>(m_queuedCount);
+
+    auto result = io_uring_submit_and_wait(&m_ring, outstandingCount);
+
+    /**
+     * the request slots are reused by the next batch, so every completion must be reaped before returning.
+     */
+
+    while ((result >= 0) && (outstandingCount > 0)) {
+        struct io_uring_cqe *completionEntry;
+        unsigned head;
+        unsigned completedCount = 0;
+
+        io_uring_for_each_cqe(&m_ring, head, completionEntry) {
+            if (completionEntry->res >= 0) {
+                m_sentCount++;
+            }
+
+            completedCount++;
+        }
+
+        io_uring_cq_advance(&m_ring, completedCount);
+
+        outstandingCount -= qMin(completedCount, outstandingCount);
+
+        if (outstandingCount > 0) {
+            result = io_uring_wait_cqe_nr(&m_ring, &completionEntry, outstandingCount);
+        }
+    }
+
+    m_queuedCount = 0;
+}
+
+auto Nedrysoft::ICMPSocket::ICMPIoUringSender::flush() -> int {
+    submit();
+
+    auto sentCount = m_sentCount;
+
+    m_sentCount = 0;
+
+    return sentCount;
+}
+
+#endif // defined(NEDRYSOFT_ICMPSOCKET_IO_URING)
@@ -0,0 +1,206 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 19/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef NEDRYSOFT_ICMPSOCKET_ICMPIOURING_H
+#define NEDRYSOFT_ICMPSOCKET_ICMPIOURING_H
+
+#if defined(NEDRYSOFT_ICMPSOCKET_IO_URING)
+
+#include <QByteArray>
+#include <QHostAddress>
+#include <liburing.h>
+#include <sys/socket.h>
+#include <vector>
+
+namespace Nedrysoft { namespace ICMPSocket {
+    /**
+     * @brief       The ICMPIoUringReceiver class receives packets from a socket using an io_uring.
+     *
+     * @details     A multishot recvmsg is kept posted against a ring of registered buffers, so that packets that
+     *              have already arrived are collected from the completion queue without a system call.
+     *
+     * @note        An instance must only be used from one thread at a time.
+     */
+    class ICMPIoUringReceiver {
+        private:
+            /**
+             * @brief       Constructs a new ICMPIoUringReceiver.
+             *
+             * @param[in]   socketDescriptor the socket to receive from.
+             */
+            ICMPIoUringReceiver(int socketDescriptor);
+
+        public:
+            /**
+             * @brief       Destroys the ICMPIoUringReceiver.
+             */
+            ~ICMPIoUringReceiver();
+
+            /**
+             * @brief       Creates a receiver for the given socket.
+             *
+             * @param[in]   socketDescriptor the socket to receive from.
+             *
+             * @returns     the receiver; or nullptr if the kernel does not support the required features.
+             */
+            static auto create(int socketDescriptor) -> Nedrysoft::ICMPSocket::ICMPIoUringReceiver *;
+
+            /**
+             * @brief       Receives a packet.
+             *
+             * @param[out]  buffer the buffer to receive data.
+             * @param[out]  receiveAddress the address that the packet was received from.
+             * @param[in]   timeout read timeout in milliseconds.
+             *
+             * @returns     -1 on timeout or error; otherwise the number of bytes read.
+             */
+            auto recvfrom(QByteArray &buffer, QHostAddress &receiveAddress, int timeout) -> int;
+
+            /**
+             * @brief       Returns whether the kernel rejected the receive request.
+             *
+             * @details     Kernels that support io_uring but not multishot recvmsg only report this when the
+             *              first receive completes, the socket should then fall back to the poll backend.
+             *
+             * @returns     true if the receiver can no longer be used; otherwise false.
+             */
+            auto hasFailed() -> bool;
+
+        private:
+            /**
+             * @brief       Posts the multishot receive request.
+             *
+             * @returns     true if the request was submitted; otherwise false.
+             */
+            auto arm() -> bool;
+
+            /**
+             * @brief       Returns a buffer to the buffer ring so that the kernel can reuse it.
+             *
+             * @param[in]   bufferId the identifier of the buffer.
+             */
+            auto recycle(int bufferId) -> void;
+
+        private:
+            //! @cond
+
+            int m_socketDescriptor;
+            struct io_uring m_ring;
+            struct io_uring_buf_ring *m_bufferRing;
+            struct msghdr m_messageHeader;
+            std::vector<char> m_buffers;
+            bool m_initialised;
+            bool m_failed;
+
+            //! @endcond
+    };
+
+    /**
+     * @brief       The ICMPIoUringSender class batches packets sent by a thread into one io_uring submission.
+     *
+     * @details     Each thread has its own sender, sendmsg requests are prepared as packets are queued and all of
+     *              them are submitted to the kernel and reaped with a single io_uring_enter when flushed.
+     */
+    class ICMPIoUringSender {
+        private:
+            /**
+             * @brief       Constructs a new ICMPIoUringSender.
+             */
+            ICMPIoUringSender();
+
+        public:
+            /**
+             * @brief       Destroys the ICMPIoUringSender.
+             */
+            ~ICMPIoUringSender();
+
+            /**
+             * @brief       Returns the sender for the calling thread.
+             *
+             * @returns     the sender; or nullptr if an io_uring could not be created.
+             */
+            static auto forCurrentThread() -> Nedrysoft::ICMPSocket::ICMPIoUringSender *;
+
+            /**
+             * @brief       Returns whether the running kernel supports io_uring.
+             *
+             * @returns     true if supported; otherwise false.
+             */
+            static auto isSupported() -> bool;
+
+            /**
+             * @brief       Queues a packet to be sent.
+             *
+             * @note        If the submission queue is full then the queued packets are flushed first.
+             *
+             * @param[in]   socketDescriptor the socket to send the packet on.
+             * @param[in]   buffer the packet data.
+             * @param[in]   socketAddress the destination address.
+             * @param[in]   socketAddressLength the length of the destination address.
+             *
+             * @returns     true if the packet was queued; otherwise false if no submission entry was available.
+             */
+            auto queue(
+                int socketDescriptor,
+                const QByteArray &buffer,
+                const sockaddr_storage &socketAddress,
+                socklen_t socketAddressLength
+            ) -> bool;
+
+            /**
+             * @brief       Submits the queued packets and waits for them to be sent.
+             *
+             * @returns     the number of packets sent successfully since the last flush.
+             */
+            auto flush() -> int;
+
+        private:
+            /**
+             * @brief       Submits the queued packets and adds the number sent successfully to the sent count.
+             */
+            auto submit() -> void;
+
+        private:
+            //! @cond
+
+            struct SendRequest {
+                struct msghdr messageHeader;
+                struct iovec ioVector;
+                sockaddr_storage socketAddress;
+                QByteArray data;
+            };
+
+            struct io_uring m_ring;
+            std::vector<SendRequest> m_requests;
+            int m_queuedCount;
+            int m_sentCount;
+            bool m_initialised;
+
+            //! @endcond
+    };
+}}
+
+#endif // defined(NEDRYSOFT_ICMPSOCKET_IO_URING)
+
+#endif // NEDRYSOFT_ICMPSOCKET_ICMPIOURING_H
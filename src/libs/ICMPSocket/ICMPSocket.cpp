@@ -23,6 +23,8 @@
 
 #include "ICMPSocket.h"
 
+#include "ICMPIoUring.h"
+
 #if defined(Q_OS_UNIX)
 #include <fcntl.h>
 #include <netinet/in.h>
@@ -45,14 +47,37 @@ constexpr int SocketError = -1;
 
 constexpr auto ReceiveBufferSize = 4096;
 
+//! @cond
+#if defined(NEDRYSOFT_ICMPSOCKET_IO_URING)
+Nedrysoft::ICMPSocket::ICMPSocket::Backend Nedrysoft::ICMPSocket::ICMPSocket::m_preferredBackend =
+        Nedrysoft::ICMPSocket::ICMPSocket::Backend::IoUring;
+#else
+Nedrysoft::ICMPSocket::ICMPSocket::Backend Nedrysoft::ICMPSocket::ICMPSocket::m_preferredBackend =
+        Nedrysoft::ICMPSocket::ICMPSocket::Backend::Poll;
+#endif
+
+/**
+ * packets queued by a thread on a poll backend socket are sent immediately, the number sent is held until the
+ * thread calls flush.
+ */
+
+static thread_local int queuedSentCount = 0;
+//! @endcond
+
 Nedrysoft::ICMPSocket::ICMPSocket::ICMPSocket(Nedrysoft::ICMPSocket::ICMPSocket::socket_t socket, IPVersion version) :
         m_socketDescriptor(socket),
         m_version(version),
-        m_ttl(64) {
+        m_ttl(64),
+        m_backend(Nedrysoft::ICMPSocket::ICMPSocket::Backend::Poll),
+        m_receiver(nullptr) {
 
 }
 
 Nedrysoft::ICMPSocket::ICMPSocket::~ICMPSocket() {
+#if defined(NEDRYSOFT_ICMPSOCKET_IO_URING)
+    delete m_receiver;
+#endif
+
 #if defined(Q_OS_WIN)
     closesocket(m_socketDescriptor);
 #else
@@ -150,7 +175,19 @@ auto Nedrysoft::ICMPSocket::ICMPSocket::createReadSocket(
     }
 #endif
 
-    return new Nedrysoft::ICMPSocket::ICMPSocket(socketDescriptor, version);
+    auto socketInstance = new Nedrysoft::ICMPSocket::ICMPSocket(socketDescriptor, version);
+
+#if defined(NEDRYSOFT_ICMPSOCKET_IO_URING)
+    if (m_preferredBackend==Backend::IoUring) {
+        socketInstance->m_receiver = Nedrysoft::ICMPSocket::ICMPIoUringReceiver::create(socketDescriptor);
+
+        if (socketInstance->m_receiver) {
+            socketInstance->m_backend = Backend::IoUring;
+        }
+    }
+#endif
+
+    return socketInstance;
 }
 
 auto Nedrysoft::ICMPSocket::ICMPSocket::createWriteSocket(
@@ -216,6 +253,12 @@ auto Nedrysoft::ICMPSocket::ICMPSocket::createWriteSocket(
     if (isValid(socketDescriptor)) {
         socketInstance = new Nedrysoft::ICMPSocket::ICMPSocket(socketDescriptor, version);
 
+#if defined(NEDRYSOFT_ICMPSOCKET_IO_URING)
+        if ((m_preferredBackend==Backend::IoUring) && (Nedrysoft::ICMPSocket::ICMPIoUringSender::isSupported())) {
+            socketInstance->m_backend = Backend::IoUring;
+        }
+#endif
+
         if (ttl) {
             if (version == V4) {
                 socketInstance->setTTL(ttl);
@@ -235,6 +278,25 @@ auto Nedrysoft::ICMPSocket::ICMPSocket::recvfrom(
         QHostAddress &receiveAddress,
         int timeout) -> int {
 
+#if defined(NEDRYSOFT_ICMPSOCKET_IO_URING)
+    if (m_receiver) {
+        auto result = m_receiver->recvfrom(buffer, receiveAddress, timeout);
+
+        if (m_receiver->hasFailed()) {
+            /**
+             * the kernel has io_uring but not multishot receives, so this socket reverts to the poll backend.
+             */
+
+            delete m_receiver;
+
+            m_receiver = nullptr;
+            m_backend = Backend::Poll;
+        }
+
+        return result;
+    }
+#endif
+
 #if defined(Q_OS_UNIX)
     socklen_t addressLength;
     unsigned int socketErrorLength;
@@ -293,29 +355,104 @@ auto Nedrysoft::ICMPSocket::ICMPSocket::recvfrom(
 }
 
 auto Nedrysoft::ICMPSocket::ICMPSocket::sendto(QByteArray &buffer, const QHostAddress &hostAddress) -> int {
-    if (m_version == V4) {
-        struct sockaddr_in toAddress = {};
+    struct sockaddr_storage toAddress = {};
+
+    auto addressLength = toSocketAddress(hostAddress, toAddress);
+
+    if (!addressLength) {
+        return -1;
+    }
+
+    return ::sendto(m_socketDescriptor, buffer.data(), buffer.length(), 0,
+                    reinterpret_cast<struct sockaddr *>(&toAddress), addressLength);
+}
 
-        memset(&toAddress, 0, sizeof(toAddress));
+auto Nedrysoft::ICMPSocket::ICMPSocket::queueSendto(const QByteArray &buffer, const QHostAddress &hostAddress) -> void {
+    struct sockaddr_storage toAddress = {};
 
-        toAddress.sin_family = AF_INET;
-        toAddress.sin_addr.s_addr = qToBigEndian<uint32_t>(hostAddress.toIPv4Address());
+    auto addressLength = toSocketAddress(hostAddress, toAddress);
 
-        return ::sendto(m_socketDescriptor, buffer.data(), buffer.length(), 0,
-                        reinterpret_cast<struct sockaddr *>(&toAddress), sizeof(toAddress));
+    if (!addressLength) {
+        return;
+    }
+
+#if defined(NEDRYSOFT_ICMPSOCKET_IO_URING)
+    if (m_backend==Backend::IoUring) {
+        auto sender = Nedrysoft::ICMPSocket::ICMPIoUringSender::forCurrentThread();
+
+        if ((sender) && (sender->queue(m_socketDescriptor, buffer, toAddress, static_cast<socklen_t>(addressLength)))) {
+            return;
+        }
+    }
+#endif
+
+    auto result = ::sendto(m_socketDescriptor, buffer.constData(), buffer.length(), 0,
+                           reinterpret_cast<struct sockaddr *>(&toAddress), addressLength);
+
+    if (result == buffer.length()) {
+        queuedSentCount++;
+    }
+}
+
+auto Nedrysoft::ICMPSocket::ICMPSocket::flush() -> int {
+    auto sentCount = queuedSentCount;
+
+    queuedSentCount = 0;
+
+#if defined(NEDRYSOFT_ICMPSOCKET_IO_URING)
+    if (m_preferredBackend==Backend::IoUring) {
+        auto sender = Nedrysoft::ICMPSocket::ICMPIoUringSender::forCurrentThread();
+
+        if (sender) {
+            sentCount += sender->flush();
+        }
+    }
+#endif
+
+    return sentCount;
+}
+
+auto Nedrysoft::ICMPSocket::ICMPSocket::toSocketAddress(
+        const QHostAddress &hostAddress,
+        sockaddr_storage &socketAddress ) -> int {
+
+    memset(&socketAddress, 0, sizeof(socketAddress));
+
+    if (m_version == V4) {
+        auto toAddress = reinterpret_cast<struct sockaddr_in *>(&socketAddress);
+
+        toAddress->sin_family = AF_INET;
+        toAddress->sin_addr.s_addr = qToBigEndian<uint32_t>(hostAddress.toIPv4Address());
+
+        return sizeof(struct sockaddr_in);
     } else if (m_version == V6) {
-        struct sockaddr_in6 toAddress = {};
+        auto toAddress = reinterpret_cast<struct sockaddr_in6 *>(&socketAddress);
 
         auto destinationAddress = hostAddress.toIPv6Address();
 
-        toAddress.sin6_family = AF_INET6;
-        memcpy(toAddress.sin6_addr.s6_addr, &destinationAddress, 16);
+        toAddress->sin6_family = AF_INET6;
+        memcpy(toAddress->sin6_addr.s6_addr, &destinationAddress, 16);
 
-        return ::sendto(m_socketDescriptor, buffer.data(), buffer.length(), 0,
-                        reinterpret_cast<struct sockaddr *>(&toAddress), sizeof(toAddress));
+        return sizeof(struct sockaddr_in6);
     }
 
-    return -1;
+    return 0;
+}
+
+auto Nedrysoft::ICMPSocket::ICMPSocket::setPreferredBackend(Nedrysoft::ICMPSocket::ICMPSocket::Backend backend) -> void {
+    m_preferredBackend = backend;
+}
+
+auto Nedrysoft::ICMPSocket::ICMPSocket::isIoUringAvailable() -> bool {
+#if defined(NEDRYSOFT_ICMPSOCKET_IO_URING)
+    return Nedrysoft::ICMPSocket::ICMPIoUringSender::isSupported();
+#else
+    return false;
+#endif
+}
+
+auto Nedrysoft::ICMPSocket::ICMPSocket::backend() -> Nedrysoft::ICMPSocket::ICMPSocket::Backend {
+    return m_backend;
 }
 
 auto Nedrysoft::ICMPSocket::ICMPSocket::isValid(Nedrysoft::ICMPSocket::ICMPSocket::socket_t socket) -> bool {
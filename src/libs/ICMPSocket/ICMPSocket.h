@@ -59,6 +59,8 @@ namespace Nedrysoft { namespace ICMPSocket {
         V6 = 6
     };
 
+    class ICMPIoUringReceiver;
+
     /**
      * @brief           The ICMPSocket class abstracts the platform specific code for ICMP sockets.
      */
@@ -69,6 +71,20 @@ namespace Nedrysoft { namespace ICMPSocket {
 #else
             typedef int socket_t;
 #endif
+        public:
+            /**
+             * @brief       The mechanism used to move packets between the socket and the kernel.
+             *
+             * @details     Poll uses poll() and the socket system calls for each packet, IoUring keeps multishot
+             *              receives posted on an io_uring and submits queued sends in a single system call.
+             *              IoUring is only available on Linux when built with liburing, sockets fall back to Poll
+             *              if the running kernel does not support it.
+             */
+            enum class Backend {
+                Poll,
+                IoUring
+            };
+
         private:
             /**
              * @brief       Constructs a new ICMPSocket.
@@ -144,6 +160,52 @@ namespace Nedrysoft { namespace ICMPSocket {
              */
             auto sendto(QByteArray &buffer, const QHostAddress &hostAddress) -> int;
 
+            /**
+             * @brief       Queues data to be sent on a write socket.
+             *
+             * @details     Queued packets are sent by the next call to flush() on the same thread, when the
+             *              io_uring backend is in use all packets queued by the thread are submitted to the kernel
+             *              with a single system call; otherwise the packet is sent immediately.
+             *
+             * @note        The buffer is copied, so it may be reused as soon as this function returns.  The socket
+             *              is only referenced by its descriptor, so it must not be deleted until flush() has
+             *              returned.
+             *
+             * @param[in]   buffer the data to send.
+             * @param[in]   hostAddress the address to send the data to.
+             */
+            auto queueSendto(const QByteArray &buffer, const QHostAddress &hostAddress) -> void;
+
+            /**
+             * @brief       Sends the packets queued by the calling thread.
+             *
+             * @returns     the number of packets queued since the last flush that were sent successfully.
+             */
+            static auto flush() -> int;
+
+            /**
+             * @brief       Sets the backend used by sockets created after this call.
+             *
+             * @note        The default is IoUring where it is available.
+             *
+             * @param[in]   backend the preferred backend.
+             */
+            static auto setPreferredBackend(Nedrysoft::ICMPSocket::ICMPSocket::Backend backend) -> void;
+
+            /**
+             * @brief       Returns whether the io_uring backend is supported by this build and the running kernel.
+             *
+             * @returns     true if supported; otherwise false.
+             */
+            static auto isIoUringAvailable() -> bool;
+
+            /**
+             * @brief       Returns the backend in use by this socket.
+             *
+             * @returns     the backend.
+             */
+            auto backend() -> Nedrysoft::ICMPSocket::ICMPSocket::Backend;
+
             /**
              * @brief       Sets the TTL on a write socket.
              *
@@ -172,12 +234,27 @@ namespace Nedrysoft { namespace ICMPSocket {
              */
             auto version() -> Nedrysoft::ICMPSocket::IPVersion;
 
+        private:
+            /**
+             * @brief       Converts a host address into a socket address for this socket.
+             *
+             * @param[in]   hostAddress the host address.
+             * @param[out]  socketAddress the socket address.
+             *
+             * @returns     the length of the socket address; or 0 if the address does not match the socket.
+             */
+            auto toSocketAddress(const QHostAddress &hostAddress, sockaddr_storage &socketAddress) -> int;
+
         private:
             //! @cond
 
             ICMPSocket::socket_t m_socketDescriptor;
             Nedrysoft::ICMPSocket::IPVersion m_version;
             int m_ttl;
+            Nedrysoft::ICMPSocket::ICMPSocket::Backend m_backend;
+            Nedrysoft::ICMPSocket::ICMPIoUringReceiver *m_receiver;
+
+            static Nedrysoft::ICMPSocket::ICMPSocket::Backend m_preferredBackend;
 
             //! @endcond
     };
@@ -0,0 +1,417 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 19/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "IP2ASNDatabase.h"
+
+#include <QFile>
+#include <QHash>
+#include <algorithm>
+#include <cstring>
+
+constexpr auto FieldSeparator = '\t';
+constexpr auto LineSeparator = '\n';
+constexpr auto MaximumIPv4Digits = 3;
+constexpr auto MaximumIntegerDigits = 10;
+constexpr auto NotRoutedAsn = 0;
+
+/**
+ * @brief       Parses an IPv4 address written in dotted decimal or as a 32 bit integer.
+ *
+ * @param[in]   begin the first character.
+ * @param[in]   end the character after the last.
+ * @param[out]  address the address in host byte order.
+ *
+ * @returns     true if the address is valid; otherwise false.
+ */
+static auto parseIPv4(const char *begin, const char *end, quint32 &address) -> bool {
+    auto value = quint32(0);
+    auto part = quint64(0);
+    auto digits = 0;
+    auto dots = 0;
+
+    for (auto current = begin; current<end; current++) {
+        if ((*current>='0') && (*current<='9')) {
+            if (++digits>MaximumIntegerDigits) {
+                return false;
+            }
+
+            part = (part*10)+static_cast<quint64>(*current-'0');
+        } else if ((*current=='.') && (dots<3) && (digits>0) && (digits<=MaximumIPv4Digits) && (part<=255)) {
+            value = (value<<8) | static_cast<quint32>(part);
+            part = 0;
+            digits = 0;
+            dots++;
+        } else {
+            return false;
+        }
+    }
+
+    if (digits==0) {
+        return false;
+    }
+
+    if (dots==3) {
+        if ((digits>MaximumIPv4Digits) || (part>255)) {
+            return false;
+        }
+
+        address = (value<<8) | static_cast<quint32>(part);
+
+        return true;
+    }
+
+    if ((dots==0) && (part<=0xffffffffULL)) {
+        address = static_cast<quint32>(part);
+
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * @brief       Parses an IPv6 address.
+ *
+ * @param[in]   begin the first character.
+ * @param[in]   end the character after the last.
+ * @param[out]  high the most significant 64 bits of the address.
+ * @param[out]  low the least significant 64 bits of the address.
+ *
+ * @returns     true if the address is valid; otherwise false.
+ */
+static auto parseIPv6(const char *begin, const char *end, quint64 &high, quint64 &low) -> bool {
+    auto hostAddress = QHostAddress();
+
+    if (!hostAddress.setAddress(QString::fromLatin1(begin, static_cast<int>(end-begin)))) {
+        return false;
+    }
+
+    if (hostAddress.protocol()!=QAbstractSocket::IPv6Protocol) {
+        return false;
+    }
+
+    auto ipv6Address = hostAddress.toIPv6Address();
+
+    high = 0;
+    low = 0;
+
+    for (auto index = 0; index<8; index++) {
+        high = (high<<8) | ipv6Address[index];
+        low = (low<<8) | ipv6Address[index+8];
+    }
+
+    return true;
+}
+
+/**
+ * @brief       Parses an unsigned decimal number.
+ *
+ * @param[in]   begin the first character.
+ * @param[in]   end the character after the last.
+ * @param[out]  number the number.
+ *
+ * @returns     true if the number is valid; otherwise false.
+ */
+static auto parseNumber(const char *begin, const char *end, quint32 &number) -> bool {
+    auto value = quint64(0);
+
+    if ((begin==end) || ((end-begin)>MaximumIntegerDigits)) {
+        return false;
+    }
+
+    for (auto current = begin; current<end; current++) {
+        if ((*current<'0') || (*current>'9')) {
+            return false;
+        }
+
+        value = (value*10)+static_cast<quint64>(*current-'0');
+    }
+
+    if (value>0xffffffffULL) {
+        return false;
+    }
+
+    number = static_cast<quint32>(value);
+
+    return true;
+}
+
+/**
+ * @brief       Finds the end of a field.
+ *
+ * @param[in]   begin the first character of the field.
+ * @param[in]   end the end of the line.
+ *
+ * @returns     the separator after the field, or the end of the line if it is the last field.
+ */
+static auto fieldEnd(const char *begin, const char *end) -> const char * {
+    auto separator = static_cast<const char *>(memchr(begin, FieldSeparator, static_cast<size_t>(end-begin)));
+
+    return separator ? separator : end;
+}
+
+Nedrysoft::IP2ASNDatabase::IP2ASNDatabase::IP2ASNDatabase() {
+
+}
+
+Nedrysoft::IP2ASNDatabase::IP2ASNDatabase::~IP2ASNDatabase() {
+
+}
+
+auto Nedrysoft::IP2ASNDatabase::IP2ASNDatabase::load(const QString &filename) -> bool {
+    QFile file(filename);
+
+    clear();
+
+    if (!file.open(QFile::ReadOnly)) {
+        return false;
+    }
+
+    /**
+     * the table is parsed in place from a mapping of the file, files that cannot be mapped (such as resources)
+     * are read into memory instead.
+     */
+
+    auto size = file.size();
+    auto data = file.map(0, size);
+
+    if (data) {
+        parse(reinterpret_cast<const char *>(data), size);
+
+        file.unmap(data);
+    } else {
+        auto content = file.readAll();
+
+        parse(content.constData(), content.size());
+    }
+
+    auto ipv4Less = [](const IPv4Range &left, const IPv4Range &right) {
+        return left.m_start<right.m_start;
+    };
+
+    auto ipv6Less = [](const IPv6Range &left, const IPv6Range &right) {
+        return (left.m_startHigh<right.m_startHigh) ||
+               ((left.m_startHigh==right.m_startHigh) && (left.m_startLow<right.m_startLow));
+    };
+
+    /**
+     * the published tables are already in order, so the ranges only need sorting if they were not.
+     */
+
+    if (!std::is_sorted(m_ipv4Ranges.begin(), m_ipv4Ranges.end(), ipv4Less)) {
+        std::sort(m_ipv4Ranges.begin(), m_ipv4Ranges.end(), ipv4Less);
+    }
+
+    if (!std::is_sorted(m_ipv6Ranges.begin(), m_ipv6Ranges.end(), ipv6Less)) {
+        std::sort(m_ipv6Ranges.begin(), m_ipv6Ranges.end(), ipv6Less);
+    }
+
+    m_ipv4Ranges.shrink_to_fit();
+    m_ipv6Ranges.shrink_to_fit();
+    m_owners.shrink_to_fit();
+
+    return count()>0;
+}
+
+auto Nedrysoft::IP2ASNDatabase::IP2ASNDatabase::parse(const char *data, qint64 size) -> void {
+    auto owners = QHash<QByteArray, quint32>();
+    auto lastOwnerKey = QByteArray();
+    auto lastOwner = quint32(0);
+    auto dataEnd = data+size;
+
+    for (auto lineBegin = data; lineBegin<dataEnd;) {
+        auto lineEnd = static_cast<const char *>(
+            memchr(lineBegin, LineSeparator, static_cast<size_t>(dataEnd-lineBegin))
+        );
+
+        if (!lineEnd) {
+            lineEnd = dataEnd;
+        }
+
+        auto nextLine = (lineEnd<dataEnd) ? lineEnd+1 : dataEnd;
+
+        if ((lineEnd>lineBegin) && (*(lineEnd-1)=='\r')) {
+            lineEnd--;
+        }
+
+        /**
+         * start, end, AS number, country code and description.
+         */
+
+        auto startEnd = fieldEnd(lineBegin, lineEnd);
+        auto endBegin = startEnd+1;
+        auto endEnd = (startEnd<lineEnd) ? fieldEnd(endBegin, lineEnd) : lineEnd;
+        auto asnBegin = endEnd+1;
+        auto asnEnd = (endEnd<lineEnd) ? fieldEnd(asnBegin, lineEnd) : lineEnd;
+        auto countryBegin = asnEnd+1;
+        auto countryEnd = (asnEnd<lineEnd) ? fieldEnd(countryBegin, lineEnd) : lineEnd;
+        auto descriptionBegin = countryEnd+1;
+        auto asn = quint32(0);
+
+        if ((countryEnd>=lineEnd) || !parseNumber(asnBegin, asnEnd, asn) || (asn==NotRoutedAsn)) {
+            lineBegin = nextLine;
+
+            continue;
+        }
+
+        auto isIPv6 = memchr(lineBegin, ':', static_cast<size_t>(startEnd-lineBegin))!=nullptr;
+        auto ipv4Range = IPv4Range();
+        auto ipv6Range = IPv6Range();
+
+        if (isIPv6) {
+            if (!parseIPv6(lineBegin, startEnd, ipv6Range.m_startHigh, ipv6Range.m_startLow) ||
+                !parseIPv6(endBegin, endEnd, ipv6Range.m_endHigh, ipv6Range.m_endLow) ||
+                (ipv6Range.m_endHigh<ipv6Range.m_startHigh) ||
+                ((ipv6Range.m_endHigh==ipv6Range.m_startHigh) && (ipv6Range.m_endLow<ipv6Range.m_startLow))) {
+
+                lineBegin = nextLine;
+
+                continue;
+            }
+        } else {
+            if (!parseIPv4(lineBegin, startEnd, ipv4Range.m_start) ||
+                !parseIPv4(endBegin, endEnd, ipv4Range.m_end) ||
+                (ipv4Range.m_end<ipv4Range.m_start)) {
+
+                lineBegin = nextLine;
+
+                continue;
+            }
+        }
+
+        /**
+         * consecutive ranges usually belong to the same AS, so the previous owner is checked before the hash.
+         */
+
+        auto ownerKey = QByteArray::fromRawData(asnBegin, static_cast<int>(lineEnd-asnBegin));
+
+        if ((lastOwnerKey.isNull()) || (ownerKey!=lastOwnerKey)) {
+            auto ownerIterator = owners.constFind(ownerKey);
+
+            if (ownerIterator==owners.constEnd()) {
+                auto record = Record();
+
+                record.m_asn = asn;
+                record.m_countryCode = QString::fromUtf8(countryBegin, static_cast<int>(countryEnd-countryBegin));
+                record.m_description = QString::fromUtf8(descriptionBegin, static_cast<int>(lineEnd-descriptionBegin));
+
+                lastOwner = static_cast<quint32>(m_owners.size());
+
+                m_owners.push_back(record);
+
+                owners.insert(QByteArray(ownerKey.constData(), ownerKey.size()), lastOwner);
+            } else {
+                lastOwner = ownerIterator.value();
+            }
+
+            lastOwnerKey = ownerKey;
+        }
+
+        if (isIPv6) {
+            ipv6Range.m_owner = lastOwner;
+
+            m_ipv6Ranges.push_back(ipv6Range);
+        } else {
+            ipv4Range.m_owner = lastOwner;
+
+            m_ipv4Ranges.push_back(ipv4Range);
+        }
+
+        lineBegin = nextLine;
+    }
+}
+
+auto Nedrysoft::IP2ASNDatabase::IP2ASNDatabase::clear() -> void {
+    m_ipv4Ranges.clear();
+    m_ipv6Ranges.clear();
+    m_owners.clear();
+}
+
+auto Nedrysoft::IP2ASNDatabase::IP2ASNDatabase::count() const -> int {
+    return static_cast<int>(m_ipv4Ranges.size()+m_ipv6Ranges.size());
+}
+
+auto Nedrysoft::IP2ASNDatabase::IP2ASNDatabase::find(const QHostAddress &address, Record &record) const -> bool {
+    auto isIPv4 = false;
+    auto ipv4Address = address.toIPv4Address(&isIPv4);
+
+    /**
+     * the range that contains the address is the last one that starts at or before it, if it ends after it.
+     */
+
+    if (isIPv4) {
+        auto range = std::upper_bound(
+            m_ipv4Ranges.begin(),
+            m_ipv4Ranges.end(),
+            ipv4Address,
+            [](quint32 value, const IPv4Range &range) {
+                return value<range.m_start;
+            }
+        );
+
+        if ((range==m_ipv4Ranges.begin()) || (ipv4Address>(--range)->m_end)) {
+            return false;
+        }
+
+        record = m_owners[range->m_owner];
+
+        return true;
+    }
+
+    if (address.protocol()!=QAbstractSocket::IPv6Protocol) {
+        return false;
+    }
+
+    auto ipv6Address = address.toIPv6Address();
+    auto high = quint64(0);
+    auto low = quint64(0);
+
+    for (auto index = 0; index<8; index++) {
+        high = (high<<8) | ipv6Address[index];
+        low = (low<<8) | ipv6Address[index+8];
+    }
+
+    auto range = std::upper_bound(
+        m_ipv6Ranges.begin(),
+        m_ipv6Ranges.end(),
+        std::make_pair(high, low),
+        [](const std::pair<quint64, quint64> &value, const IPv6Range &range) {
+            return (value.first<range.m_startHigh) ||
+                   ((value.first==range.m_startHigh) && (value.second<range.m_startLow));
+        }
+    );
+
+    if (range==m_ipv6Ranges.begin()) {
+        return false;
+    }
+
+    range--;
+
+    if ((high>range->m_endHigh) || ((high==range->m_endHigh) && (low>range->m_endLow))) {
+        return false;
+    }
+
+    record = m_owners[range->m_owner];
+
+    return true;
+}
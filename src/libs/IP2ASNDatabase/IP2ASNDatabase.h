@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 19/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NEDRYSOFT_IP2ASNDATABASE_IP2ASNDATABASE_H
+#define NEDRYSOFT_IP2ASNDATABASE_IP2ASNDATABASE_H
+
+#include <QHostAddress>
+#include <QString>
+#include <vector>
+
+#if ( defined(NEDRYSOFT_LIBRARY_IP2ASNDATABASE_EXPORT))
+#define NEDRYSOFT_IP2ASNDATABASE_DLLSPEC Q_DECL_EXPORT
+#else
+#define NEDRYSOFT_IP2ASNDATABASE_DLLSPEC Q_DECL_IMPORT
+#endif
+
+namespace Nedrysoft { namespace IP2ASNDatabase {
+    /**
+     * @brief       The IP2ASNDatabase class finds the autonomous system that announces an address.
+     *
+     * @details     Loads the tab separated tables published by iptoasn.com, each line holds the first and last
+     *              address of a range followed by the AS number, the country code of the AS and its description.
+     *              The IPv4, IPv6 and combined tables can all be loaded, as can the IPv4 table with the addresses
+     *              written as 32 bit integers.  Ranges with an AS number of 0 are not routed and are left out.
+     *
+     *              The ranges are held in a sorted array for each protocol and the owners are shared between
+     *              them, a lookup is a binary search of the array.  Ranges must not overlap, which is the case
+     *              for the published tables.  Once loaded the database is only read, so lookups may be made from
+     *              any thread.
+     */
+    class NEDRYSOFT_IP2ASNDATABASE_DLLSPEC IP2ASNDatabase {
+        public:
+            /**
+             * @brief       The autonomous system that owns a range.
+             */
+            struct Record {
+                quint32 m_asn;              /**< the AS number. */
+                QString m_countryCode;      /**< the country code of the AS. */
+                QString m_description;      /**< the description of the AS, usually the name of the owner. */
+            };
+
+            /**
+             * @brief       Constructs an IP2ASNDatabase.
+             */
+            IP2ASNDatabase();
+
+            /**
+             * @brief       Destroys the IP2ASNDatabase.
+             */
+            ~IP2ASNDatabase();
+
+            /**
+             * @brief       Loads the ranges from a table.
+             *
+             * @details     Any ranges that are already loaded are replaced, lines that cannot be parsed are skipped.
+             *
+             * @param[in]   filename the filename of the table.
+             *
+             * @returns     true if the file was read and contained at least one range; otherwise false.
+             */
+            auto load(const QString &filename) -> bool;
+
+            /**
+             * @brief       Removes all of the ranges.
+             */
+            auto clear() -> void;
+
+            /**
+             * @brief       Returns the number of ranges that are loaded.
+             *
+             * @returns     the number of ranges.
+             */
+            auto count() const -> int;
+
+            /**
+             * @brief       Finds the autonomous system that announces an address.
+             *
+             * @details     An IPv4 mapped IPv6 address is found in the IPv4 ranges.
+             *
+             * @param[in]   address the address to find.
+             * @param[out]  record the owner of the range that contains the address.
+             *
+             * @returns     true if a range contains the address; otherwise false.
+             */
+            auto find(const QHostAddress &address, Record &record) const -> bool;
+
+        private:
+            /**
+             * @brief       Parses the lines of a table.
+             *
+             * @param[in]   data the start of the table.
+             * @param[in]   size the size of the table in bytes.
+             */
+            auto parse(const char *data, qint64 size) -> void;
+
+        private:
+            //! @cond
+
+            struct IPv4Range {
+                quint32 m_start;
+                quint32 m_end;
+                quint32 m_owner;
+            };
+
+            struct IPv6Range {
+                quint64 m_startHigh;
+                quint64 m_startLow;
+                quint64 m_endHigh;
+                quint64 m_endLow;
+                quint32 m_owner;
+            };
+
+            std::vector<IPv4Range> m_ipv4Ranges;
+            std::vector<IPv6Range> m_ipv6Ranges;
+            std::vector<Record> m_owners;
+
+            //! @endcond
+    };
+}}
+
+#endif // NEDRYSOFT_IP2ASNDATABASE_IP2ASNDATABASE_H
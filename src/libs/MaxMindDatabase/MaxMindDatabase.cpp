@@ -0,0 +1,709 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 19/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MaxMindDatabase.h"
+
+#include <cstring>
+#include <limits>
+
+constexpr auto MetadataMarker = "\xAB\xCD\xEF" "MaxMind.com";
+constexpr auto MetadataMarkerLength = 14;
+constexpr auto MetadataSearchSize = 128*1024;
+constexpr auto DataSectionSeparatorSize = 16;
+constexpr auto IPv4SubtreeDepth = 96;
+constexpr auto MaximumDepth = 32;
+
+/**
+ * the data types used by the data and metadata sections, types above 7 are stored as extended types.
+ */
+
+enum DataType {
+    Extended = 0,
+    Pointer = 1,
+    Utf8String = 2,
+    Double = 3,
+    Bytes = 4,
+    Uint16 = 5,
+    Uint32 = 6,
+    Map = 7,
+    Int32 = 8,
+    Uint64 = 9,
+    Uint128 = 10,
+    Array = 11,
+    DataCacheContainer = 12,
+    EndMarker = 13,
+    Boolean = 14,
+    Float = 15
+};
+
+/**
+ * @brief       Reads a big endian unsigned integer of up to 8 bytes.
+ *
+ * @param[in]   data the first byte.
+ * @param[in]   length the number of bytes.
+ *
+ * @returns     the value.
+ */
+static auto readUnsigned(const uchar *data, quint32 length) -> quint64 {
+    auto value = quint64(0);
+
+    for (auto index = quint32(0); index<length; index++) {
+        value = (value<<8) | data[index];
+    }
+
+    return value;
+}
+
+Nedrysoft::MaxMindDatabase::MaxMindDatabase::MaxMindDatabase() :
+        m_data(nullptr),
+        m_dataSection{nullptr, 0},
+        m_nodeCount(0),
+        m_recordSize(0),
+        m_nodeSize(0),
+        m_ipVersion(0),
+        m_ipv4StartNode(0) {
+
+}
+
+Nedrysoft::MaxMindDatabase::MaxMindDatabase::~MaxMindDatabase() {
+    close();
+}
+
+auto Nedrysoft::MaxMindDatabase::MaxMindDatabase::open(const QString &filename) -> bool {
+    close();
+
+    m_file.setFileName(filename);
+
+    if (!m_file.open(QFile::ReadOnly)) {
+        return false;
+    }
+
+    auto fileSize = m_file.size();
+
+    if ((fileSize<MetadataMarkerLength) || (fileSize>std::numeric_limits<quint32>::max())) {
+        close();
+
+        return false;
+    }
+
+    m_data = m_file.map(0, fileSize);
+
+    if (!m_data) {
+        close();
+
+        return false;
+    }
+
+    /**
+     * the metadata follows the last occurrence of the marker, which is within the last 128KiB of the file.
+     */
+
+    auto searchStart = qMax(qint64(0), fileSize-MetadataSearchSize);
+    auto markerOffset = qint64(-1);
+
+    for (auto offset = fileSize-MetadataMarkerLength; offset>=searchStart; offset--) {
+        if (memcmp(m_data+offset, MetadataMarker, MetadataMarkerLength)==0) {
+            markerOffset = offset;
+            break;
+        }
+    }
+
+    if (markerOffset<0) {
+        close();
+
+        return false;
+    }
+
+    auto metadataSection = Section{
+        m_data+markerOffset+MetadataMarkerLength,
+        static_cast<quint32>(fileSize-markerOffset-MetadataMarkerLength)
+    };
+
+    auto metadataOffset = quint32(0);
+
+    m_metadata = decodeValue(metadataSection, metadataOffset, 0).toMap();
+
+    m_nodeCount = m_metadata["node_count"].toUInt();
+    m_recordSize = m_metadata["record_size"].toInt();
+    m_ipVersion = m_metadata["ip_version"].toInt();
+
+    if (((m_recordSize!=24) && (m_recordSize!=28) && (m_recordSize!=32)) ||
+        ((m_ipVersion!=4) && (m_ipVersion!=6))) {
+
+        close();
+
+        return false;
+    }
+
+    m_nodeSize = m_recordSize/4;
+
+    auto searchTreeSize = static_cast<quint64>(m_nodeCount)*m_nodeSize;
+
+    if (searchTreeSize+DataSectionSeparatorSize>static_cast<quint64>(markerOffset)) {
+        close();
+
+        return false;
+    }
+
+    m_dataSection = Section{
+        m_data+searchTreeSize+DataSectionSeparatorSize,
+        static_cast<quint32>(markerOffset-searchTreeSize-DataSectionSeparatorSize)
+    };
+
+    /**
+     * IPv4 addresses are stored in an IPv6 tree as ::a.b.c.d, the node at the end of the 96 zero bits is found
+     * once here rather than on every lookup.
+     */
+
+    m_ipv4StartNode = 0;
+
+    if (m_ipVersion==6) {
+        for (auto bit = 0; (bit<IPv4SubtreeDepth) && (m_ipv4StartNode<m_nodeCount); bit++) {
+            m_ipv4StartNode = readRecord(m_ipv4StartNode, 0);
+        }
+    }
+
+    return true;
+}
+
+auto Nedrysoft::MaxMindDatabase::MaxMindDatabase::close() -> void {
+    if (m_data) {
+        m_file.unmap(m_data);
+    }
+
+    m_file.close();
+
+    m_data = nullptr;
+    m_dataSection = Section{nullptr, 0};
+    m_metadata.clear();
+    m_nodeCount = 0;
+    m_recordSize = 0;
+    m_nodeSize = 0;
+    m_ipVersion = 0;
+    m_ipv4StartNode = 0;
+}
+
+auto Nedrysoft::MaxMindDatabase::MaxMindDatabase::isOpen() -> bool {
+    return m_data!=nullptr;
+}
+
+auto Nedrysoft::MaxMindDatabase::MaxMindDatabase::metadata() -> QVariantMap {
+    return m_metadata;
+}
+
+auto Nedrysoft::MaxMindDatabase::MaxMindDatabase::databaseType() -> QString {
+    return m_metadata["database_type"].toString();
+}
+
+auto Nedrysoft::MaxMindDatabase::MaxMindDatabase::readRecord(quint32 node, int bit) -> quint32 {
+    auto nodeData = m_data+static_cast<quint64>(node)*m_nodeSize;
+
+    switch (m_recordSize) {
+        case 24: {
+            return static_cast<quint32>(readUnsigned(nodeData+bit*3, 3));
+        }
+
+        case 28: {
+            if (bit==0) {
+                return ((nodeData[3] & 0xF0u)<<20) | static_cast<quint32>(readUnsigned(nodeData, 3));
+            }
+
+            return ((nodeData[3] & 0x0Fu)<<24) | static_cast<quint32>(readUnsigned(nodeData+4, 3));
+        }
+
+        default: {
+            return static_cast<quint32>(readUnsigned(nodeData+bit*4, 4));
+        }
+    }
+}
+
+auto Nedrysoft::MaxMindDatabase::MaxMindDatabase::find(const QHostAddress &address, Entry &entry) -> bool {
+    if (!m_data) {
+        return false;
+    }
+
+    uchar addressBytes[16];
+    auto bitCount = 0;
+    auto node = quint32(0);
+    auto isIPv4 = false;
+    auto ipv4Address = quint32(0);
+
+    if (address.protocol()==QAbstractSocket::IPv4Protocol) {
+        isIPv4 = true;
+        ipv4Address = address.toIPv4Address();
+    } else if (address.protocol()==QAbstractSocket::IPv6Protocol) {
+        if (m_ipVersion==4) {
+            ipv4Address = address.toIPv4Address(&isIPv4);
+
+            if (!isIPv4) {
+                return false;
+            }
+        } else {
+            auto ipv6Address = address.toIPv6Address();
+
+            memcpy(addressBytes, &ipv6Address, sizeof(addressBytes));
+
+            bitCount = 128;
+        }
+    } else {
+        return false;
+    }
+
+    if (isIPv4) {
+        addressBytes[0] = static_cast<uchar>(ipv4Address>>24);
+        addressBytes[1] = static_cast<uchar>(ipv4Address>>16);
+        addressBytes[2] = static_cast<uchar>(ipv4Address>>8);
+        addressBytes[3] = static_cast<uchar>(ipv4Address);
+
+        bitCount = 32;
+        node = (m_ipVersion==6) ? m_ipv4StartNode : 0;
+    }
+
+    auto bit = 0;
+
+    for (; (bit<bitCount) && (node<m_nodeCount); bit++) {
+        node = readRecord(node, (addressBytes[bit>>3]>>(7-(bit&7))) & 1);
+    }
+
+    /**
+     * a record equal to the node count means that there is no data, a larger record points into the data section.
+     */
+
+    if (node<=m_nodeCount) {
+        return false;
+    }
+
+    auto dataOffset = static_cast<quint64>(node)-m_nodeCount-DataSectionSeparatorSize;
+
+    if (dataOffset>=m_dataSection.m_size) {
+        return false;
+    }
+
+    entry.m_offset = static_cast<quint32>(dataOffset);
+    entry.m_prefixLength = bit;
+
+    return true;
+}
+
+auto Nedrysoft::MaxMindDatabase::MaxMindDatabase::value(
+        const Entry &entry,
+        std::initializer_list<const char *> path ) -> QVariant {
+
+    auto offset = entry.m_offset;
+
+    for (auto key : path) {
+        auto type = 0;
+        auto size = quint32(0);
+
+        if (!readControl(m_dataSection, offset, type, size)) {
+            return QVariant();
+        }
+
+        if (type==Pointer) {
+            auto target = quint32(0);
+
+            if ((!readPointer(m_dataSection, offset, size, target)) ||
+                (!readControl(m_dataSection, target, type, size))) {
+
+                return QVariant();
+            }
+
+            offset = target;
+        }
+
+        if (type==Array) {
+            auto index = QByteArray(key).toUInt();
+
+            if (index>=size) {
+                return QVariant();
+            }
+
+            for (auto element = quint32(0); element<index; element++) {
+                if (!skip(m_dataSection, offset, 1)) {
+                    return QVariant();
+                }
+            }
+
+            continue;
+        }
+
+        if (type!=Map) {
+            return QVariant();
+        }
+
+        auto keyLength = static_cast<quint32>(strlen(key));
+        auto found = false;
+
+        for (auto pair = quint32(0); pair<size; pair++) {
+            auto keyOffset = offset;
+            auto keyType = 0;
+            auto keySize = quint32(0);
+
+            if (!readControl(m_dataSection, keyOffset, keyType, keySize)) {
+                return QVariant();
+            }
+
+            /**
+             * keys are often pointers to a string that is shared by every record.
+             */
+
+            if (keyType==Pointer) {
+                auto target = quint32(0);
+
+                if ((!readPointer(m_dataSection, keyOffset, keySize, target)) ||
+                    (!readControl(m_dataSection, target, keyType, keySize))) {
+
+                    return QVariant();
+                }
+
+                offset = keyOffset;
+                keyOffset = target;
+            } else {
+                offset = keyOffset+keySize;
+            }
+
+            if ((keyType!=Utf8String) || (static_cast<quint64>(keyOffset)+keySize>m_dataSection.m_size)) {
+                return QVariant();
+            }
+
+            if ((keySize==keyLength) && (memcmp(m_dataSection.m_data+keyOffset, key, keyLength)==0)) {
+                found = true;
+                break;
+            }
+
+            if (!skip(m_dataSection, offset, 1)) {
+                return QVariant();
+            }
+        }
+
+        if (!found) {
+            return QVariant();
+        }
+    }
+
+    return decodeValue(m_dataSection, offset, 0);
+}
+
+auto Nedrysoft::MaxMindDatabase::MaxMindDatabase::decode(const Entry &entry) -> QVariant {
+    auto offset = entry.m_offset;
+
+    return decodeValue(m_dataSection, offset, 0);
+}
+
+auto Nedrysoft::MaxMindDatabase::MaxMindDatabase::readControl(
+        const Section &section,
+        quint32 &offset,
+        int &type,
+        quint32 &size ) -> bool {
+
+    if (offset>=section.m_size) {
+        return false;
+    }
+
+    auto control = section.m_data[offset++];
+
+    type = control>>5;
+    size = control & 0x1F;
+
+    if (type==Pointer) {
+        return true;
+    }
+
+    if (type==Extended) {
+        if (offset>=section.m_size) {
+            return false;
+        }
+
+        type = 7+section.m_data[offset++];
+
+        if ((type<=Map) || (type>Float)) {
+            return false;
+        }
+    }
+
+    if (size>=29) {
+        auto sizeLength = size-28;
+
+        if (static_cast<quint64>(offset)+sizeLength>section.m_size) {
+            return false;
+        }
+
+        auto sizeValue = static_cast<quint32>(readUnsigned(section.m_data+offset, sizeLength));
+
+        offset += sizeLength;
+
+        switch (sizeLength) {
+            case 1: {
+                size = 29+sizeValue;
+                break;
+            }
+
+            case 2: {
+                size = 285+sizeValue;
+                break;
+            }
+
+            default: {
+                size = 65821+sizeValue;
+                break;
+            }
+        }
+    }
+
+    return true;
+}
+
+auto Nedrysoft::MaxMindDatabase::MaxMindDatabase::readPointer(
+        const Section &section,
+        quint32 &offset,
+        quint32 size,
+        quint32 &target ) -> bool {
+
+    auto pointerLength = ((size>>3) & 0x03)+1;
+    auto valueBits = size & 0x07;
+
+    if (static_cast<quint64>(offset)+pointerLength>section.m_size) {
+        return false;
+    }
+
+    auto pointerValue = static_cast<quint32>(readUnsigned(section.m_data+offset, pointerLength));
+
+    offset += pointerLength;
+
+    switch (pointerLength) {
+        case 1: {
+            target = (valueBits<<8) | pointerValue;
+            break;
+        }
+
+        case 2: {
+            target = ((valueBits<<16) | pointerValue)+2048;
+            break;
+        }
+
+        case 3: {
+            target = ((valueBits<<24) | pointerValue)+526336;
+            break;
+        }
+
+        default: {
+            target = pointerValue;
+            break;
+        }
+    }
+
+    return target<section.m_size;
+}
+
+auto Nedrysoft::MaxMindDatabase::MaxMindDatabase::skip(const Section &section, quint32 &offset, int depth) -> bool {
+    auto type = 0;
+    auto size = quint32(0);
+
+    if ((depth>MaximumDepth) || (!readControl(section, offset, type, size))) {
+        return false;
+    }
+
+    switch (type) {
+        case Pointer: {
+            auto target = quint32(0);
+
+            return readPointer(section, offset, size, target);
+        }
+
+        case Map:
+        case Array: {
+            auto count = (type==Map) ? static_cast<quint64>(size)*2 : size;
+
+            for (auto index = quint64(0); index<count; index++) {
+                if (!skip(section, offset, depth+1)) {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        case Boolean: {
+            return true;
+        }
+
+        case DataCacheContainer:
+        case EndMarker: {
+            return false;
+        }
+
+        default: {
+            if (static_cast<quint64>(offset)+size>section.m_size) {
+                return false;
+            }
+
+            offset += size;
+
+            return true;
+        }
+    }
+}
+
+auto Nedrysoft::MaxMindDatabase::MaxMindDatabase::decodeValue(
+        const Section &section,
+        quint32 &offset,
+        int depth ) -> QVariant {
+
+    auto type = 0;
+    auto size = quint32(0);
+
+    if ((depth>MaximumDepth) || (!readControl(section, offset, type, size))) {
+        return QVariant();
+    }
+
+    if ((type!=Pointer) && (type!=Map) && (type!=Array) && (type!=Boolean)) {
+        if (static_cast<quint64>(offset)+size>section.m_size) {
+            return QVariant();
+        }
+    }
+
+    auto data = section.m_data+offset;
+
+    switch (type) {
+        case Pointer: {
+            auto target = quint32(0);
+
+            if (!readPointer(section, offset, size, target)) {
+                return QVariant();
+            }
+
+            return decodeValue(section, target, depth+1);
+        }
+
+        case Utf8String: {
+            offset += size;
+
+            return QString::fromUtf8(reinterpret_cast<const char *>(data), static_cast<int>(size));
+        }
+
+        case Double: {
+            if (size!=sizeof(double)) {
+                return QVariant();
+            }
+
+            auto bits = readUnsigned(data, size);
+            auto value = 0.0;
+
+            memcpy(&value, &bits, sizeof(value));
+
+            offset += size;
+
+            return value;
+        }
+
+        case Float: {
+            if (size!=sizeof(float)) {
+                return QVariant();
+            }
+
+            auto bits = static_cast<quint32>(readUnsigned(data, size));
+            auto value = 0.0f;
+
+            memcpy(&value, &bits, sizeof(value));
+
+            offset += size;
+
+            return value;
+        }
+
+        case Bytes:
+        case Uint128: {
+            offset += size;
+
+            return QByteArray(reinterpret_cast<const char *>(data), static_cast<int>(size));
+        }
+
+        case Uint16:
+        case Uint32:
+        case Uint64: {
+            if (size>8) {
+                return QVariant();
+            }
+
+            offset += size;
+
+            return readUnsigned(data, size);
+        }
+
+        case Int32: {
+            if (size>4) {
+                return QVariant();
+            }
+
+            offset += size;
+
+            return static_cast<qint32>(static_cast<quint32>(readUnsigned(data, size)));
+        }
+
+        case Boolean: {
+            return size!=0;
+        }
+
+        case Map: {
+            auto map = QVariantMap();
+
+            for (auto pair = quint32(0); pair<size; pair++) {
+                auto key = decodeValue(section, offset, depth+1);
+
+                if (key.userType()!=QMetaType::QString) {
+                    return QVariant();
+                }
+
+                auto value = decodeValue(section, offset, depth+1);
+
+                if (!value.isValid()) {
+                    return QVariant();
+                }
+
+                map[key.toString()] = value;
+            }
+
+            return map;
+        }
+
+        case Array: {
+            auto list = QVariantList();
+
+            for (auto element = quint32(0); element<size; element++) {
+                auto value = decodeValue(section, offset, depth+1);
+
+                if (!value.isValid()) {
+                    return QVariant();
+                }
+
+                list.append(value);
+            }
+
+            return list;
+        }
+
+        default: {
+            return QVariant();
+        }
+    }
+}
@@ -0,0 +1,225 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 19/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NEDRYSOFT_MAXMINDDATABASE_MAXMINDDATABASE_H
+#define NEDRYSOFT_MAXMINDDATABASE_MAXMINDDATABASE_H
+
+#include <QFile>
+#include <QHostAddress>
+#include <QString>
+#include <QVariant>
+#include <QVariantMap>
+#include <initializer_list>
+
+#if ( defined(NEDRYSOFT_LIBRARY_MAXMINDDATABASE_EXPORT))
+#define NEDRYSOFT_MAXMINDDATABASE_DLLSPEC Q_DECL_EXPORT
+#else
+#define NEDRYSOFT_MAXMINDDATABASE_DLLSPEC Q_DECL_IMPORT
+#endif
+
+namespace Nedrysoft { namespace MaxMindDatabase {
+    /**
+     * @brief       The MaxMindDatabase class reads a MaxMind format (.mmdb) database.
+     *
+     * @details     The file is memory mapped and the binary search tree is walked in place, a lookup reads only
+     *              the nodes on the path to the address and the fields that are asked for, nothing is copied or
+     *              decoded up front.
+     *
+     *              The file is treated as untrusted, every read is checked against the bounds of the section that
+     *              it is in.  Once the database is open it is only read, so lookups may be made from any thread.
+     */
+    class NEDRYSOFT_MAXMINDDATABASE_DLLSPEC MaxMindDatabase {
+        public:
+            /**
+             * @brief       The location of the data for an address.
+             */
+            struct Entry {
+                quint32 m_offset;           /**< the offset of the data in the data section. */
+                int m_prefixLength;         /**< the prefix length of the network that contains the address. */
+            };
+
+            /**
+             * @brief       Constructs a MaxMindDatabase.
+             */
+            MaxMindDatabase();
+
+            /**
+             * @brief       Destroys the MaxMindDatabase.
+             */
+            ~MaxMindDatabase();
+
+            /**
+             * @brief       Opens a database.
+             *
+             * @param[in]   filename the filename of the database.
+             *
+             * @returns     true if the database was opened; otherwise false.
+             */
+            auto open(const QString &filename) -> bool;
+
+            /**
+             * @brief       Closes the database.
+             */
+            auto close() -> void;
+
+            /**
+             * @brief       Returns whether a database is open.
+             *
+             * @returns     true if open; otherwise false.
+             */
+            auto isOpen() -> bool;
+
+            /**
+             * @brief       Returns the metadata of the database.
+             *
+             * @returns     the metadata map.
+             */
+            auto metadata() -> QVariantMap;
+
+            /**
+             * @brief       Returns the type of the database, such as "GeoLite2-City".
+             *
+             * @returns     the database type.
+             */
+            auto databaseType() -> QString;
+
+            /**
+             * @brief       Finds the data for an address.
+             *
+             * @details     An IPv4 address is found in an IPv6 database through the IPv4 subtree, an IPv6 address
+             *              can only be found in an IPv4 database if it is an IPv4 mapped address.
+             *
+             * @param[in]   address the address to find.
+             * @param[out]  entry the location of the data for the address.
+             *
+             * @returns     true if the database has data for the address; otherwise false.
+             */
+            auto find(const QHostAddress &address, Entry &entry) -> bool;
+
+            /**
+             * @brief       Returns a value from the data of an entry.
+             *
+             * @details     The path is a list of map keys, or array indexes for arrays, that lead to the value. For
+             *              example {"country", "names", "en"} or {"subdivisions", "0", "iso_code"}.  Only the value
+             *              at the end of the path is decoded.
+             *
+             * @param[in]   entry the entry returned by find.
+             * @param[in]   path the path to the value.
+             *
+             * @returns     the value, invalid if the path does not exist.
+             */
+            auto value(const Entry &entry, std::initializer_list<const char *> path) -> QVariant;
+
+            /**
+             * @brief       Decodes all of the data for an entry.
+             *
+             * @param[in]   entry the entry returned by find.
+             *
+             * @returns     the data, usually a map.
+             */
+            auto decode(const Entry &entry) -> QVariant;
+
+        private:
+            //! @cond
+
+            struct Section {
+                const uchar *m_data;
+                quint32 m_size;
+            };
+
+            //! @endcond
+
+            /**
+             * @brief       Reads one of the two records of a search tree node.
+             *
+             * @param[in]   node the node number.
+             * @param[in]   bit the record to read, 0 for the left record and 1 for the right.
+             *
+             * @returns     the record value.
+             */
+            auto readRecord(quint32 node, int bit) -> quint32;
+
+            /**
+             * @brief       Reads the control byte (and any extended type and size bytes) of a field.
+             *
+             * @param[in]   section the section that contains the field.
+             * @param[in,out] offset the offset of the field, updated to the offset of the field payload.
+             * @param[out]  type the data type of the field.
+             * @param[out]  size the size of the field, for a pointer this is the size bits of the control byte.
+             *
+             * @returns     true if the field is valid; otherwise false.
+             */
+            static auto readControl(const Section &section, quint32 &offset, int &type, quint32 &size) -> bool;
+
+            /**
+             * @brief       Reads the target of a pointer field.
+             *
+             * @param[in]   section the section that contains the pointer.
+             * @param[in,out] offset the offset of the pointer payload, updated to the offset after it.
+             * @param[in]   size the size bits from the control byte.
+             * @param[out]  target the offset that the pointer points to.
+             *
+             * @returns     true if the pointer is valid; otherwise false.
+             */
+            static auto readPointer(const Section &section, quint32 &offset, quint32 size, quint32 &target) -> bool;
+
+            /**
+             * @brief       Moves past a field without decoding it.
+             *
+             * @param[in]   section the section that contains the field.
+             * @param[in,out] offset the offset of the field, updated to the offset after it.
+             * @param[in]   depth the nesting depth of the field.
+             *
+             * @returns     true if the field is valid; otherwise false.
+             */
+            static auto skip(const Section &section, quint32 &offset, int depth) -> bool;
+
+            /**
+             * @brief       Decodes a field.
+             *
+             * @param[in]   section the section that contains the field.
+             * @param[in,out] offset the offset of the field, updated to the offset after it.
+             * @param[in]   depth the nesting depth of the field.
+             *
+             * @returns     the decoded value, invalid if the field is not valid.
+             */
+            static auto decodeValue(const Section &section, quint32 &offset, int depth) -> QVariant;
+
+        private:
+            //! @cond
+
+            QFile m_file;
+            uchar *m_data;
+            Section m_dataSection;
+            QVariantMap m_metadata;
+            quint32 m_nodeCount;
+            int m_recordSize;
+            int m_nodeSize;
+            int m_ipVersion;
+            quint32 m_ipv4StartNode;
+
+            //! @endcond
+    };
+}}
+
+#endif // NEDRYSOFT_MAXMINDDATABASE_MAXMINDDATABASE_H
@@ -0,0 +1,310 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 19/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PingCommand.h"
+
+#include "PingOutputParser.h"
+
+#include <QDate>
+#include <QTime>
+#include <QTimer>
+#include <cstring>
+
+constexpr auto DefaultProgram = "ping";
+constexpr auto MinimumInterval = 200;
+constexpr auto TerminateTimeout = 1000;
+constexpr auto MillisecondsInSecond = 1000.0;
+constexpr auto ReadBufferSize = 4096;
+constexpr auto SequenceRange = 65536UL;
+
+Nedrysoft::PingCommand::PingCommand::PingCommand(QObject *parent) :
+        QObject(parent),
+        m_process(nullptr),
+        m_readLength(0),
+        m_program(DefaultProgram),
+        m_interval(MinimumInterval),
+        m_sequenceEpoch(0),
+        m_lastSequence(0) {
+
+    m_readBuffer.resize(ReadBufferSize);
+}
+
+Nedrysoft::PingCommand::PingCommand::~PingCommand() {
+    stop();
+}
+
+auto Nedrysoft::PingCommand::PingCommand::setProgram(const QString &program) -> void {
+    m_program = program;
+}
+
+auto Nedrysoft::PingCommand::PingCommand::program() -> QString {
+    return m_program;
+}
+
+auto Nedrysoft::PingCommand::PingCommand::start(const QHostAddress &hostAddress, int ttl, int interval) -> QStringList {
+    stop();
+
+    m_hostAddress = hostAddress;
+    m_interval = qMax(MinimumInterval, interval);
+    m_lastSequence = 0;
+    m_readLength = 0;
+
+    /**
+     * -n stops the command from looking up the names of the hosts that reply, so the address is always in the
+     * same place in the output, -D prefixes each line with the time it was written and -O reports requests that
+     * have not been answered when the next request is sent.
+     */
+
+    auto arguments = QStringList() <<
+            "-n" <<
+            "-D" <<
+            "-O" <<
+            "-i" << QString::number(m_interval/MillisecondsInSecond, 'f', 3) <<
+            "-t" << QString::number(ttl) <<
+            hostAddress.toString();
+
+    m_process = new QProcess(this);
+
+    connect(m_process, &QProcess::readyReadStandardOutput, this, [=]() {
+        readOutput();
+    });
+
+    m_sequenceEpoch = static_cast<double>(QDateTime::currentMSecsSinceEpoch());
+
+    m_process->start(m_program, arguments);
+
+    return arguments;
+}
+
+auto Nedrysoft::PingCommand::PingCommand::stop() -> void {
+    if (!m_process) {
+        return;
+    }
+
+    auto process = m_process;
+
+    m_process = nullptr;
+
+    process->disconnect(this);
+
+    if (process->state()==QProcess::NotRunning) {
+        process->deleteLater();
+
+        return;
+    }
+
+    /**
+     * waiting for the process to exit would block the thread of the caller (normally the gui thread), so the
+     * process is left to finish in the background.  it is unparented so that it outlives this command.
+     */
+
+    process->setParent(nullptr);
+
+    connect(process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), process, &QObject::deleteLater);
+
+    connect(process, &QProcess::errorOccurred, process, [process](QProcess::ProcessError error) {
+        if (error==QProcess::FailedToStart) {
+            process->deleteLater();
+        }
+    });
+
+    QTimer::singleShot(TerminateTimeout, process, [process]() {
+        process->kill();
+    });
+
+    process->terminate();
+}
+
+auto Nedrysoft::PingCommand::PingCommand::isRunning() -> bool {
+    return (m_process) && (m_process->state()!=QProcess::NotRunning);
+}
+
+auto Nedrysoft::PingCommand::PingCommand::readOutput() -> void {
+    auto process = m_process;
+
+    while (m_process==process) {
+        auto bytesRead = process->read(m_readBuffer.data()+m_readLength, m_readBuffer.size()-m_readLength);
+
+        if (bytesRead<=0) {
+            return;
+        }
+
+        m_readLength += static_cast<int>(bytesRead);
+
+        auto lineStart = m_readBuffer.constData();
+        auto bufferEnd = lineStart+m_readLength;
+
+        for (auto position = lineStart;position<bufferEnd;position++) {
+            if (*position!='\n') {
+                continue;
+            }
+
+            parseLine(lineStart, static_cast<int>(position-lineStart));
+
+            /**
+             * a receiver of the reply signal may have stopped or restarted the command, in which case the rest of
+             * the buffer belongs to a process that no longer exists.
+             */
+
+            if (m_process!=process) {
+                return;
+            }
+
+            lineStart = position+1;
+        }
+
+        auto remaining = static_cast<int>(bufferEnd-lineStart);
+
+        if (remaining==m_readBuffer.size()) {
+            /**
+             * a line that fills the whole buffer is not ping output, it is discarded.
+             */
+
+            remaining = 0;
+        }
+
+        memmove(m_readBuffer.data(), lineStart, static_cast<size_t>(remaining));
+
+        m_readLength = remaining;
+    }
+}
+
+auto Nedrysoft::PingCommand::PingCommand::parseLine(const char *data, int length) -> void {
+    Nedrysoft::PingCommand::PingOutputParser::Line line;
+
+    if ((!Nedrysoft::PingCommand::PingOutputParser::parse(data, length, line)) || (!line.hasSequence)) {
+        return;
+    }
+
+    /**
+     * the sequence number is extended before it is compared, otherwise every line would be ignored once the 16 bit
+     * sequence number wraps.
+     */
+
+    auto sequence = extendSequence(line.sequence);
+
+    if ((sequence==0) || (sequence<=m_lastSequence)) {
+        return;
+    }
+
+    auto receiveTime = 0.0;
+
+    switch (line.timestampType) {
+        case Nedrysoft::PingCommand::PingOutputParser::TimestampType::Epoch: {
+            receiveTime = line.timestamp*MillisecondsInSecond;
+            break;
+        }
+
+        case Nedrysoft::PingCommand::PingOutputParser::TimestampType::TimeOfDay: {
+            receiveTime = static_cast<double>(QDateTime(QDate::currentDate(), QTime(0, 0)).toMSecsSinceEpoch())+
+                          line.timestamp*MillisecondsInSecond;
+            break;
+        }
+
+        case Nedrysoft::PingCommand::PingOutputParser::TimestampType::None: {
+            receiveTime = static_cast<double>(QDateTime::currentMSecsSinceEpoch());
+            break;
+        }
+    }
+
+    auto replyType = ReplyType::NoReply;
+
+    switch (line.type) {
+        case Nedrysoft::PingCommand::PingOutputParser::LineType::Reply: {
+            replyType = ReplyType::Reply;
+            break;
+        }
+
+        case Nedrysoft::PingCommand::PingOutputParser::LineType::TimeExceeded: {
+            replyType = ReplyType::TimeExceeded;
+            break;
+        }
+
+        case Nedrysoft::PingCommand::PingOutputParser::LineType::Unreachable: {
+            replyType = ReplyType::Unreachable;
+            break;
+        }
+
+        case Nedrysoft::PingCommand::PingOutputParser::LineType::NoAnswer:
+        case Nedrysoft::PingCommand::PingOutputParser::LineType::Unknown: {
+            break;
+        }
+    }
+
+    report(
+        sequence,
+        replyType,
+        Nedrysoft::PingCommand::PingOutputParser::hostAddress(line),
+        receiveTime,
+        line.roundTripTime
+    );
+}
+
+auto Nedrysoft::PingCommand::PingCommand::extendSequence(unsigned long sequence) -> unsigned long {
+    auto extendedSequence = (m_lastSequence-(m_lastSequence%SequenceRange))+(sequence%SequenceRange);
+
+    if (extendedSequence+SequenceRange/2<=m_lastSequence) {
+        extendedSequence += SequenceRange;
+    } else if ((extendedSequence>=SequenceRange) && (extendedSequence>m_lastSequence+SequenceRange/2)) {
+        extendedSequence -= SequenceRange;
+    }
+
+    return extendedSequence;
+}
+
+auto Nedrysoft::PingCommand::PingCommand::requestTime(unsigned long sequence) -> double {
+    return m_sequenceEpoch+static_cast<double>(sequence-1)*m_interval;
+}
+
+auto Nedrysoft::PingCommand::PingCommand::report(
+        unsigned long sequence,
+        Nedrysoft::PingCommand::PingCommand::ReplyType replyType,
+        const QHostAddress &hostAddress,
+        double receiveTime,
+        double roundTripTime ) -> void {
+
+    m_lastSequence = sequence;
+
+    auto sendTime = requestTime(sequence);
+
+    if (replyType==ReplyType::Reply) {
+        /**
+         * an echo reply carries its own round trip time, so the send time is known exactly and is used to correct
+         * the send times that are calculated for the replies that do not.
+         */
+
+        sendTime = receiveTime-roundTripTime;
+
+        m_sequenceEpoch = sendTime-static_cast<double>(sequence-1)*m_interval;
+    } else if (replyType!=ReplyType::NoReply) {
+        roundTripTime = qMax(0.0, receiveTime-sendTime);
+    }
+
+    Q_EMIT reply(
+        sequence-1,
+        replyType,
+        hostAddress,
+        QDateTime::fromMSecsSinceEpoch(qRound64(sendTime)),
+        roundTripTime<0 ? -1 : roundTripTime/MillisecondsInSecond
+    );
+}
@@ -0,0 +1,229 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 19/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NEDRYSOFT_PINGCOMMAND_PINGCOMMAND_H
+#define NEDRYSOFT_PINGCOMMAND_PINGCOMMAND_H
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QHostAddress>
+#include <QObject>
+#include <QProcess>
+#include <QString>
+
+#if ( defined(NEDRYSOFT_LIBRARY_PINGCOMMAND_EXPORT))
+#define NEDRYSOFT_PINGCOMMAND_DLLSPEC Q_DECL_EXPORT
+#else
+#define NEDRYSOFT_PINGCOMMAND_DLLSPEC Q_DECL_IMPORT
+#endif
+
+namespace Nedrysoft { namespace PingCommand {
+    /**
+     * @brief       The PingCommand class runs the operating system ping command for a target.
+     *
+     * @details     A single long running ping process is started for the target, it pings at the requested
+     *              interval and its output is parsed as it is written so that every sample is reported as soon as
+     *              it is available.  The process is started with timestamps (-D) and with outstanding replies
+     *              reported (-O) so that lost packets are reported without waiting for the process to finish.
+     *
+     *              The command is run from the event loop of the thread that owns the object, no threads are
+     *              created.
+     */
+    class NEDRYSOFT_PINGCOMMAND_DLLSPEC PingCommand :
+            public QObject {
+
+        private:
+            Q_OBJECT
+
+        public:
+            /**
+             * @brief       The type of a reply reported by the ping command.
+             */
+            enum class ReplyType {
+                Reply,
+                TimeExceeded,
+                Unreachable,
+                NoReply
+            };
+
+            Q_ENUM(ReplyType)
+
+        public:
+            /**
+             * @brief       Constructs a new PingCommand.
+             *
+             * @param[in]   parent the parent of the object.
+             */
+            explicit PingCommand(QObject *parent = nullptr);
+
+            /**
+             * @brief       Destroys the PingCommand, the ping process is stopped if it is running.
+             */
+            ~PingCommand() override;
+
+            /**
+             * @brief       Sets the program that is run, by default this is the ping command found on the path.
+             *
+             * @note        The program must accept the arguments and write the output of iputils ping.
+             *
+             * @param[in]   program the name or path of the program.
+             */
+            auto setProgram(const QString &program) -> void;
+
+            /**
+             * @brief       Returns the program that is run.
+             *
+             * @returns     the name or path of the program.
+             */
+            auto program() -> QString;
+
+            /**
+             * @brief       Starts pinging a target.
+             *
+             * @details     If the command is already running it is stopped and started again with the new
+             *              parameters.
+             *
+             * @param[in]   hostAddress the address to ping.
+             * @param[in]   ttl the time to live of the requests.
+             * @param[in]   interval the interval between requests in milliseconds.
+             *
+             * @returns     the arguments that the program was started with.
+             */
+            auto start(const QHostAddress &hostAddress, int ttl, int interval) -> QStringList;
+
+            /**
+             * @brief       Stops the ping process.
+             *
+             * @details     The process is asked to terminate and is then detached from the command, it is killed
+             *              if it has not exited within the terminate timeout and deletes itself once it has
+             *              finished, so the caller is never blocked waiting for it.
+             */
+            auto stop() -> void;
+
+            /**
+             * @brief       Returns whether the ping process is running.
+             *
+             * @returns     true if running; otherwise false.
+             */
+            auto isRunning() -> bool;
+
+            /**
+             * @brief       Parses a line of output from the ping command.
+             *
+             * @details     Called for every complete line that the process writes, the reply signal is emitted if
+             *              the line reports the result of a request.  Each request is reported once, a reply that
+             *              arrives after the request was reported as outstanding is ignored.
+             *
+             * @param[in]   data the line of output.
+             * @param[in]   length the length of the line in bytes.
+             */
+            auto parseLine(const char *data, int length) -> void;
+
+            /**
+             * @brief       This signal is emitted when the result of a request is available.
+             *
+             * @param[in]   sampleNumber the number of the request, starting at 0.
+             * @param[in]   replyType the type of the reply.
+             * @param[in]   hostAddress the address of the host that replied, null if there was no reply.
+             * @param[in]   requestTime the time that the request was sent.
+             * @param[in]   roundTripTime the round trip time in seconds, -1 if there was no reply.
+             */
+            Q_SIGNAL void reply(
+                unsigned long sampleNumber,
+                Nedrysoft::PingCommand::PingCommand::ReplyType replyType,
+                const QHostAddress &hostAddress,
+                const QDateTime &requestTime,
+                double roundTripTime
+            );
+
+        private:
+            /**
+             * @brief       Reads the complete lines that are available from the process.
+             *
+             * @details     The output is read into a buffer that is reused for the lifetime of the object and each
+             *              line is parsed in place, so reading the output does not allocate.
+             */
+            auto readOutput() -> void;
+
+            /**
+             * @brief       Converts a sequence number reported by the ping command into a running count.
+             *
+             * @details     The ping command reports the 16 bit sequence number of the ICMP request, which wraps
+             *              back to 0 after 65535.  The number is placed in the same 65536 range as the last request
+             *              that was reported, moving to the next range if it has wrapped or the previous range if it
+             *              is a late reply from before the wrap, so the count keeps increasing for as long as the
+             *              process runs.
+             *
+             * @param[in]   sequence the sequence number from the output.
+             *
+             * @returns     the running sequence count.
+             */
+            auto extendSequence(unsigned long sequence) -> unsigned long;
+
+            /**
+             * @brief       Returns the time that a request was sent.
+             *
+             * @details     The ping command only reports the round trip time of echo replies, for other replies the
+             *              send time is calculated from the interval and the most recent echo reply, or the time
+             *              the process was started if there have been none.
+             *
+             * @param[in]   sequence the running sequence count of the request.
+             *
+             * @returns     the time in milliseconds since the unix epoch.
+             */
+            auto requestTime(unsigned long sequence) -> double;
+
+            /**
+             * @brief       Reports the result of a request.
+             *
+             * @param[in]   sequence the running sequence count of the request.
+             * @param[in]   replyType the type of the reply.
+             * @param[in]   hostAddress the address of the host that replied.
+             * @param[in]   receiveTime the time the reply was received in milliseconds since the unix epoch.
+             * @param[in]   roundTripTime the round trip time in milliseconds, -1 if not known.
+             */
+            auto report(
+                unsigned long sequence,
+                Nedrysoft::PingCommand::PingCommand::ReplyType replyType,
+                const QHostAddress &hostAddress,
+                double receiveTime,
+                double roundTripTime
+            ) -> void;
+
+        private:
+            //! @cond
+
+            QProcess *m_process;
+            QByteArray m_readBuffer;
+            int m_readLength;
+            QString m_program;
+            QHostAddress m_hostAddress;
+            int m_interval;
+            double m_sequenceEpoch;
+            unsigned long m_lastSequence;
+
+            //! @endcond
+    };
+}}
+
+#endif // NEDRYSOFT_PINGCOMMAND_PINGCOMMAND_H
@@ -0,0 +1,334 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 19/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PingOutputParser.h"
+
+#include <cstring>
+
+constexpr auto SecondsInMinute = 60.0;
+constexpr auto SecondsInHour = 3600.0;
+constexpr auto MaximumFractionDigits = 15;
+
+namespace {
+    auto isDigit(char character) -> bool {
+        return (character>='0') && (character<='9');
+    }
+
+    template <int N>
+    auto startsWith(const char *position, const char *end, const char (&text)[N]) -> bool {
+        return ((end-position)>=(N-1)) && (memcmp(position, text, N-1)==0);
+    }
+
+    template <int N>
+    auto find(const char *position, const char *end, const char (&text)[N]) -> const char * {
+        for (;(end-position)>=(N-1);position++) {
+            if (memcmp(position, text, N-1)==0) {
+                return position;
+            }
+        }
+
+        return nullptr;
+    }
+
+    auto skipSpaces(const char *&position, const char *end) -> void {
+        while ((position<end) && (*position==' ')) {
+            position++;
+        }
+    }
+
+    auto parseUnsigned(const char *&position, const char *end, unsigned long &value) -> bool {
+        auto start = position;
+
+        value = 0;
+
+        while ((position<end) && (isDigit(*position))) {
+            value = value*10+static_cast<unsigned long>(*position-'0');
+
+            position++;
+        }
+
+        return position!=start;
+    }
+
+    auto parseDecimal(const char *&position, const char *end, double &value) -> bool {
+        unsigned long integerPart;
+
+        if (!parseUnsigned(position, end, integerPart)) {
+            return false;
+        }
+
+        value = static_cast<double>(integerPart);
+
+        if ((position<end) && (*position=='.')) {
+            unsigned long long fraction = 0;
+            unsigned long long divisor = 1;
+            auto digits = 0;
+
+            position++;
+
+            /**
+             * the fraction is gathered as an integer and divided once so that values such as timestamps keep
+             * their precision, digits beyond what a double can hold are skipped.
+             */
+
+            while ((position<end) && (isDigit(*position))) {
+                if (digits<MaximumFractionDigits) {
+                    fraction = fraction*10+static_cast<unsigned long long>(*position-'0');
+                    divisor *= 10;
+                    digits++;
+                }
+
+                position++;
+            }
+
+            value += static_cast<double>(fraction)/static_cast<double>(divisor);
+        }
+
+        return true;
+    }
+
+    /**
+     * parses the "[seconds.microseconds] " prefix written by iputils -D and the "hh:mm:ss.microseconds " prefix
+     * written by macOS --apple-time.
+     */
+
+    auto parseTimestamp(const char *&position, const char *end, Nedrysoft::PingCommand::PingOutputParser::Line &line) -> void {
+        if ((position<end) && (*position=='[')) {
+            auto cursor = position+1;
+            double timestamp;
+
+            if ((parseDecimal(cursor, end, timestamp)) && (cursor<end) && (*cursor==']')) {
+                line.timestampType = Nedrysoft::PingCommand::PingOutputParser::TimestampType::Epoch;
+                line.timestamp = timestamp;
+
+                position = cursor+1;
+
+                skipSpaces(position, end);
+            }
+
+            return;
+        }
+
+        if (((end-position)<8) ||
+            (!isDigit(position[0])) || (!isDigit(position[1])) || (position[2]!=':') ||
+            (!isDigit(position[3])) || (!isDigit(position[4])) || (position[5]!=':')) {
+
+            return;
+        }
+
+        auto cursor = position+6;
+        double seconds;
+
+        if (!parseDecimal(cursor, end, seconds)) {
+            return;
+        }
+
+        auto hours = (position[0]-'0')*10+(position[1]-'0');
+        auto minutes = (position[3]-'0')*10+(position[4]-'0');
+
+        line.timestampType = Nedrysoft::PingCommand::PingOutputParser::TimestampType::TimeOfDay;
+        line.timestamp = hours*SecondsInHour+minutes*SecondsInMinute+seconds;
+
+        position = cursor;
+
+        skipSpaces(position, end);
+    }
+
+    /**
+     * the address is either a bare address, which may be followed by a colon, or a host name followed by the
+     * address in brackets when the command has been asked to resolve names.
+     */
+
+    auto parseAddress(const char *&position, const char *end, Nedrysoft::PingCommand::PingOutputParser::Line &line) -> void {
+        auto start = position;
+
+        while ((position<end) && (*position!=' ')) {
+            position++;
+        }
+
+        auto addressEnd = position;
+
+        if ((addressEnd>start) && (*(addressEnd-1)==':')) {
+            addressEnd--;
+        }
+
+        line.address = start;
+        line.addressLength = static_cast<int>(addressEnd-start);
+
+        if (((end-position)>=2) && (position[1]=='(')) {
+            auto open = position+2;
+            auto close = find(open, end, ")");
+
+            if (close) {
+                line.address = open;
+                line.addressLength = static_cast<int>(close-open);
+
+                position = close+1;
+            }
+        }
+    }
+
+    /**
+     * the remainder of a reply holds the sequence number ("icmp_seq=" for iputils and macOS, "seq=" for BusyBox),
+     * the round trip time and the reason for an error reply.
+     */
+
+    auto parseReplyBody(
+            const char *position,
+            const char *end,
+            bool isError,
+            Nedrysoft::PingCommand::PingOutputParser::Line &line ) -> void {
+
+        auto sequence = find(position, end, "seq=");
+
+        if (sequence) {
+            sequence += 4;
+
+            line.hasSequence = parseUnsigned(sequence, end, line.sequence);
+        }
+
+        auto time = find(position, end, "time=");
+
+        if (time) {
+            time += 5;
+
+            if (!parseDecimal(time, end, line.roundTripTime)) {
+                line.roundTripTime = -1;
+            }
+        }
+
+        if (find(position, end, "exceeded")) {
+            line.type = Nedrysoft::PingCommand::PingOutputParser::LineType::TimeExceeded;
+        } else if (find(position, end, "nreachable")) {
+            line.type = Nedrysoft::PingCommand::PingOutputParser::LineType::Unreachable;
+        } else if ((!isError) && (line.roundTripTime>=0)) {
+            line.type = Nedrysoft::PingCommand::PingOutputParser::LineType::Reply;
+        }
+
+        if (line.type!=Nedrysoft::PingCommand::PingOutputParser::LineType::Reply) {
+            line.roundTripTime = -1;
+        }
+    }
+}
+
+auto Nedrysoft::PingCommand::PingOutputParser::parse(const char *data, int length, Line &line) -> bool {
+    line.type = LineType::Unknown;
+    line.timestampType = TimestampType::None;
+    line.timestamp = 0;
+    line.hasSequence = false;
+    line.sequence = 0;
+    line.roundTripTime = -1;
+    line.address = nullptr;
+    line.addressLength = 0;
+
+    if ((!data) || (length<=0)) {
+        return false;
+    }
+
+    auto position = data;
+    auto end = data+length;
+
+    while ((end>position) && ((*(end-1)=='\n') || (*(end-1)=='\r'))) {
+        end--;
+    }
+
+    parseTimestamp(position, end, line);
+
+    if (startsWith(position, end, "no answer yet for icmp_seq=")) {
+        position += sizeof("no answer yet for icmp_seq=")-1;
+
+        line.hasSequence = parseUnsigned(position, end, line.sequence);
+        line.type = LineType::NoAnswer;
+
+        return true;
+    }
+
+    if (startsWith(position, end, "Request timeout for icmp_seq")) {
+        position += sizeof("Request timeout for icmp_seq")-1;
+
+        while ((position<end) && ((*position==' ') || (*position=='='))) {
+            position++;
+        }
+
+        line.hasSequence = parseUnsigned(position, end, line.sequence);
+        line.type = LineType::NoAnswer;
+
+        return true;
+    }
+
+    if (startsWith(position, end, "From ")) {
+        position += sizeof("From ")-1;
+
+        parseAddress(position, end, line);
+        parseReplyBody(position, end, true, line);
+
+        return line.type!=LineType::Unknown;
+    }
+
+    auto bytesFrom = find(position, end, " bytes from ");
+
+    if (bytesFrom) {
+        position = bytesFrom+sizeof(" bytes from ")-1;
+
+        parseAddress(position, end, line);
+        parseReplyBody(position, end, false, line);
+
+        return line.type!=LineType::Unknown;
+    }
+
+    return false;
+}
+
+auto Nedrysoft::PingCommand::PingOutputParser::hostAddress(const Line &line) -> QHostAddress {
+    if ((!line.address) || (line.addressLength<=0)) {
+        return QHostAddress();
+    }
+
+    auto position = line.address;
+    auto end = line.address+line.addressLength;
+    quint32 ipv4Address = 0;
+    auto octets = 0;
+
+    while (position<end) {
+        unsigned long octet;
+
+        if ((!parseUnsigned(position, end, octet)) || (octet>255)) {
+            break;
+        }
+
+        ipv4Address = (ipv4Address<<8) | static_cast<quint32>(octet);
+        octets++;
+
+        if ((position==end) || (*position!='.') || (octets==4)) {
+            break;
+        }
+
+        position++;
+    }
+
+    if ((octets==4) && (position==end)) {
+        return QHostAddress(ipv4Address);
+    }
+
+    return QHostAddress(QString::fromLatin1(line.address, line.addressLength));
+}
@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 19/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NEDRYSOFT_PINGCOMMAND_PINGOUTPUTPARSER_H
+#define NEDRYSOFT_PINGCOMMAND_PINGOUTPUTPARSER_H
+
+#include "PingCommand.h"
+
+#include <QHostAddress>
+
+namespace Nedrysoft { namespace PingCommand {
+    /**
+     * @brief       The PingOutputParser class parses the lines written by the operating system ping command.
+     *
+     * @details     The parser works directly on the bytes of a line and does not allocate, the address of the
+     *              host that replied is returned as a view into the line so that an address is only built for
+     *              the lines that are reported.
+     *
+     *              The output of Linux iputils, BusyBox and macOS ping is understood, including the iputils -D
+     *              (unix time) and macOS --apple-time (time of day) timestamps.
+     */
+    class NEDRYSOFT_PINGCOMMAND_DLLSPEC PingOutputParser {
+        public:
+            /**
+             * @brief       The type of line.
+             */
+            enum class LineType {
+                Unknown,
+                Reply,
+                TimeExceeded,
+                Unreachable,
+                NoAnswer
+            };
+
+            /**
+             * @brief       The type of timestamp that prefixed the line.
+             */
+            enum class TimestampType {
+                None,
+                Epoch,
+                TimeOfDay
+            };
+
+            /**
+             * @brief       The Line structure holds the information parsed from a line.
+             *
+             * @note        The address points into the data that was parsed and is only valid for as long as the
+             *              data is.
+             */
+            struct Line {
+                LineType type;
+                TimestampType timestampType;
+                double timestamp;
+                bool hasSequence;
+                unsigned long sequence;
+                double roundTripTime;
+                const char *address;
+                int addressLength;
+            };
+
+        public:
+            /**
+             * @brief       Parses a line of output.
+             *
+             * @param[in]   data the line, a trailing line ending is ignored.
+             * @param[in]   length the length of the line in bytes.
+             * @param[out]  line the parsed information, the timestamp is in seconds (since the unix epoch or
+             *              since midnight) and the round trip time is in milliseconds, -1 if not present.
+             *
+             * @returns     true if the line reports the result of a request; otherwise false.
+             */
+            static auto parse(const char *data, int length, Line &line) -> bool;
+
+            /**
+             * @brief       Returns the address of the host that sent a reply.
+             *
+             * @details     IPv4 addresses are converted without creating a string.
+             *
+             * @param[in]   line the parsed line.
+             *
+             * @returns     the address; a null address if the line did not contain one.
+             */
+            static auto hostAddress(const Line &line) -> QHostAddress;
+    };
+}}
+
+#endif // NEDRYSOFT_PINGCOMMAND_PINGOUTPUTPARSER_H
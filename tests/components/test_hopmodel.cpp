@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 19/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "catch.hpp"
+#include "RouteAnalyser/AddressTable.h"
+#include "RouteAnalyser/HopModel.h"
+
+TEST_CASE("HopModel Tests", "[app][components][network]") {
+    SECTION("check addresses are interned once") {
+        Nedrysoft::RouteAnalyser::AddressTable addressTable;
+
+        auto firstId = addressTable.intern(QHostAddress("192.0.2.1"));
+        auto secondId = addressTable.intern(QHostAddress("192.0.2.2"));
+
+        REQUIRE(firstId!=Nedrysoft::RouteAnalyser::NullAddressId);
+        REQUIRE(secondId!=Nedrysoft::RouteAnalyser::NullAddressId);
+        REQUIRE(firstId!=secondId);
+        REQUIRE(addressTable.intern(QHostAddress("192.0.2.1"))==firstId);
+        REQUIRE(addressTable.intern(QHostAddress())==Nedrysoft::RouteAnalyser::NullAddressId);
+        REQUIRE(addressTable.count()==2);
+
+        REQUIRE(addressTable.address(firstId)==QHostAddress("192.0.2.1"));
+        REQUIRE(addressTable.address(secondId)==QHostAddress("192.0.2.2"));
+        REQUIRE(addressTable.address(secondId+1).isNull());
+    }
+
+    SECTION("check the address table is cleared") {
+        Nedrysoft::RouteAnalyser::AddressTable addressTable;
+
+        auto addressId = addressTable.intern(QHostAddress("192.0.2.1"));
+
+        addressTable.clear();
+
+        REQUIRE(addressTable.count()==0);
+        REQUIRE(addressTable.address(addressId).isNull());
+
+        /**
+         * the identifiers start again from the beginning once the table has been cleared.
+         */
+
+        REQUIRE(addressTable.intern(QHostAddress("198.51.100.1"))==addressId);
+        REQUIRE(addressTable.count()==1);
+    }
+
+    SECTION("check responders are ordered by the number of replies") {
+        Nedrysoft::RouteAnalyser::HopModel hopModel;
+
+        auto firstAddress = QHostAddress("192.0.2.1");
+        auto secondAddress = QHostAddress("192.0.2.2");
+        auto thirdAddress = QHostAddress("192.0.2.3");
+
+        REQUIRE(hopModel.addResponse(2, firstAddress)==true);
+        REQUIRE(hopModel.addResponse(2, secondAddress)==true);
+        REQUIRE(hopModel.addResponse(2, secondAddress)==false);
+        REQUIRE(hopModel.addResponse(2, thirdAddress)==true);
+        REQUIRE(hopModel.addResponse(2, thirdAddress)==false);
+        REQUIRE(hopModel.addResponse(2, thirdAddress)==false);
+
+        auto responders = hopModel.responders(2);
+
+        REQUIRE(responders.count()==3);
+        REQUIRE(hopModel.address(responders.at(0).addressId)==thirdAddress);
+        REQUIRE(responders.at(0).hitCount==3);
+        REQUIRE(hopModel.address(responders.at(1).addressId)==secondAddress);
+        REQUIRE(responders.at(1).hitCount==2);
+        REQUIRE(hopModel.address(responders.at(2).addressId)==firstAddress);
+        REQUIRE(responders.at(2).hitCount==1);
+
+        REQUIRE(hopModel.primaryResponder(2)==hopModel.intern(thirdAddress));
+        REQUIRE(hopModel.isLoadBalanced(2)==true);
+        REQUIRE(hopModel.hopCount()==2);
+
+        /**
+         * a hop that has not replied has no responders, and a reply with no address is ignored.
+         */
+
+        REQUIRE(hopModel.addResponse(1, QHostAddress())==false);
+        REQUIRE(hopModel.responderCount(1)==0);
+        REQUIRE(hopModel.primaryResponder(1)==Nedrysoft::RouteAnalyser::NullAddressId);
+        REQUIRE(hopModel.isLoadBalanced(1)==false);
+    }
+
+    SECTION("check the route is made up of the primary responders") {
+        Nedrysoft::RouteAnalyser::HopModel hopModel;
+
+        hopModel.addRoute(Nedrysoft::RouteAnalyser::RouteList()
+                << QHostAddress("192.0.2.1")
+                << QHostAddress()
+                << QHostAddress("192.0.2.3") );
+
+        hopModel.addResponse(1, QHostAddress("198.51.100.1"));
+        hopModel.addResponse(1, QHostAddress("198.51.100.1"));
+
+        auto route = hopModel.route();
+
+        REQUIRE(route.count()==3);
+        REQUIRE(route.at(0)==QHostAddress("198.51.100.1"));
+        REQUIRE(route.at(1).isNull());
+        REQUIRE(route.at(2)==QHostAddress("192.0.2.3"));
+
+        hopModel.clear();
+
+        REQUIRE(hopModel.hopCount()==0);
+        REQUIRE(hopModel.route().isEmpty());
+    }
+}
@@ -0,0 +1,229 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 19/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "catch.hpp"
+
+#include <ComponentLoader>
+#include <IComponentManager>
+#include <IConfiguration.h>
+#include <IGeoIPProvider.h>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMap>
+#include <QRandomGenerator>
+#include <QTemporaryDir>
+#include <QTcpServer>
+#include <QTcpSocket>
+
+/**
+ * @brief       A local stand-in for the ip-api batch endpoint.
+ *
+ * @details     Answers every POSTed array of addresses with a successful result for each address, the requests
+ *              are recorded so that the batching can be checked.
+ */
+class BatchEndpoint {
+    public:
+        BatchEndpoint() {
+            m_server.listen(QHostAddress::LocalHost);
+
+            QObject::connect(&m_server, &QTcpServer::newConnection, [this]() {
+                while (m_server.hasPendingConnections()) {
+                    auto socket = m_server.nextPendingConnection();
+
+                    QObject::connect(socket, &QTcpSocket::readyRead, [this, socket]() {
+                        m_buffers[socket].append(socket->readAll());
+
+                        processRequest(socket);
+                    });
+
+                    QObject::connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+                }
+            });
+        }
+
+        auto url() -> QString {
+            return QString("http://127.0.0.1:%1/batch").arg(m_server.serverPort());
+        }
+
+        QList<QStringList> m_requests;
+
+    private:
+        auto processRequest(QTcpSocket *socket) -> void {
+            auto &buffer = m_buffers[socket];
+            auto headerEnd = buffer.indexOf("\r\n\r\n");
+
+            if (headerEnd<0) {
+                return;
+            }
+
+            auto contentLength = 0;
+
+            for (const auto &header : buffer.left(headerEnd).split('\n')) {
+                if (header.toLower().startsWith("content-length:")) {
+                    contentLength = header.mid(header.indexOf(':')+1).trimmed().toInt();
+                }
+            }
+
+            if (buffer.length()<headerEnd+4+contentLength) {
+                return;
+            }
+
+            auto body = buffer.mid(headerEnd+4, contentLength);
+            auto hosts = QStringList();
+            auto resultArray = QJsonArray();
+
+            buffer.clear();
+
+            for (const auto &value : QJsonDocument::fromJson(body).array()) {
+                auto result = QJsonObject();
+
+                hosts.append(value.toString());
+
+                result["status"] = "success";
+                result["query"] = value.toString();
+                result["country"] = "Testland";
+                result["countryCode"] = "TL";
+                result["region"] = "T";
+                result["regionName"] = "Test";
+                result["city"] = "Testville";
+                result["zip"] = "T1";
+                result["lat"] = 1.0;
+                result["lon"] = 2.0;
+                result["timezone"] = "UTC";
+                result["isp"] = "Test ISP";
+                result["org"] = "Test Org";
+                result["as"] = "AS64496 Test";
+
+                resultArray.append(result);
+            }
+
+            m_requests.append(hosts);
+
+            auto response = QJsonDocument(resultArray).toJson(QJsonDocument::Compact);
+
+            socket->write(
+                QString("HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nContent-Length: %1\r\n"
+                        "Connection: close\r\n\r\n").arg(response.length()).toLatin1()+response
+            );
+
+            socket->disconnectFromHost();
+        }
+
+        QTcpServer m_server;
+        QMap<QTcpSocket *, QByteArray> m_buffers;
+};
+
+TEST_CASE("IPAPIGeoIPProvider Tests", "[app][components][network]") {
+    SECTION("check lookups are batched and coalesced") {
+        QTemporaryDir temporaryDir;
+        Nedrysoft::ComponentSystem::ComponentLoader componentLoader;
+        BatchEndpoint batchEndpoint;
+
+        REQUIRE(temporaryDir.isValid());
+
+        componentLoader.addComponents(PINGNOO_TEST_COMPONENTS_DIR);
+
+        componentLoader.loadComponents();
+
+        Nedrysoft::Core::IGeoIPProvider *geoIPProvider = nullptr;
+
+        for (auto provider : Nedrysoft::ComponentSystem::getObjects<Nedrysoft::Core::IGeoIPProvider>()) {
+            if (QString::fromLatin1(provider->metaObject()->className())=="Nedrysoft::IPAPIGeoIPProvider::IPAPIGeoIPProvider") {
+                geoIPProvider = provider;
+                break;
+            }
+        }
+
+        REQUIRE_MESSAGE(geoIPProvider!=nullptr, "Unable to find Nedrysoft::IPAPIGeoIPProvider::IPAPIGeoIPProvider");
+
+        auto configuration = dynamic_cast<Nedrysoft::Core::IConfiguration *>(geoIPProvider);
+
+        REQUIRE(configuration!=nullptr);
+
+        auto configurationObject = QJsonObject();
+
+        configurationObject["batchUrl"] = batchEndpoint.url();
+        configurationObject["flushWindow"] = 200;
+        configurationObject["ipv6PrefixLength"] = 128;
+        configurationObject["cacheFilename"] = temporaryDir.filePath("ip-api-cache.db");
+
+        configuration->loadConfiguration(configurationObject);
+
+        /**
+         * the cache is kept in a temporary directory so that nothing is answered from an earlier run, each address
+         * is cached on its own rather than by network so that every one of them is requested.
+         */
+
+        auto hosts = QStringList();
+        auto prefix = QString("2001:db8:%1:%2::").
+                arg(QRandomGenerator::global()->bounded(0x10000), 0, 16).
+                arg(QRandomGenerator::global()->bounded(0x10000), 0, 16);
+
+        for (auto index=0;index<150;index++) {
+            hosts.append(QHostAddress(prefix+QString::number(index+1, 16)).toString());
+        }
+
+        auto results = QMap<QString, int>();
+
+        for (const auto &host : hosts) {
+            geoIPProvider->lookup(host, [&results](const QString &host, const QVariantMap &result) {
+                if (result["country"].toString()=="Testland") {
+                    results[host]++;
+                }
+            });
+        }
+
+        geoIPProvider->lookup(hosts.first(), [&results](const QString &host, const QVariantMap &) {
+            results[host]++;
+        });
+
+        /**
+         * the same address written differently is coalesced with the pending lookup.
+         */
+
+        geoIPProvider->lookup(hosts.at(1).toUpper(), [&results](const QString &host, const QVariantMap &) {
+            results[host]++;
+        });
+
+        QElapsedTimer timer;
+
+        timer.start();
+
+        while (((results.count()<hosts.count()) || (results[hosts.first()]<2) || (results[hosts.at(1)]<2)) &&
+               (timer.elapsed()<10000)) {
+            QCoreApplication::processEvents(QEventLoop::AllEvents, 50);
+        }
+
+        REQUIRE_MESSAGE(results.count()==hosts.count(), "Not every lookup was answered.");
+        REQUIRE_MESSAGE(results[hosts.first()]==2, "A coalesced lookup was not answered.");
+        REQUIRE_MESSAGE(results[hosts.at(1)]==2, "A lookup of a differently written address was not coalesced.");
+
+        REQUIRE_MESSAGE(batchEndpoint.m_requests.count()==2, "The lookups were not sent in batches of 100.");
+        REQUIRE(batchEndpoint.m_requests.at(0).count()==100);
+        REQUIRE(batchEndpoint.m_requests.at(1).count()==50);
+        REQUIRE_MESSAGE(!batchEndpoint.m_requests.at(1).contains(hosts.first()), "A duplicate lookup was sent.");
+    }
+}
@@ -0,0 +1,171 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 19/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "catch.hpp"
+#include "RouteAnalyser/PacketRateGovernor.h"
+
+#include <QList>
+#include <QMutex>
+#include <QThread>
+#include <thread>
+
+constexpr auto PacketLength = 64;
+
+TEST_CASE("PacketRateGovernor Tests", "[app][components][network]") {
+    auto packetRateGovernor = Nedrysoft::RouteAnalyser::PacketRateGovernor::getInstance();
+    int session;
+
+    SECTION("check packets are not limited without a budget") {
+        packetRateGovernor->setPacketRate(0);
+        packetRateGovernor->setByteRate(0);
+
+        for (auto packet = 0; packet<1000; packet++) {
+            REQUIRE(packetRateGovernor->tryAcquire(&session, PacketLength));
+        }
+    }
+
+    SECTION("check the packet bucket holds a limited burst") {
+        packetRateGovernor->setByteRate(0);
+        packetRateGovernor->setPacketRate(100);
+
+        /**
+         * the bucket holds 100ms worth of packets, once it is empty the next packet has to wait for a refill.
+         */
+
+        auto acquiredCount = 0;
+
+        while ((acquiredCount<20) && (packetRateGovernor->tryAcquire(&session, PacketLength))) {
+            acquiredCount++;
+        }
+
+        REQUIRE(acquiredCount>=10);
+        REQUIRE(acquiredCount<=11);
+
+        /**
+         * the burst is not exceeded however long the bucket is left to refill.
+         */
+
+        QThread::msleep(300);
+
+        acquiredCount = 0;
+
+        while ((acquiredCount<20) && (packetRateGovernor->tryAcquire(&session, PacketLength))) {
+            acquiredCount++;
+        }
+
+        REQUIRE(acquiredCount>=10);
+        REQUIRE(acquiredCount<=11);
+    }
+
+    SECTION("check the buckets are refilled at the configured rate") {
+        packetRateGovernor->setByteRate(0);
+        packetRateGovernor->setPacketRate(100);
+
+        while (packetRateGovernor->tryAcquire(&session, PacketLength)) {
+        }
+
+        REQUIRE(!packetRateGovernor->tryAcquire(&session, PacketLength));
+
+        QThread::msleep(50);
+
+        /**
+         * 50ms at 100 packets per second is worth 5 packets.
+         */
+
+        auto acquiredCount = 0;
+
+        while ((acquiredCount<20) && (packetRateGovernor->tryAcquire(&session, PacketLength))) {
+            acquiredCount++;
+        }
+
+        REQUIRE(acquiredCount>=4);
+        REQUIRE(acquiredCount<=10);
+
+        packetRateGovernor->setPacketRate(0);
+        packetRateGovernor->setByteRate(15000);
+
+        /**
+         * the byte bucket holds 1500 bytes, one 1000 byte packet fits but a second has to wait.
+         */
+
+        REQUIRE(packetRateGovernor->tryAcquire(&session, 1000));
+        REQUIRE(!packetRateGovernor->tryAcquire(&session, 1000));
+
+        QThread::msleep(100);
+
+        REQUIRE(packetRateGovernor->tryAcquire(&session, 1000));
+    }
+
+    SECTION("check waiting sessions are granted packets in turn") {
+        constexpr auto PacketsPerSession = 10;
+
+        int firstSession, secondSession;
+        QList<const void *> grantOrder;
+        QMutex grantMutex;
+
+        packetRateGovernor->setByteRate(0);
+        packetRateGovernor->setPacketRate(50);
+
+        while (packetRateGovernor->tryAcquire(&session, PacketLength)) {
+        }
+
+        auto sender = [&](const void *senderSession) {
+            for (auto packet = 0; packet<PacketsPerSession; packet++) {
+                packetRateGovernor->acquire(senderSession, PacketLength);
+
+                QMutexLocker locker(&grantMutex);
+
+                grantOrder.append(senderSession);
+            }
+        };
+
+        std::thread firstSender(sender, &firstSession);
+        std::thread secondSender(sender, &secondSession);
+
+        firstSender.join();
+        secondSender.join();
+
+        REQUIRE(grantOrder.count()==PacketsPerSession*2);
+
+        /**
+         * both sessions always have a packet waiting, so neither is granted more than one packet in a row apart
+         * from at the start and end when only one of them may be waiting.
+         */
+
+        auto longestRun = 0;
+        auto currentRun = 0;
+
+        for (auto index = 1; index<grantOrder.count()-1; index++) {
+            currentRun = (grantOrder.at(index)==grantOrder.at(index-1)) ? currentRun+1 : 0;
+            longestRun = qMax(longestRun, currentRun);
+        }
+
+        REQUIRE(longestRun<=1);
+
+        REQUIRE(packetRateGovernor->throttleLevel()>0);
+    }
+
+    packetRateGovernor->setPacketRate(0);
+    packetRateGovernor->setByteRate(0);
+}
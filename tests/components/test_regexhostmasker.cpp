@@ -27,7 +27,9 @@
 #include <IComponentManager>
 #include <IHostMasker.h>
 #include <QFile>
+#include <QJsonArray>
 #include <QJsonDocument>
+#include <QJsonObject>
 
 QByteArray fileContent(QString filename) {
     QFile file(filename);
@@ -122,4 +124,283 @@ TEST_CASE("RegExHostMasker Tests", "[app][components][network]") {
         REQUIRE_MESSAGE(maskedHostName.toStdString()==std::string("1.123-123-123.static.test2.co.uk"), "Host name was masked and shouldn't have been.");
         REQUIRE_MESSAGE(maskedHostAddress.toStdString()==std::string("1.123.123.123"), "Host address was masked and shouldn't have been.");
     }
+
+    SECTION("check the first matching rule is applied to each field") {
+        Nedrysoft::ComponentSystem::ComponentLoader componentLoader;
+        QString maskedHostName, maskedHostAddress;
+
+        componentLoader.addComponents(PINGNOO_TEST_COMPONENTS_DIR);
+
+        componentLoader.loadComponents();
+
+        Nedrysoft::Core::IHostMasker *regExHostMasker = nullptr;
+
+        for (auto hostMasker : Nedrysoft::ComponentSystem::getObjects<Nedrysoft::Core::IHostMasker>()) {
+            if (QString::fromLatin1(hostMasker->metaObject()->className())=="Nedrysoft::RegExHostMasker::RegExHostMasker") {
+                regExHostMasker = hostMasker;
+                break;
+            }
+        }
+
+        REQUIRE_MESSAGE(regExHostMasker!=nullptr, "Unable to find Nedrysoft::RegExHostMasker::RegExHostMasker");
+
+        auto configuration = QJsonObject();
+        auto matchItems = QJsonArray();
+        auto addRule = [&matchItems](
+                const QString &matchExpression,
+                int matchFlags,
+                const QString &hostReplacementString,
+                const QString &addressReplacementString) {
+
+            auto matchItem = QJsonObject();
+
+            matchItem["matchExpression"] = matchExpression;
+            matchItem["matchFlags"] = matchFlags;
+            matchItem["hostReplacementString"] = hostReplacementString;
+            matchItem["addressReplacementString"] = addressReplacementString;
+
+            matchItems.append(matchItem);
+        };
+
+        addRule(R"(^core-(?<site>[a-z]+)\.first\.example$)", 20, "<core>.${site}", "");
+        addRule(R"(\.first\.example$)", 28, "<hidden>.first.example", "<hidden>");
+        addRule(R"(^198\.51\.100\.)", 10, "", "198.51.100.x");
+        addRule(R"(^198\.51\.)", 10, "", "198.51.x.x");
+
+        configuration["id"] = "Nedrysoft::RegExHostMasker::RegExHostMasker";
+        configuration["matchItems"] = matchItems;
+
+        regExHostMasker->loadConfiguration(configuration);
+
+        /**
+         * both of the first two rules match, the host name is masked by the first and the address by the second
+         * as the first rule has no address replacement.
+         */
+
+        REQUIRE(regExHostMasker->mask(1, "core-lon.first.example", "192.0.2.1", maskedHostName, maskedHostAddress));
+        REQUIRE(maskedHostName.toStdString()==std::string("<core>.lon"));
+        REQUIRE(maskedHostAddress.toStdString()==std::string("<hidden>"));
+
+        REQUIRE(regExHostMasker->mask(2, "edge.first.example", "192.0.2.2", maskedHostName, maskedHostAddress));
+        REQUIRE(maskedHostName.toStdString()==std::string("<hidden>.first.example"));
+        REQUIRE(maskedHostAddress.toStdString()==std::string("<hidden>"));
+
+        REQUIRE(regExHostMasker->mask(3, "198.51.100.7", "198.51.100.7", maskedHostName, maskedHostAddress));
+        REQUIRE(maskedHostAddress.toStdString()==std::string("198.51.100.x"));
+
+        REQUIRE(regExHostMasker->mask(4, "198.51.200.7", "198.51.200.7", maskedHostName, maskedHostAddress));
+        REQUIRE(maskedHostAddress.toStdString()==std::string("198.51.x.x"));
+
+        REQUIRE(!regExHostMasker->mask(5, "other.example", "203.0.113.1", maskedHostName, maskedHostAddress));
+        REQUIRE(maskedHostName.toStdString()==std::string("other.example"));
+        REQUIRE(maskedHostAddress.toStdString()==std::string("203.0.113.1"));
+    }
+
+    SECTION("check a host rule and an address rule are both applied") {
+        Nedrysoft::ComponentSystem::ComponentLoader componentLoader;
+        QString maskedHostName, maskedHostAddress;
+
+        componentLoader.addComponents(PINGNOO_TEST_COMPONENTS_DIR);
+
+        componentLoader.loadComponents();
+
+        Nedrysoft::Core::IHostMasker *regExHostMasker = nullptr;
+
+        for (auto hostMasker : Nedrysoft::ComponentSystem::getObjects<Nedrysoft::Core::IHostMasker>()) {
+            if (QString::fromLatin1(hostMasker->metaObject()->className())=="Nedrysoft::RegExHostMasker::RegExHostMasker") {
+                regExHostMasker = hostMasker;
+                break;
+            }
+        }
+
+        REQUIRE_MESSAGE(regExHostMasker!=nullptr, "Unable to find Nedrysoft::RegExHostMasker::RegExHostMasker");
+
+        auto configuration = QJsonObject();
+        auto matchItems = QJsonArray();
+        auto hostItem = QJsonObject();
+        auto addressItem = QJsonObject();
+
+        hostItem["matchExpression"] = R"(\.home\.example$)";
+        hostItem["matchFlags"] = 20;
+        hostItem["hostReplacementString"] = "<hidden>.home.example";
+        hostItem["addressReplacementString"] = "";
+
+        addressItem["matchExpression"] = R"(^192\.0\.2\.)";
+        addressItem["matchFlags"] = 10;
+        addressItem["hostReplacementString"] = "";
+        addressItem["addressReplacementString"] = "192.0.2.x";
+
+        matchItems.append(hostItem);
+        matchItems.append(addressItem);
+
+        configuration["id"] = "Nedrysoft::RegExHostMasker::RegExHostMasker";
+        configuration["matchItems"] = matchItems;
+
+        regExHostMasker->loadConfiguration(configuration);
+
+        /**
+         * the host rule matches first but only masks the host name, the address is still masked by the address
+         * rule rather than being shown.
+         */
+
+        REQUIRE(regExHostMasker->mask(1, "router.home.example", "192.0.2.1", maskedHostName, maskedHostAddress));
+        REQUIRE(maskedHostName.toStdString()==std::string("<hidden>.home.example"));
+        REQUIRE(maskedHostAddress.toStdString()==std::string("192.0.2.x"));
+
+        REQUIRE(regExHostMasker->mask(2, "router.isp.example", "192.0.2.2", maskedHostName, maskedHostAddress));
+        REQUIRE(maskedHostName.toStdString()==std::string("router.isp.example"));
+        REQUIRE(maskedHostAddress.toStdString()==std::string("192.0.2.x"));
+
+        REQUIRE(regExHostMasker->mask(3, "router.home.example", "198.51.100.1", maskedHostName, maskedHostAddress));
+        REQUIRE(maskedHostName.toStdString()==std::string("<hidden>.home.example"));
+        REQUIRE(maskedHostAddress.toStdString()==std::string("198.51.100.1"));
+    }
+}
+
+TEST_CASE("RegExHostMasker Throughput", "[.][benchmark][components][network]") {
+    constexpr auto RuleCount = 32;
+    constexpr auto HopCount = 30;
+
+    Nedrysoft::ComponentSystem::ComponentLoader componentLoader;
+
+    componentLoader.addComponents(PINGNOO_TEST_COMPONENTS_DIR);
+
+    componentLoader.loadComponents();
+
+    Nedrysoft::Core::IHostMasker *regExHostMasker = nullptr;
+
+    for (auto hostMasker : Nedrysoft::ComponentSystem::getObjects<Nedrysoft::Core::IHostMasker>()) {
+        if (QString::fromLatin1(hostMasker->metaObject()->className())=="Nedrysoft::RegExHostMasker::RegExHostMasker") {
+            regExHostMasker = hostMasker;
+            break;
+        }
+    }
+
+    REQUIRE_MESSAGE(regExHostMasker!=nullptr, "Unable to find Nedrysoft::RegExHostMasker::RegExHostMasker");
+
+    /**
+     * a rule set of a realistic size where only the last rule matches the hosts of the route.
+     */
+
+    auto configuration = QJsonObject();
+    auto matchItems = QJsonArray();
+
+    configuration["id"] = "Nedrysoft::RegExHostMasker::RegExHostMasker";
+
+    for (auto ruleIndex = 0; ruleIndex<RuleCount; ruleIndex++) {
+        auto matchItem = QJsonObject();
+
+        matchItem["matchExpression"] =
+                QString(R"(([0-9]{1,3})-([0-9]{1,3})-([0-9]{1,3})-([0-9]{1,3})\.(?<domain>isp%1\.example))").
+                        arg(ruleIndex);
+        matchItem["matchFlags"] = 20;
+        matchItem["hostReplacementString"] = "<hidden>.${domain}";
+
+        matchItems.append(matchItem);
+    }
+
+    configuration["matchItems"] = matchItems;
+
+    regExHostMasker->loadConfiguration(configuration);
+
+    auto hostNames = QStringList();
+
+    for (auto hop = 0; hop<HopCount; hop++) {
+        hostNames.append(QString("10-0-0-%1.isp%2.example").arg(hop).arg(RuleCount-1));
+    }
+
+    QString maskedHostName, maskedHostAddress;
+
+    REQUIRE(regExHostMasker->mask(1, hostNames[0], "10.0.0.0", maskedHostName, maskedHostAddress));
+    REQUIRE(maskedHostName==QString("<hidden>.isp%1.example").arg(RuleCount-1));
+
+    BENCHMARK("mask the hops of a route") {
+        auto maskedCount = 0;
+
+        for (auto hop = 0; hop<HopCount; hop++) {
+            maskedCount += regExHostMasker->mask(hop+1, hostNames[hop], "10.0.0.0", maskedHostName, maskedHostAddress);
+        }
+
+        return maskedCount;
+    };
+
+    auto uniqueIndex = 0;
+
+    BENCHMARK("mask a host that has not been seen") {
+        auto hostName = QString("10-0-%1-%2.isp%3.example").
+                arg((uniqueIndex/256)%256).
+                arg(uniqueIndex%256).
+                arg(RuleCount-1);
+
+        uniqueIndex++;
+
+        return regExHostMasker->mask(1, hostName, "10.0.0.0", maskedHostName, maskedHostAddress);
+    };
+}
+
+TEST_CASE("RegExHostMasker Rule Count Scaling", "[.][benchmark][components][network]") {
+    auto ruleCount = GENERATE(8, 32, 128);
+
+    Nedrysoft::ComponentSystem::ComponentLoader componentLoader;
+
+    componentLoader.addComponents(PINGNOO_TEST_COMPONENTS_DIR);
+
+    componentLoader.loadComponents();
+
+    Nedrysoft::Core::IHostMasker *regExHostMasker = nullptr;
+
+    for (auto hostMasker : Nedrysoft::ComponentSystem::getObjects<Nedrysoft::Core::IHostMasker>()) {
+        if (QString::fromLatin1(hostMasker->metaObject()->className())=="Nedrysoft::RegExHostMasker::RegExHostMasker") {
+            regExHostMasker = hostMasker;
+            break;
+        }
+    }
+
+    REQUIRE_MESSAGE(regExHostMasker!=nullptr, "Unable to find Nedrysoft::RegExHostMasker::RegExHostMasker");
+
+    /**
+     * the required literal of each rule sits inside a named group, if the prefilter finds it then the cost of
+     * masking an unseen host should stay flat as the number of rules grows.
+     */
+
+    auto configuration = QJsonObject();
+    auto matchItems = QJsonArray();
+
+    configuration["id"] = "Nedrysoft::RegExHostMasker::RegExHostMasker";
+
+    for (auto ruleIndex = 0; ruleIndex<ruleCount; ruleIndex++) {
+        auto matchItem = QJsonObject();
+
+        matchItem["matchExpression"] =
+                QString(R"(([0-9]{1,3})-([0-9]{1,3})-([0-9]{1,3})-([0-9]{1,3})\.(?<domain>isp%1\.example))").
+                        arg(ruleIndex);
+        matchItem["matchFlags"] = 20;
+        matchItem["hostReplacementString"] = "<hidden>.${domain}";
+
+        matchItems.append(matchItem);
+    }
+
+    configuration["matchItems"] = matchItems;
+
+    regExHostMasker->loadConfiguration(configuration);
+
+    QString maskedHostName, maskedHostAddress;
+
+    REQUIRE(regExHostMasker->mask(1, QString("10-0-0-1.isp%1.example").arg(ruleCount-1), "10.0.0.0",
+                                  maskedHostName, maskedHostAddress));
+
+    REQUIRE(maskedHostName==QString("<hidden>.isp%1.example").arg(ruleCount-1));
+
+    auto uniqueIndex = 0;
+
+    BENCHMARK(QString("mask a host that has not been seen with %1 rules").arg(ruleCount).toStdString()) {
+        auto hostName = QString("10-1-%1-%2.isp%3.example").
+                arg((uniqueIndex/256)%256).
+                arg(uniqueIndex%256).
+                arg(ruleCount-1);
+
+        uniqueIndex++;
+
+        return regExHostMasker->mask(1, hostName, "10.0.0.0", maskedHostName, maskedHostAddress);
+    };
 }
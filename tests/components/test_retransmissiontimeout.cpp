@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 19/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "catch.hpp"
+#include "RouteAnalyser/RetransmissionTimeout.h"
+
+TEST_CASE("RetransmissionTimeout Tests", "[app][components][network]") {
+    SECTION("check the initial timeout is used until a sample is added") {
+        Nedrysoft::RouteAnalyser::RetransmissionTimeout retransmissionTimeout(1.0, 0.05, 10.0);
+
+        REQUIRE(retransmissionTimeout.smoothedRoundTripTime()==Approx(-1));
+        REQUIRE(retransmissionTimeout.timeout()==Approx(1.0));
+
+        retransmissionTimeout.setInitialTimeout(2.0);
+
+        REQUIRE(retransmissionTimeout.timeout()==Approx(2.0));
+
+        /**
+         * a negative round trip time is not a measurement and is ignored.
+         */
+
+        retransmissionTimeout.addSample(-1);
+
+        REQUIRE(retransmissionTimeout.smoothedRoundTripTime()==Approx(-1));
+        REQUIRE(retransmissionTimeout.timeout()==Approx(2.0));
+    }
+
+    SECTION("check the first sample sets the smoothed round trip time and variation") {
+        Nedrysoft::RouteAnalyser::RetransmissionTimeout retransmissionTimeout(1.0, 0.05, 10.0);
+
+        retransmissionTimeout.addSample(0.1);
+
+        /**
+         * srtt = 0.1 and rttvar = 0.05, so the timeout is 0.1+4*0.05.
+         */
+
+        REQUIRE(retransmissionTimeout.smoothedRoundTripTime()==Approx(0.1));
+        REQUIRE(retransmissionTimeout.timeout()==Approx(0.3));
+
+        retransmissionTimeout.addSample(0.2);
+
+        /**
+         * rttvar = 0.75*0.05+0.25*0.1 and srtt = 0.875*0.1+0.125*0.2.
+         */
+
+        REQUIRE(retransmissionTimeout.smoothedRoundTripTime()==Approx(0.1125));
+        REQUIRE(retransmissionTimeout.timeout()==Approx(0.1125+4*0.0625));
+    }
+
+    SECTION("check the estimate converges on a steady round trip time") {
+        Nedrysoft::RouteAnalyser::RetransmissionTimeout retransmissionTimeout(1.0, 0.05, 10.0);
+
+        for (auto sample = 0; sample<200; sample++) {
+            retransmissionTimeout.addSample(0.1);
+        }
+
+        REQUIRE(retransmissionTimeout.smoothedRoundTripTime()==Approx(0.1).margin(1e-6));
+        REQUIRE(retransmissionTimeout.timeout()==Approx(0.1).margin(1e-6));
+
+        /**
+         * after a step change the estimate follows the new round trip time.
+         */
+
+        for (auto sample = 0; sample<100; sample++) {
+            retransmissionTimeout.addSample(0.2);
+        }
+
+        REQUIRE(retransmissionTimeout.smoothedRoundTripTime()==Approx(0.2).margin(1e-3));
+        REQUIRE(retransmissionTimeout.timeout()==Approx(0.2).margin(1e-3));
+    }
+
+    SECTION("check the timeout is clamped") {
+        Nedrysoft::RouteAnalyser::RetransmissionTimeout retransmissionTimeout(1.0, 0.05, 10.0);
+
+        for (auto sample = 0; sample<200; sample++) {
+            retransmissionTimeout.addSample(0.001);
+        }
+
+        REQUIRE(retransmissionTimeout.smoothedRoundTripTime()==Approx(0.001).margin(1e-6));
+        REQUIRE(retransmissionTimeout.timeout()==Approx(0.05));
+
+        retransmissionTimeout.addSample(20.0);
+
+        REQUIRE(retransmissionTimeout.timeout()==Approx(10.0));
+    }
+
+    SECTION("check losses back off the timeout until a reply is received") {
+        Nedrysoft::RouteAnalyser::RetransmissionTimeout retransmissionTimeout(1.0, 0.05, 10.0);
+
+        for (auto sample = 0; sample<200; sample++) {
+            retransmissionTimeout.addSample(0.1);
+        }
+
+        retransmissionTimeout.addLoss();
+
+        REQUIRE(retransmissionTimeout.timeout()==Approx(0.2).margin(1e-6));
+
+        retransmissionTimeout.addLoss();
+
+        REQUIRE(retransmissionTimeout.timeout()==Approx(0.4).margin(1e-6));
+
+        /**
+         * the backoff is limited to 64 times the estimate.
+         */
+
+        for (auto loss = 0; loss<10; loss++) {
+            retransmissionTimeout.addLoss();
+        }
+
+        REQUIRE(retransmissionTimeout.timeout()==Approx(6.4).margin(1e-4));
+
+        retransmissionTimeout.addSample(0.1);
+
+        REQUIRE(retransmissionTimeout.timeout()==Approx(0.1).margin(1e-6));
+    }
+}
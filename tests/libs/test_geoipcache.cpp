@@ -0,0 +1,242 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 19/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "catch.hpp"
+#include "GeoIPCache/GeoIPCache.h"
+#include "GeoIPCache/PrefixTrie.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QTemporaryDir>
+
+/**
+ * @brief       Looks up a host in memory and the database, waiting for the answer.
+ *
+ * @param[in]   cache the cache to search.
+ * @param[in]   host the host address string.
+ * @param[out]  result the cached result if the host was found.
+ *
+ * @returns     the status of the host in the cache.
+ */
+static auto waitForLookup(
+        Nedrysoft::GeoIPCache::GeoIPCache &cache,
+        const QString &host,
+        QVariantMap &result ) -> Nedrysoft::GeoIPCache::GeoIPCache::Status {
+
+    auto answered = false;
+    auto lookupStatus = Nedrysoft::GeoIPCache::GeoIPCache::Status::Miss;
+    QElapsedTimer timer;
+
+    cache.lookup(host, [&](Nedrysoft::GeoIPCache::GeoIPCache::Status status, const QVariantMap &lookupResult) {
+        lookupStatus = status;
+        result = lookupResult;
+        answered = true;
+    });
+
+    timer.start();
+
+    while ((!answered) && (timer.elapsed()<5000)) {
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+    }
+
+    REQUIRE_MESSAGE(answered, "The lookup was not answered.");
+
+    return lookupStatus;
+}
+
+TEST_CASE("GeoIPCache Tests", "[app][libs][network]") {
+    QTemporaryDir temporaryDir;
+
+    REQUIRE(temporaryDir.isValid());
+
+    auto filename = temporaryDir.filePath("geoip/cache.db");
+    auto result = QVariantMap();
+    auto location = QVariantMap();
+
+    location["country"] = "Testland";
+    location["city"] = "Testville";
+
+    SECTION("check results are held in memory") {
+        Nedrysoft::GeoIPCache::GeoIPCache cache(filename);
+
+        REQUIRE(cache.lookup("192.0.2.1", result)==Nedrysoft::GeoIPCache::GeoIPCache::Status::Miss);
+
+        cache.add("192.0.2.1", location, 60);
+        cache.addNegative("192.0.2.2", 60);
+
+        REQUIRE(cache.lookup("192.0.2.1", result)==Nedrysoft::GeoIPCache::GeoIPCache::Status::Hit);
+        REQUIRE(result["city"].toString()=="Testville");
+        REQUIRE(cache.lookup("192.0.2.2", result)==Nedrysoft::GeoIPCache::GeoIPCache::Status::NegativeHit);
+    }
+
+    SECTION("check the least recently used entry is evicted") {
+        Nedrysoft::GeoIPCache::GeoIPCache cache(filename, 2);
+
+        cache.add("192.0.2.1", location, 60);
+        cache.add("198.51.100.1", location, 60);
+
+        REQUIRE(cache.lookup("192.0.2.1", result)==Nedrysoft::GeoIPCache::GeoIPCache::Status::Hit);
+
+        cache.add("203.0.113.1", location, 60);
+
+        REQUIRE(cache.count()==2);
+        REQUIRE(cache.lookup("192.0.2.1", result)==Nedrysoft::GeoIPCache::GeoIPCache::Status::Hit);
+        REQUIRE(cache.lookup("198.51.100.1", result)==Nedrysoft::GeoIPCache::GeoIPCache::Status::Miss);
+        REQUIRE(cache.lookup("203.0.113.1", result)==Nedrysoft::GeoIPCache::GeoIPCache::Status::Hit);
+
+        /**
+         * an evicted entry is still found in the database.
+         */
+
+        REQUIRE(waitForLookup(cache, "198.51.100.1", result)==Nedrysoft::GeoIPCache::GeoIPCache::Status::Hit);
+        REQUIRE(result["country"].toString()=="Testland");
+    }
+
+    SECTION("check expired entries are not returned") {
+        Nedrysoft::GeoIPCache::GeoIPCache cache(filename);
+
+        cache.add("192.0.2.1", location, 0);
+        cache.addNegative("192.0.2.2", 0);
+
+        REQUIRE(cache.lookup("192.0.2.1", result)==Nedrysoft::GeoIPCache::GeoIPCache::Status::Miss);
+        REQUIRE(cache.lookup("192.0.2.2", result)==Nedrysoft::GeoIPCache::GeoIPCache::Status::Miss);
+        REQUIRE(waitForLookup(cache, "192.0.2.1", result)==Nedrysoft::GeoIPCache::GeoIPCache::Status::Miss);
+    }
+
+    SECTION("check entries persist between instances") {
+        {
+            Nedrysoft::GeoIPCache::GeoIPCache cache(filename);
+
+            cache.add("192.0.2.1", location, 60);
+            cache.addNegative("192.0.2.2", 60);
+        }
+
+        Nedrysoft::GeoIPCache::GeoIPCache cache(filename);
+
+        REQUIRE(cache.lookup("192.0.2.1", result)==Nedrysoft::GeoIPCache::GeoIPCache::Status::Miss);
+
+        REQUIRE(waitForLookup(cache, "192.0.2.1", result)==Nedrysoft::GeoIPCache::GeoIPCache::Status::Hit);
+        REQUIRE(result["city"].toString()=="Testville");
+        REQUIRE(waitForLookup(cache, "192.0.2.2", result)==Nedrysoft::GeoIPCache::GeoIPCache::Status::NegativeHit);
+        REQUIRE(waitForLookup(cache, "192.0.2.3", result)==Nedrysoft::GeoIPCache::GeoIPCache::Status::Hit);
+        REQUIRE(waitForLookup(cache, "198.51.100.3", result)==Nedrysoft::GeoIPCache::GeoIPCache::Status::Miss);
+
+        /**
+         * the entry read from the database is now held in memory.
+         */
+
+        REQUIRE(cache.lookup("192.0.2.1", result)==Nedrysoft::GeoIPCache::GeoIPCache::Status::Hit);
+    }
+
+    SECTION("check results are shared by the addresses of a network") {
+        Nedrysoft::GeoIPCache::GeoIPCache cache(filename);
+        auto otherLocation = QVariantMap();
+
+        otherLocation["city"] = "Otherville";
+
+        cache.add("192.0.2.1", location, 60);
+        cache.add("192.0.2.200", otherLocation, 60, 32);
+        cache.add("2001:db8:1::1", location, 60);
+
+        REQUIRE(cache.count()==3);
+
+        REQUIRE(cache.lookup("192.0.2.77", result)==Nedrysoft::GeoIPCache::GeoIPCache::Status::Hit);
+        REQUIRE(result["city"].toString()=="Testville");
+        REQUIRE(cache.lookup("192.0.2.200", result)==Nedrysoft::GeoIPCache::GeoIPCache::Status::Hit);
+        REQUIRE(result["city"].toString()=="Otherville");
+        REQUIRE(cache.lookup("192.0.3.1", result)==Nedrysoft::GeoIPCache::GeoIPCache::Status::Miss);
+
+        REQUIRE(cache.lookup("2001:db8:1:ffff::1", result)==Nedrysoft::GeoIPCache::GeoIPCache::Status::Hit);
+        REQUIRE(cache.lookup("2001:db8:2::1", result)==Nedrysoft::GeoIPCache::GeoIPCache::Status::Miss);
+
+        /**
+         * a negative entry only covers the address itself unless a prefix is given.
+         */
+
+        cache.addNegative("192.0.2.9", 60);
+
+        REQUIRE(cache.lookup("192.0.2.9", result)==Nedrysoft::GeoIPCache::GeoIPCache::Status::NegativeHit);
+        REQUIRE(cache.lookup("192.0.2.10", result)==Nedrysoft::GeoIPCache::GeoIPCache::Status::Hit);
+
+        cache.setDefaultPrefixLength(32, 128);
+
+        cache.add("203.0.113.1", location, 60);
+
+        REQUIRE(cache.lookup("203.0.113.1", result)==Nedrysoft::GeoIPCache::GeoIPCache::Status::Hit);
+        REQUIRE(cache.lookup("203.0.113.2", result)==Nedrysoft::GeoIPCache::GeoIPCache::Status::Miss);
+    }
+
+    SECTION("check the prefix trie") {
+        Nedrysoft::GeoIPCache::PrefixTrie<int> trie;
+        auto prefixLength = 0;
+
+        auto keyOf = [](const char *address) {
+            auto addressKey = Nedrysoft::GeoIPCache::PrefixKey();
+
+            Nedrysoft::GeoIPCache::PrefixKey::fromAddress(QHostAddress(address), addressKey);
+
+            return addressKey;
+        };
+
+        trie.insert(keyOf("2001:db8::"), 32, 1);
+        trie.insert(keyOf("2001:db8:1::"), 48, 2);
+        trie.insert(keyOf("2001:db8:1:2::"), 64, 3);
+        trie.insert(keyOf("192.0.2.0"), 96+24, 4);
+
+        REQUIRE(*trie.longestMatch(keyOf("2001:db8:1:2::1"), &prefixLength)==3);
+        REQUIRE(prefixLength==64);
+        REQUIRE(*trie.longestMatch(keyOf("2001:db8:1:3::1"), &prefixLength)==2);
+        REQUIRE(prefixLength==48);
+        REQUIRE(*trie.longestMatch(keyOf("2001:db8:ffff::1"))==1);
+        REQUIRE(*trie.longestMatch(keyOf("192.0.2.99"))==4);
+        REQUIRE(trie.longestMatch(keyOf("2001:db9::1"))==nullptr);
+        REQUIRE(trie.longestMatch(keyOf("192.0.3.1"))==nullptr);
+
+        REQUIRE(trie.remove(keyOf("2001:db8:1::"), 48));
+        REQUIRE(!trie.remove(keyOf("2001:db8:1::"), 48));
+        REQUIRE(trie.find(keyOf("2001:db8:1::"), 48)==nullptr);
+        REQUIRE(*trie.longestMatch(keyOf("2001:db8:1:3::1"))==1);
+        REQUIRE(*trie.longestMatch(keyOf("2001:db8:1:2::1"))==3);
+
+        trie.insert(keyOf("::"), 0, 5);
+
+        REQUIRE(*trie.longestMatch(keyOf("2001:db9::1"))==5);
+        REQUIRE(*trie.find(keyOf("192.0.2.1"), 96+24)==4);
+    }
+
+    SECTION("check private and reserved addresses") {
+        for (const auto &host : QStringList() <<
+                "10.1.2.3" << "172.20.0.1" << "192.168.1.1" << "127.0.0.1" << "169.254.1.1" <<
+                "100.64.0.1" << "224.0.0.1" << "255.255.255.255" << "0.0.0.0" << "::1" << "::" <<
+                "fd00::1" << "fe80::1" << "ff02::1" << "::ffff:192.168.1.1") {
+
+            REQUIRE_MESSAGE(Nedrysoft::GeoIPCache::GeoIPCache::isPrivateAddress(host), host.toStdString());
+        }
+
+        for (const auto &host : QStringList() <<
+                "8.8.8.8" << "172.32.0.1" << "192.0.2.1" << "2001:db8::1" << "2a00:1450::1" << "example.com") {
+
+            REQUIRE_MESSAGE(!Nedrysoft::GeoIPCache::GeoIPCache::isPrivateAddress(host), host.toStdString());
+        }
+    }
+}
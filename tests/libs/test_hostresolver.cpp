@@ -0,0 +1,257 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 19/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "catch.hpp"
+#include "HostResolver/HostResolver.h"
+
+#include <QAtomicInt>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QThread>
+#include <QTimer>
+
+/**
+ * @brief       A stub resolver backend which answers from a fixed table after a configurable delay.
+ */
+class StubResolverBackend :
+        public Nedrysoft::HostResolver::ResolverBackend {
+
+    public:
+        auto lookup(
+                const QString &host,
+                QAbstractSocket::NetworkLayerProtocol protocol,
+                Callback callback ) -> void override {
+
+            auto addresses = QList<QHostAddress>();
+
+            m_lookupCount.fetchAndAddOrdered(1);
+
+            if (host=="example.test") {
+                if (protocol==QAbstractSocket::IPv4Protocol) {
+                    addresses << QHostAddress("192.0.2.1");
+                } else {
+                    addresses << QHostAddress("2001:db8::1");
+                }
+            }
+
+            auto delay = (protocol==QAbstractSocket::IPv6Protocol) ? m_ipv6Delay : 0;
+
+            QTimer::singleShot(delay, [=]() {
+                callback(addresses, m_timeToLive);
+            });
+        }
+
+        auto reverseLookup(
+                const QHostAddress &hostAddress,
+                ReverseCallback callback ) -> void override {
+
+            auto hostName = QString();
+
+            m_reverseLookupCount.fetchAndAddOrdered(1);
+
+            if (hostAddress==QHostAddress("192.0.2.1")) {
+                hostName = "example.test";
+            }
+
+            QTimer::singleShot(m_reverseDelay, [=]() {
+                callback(hostName, m_timeToLive);
+            });
+        }
+
+        QAtomicInt m_lookupCount;
+        QAtomicInt m_reverseLookupCount;
+        int m_reverseDelay = 0;
+        int m_ipv6Delay = 0;
+        int m_timeToLive = 300;
+};
+
+TEST_CASE("HostResolver Tests", "[app][libs][network]") {
+    constexpr auto ResolveTimeout = 5000;
+
+    SECTION("check addresses are returned without a lookup") {
+        auto backend = new StubResolverBackend;
+        auto resolver = new Nedrysoft::HostResolver::HostResolver(backend);
+
+        auto addresses = resolver->resolve("192.0.2.10", QAbstractSocket::IPv4Protocol, ResolveTimeout);
+
+        REQUIRE_MESSAGE(addresses.count()==1, "Address was not returned.");
+        REQUIRE_MESSAGE(addresses.at(0)==QHostAddress("192.0.2.10"), "Address was changed.");
+        REQUIRE_MESSAGE(backend->m_lookupCount.loadAcquire()==0, "A lookup was made for an address.");
+
+        delete resolver;
+    }
+
+    SECTION("check answers are cached") {
+        auto backend = new StubResolverBackend;
+        auto resolver = new Nedrysoft::HostResolver::HostResolver(backend);
+
+        auto addresses = resolver->resolve("example.test", QAbstractSocket::IPv4Protocol, ResolveTimeout);
+
+        REQUIRE_MESSAGE(addresses.count()==1, "Host was not resolved.");
+        REQUIRE_MESSAGE(addresses.at(0)==QHostAddress("192.0.2.1"), "Host was resolved incorrectly.");
+
+        resolver->resolve("EXAMPLE.test", QAbstractSocket::IPv4Protocol, ResolveTimeout);
+        resolver->resolve("example.test", QAbstractSocket::IPv6Protocol, ResolveTimeout);
+
+        REQUIRE_MESSAGE(backend->m_lookupCount.loadAcquire()==2, "Cached answers were looked up again.");
+
+        delete resolver;
+    }
+
+    SECTION("check answers expire after their time to live") {
+        auto backend = new StubResolverBackend;
+        auto resolver = new Nedrysoft::HostResolver::HostResolver(backend);
+
+        backend->m_timeToLive = 1;
+
+        resolver->resolve("example.test", QAbstractSocket::IPv4Protocol, ResolveTimeout);
+
+        QThread::msleep(1100);
+
+        resolver->resolve("example.test", QAbstractSocket::IPv4Protocol, ResolveTimeout);
+
+        REQUIRE_MESSAGE(backend->m_lookupCount.loadAcquire()==4, "Expired answers were not looked up again.");
+
+        delete resolver;
+    }
+
+    SECTION("check names that do not exist are cached") {
+        auto backend = new StubResolverBackend;
+        auto resolver = new Nedrysoft::HostResolver::HostResolver(backend);
+
+        auto addresses = resolver->resolve("missing.test", QAbstractSocket::IPv4Protocol, ResolveTimeout);
+
+        REQUIRE_MESSAGE(addresses.isEmpty(), "A name that does not exist was resolved.");
+
+        resolver->resolve("missing.test", QAbstractSocket::IPv4Protocol, ResolveTimeout);
+
+        REQUIRE_MESSAGE(backend->m_lookupCount.loadAcquire()==2, "A negative answer was not cached.");
+
+        resolver->setNegativeTimeToLive(0);
+        resolver->clear();
+
+        resolver->resolve("missing.test", QAbstractSocket::IPv4Protocol, ResolveTimeout);
+        resolver->resolve("missing.test", QAbstractSocket::IPv4Protocol, ResolveTimeout);
+
+        REQUIRE_MESSAGE(backend->m_lookupCount.loadAcquire()>=5, "A negative answer outlived its time to live.");
+
+        delete resolver;
+    }
+
+    SECTION("check the first answer is returned without waiting for the other") {
+        auto backend = new StubResolverBackend;
+        auto resolver = new Nedrysoft::HostResolver::HostResolver(backend);
+
+        backend->m_ipv6Delay = 2000;
+
+        QElapsedTimer resolveTimer;
+
+        resolveTimer.start();
+
+        auto addresses = resolver->resolve("example.test", QAbstractSocket::IPv4Protocol, ResolveTimeout);
+
+        REQUIRE_MESSAGE(addresses.count()==1, "Host was not resolved.");
+        REQUIRE_MESSAGE(resolveTimer.elapsed()<1000, "The IPv4 answer waited for the IPv6 answer.");
+
+        addresses = resolver->resolve("example.test", QAbstractSocket::IPv6Protocol, ResolveTimeout);
+
+        REQUIRE_MESSAGE(addresses.count()==1, "The IPv6 answer was not delivered.");
+        REQUIRE_MESSAGE(backend->m_lookupCount.loadAcquire()==2, "The IPv6 lookup was not shared.");
+
+        delete resolver;
+    }
+
+    SECTION("check host names are looked up asynchronously and cached") {
+        auto backend = new StubResolverBackend;
+        auto resolver = new Nedrysoft::HostResolver::HostResolver(backend);
+        auto hostName = QString();
+        auto callbackCount = 0;
+        QObject context;
+
+        backend->m_reverseDelay = 100;
+
+        resolver->lookupHostName(QHostAddress("192.0.2.1"), &context, [&](const QString &name) {
+            hostName = name;
+            callbackCount++;
+        });
+
+        REQUIRE_MESSAGE(callbackCount==0, "The lookup blocked the caller.");
+
+        QElapsedTimer waitTimer;
+
+        waitTimer.start();
+
+        while ((callbackCount==0) && (waitTimer.elapsed()<ResolveTimeout)) {
+            QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+        }
+
+        REQUIRE_MESSAGE(hostName==QString("example.test"), "Host name was not delivered.");
+
+        resolver->lookupHostName(QHostAddress("192.0.2.1"), &context, [&](const QString &name) {
+            hostName = name;
+            callbackCount++;
+        });
+
+        REQUIRE_MESSAGE(callbackCount==2, "A cached host name was not delivered immediately.");
+        REQUIRE_MESSAGE(backend->m_reverseLookupCount.loadAcquire()==1, "A cached host name was looked up again.");
+        REQUIRE_MESSAGE(resolver->reverseLookupHits()==1, "The cache hit was not counted.");
+        REQUIRE_MESSAGE(resolver->reverseLookupMisses()==1, "The cache miss was not counted.");
+
+        delete resolver;
+    }
+
+    SECTION("check reverse lookups are limited") {
+        constexpr auto AddressCount = 16;
+
+        auto backend = new StubResolverBackend;
+        auto resolver = new Nedrysoft::HostResolver::HostResolver(backend);
+        auto callbackCount = 0;
+        QObject context;
+
+        backend->m_reverseDelay = 200;
+
+        resolver->setMaximumReverseLookups(4);
+
+        for (int addressIndex=0;addressIndex<AddressCount;addressIndex++) {
+            resolver->lookupHostName(QHostAddress(QString("198.51.100.%1").arg(addressIndex)), &context, [&](const QString &) {
+                callbackCount++;
+            });
+        }
+
+        QThread::msleep(100);
+
+        REQUIRE_MESSAGE(backend->m_reverseLookupCount.loadAcquire()==4, "Too many reverse lookups were started.");
+
+        QElapsedTimer waitTimer;
+
+        waitTimer.start();
+
+        while ((callbackCount<AddressCount) && (waitTimer.elapsed()<ResolveTimeout)) {
+            QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+        }
+
+        REQUIRE_MESSAGE(callbackCount==AddressCount, "Queued reverse lookups were not completed.");
+
+        delete resolver;
+    }
+}
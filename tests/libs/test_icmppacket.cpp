@@ -35,4 +35,49 @@ TEST_CASE("ICMPPacket Tests", "[app][libs][network]") {
 
         REQUIRE_MESSAGE(checksum==0x38D1, "ICMP checksum was calculated incorrectly.");
     }
+
+    SECTION("flow stable packets keep the same checksum for an id") {
+        auto firstPacket = Nedrysoft::ICMPPacket::ICMPPacket::pingPacket(
+            0x1234,
+            1,
+            52,
+            QHostAddress("127.0.0.1"),
+            Nedrysoft::ICMPPacket::V4,
+            true
+        );
+
+        auto secondPacket = Nedrysoft::ICMPPacket::ICMPPacket::pingPacket(
+            0x1234,
+            0xBEEF,
+            52,
+            QHostAddress("127.0.0.1"),
+            Nedrysoft::ICMPPacket::V4,
+            true
+        );
+
+        REQUIRE_MESSAGE(firstPacket.mid(2, 2)==secondPacket.mid(2, 2), "ICMP checksum changed with the sequence.");
+    }
+
+    SECTION("destination unreachable is matched to the quoted request") {
+        auto ipHeader = QByteArray(20, 0);
+
+        ipHeader[0] = 0x45;
+
+        auto unreachablePacket = ipHeader;
+
+        // type 3 (destination unreachable), code 1 (host unreachable), checksum and unused fields.
+
+        unreachablePacket.append(QByteArray::fromHex("0301000000000000"));
+
+        // the quoted ip header and the first 8 bytes of the original echo request (id 0x1234, sequence 0x0042).
+
+        unreachablePacket.append(ipHeader);
+        unreachablePacket.append(QByteArray::fromHex("0800000012340042"));
+
+        auto packet = Nedrysoft::ICMPPacket::ICMPPacket::fromData(unreachablePacket, Nedrysoft::ICMPPacket::V4);
+
+        REQUIRE(packet.resultCode()==Nedrysoft::ICMPPacket::DestinationUnreachable);
+        REQUIRE(packet.id()==0x1234);
+        REQUIRE(packet.sequence()==0x0042);
+    }
 }
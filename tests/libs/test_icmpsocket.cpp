@@ -22,6 +22,7 @@
  */
 
 #include "catch.hpp"
+#include "ICMPPacket/ICMPPacket.h"
 #include "ICMPSocket/ICMPSocket.h"
 
 #include <QString>
@@ -42,3 +43,104 @@ TEST_CASE("ICMPSocket Tests", "[app][libs][network]") {
         REQUIRE_MESSAGE(writeSocket!=nullptr, "Unable to create a IPv4 ICMP write socket.");
     }
 }
+
+/**
+ * @brief       Sends a round of echo requests to the loopback address and collects the packets that come back.
+ *
+ * @param[in]   readSocket the socket to receive on.
+ * @param[in]   writeSocket the socket to send on.
+ * @param[in]   packetCount the number of echo requests to send.
+ * @param[in]   batched true if the packets are queued and flushed together; otherwise they are sent individually.
+ *
+ * @returns     the number of packets received.
+ */
+static auto loopbackRound(
+        Nedrysoft::ICMPSocket::ICMPSocket *readSocket,
+        Nedrysoft::ICMPSocket::ICMPSocket *writeSocket,
+        int packetCount,
+        bool batched ) -> int {
+
+    constexpr auto ReceiveTimeout = 100;
+
+    auto loopbackAddress = QHostAddress(QHostAddress::LocalHost);
+
+    for (auto sequenceId = 0; sequenceId < packetCount; sequenceId++) {
+        auto buffer = Nedrysoft::ICMPPacket::ICMPPacket::pingPacket(
+            0x1234,
+            static_cast<uint16_t>(sequenceId),
+            52,
+            loopbackAddress,
+            Nedrysoft::ICMPPacket::V4
+        );
+
+        if (batched) {
+            writeSocket->queueSendto(buffer, loopbackAddress);
+        } else {
+            writeSocket->sendto(buffer, loopbackAddress);
+        }
+    }
+
+    if (batched) {
+        Nedrysoft::ICMPSocket::ICMPSocket::flush();
+    }
+
+    /**
+     * a raw socket on the loopback interface sees both the requests and the replies.
+     */
+
+    auto receivedCount = 0;
+    QByteArray receiveBuffer;
+    QHostAddress receiveAddress;
+
+    while (receivedCount < packetCount*2) {
+        if (readSocket->recvfrom(receiveBuffer, receiveAddress, ReceiveTimeout) < 0) {
+            break;
+        }
+
+        receivedCount++;
+    }
+
+    return receivedCount;
+}
+
+TEST_CASE("ICMPSocket Throughput", "[.][benchmark][libs][network]") {
+    constexpr auto PacketsPerRound = 256;
+
+    SECTION("poll backend") {
+        Nedrysoft::ICMPSocket::ICMPSocket::setPreferredBackend(Nedrysoft::ICMPSocket::ICMPSocket::Backend::Poll);
+
+        auto readSocket = Nedrysoft::ICMPSocket::ICMPSocket::createReadSocket(Nedrysoft::ICMPSocket::V4);
+        auto writeSocket = Nedrysoft::ICMPSocket::ICMPSocket::createWriteSocket(64, Nedrysoft::ICMPSocket::V4);
+
+        REQUIRE_MESSAGE((readSocket!=nullptr) && (writeSocket!=nullptr), "Unable to create IPv4 ICMP sockets.");
+
+        BENCHMARK("poll round of 256 packets") {
+            return loopbackRound(readSocket, writeSocket, PacketsPerRound, false);
+        };
+
+        delete readSocket;
+        delete writeSocket;
+    }
+
+    SECTION("io_uring backend") {
+        if (!Nedrysoft::ICMPSocket::ICMPSocket::isIoUringAvailable()) {
+            WARN("io_uring is not available, skipping.");
+
+            return;
+        }
+
+        Nedrysoft::ICMPSocket::ICMPSocket::setPreferredBackend(Nedrysoft::ICMPSocket::ICMPSocket::Backend::IoUring);
+
+        auto readSocket = Nedrysoft::ICMPSocket::ICMPSocket::createReadSocket(Nedrysoft::ICMPSocket::V4);
+        auto writeSocket = Nedrysoft::ICMPSocket::ICMPSocket::createWriteSocket(64, Nedrysoft::ICMPSocket::V4);
+
+        REQUIRE_MESSAGE((readSocket!=nullptr) && (writeSocket!=nullptr), "Unable to create IPv4 ICMP sockets.");
+
+        BENCHMARK("io_uring round of 256 packets") {
+            return loopbackRound(readSocket, writeSocket, PacketsPerRound, true);
+        };
+
+        delete readSocket;
+        delete writeSocket;
+    }
+}
@@ -0,0 +1,215 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 19/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "catch.hpp"
+#include "IP2ASNDatabase/IP2ASNDatabase.h"
+
+#include <QFile>
+#include <QHostAddress>
+#include <QTemporaryDir>
+
+/**
+ * @brief       Writes a table to a file.
+ *
+ * @param[in]   filename the filename of the table.
+ * @param[in]   content the content of the table.
+ *
+ * @returns     true if the table was written; otherwise false.
+ */
+static auto writeTable(const QString &filename, const QByteArray &content) -> bool {
+    QFile file(filename);
+
+    if (!file.open(QFile::WriteOnly)) {
+        return false;
+    }
+
+    return file.write(content)==content.size();
+}
+
+TEST_CASE("IP2ASNDatabase Tests", "[app][libs][network]") {
+    Nedrysoft::IP2ASNDatabase::IP2ASNDatabase database;
+    Nedrysoft::IP2ASNDatabase::IP2ASNDatabase::Record record;
+
+    SECTION("check the table is loaded") {
+        REQUIRE(database.load(":/test_ip2asndatabase.tsv"));
+
+        /**
+         * the ranges that are not routed are left out.
+         */
+
+        REQUIRE(database.count()==9);
+
+        /**
+         * loading a table replaces the ranges that were loaded before.
+         */
+
+        REQUIRE(database.load(":/test_ip2asndatabase.tsv"));
+        REQUIRE(database.count()==9);
+
+        database.clear();
+
+        REQUIRE(database.count()==0);
+        REQUIRE(!database.load("does-not-exist.tsv"));
+    }
+
+    SECTION("check IPv4 lookups") {
+        REQUIRE(database.load(":/test_ip2asndatabase.tsv"));
+
+        REQUIRE(database.find(QHostAddress("1.0.0.1"), record));
+        REQUIRE(record.m_asn==13335);
+        REQUIRE(record.m_countryCode=="US");
+        REQUIRE(record.m_description=="CLOUDFLARENET");
+
+        REQUIRE(database.find(QHostAddress("1.0.7.255"), record));
+        REQUIRE(record.m_asn==38803);
+        REQUIRE(record.m_description=="WPL-AS-AP Wirefreebroadband Pty Ltd");
+
+        REQUIRE(database.find(QHostAddress("198.51.100.127"), record));
+        REQUIRE(record.m_asn==64497);
+        REQUIRE(database.find(QHostAddress("198.51.100.128"), record));
+        REQUIRE(record.m_asn==64496);
+        REQUIRE(database.find(QHostAddress("::ffff:8.8.8.8"), record));
+        REQUIRE(record.m_asn==15169);
+
+        REQUIRE(!database.find(QHostAddress("0.0.0.1"), record));
+        REQUIRE(!database.find(QHostAddress("1.0.2.1"), record));
+        REQUIRE(!database.find(QHostAddress("8.8.9.0"), record));
+        REQUIRE(!database.find(QHostAddress("255.255.255.255"), record));
+    }
+
+    SECTION("check IPv6 lookups") {
+        REQUIRE(database.load(":/test_ip2asndatabase.tsv"));
+
+        REQUIRE(database.find(QHostAddress("2001:4860:4860::8888"), record));
+        REQUIRE(record.m_asn==15169);
+        REQUIRE(record.m_description=="GOOGLE");
+
+        REQUIRE(database.find(QHostAddress("2001:db8::"), record));
+        REQUIRE(record.m_asn==64498);
+        REQUIRE(database.find(QHostAddress("2001:db8:ffff:ffff:ffff:ffff:ffff:ffff"), record));
+        REQUIRE(record.m_asn==64498);
+
+        REQUIRE(!database.find(QHostAddress("::1"), record));
+        REQUIRE(!database.find(QHostAddress("2001:db9::"), record));
+        REQUIRE(!database.find(QHostAddress("ffff::1"), record));
+    }
+
+    SECTION("check unordered, integer and damaged lines") {
+        QTemporaryDir temporaryDir;
+
+        REQUIRE(temporaryDir.isValid());
+
+        auto filename = temporaryDir.filePath("ip2asn.tsv");
+
+        REQUIRE(writeTable(
+            filename,
+            "203.0.113.0\t203.0.113.255\t64500\tZZ\tEXAMPLE-NET-5\r\n"
+            "3221225984\t3221226239\t64499\tZZ\tEXAMPLE-NET-4\r\n"
+            "\n"
+            "not a range\n"
+            "192.0.2.0\t192.0.2.255\n"
+            "198.51.100.255\t198.51.100.0\t64501\tZZ\tBACKWARDS\n"
+            "198.51.100.0\t198.51.100.256\t64501\tZZ\tOUT-OF-RANGE\n"
+            "2001:db8::\t2001:db8::ffff\tAS64502\tZZ\tNOT-A-NUMBER\n"
+            "2001:db8::\t2001:db8::ffff\t64503\tZZ\tEXAMPLE-NET-6"
+        ));
+
+        REQUIRE(database.load(filename));
+        REQUIRE(database.count()==3);
+
+        REQUIRE(database.find(QHostAddress("192.0.2.1"), record));
+        REQUIRE(record.m_asn==64499);
+        REQUIRE(record.m_description=="EXAMPLE-NET-4");
+
+        REQUIRE(database.find(QHostAddress("203.0.113.255"), record));
+        REQUIRE(record.m_asn==64500);
+        REQUIRE(record.m_description=="EXAMPLE-NET-5");
+
+        REQUIRE(database.find(QHostAddress("2001:db8::1"), record));
+        REQUIRE(record.m_asn==64503);
+
+        REQUIRE(!database.find(QHostAddress("198.51.100.1"), record));
+
+        /**
+         * a table without a single usable range is not a successful load.
+         */
+
+        REQUIRE(writeTable(filename, "not a range\n192.0.2.0\t192.0.2.255\n"));
+
+        REQUIRE(!database.load(filename));
+        REQUIRE(database.count()==0);
+    }
+}
+
+TEST_CASE("IP2ASNDatabase Load Time", "[.][benchmark][libs][network]") {
+    constexpr auto IPv4RangeCount = 500000;
+    constexpr auto IPv6RangeCount = 100000;
+    constexpr auto RangesPerAS = 8;
+
+    QTemporaryDir temporaryDir;
+
+    REQUIRE(temporaryDir.isValid());
+
+    /**
+     * a table of about the size of the published combined table.
+     */
+
+    auto filename = temporaryDir.filePath("ip2asn-combined.tsv");
+    auto content = QByteArray();
+
+    for (auto index = 0; index<IPv4RangeCount; index++) {
+        auto network = QHostAddress(static_cast<quint32>(0x01000000+(index*256)));
+        auto asn = QByteArray::number(64512+(index/RangesPerAS));
+
+        content += network.toString().toLatin1()+"\t"+
+                   QHostAddress(network.toIPv4Address()+255).toString().toLatin1()+"\t"+
+                   asn+"\tZZ\tEXAMPLE-AS-"+asn+"\n";
+    }
+
+    for (auto index = 0; index<IPv6RangeCount; index++) {
+        auto network = QString("2001:%1:%2").arg(index>>16, 0, 16).arg(index&0xffff, 0, 16).toLatin1();
+        auto asn = QByteArray::number(64512+(index/RangesPerAS));
+
+        content += network+"::\t"+network+":ffff:ffff:ffff:ffff:ffff\t"+asn+"\tZZ\tEXAMPLE-AS-"+asn+"\n";
+    }
+
+    REQUIRE(writeTable(filename, content));
+
+    BENCHMARK("load a full size table") {
+        Nedrysoft::IP2ASNDatabase::IP2ASNDatabase database;
+
+        database.load(filename);
+
+        return database.count();
+    };
+
+    Nedrysoft::IP2ASNDatabase::IP2ASNDatabase database;
+    Nedrysoft::IP2ASNDatabase::IP2ASNDatabase::Record record;
+
+    REQUIRE(database.load(filename));
+    REQUIRE(database.count()==IPv4RangeCount+IPv6RangeCount);
+
+    BENCHMARK("look up an address") {
+        return database.find(QHostAddress("5.0.0.1"), record);
+    };
+}
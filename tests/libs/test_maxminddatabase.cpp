@@ -0,0 +1,430 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 19/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "catch.hpp"
+#include "MaxMindDatabase/MaxMindDatabase.h"
+
+#include <QFile>
+#include <QList>
+#include <QMap>
+#include <QPair>
+#include <QStringList>
+#include <QTemporaryDir>
+#include <QVector>
+#include <cstdlib>
+#include <cstring>
+
+/**
+ * @brief       Writes small MaxMind format databases for the tests.
+ *
+ * @details     Networks must not overlap.  Map keys are written once and referred to by pointers, as they are in
+ *              real databases, so that pointer handling is exercised.
+ */
+class TestDatabaseWriter {
+    public:
+        TestDatabaseWriter(int ipVersion, int recordSize) :
+                m_ipVersion(ipVersion),
+                m_recordSize(recordSize) {
+
+            m_nodes.append(Node());
+        }
+
+        static auto control(int type, quint32 size) -> QByteArray {
+            auto bytes = QByteArray();
+            auto sizeBits = size;
+            auto sizeBytes = QByteArray();
+
+            if (size>=65821) {
+                sizeBits = 31;
+                size -= 65821;
+                sizeBytes.append(static_cast<char>(size>>16)).
+                          append(static_cast<char>(size>>8)).
+                          append(static_cast<char>(size));
+            } else if (size>=285) {
+                sizeBits = 30;
+                size -= 285;
+                sizeBytes.append(static_cast<char>(size>>8)).append(static_cast<char>(size));
+            } else if (size>=29) {
+                sizeBits = 29;
+                sizeBytes.append(static_cast<char>(size-29));
+            }
+
+            if (type>7) {
+                bytes.append(static_cast<char>(sizeBits));
+                bytes.append(static_cast<char>(type-7));
+            } else {
+                bytes.append(static_cast<char>((type<<5) | sizeBits));
+            }
+
+            return bytes.append(sizeBytes);
+        }
+
+        static auto string(const QByteArray &value) -> QByteArray {
+            return control(2, value.length()).append(value);
+        }
+
+        static auto unsignedInteger(int type, quint64 value) -> QByteArray {
+            auto bytes = QByteArray();
+
+            while (value) {
+                bytes = QByteArray(1, static_cast<char>(value & 0xFF)).append(bytes);
+                value >>= 8;
+            }
+
+            return control(type, bytes.length()).append(bytes);
+        }
+
+        static auto number(double value) -> QByteArray {
+            auto bits = quint64(0);
+            auto bytes = control(3, 8);
+
+            memcpy(&bits, &value, sizeof(bits));
+
+            for (auto shift = 56; shift>=0; shift -= 8) {
+                bytes.append(static_cast<char>(bits>>shift));
+            }
+
+            return bytes;
+        }
+
+        static auto pointer(quint32 offset) -> QByteArray {
+            if (offset<2048) {
+                return QByteArray().append(static_cast<char>(0x20 | (offset>>8))).append(static_cast<char>(offset));
+            }
+
+            offset -= 2048;
+
+            return QByteArray().append(static_cast<char>(0x28 | (offset>>16))).
+                    append(static_cast<char>(offset>>8)).
+                    append(static_cast<char>(offset));
+        }
+
+        static auto map(const QList<QPair<QByteArray, QByteArray> > &pairs) -> QByteArray {
+            auto bytes = control(7, pairs.count());
+
+            for (const auto &pair : pairs) {
+                bytes.append(pair.first).append(pair.second);
+            }
+
+            return bytes;
+        }
+
+        static auto array(const QList<QByteArray> &values) -> QByteArray {
+            auto bytes = control(11, values.count());
+
+            for (const auto &value : values) {
+                bytes.append(value);
+            }
+
+            return bytes;
+        }
+
+        /**
+         * a key is written into the data section the first time it is used and is a pointer after that.
+         */
+        auto key(const QByteArray &name) -> QByteArray {
+            if (!m_keys.contains(name)) {
+                m_keys[name] = static_cast<quint32>(m_data.length());
+                m_data.append(string(name));
+            }
+
+            return pointer(m_keys[name]);
+        }
+
+        auto insert(const QString &network, const QByteArray &value) -> void {
+            auto subnet = QHostAddress::parseSubnet(network);
+            auto addressBytes = QByteArray(16, 0);
+            auto prefixLength = subnet.second;
+
+            if (subnet.first.protocol()==QAbstractSocket::IPv4Protocol) {
+                auto ipv4Address = subnet.first.toIPv4Address();
+                auto offset = (m_ipVersion==6) ? 12 : 0;
+
+                for (auto index = 0; index<4; index++) {
+                    addressBytes[offset+index] = static_cast<char>(ipv4Address>>(24-index*8));
+                }
+
+                if (m_ipVersion==6) {
+                    prefixLength += 96;
+                }
+            } else {
+                auto ipv6Address = subnet.first.toIPv6Address();
+
+                for (auto index = 0; index<16; index++) {
+                    addressBytes[index] = static_cast<char>(ipv6Address[index]);
+                }
+            }
+
+            auto dataOffset = static_cast<int>(m_data.length());
+            auto node = 0;
+
+            m_data.append(value);
+
+            for (auto bit = 0; bit<prefixLength; bit++) {
+                auto side = (static_cast<uchar>(addressBytes[bit>>3])>>(7-(bit&7))) & 1;
+
+                if (bit==prefixLength-1) {
+                    m_nodes[node].m_records[side] = -2-dataOffset;
+                } else {
+                    if (m_nodes[node].m_records[side]==-1) {
+                        m_nodes[node].m_records[side] = m_nodes.count();
+                        m_nodes.append(Node());
+                    }
+
+                    node = m_nodes[node].m_records[side];
+                }
+            }
+        }
+
+        auto write(const QString &filename) -> bool {
+            auto nodeCount = static_cast<quint32>(m_nodes.count());
+            auto bytes = QByteArray();
+
+            for (const auto &node : m_nodes) {
+                quint32 records[2];
+
+                for (auto side = 0; side<2; side++) {
+                    auto record = node.m_records[side];
+
+                    if (record==-1) {
+                        records[side] = nodeCount;
+                    } else if (record<-1) {
+                        records[side] = nodeCount+16+static_cast<quint32>(-2-record);
+                    } else {
+                        records[side] = static_cast<quint32>(record);
+                    }
+                }
+
+                if (m_recordSize==24) {
+                    for (auto side = 0; side<2; side++) {
+                        bytes.append(static_cast<char>(records[side]>>16)).
+                              append(static_cast<char>(records[side]>>8)).
+                              append(static_cast<char>(records[side]));
+                    }
+                } else if (m_recordSize==28) {
+                    bytes.append(static_cast<char>(records[0]>>16)).
+                          append(static_cast<char>(records[0]>>8)).
+                          append(static_cast<char>(records[0])).
+                          append(static_cast<char>(((records[0]>>20) & 0xF0) | ((records[1]>>24) & 0x0F))).
+                          append(static_cast<char>(records[1]>>16)).
+                          append(static_cast<char>(records[1]>>8)).
+                          append(static_cast<char>(records[1]));
+                } else {
+                    for (auto side = 0; side<2; side++) {
+                        for (auto shift = 24; shift>=0; shift -= 8) {
+                            bytes.append(static_cast<char>(records[side]>>shift));
+                        }
+                    }
+                }
+            }
+
+            bytes.append(QByteArray(16, 0));
+            bytes.append(m_data);
+            bytes.append(QByteArray("\xAB\xCD\xEF" "MaxMind.com"));
+            bytes.append(map(QList<QPair<QByteArray, QByteArray> >() <<
+                qMakePair(string("node_count"), unsignedInteger(6, nodeCount)) <<
+                qMakePair(string("record_size"), unsignedInteger(5, m_recordSize)) <<
+                qMakePair(string("ip_version"), unsignedInteger(5, m_ipVersion)) <<
+                qMakePair(string("database_type"), string("Pingnoo-Test")) <<
+                qMakePair(string("binary_format_major_version"), unsignedInteger(5, 2)) <<
+                qMakePair(string("binary_format_minor_version"), unsignedInteger(5, 0)) <<
+                qMakePair(string("build_epoch"), unsignedInteger(9, 1600000000)) <<
+                qMakePair(string("languages"), array(QList<QByteArray>() << string("en")))
+            ));
+
+            QFile file(filename);
+
+            if (!file.open(QFile::WriteOnly)) {
+                return false;
+            }
+
+            return file.write(bytes)==bytes.length();
+        }
+
+    private:
+        struct Node {
+            int m_records[2] = {-1, -1};
+        };
+
+        int m_ipVersion;
+        int m_recordSize;
+        QVector<Node> m_nodes;
+        QByteArray m_data;
+        QMap<QByteArray, quint32> m_keys;
+};
+
+/**
+ * @brief       Creates a city record with the fields that the geo ip provider reads.
+ *
+ * @param[in]   writer the writer that the record is for.
+ * @param[in]   countryCode the iso code of the country.
+ * @param[in]   country the name of the country.
+ * @param[in]   city the name of the city.
+ * @param[in]   latitude the latitude of the city.
+ * @param[in]   longitude the longitude of the city.
+ *
+ * @returns     the encoded record.
+ */
+static auto cityRecord(
+        TestDatabaseWriter &writer,
+        const QByteArray &countryCode,
+        const QByteArray &country,
+        const QByteArray &city,
+        double latitude,
+        double longitude ) -> QByteArray {
+
+    typedef QList<QPair<QByteArray, QByteArray> > Pairs;
+
+    auto names = [&writer](const QByteArray &name) {
+        return TestDatabaseWriter::map(Pairs() << qMakePair(writer.key("en"), TestDatabaseWriter::string(name)));
+    };
+
+    return TestDatabaseWriter::map(Pairs() <<
+        qMakePair(writer.key("city"), TestDatabaseWriter::map(Pairs() <<
+            qMakePair(writer.key("names"), names(city)))) <<
+        qMakePair(writer.key("country"), TestDatabaseWriter::map(Pairs() <<
+            qMakePair(writer.key("iso_code"), TestDatabaseWriter::string(countryCode)) <<
+            qMakePair(writer.key("names"), names(country)))) <<
+        qMakePair(writer.key("location"), TestDatabaseWriter::map(Pairs() <<
+            qMakePair(writer.key("latitude"), TestDatabaseWriter::number(latitude)) <<
+            qMakePair(writer.key("longitude"), TestDatabaseWriter::number(longitude)))) <<
+        qMakePair(writer.key("subdivisions"), TestDatabaseWriter::array(QList<QByteArray>() <<
+            TestDatabaseWriter::map(Pairs() << qMakePair(writer.key("iso_code"), TestDatabaseWriter::string("ENG"))))) <<
+        qMakePair(writer.key("autonomous_system_number"), TestDatabaseWriter::unsignedInteger(6, 64496))
+    );
+}
+
+TEST_CASE("MaxMindDatabase Tests", "[app][libs][network]") {
+    QTemporaryDir temporaryDir;
+
+    REQUIRE(temporaryDir.isValid());
+
+    auto filename = temporaryDir.filePath("test.mmdb");
+    auto ipVersion = GENERATE(4, 6);
+    auto recordSize = GENERATE(24, 28, 32);
+
+    TestDatabaseWriter writer(ipVersion, recordSize);
+
+    writer.insert("81.2.69.0/24", cityRecord(writer, "GB", "United Kingdom", "London", 51.5, -0.125));
+    writer.insert("192.0.2.128/25", cityRecord(writer, "XA", "Testland", "Testville", 1.0, 2.0));
+
+    if (ipVersion==6) {
+        writer.insert("2001:db8:1::/48", cityRecord(writer, "DE", "Germany", "Berlin", 52.5, 13.4));
+    }
+
+    REQUIRE(writer.write(filename));
+
+    Nedrysoft::MaxMindDatabase::MaxMindDatabase database;
+    Nedrysoft::MaxMindDatabase::MaxMindDatabase::Entry entry;
+
+    REQUIRE_MESSAGE(database.open(filename), "Unable to open the test database.");
+
+    SECTION("check the metadata") {
+        REQUIRE(database.databaseType()=="Pingnoo-Test");
+        REQUIRE(database.metadata()["ip_version"].toInt()==ipVersion);
+        REQUIRE(database.metadata()["record_size"].toInt()==recordSize);
+        REQUIRE(database.metadata()["languages"].toList().count()==1);
+    }
+
+    SECTION("check IPv4 lookups") {
+        REQUIRE(database.find(QHostAddress("81.2.69.160"), entry));
+        REQUIRE(entry.m_prefixLength==24);
+
+        REQUIRE(database.value(entry, {"city", "names", "en"}).toString()=="London");
+        REQUIRE(database.value(entry, {"country", "iso_code"}).toString()=="GB");
+        REQUIRE(database.value(entry, {"location", "longitude"}).toDouble()==-0.125);
+        REQUIRE(database.value(entry, {"subdivisions", "0", "iso_code"}).toString()=="ENG");
+        REQUIRE(database.value(entry, {"autonomous_system_number"}).toUInt()==64496);
+
+        REQUIRE(!database.value(entry, {"subdivisions", "1", "iso_code"}).isValid());
+        REQUIRE(!database.value(entry, {"city", "names", "de"}).isValid());
+
+        auto record = database.decode(entry).toMap();
+
+        REQUIRE(record["country"].toMap()["names"].toMap()["en"].toString()=="United Kingdom");
+
+        REQUIRE(database.find(QHostAddress("192.0.2.200"), entry));
+        REQUIRE(database.value(entry, {"city", "names", "en"}).toString()=="Testville");
+
+        REQUIRE(!database.find(QHostAddress("192.0.2.1"), entry));
+        REQUIRE(!database.find(QHostAddress("8.8.8.8"), entry));
+    }
+
+    SECTION("check IPv6 lookups") {
+        if (ipVersion==6) {
+            REQUIRE(database.find(QHostAddress("2001:db8:1:2::1"), entry));
+            REQUIRE(entry.m_prefixLength==48);
+            REQUIRE(database.value(entry, {"city", "names", "en"}).toString()=="Berlin");
+
+            REQUIRE(!database.find(QHostAddress("2001:db8:2::1"), entry));
+        } else {
+            REQUIRE(database.find(QHostAddress("::ffff:81.2.69.1"), entry));
+            REQUIRE(!database.find(QHostAddress("2001:db8:1:2::1"), entry));
+        }
+    }
+
+    SECTION("check damaged databases are rejected or read safely") {
+        QFile file(filename);
+
+        REQUIRE(file.open(QFile::ReadOnly));
+
+        auto content = file.readAll();
+        auto damagedFilename = temporaryDir.filePath("damaged.mmdb");
+
+        file.close();
+
+        srand(static_cast<unsigned int>(ipVersion*recordSize));
+
+        for (auto iteration = 0; iteration<1000; iteration++) {
+            auto damaged = content;
+
+            for (auto change = 0; change<8; change++) {
+                damaged[rand()%damaged.length()] = static_cast<char>(rand());
+            }
+
+            if ((iteration%4)==0) {
+                damaged.truncate(rand()%damaged.length());
+            }
+
+            QFile damagedFile(damagedFilename);
+
+            REQUIRE(damagedFile.open(QFile::WriteOnly));
+
+            damagedFile.write(damaged);
+            damagedFile.close();
+
+            Nedrysoft::MaxMindDatabase::MaxMindDatabase damagedDatabase;
+
+            if (!damagedDatabase.open(damagedFilename)) {
+                continue;
+            }
+
+            for (const auto &address : QStringList() << "81.2.69.160" << "192.0.2.200" << "2001:db8:1::1") {
+                if (damagedDatabase.find(QHostAddress(address), entry)) {
+                    damagedDatabase.decode(entry);
+                    damagedDatabase.value(entry, {"subdivisions", "0", "iso_code"});
+                }
+            }
+        }
+    }
+}
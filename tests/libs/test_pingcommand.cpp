@@ -0,0 +1,468 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 19/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "catch.hpp"
+#include "PingCommand/PingCommand.h"
+#include "PingCommand/PingOutputParser.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QList>
+#include <QRegularExpression>
+#include <QTemporaryDir>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#if defined(Q_OS_UNIX)
+
+constexpr auto FakePingScript = R"(#!/bin/sh
+echo "$@" >> "$0.log"
+for host; do :; done
+echo "PING $host ($host) 56(84) bytes of data."
+echo "[1600000000.101500] 64 bytes from $host: icmp_seq=1 ttl=64 time=1.50 ms"
+sleep 0.1
+echo "[1600000000.350000] From 192.0.2.254 icmp_seq=2 Time to live exceeded"
+sleep 0.1
+echo "[1600000000.350000] From 192.0.2.254 icmp_seq=2 Time to live exceeded"
+echo "[1600000000.600000] no answer yet for icmp_seq=3"
+echo "[1600000000.600000] no answer yet for icmp_seq=2"
+exec sleep 10
+)";
+
+constexpr auto FakeWrappingPingScript = R"(#!/bin/sh
+for host; do :; done
+echo "PING $host ($host) 56(84) bytes of data."
+echo "[1600000000.101500] 64 bytes from $host: icmp_seq=65535 ttl=64 time=1.50 ms"
+echo "[1600000000.350000] From 192.0.2.254 icmp_seq=0 Time to live exceeded"
+echo "[1600000000.400000] 64 bytes from $host: icmp_seq=65535 ttl=64 time=1.50 ms"
+echo "[1600000000.600000] no answer yet for icmp_seq=1"
+exec sleep 10
+)";
+
+/**
+ * @brief       A reply reported by the ping command.
+ */
+struct FakePingReply {
+    unsigned long sampleNumber;
+    Nedrysoft::PingCommand::PingCommand::ReplyType replyType;
+    QHostAddress hostAddress;
+    QDateTime requestTime;
+    double roundTripTime;
+};
+
+TEST_CASE("PingCommand Tests", "[app][libs][network]") {
+    QTemporaryDir temporaryDir;
+
+    auto programPath = temporaryDir.filePath("ping");
+
+    QFile programFile(programPath);
+
+    REQUIRE(programFile.open(QFile::WriteOnly));
+
+    programFile.write(FakePingScript);
+    programFile.close();
+    programFile.setPermissions(programFile.permissions() | QFile::ExeOwner);
+
+    SECTION("check output is streamed from a single process") {
+        Nedrysoft::PingCommand::PingCommand pingCommand;
+        QList<FakePingReply> replies;
+
+        QObject::connect(
+            &pingCommand,
+            &Nedrysoft::PingCommand::PingCommand::reply,
+            [&replies](unsigned long sampleNumber,
+                       Nedrysoft::PingCommand::PingCommand::ReplyType replyType,
+                       const QHostAddress &hostAddress,
+                       const QDateTime &requestTime,
+                       double roundTripTime) {
+
+                replies.append(FakePingReply{sampleNumber, replyType, hostAddress, requestTime, roundTripTime});
+            }
+        );
+
+        pingCommand.setProgram(programPath);
+
+        auto arguments = pingCommand.start(QHostAddress("192.0.2.1"), 3, 250);
+
+        REQUIRE_MESSAGE(arguments.contains("-i"), "The interval was not passed to the ping command.");
+        REQUIRE_MESSAGE(arguments.at(arguments.indexOf("-i")+1)=="0.250", "The interval was passed incorrectly.");
+
+        QElapsedTimer timer;
+
+        timer.start();
+
+        while ((replies.count()<3) && (timer.elapsed()<5000)) {
+            QCoreApplication::processEvents(QEventLoop::AllEvents, 50);
+        }
+
+        REQUIRE_MESSAGE(replies.count()==3, "The replies were not streamed from the ping command.");
+
+        REQUIRE_MESSAGE(pingCommand.isRunning(), "The ping command exited after the first sample.");
+
+        REQUIRE(replies.at(0).sampleNumber==0);
+        REQUIRE(replies.at(0).replyType==Nedrysoft::PingCommand::PingCommand::ReplyType::Reply);
+        REQUIRE(replies.at(0).hostAddress==QHostAddress("192.0.2.1"));
+        REQUIRE(replies.at(0).roundTripTime==Approx(0.0015));
+        REQUIRE(replies.at(0).requestTime.toMSecsSinceEpoch()==1600000000100);
+
+        /**
+         * the time exceeded reply does not carry a round trip time, it is calculated from the send time of the
+         * echo reply and the interval, the duplicate reply for the same request is ignored.
+         */
+
+        REQUIRE(replies.at(1).sampleNumber==1);
+        REQUIRE(replies.at(1).replyType==Nedrysoft::PingCommand::PingCommand::ReplyType::TimeExceeded);
+        REQUIRE(replies.at(1).hostAddress==QHostAddress("192.0.2.254"));
+        REQUIRE(replies.at(1).roundTripTime==Approx(0.0));
+        REQUIRE(replies.at(1).requestTime.toMSecsSinceEpoch()==1600000000350);
+
+        REQUIRE(replies.at(2).sampleNumber==2);
+        REQUIRE(replies.at(2).replyType==Nedrysoft::PingCommand::PingCommand::ReplyType::NoReply);
+        REQUIRE(replies.at(2).hostAddress.isNull());
+        REQUIRE(replies.at(2).roundTripTime<0);
+
+        pingCommand.stop();
+
+        REQUIRE_MESSAGE(!pingCommand.isRunning(), "The ping command was not stopped.");
+
+        QFile logFile(programPath+".log");
+
+        REQUIRE(logFile.open(QFile::ReadOnly));
+
+        auto invocations = logFile.readAll().trimmed().split('\n');
+
+        REQUIRE_MESSAGE(invocations.count()==1, "More than one ping process was started.");
+        REQUIRE(invocations.at(0).contains("-t 3"));
+    }
+
+    SECTION("check the sequence number is extended when it wraps") {
+        auto wrappingProgramPath = temporaryDir.filePath("ping-wrap");
+
+        QFile wrappingProgramFile(wrappingProgramPath);
+
+        REQUIRE(wrappingProgramFile.open(QFile::WriteOnly));
+
+        wrappingProgramFile.write(FakeWrappingPingScript);
+        wrappingProgramFile.close();
+        wrappingProgramFile.setPermissions(wrappingProgramFile.permissions() | QFile::ExeOwner);
+
+        Nedrysoft::PingCommand::PingCommand pingCommand;
+        QList<FakePingReply> replies;
+
+        QObject::connect(
+            &pingCommand,
+            &Nedrysoft::PingCommand::PingCommand::reply,
+            [&replies](unsigned long sampleNumber,
+                       Nedrysoft::PingCommand::PingCommand::ReplyType replyType,
+                       const QHostAddress &hostAddress,
+                       const QDateTime &requestTime,
+                       double roundTripTime) {
+
+                replies.append(FakePingReply{sampleNumber, replyType, hostAddress, requestTime, roundTripTime});
+            }
+        );
+
+        pingCommand.setProgram(wrappingProgramPath);
+        pingCommand.start(QHostAddress("192.0.2.1"), 3, 250);
+
+        QElapsedTimer timer;
+
+        timer.start();
+
+        while ((replies.count()<3) && (timer.elapsed()<5000)) {
+            QCoreApplication::processEvents(QEventLoop::AllEvents, 50);
+        }
+
+        REQUIRE_MESSAGE(replies.count()==3, "The replies after the sequence number wrapped were ignored.");
+
+        REQUIRE(replies.at(0).sampleNumber==65534);
+        REQUIRE(replies.at(0).replyType==Nedrysoft::PingCommand::PingCommand::ReplyType::Reply);
+        REQUIRE(replies.at(0).requestTime.toMSecsSinceEpoch()==1600000000100);
+
+        /**
+         * the request after 65535 is reported with a sequence number of 0, it carries on from the last request
+         * and its send time follows on from the echo reply, the late reply from before the wrap is ignored.
+         */
+
+        REQUIRE(replies.at(1).sampleNumber==65535);
+        REQUIRE(replies.at(1).replyType==Nedrysoft::PingCommand::PingCommand::ReplyType::TimeExceeded);
+        REQUIRE(replies.at(1).requestTime.toMSecsSinceEpoch()==1600000000350);
+
+        REQUIRE(replies.at(2).sampleNumber==65536);
+        REQUIRE(replies.at(2).replyType==Nedrysoft::PingCommand::PingCommand::ReplyType::NoReply);
+
+        pingCommand.stop();
+    }
+}
+
+#endif
+
+/**
+ * @brief       A line of ping output and the information that should be parsed from it.
+ */
+struct CorpusLine {
+    const char *text;
+    Nedrysoft::PingCommand::PingOutputParser::LineType type;
+    long sequence;
+    double roundTripTime;
+    const char *address;
+};
+
+static const CorpusLine PingOutputCorpus[] = {
+    /* iputils */
+    {"PING 192.0.2.1 (192.0.2.1) 56(84) bytes of data.", Nedrysoft::PingCommand::PingOutputParser::LineType::Unknown, -1, -1, ""},
+    {"64 bytes from 192.0.2.1: icmp_seq=1 ttl=57 time=10.2 ms", Nedrysoft::PingCommand::PingOutputParser::LineType::Reply, 1, 10.2, "192.0.2.1"},
+    {"[1600000000.101500] 64 bytes from 192.0.2.1: icmp_seq=2 ttl=57 time=1.50 ms", Nedrysoft::PingCommand::PingOutputParser::LineType::Reply, 2, 1.5, "192.0.2.1"},
+    {"64 bytes from dns.example (192.0.2.53): icmp_seq=3 ttl=117 time=12.3 ms", Nedrysoft::PingCommand::PingOutputParser::LineType::Reply, 3, 12.3, "192.0.2.53"},
+    {"64 bytes from 2001:db8::1: icmp_seq=4 ttl=64 time=0.045 ms", Nedrysoft::PingCommand::PingOutputParser::LineType::Reply, 4, 0.045, "2001:db8::1"},
+    {"64 bytes from 192.0.2.1: icmp_seq=5 ttl=57 time=10.2 ms (DUP!)", Nedrysoft::PingCommand::PingOutputParser::LineType::Reply, 5, 10.2, "192.0.2.1"},
+    {"From 192.0.2.254 icmp_seq=6 Time to live exceeded", Nedrysoft::PingCommand::PingOutputParser::LineType::TimeExceeded, 6, -1, "192.0.2.254"},
+    {"[1600000000.350000] From 192.0.2.254 icmp_seq=7 Time to live exceeded", Nedrysoft::PingCommand::PingOutputParser::LineType::TimeExceeded, 7, -1, "192.0.2.254"},
+    {"From router.example (192.0.2.254) icmp_seq=8 Time to live exceeded", Nedrysoft::PingCommand::PingOutputParser::LineType::TimeExceeded, 8, -1, "192.0.2.254"},
+    {"From 2001:db8::fe icmp_seq=9 Time exceeded: Hop limit", Nedrysoft::PingCommand::PingOutputParser::LineType::TimeExceeded, 9, -1, "2001:db8::fe"},
+    {"From 192.0.2.254 icmp_seq=10 Destination Host Unreachable", Nedrysoft::PingCommand::PingOutputParser::LineType::Unreachable, 10, -1, "192.0.2.254"},
+    {"From 192.0.2.254 icmp_seq=11 Redirect Host(New nexthop: 192.0.2.253)", Nedrysoft::PingCommand::PingOutputParser::LineType::Unknown, -1, -1, ""},
+    {"[1600000000.600000] no answer yet for icmp_seq=12", Nedrysoft::PingCommand::PingOutputParser::LineType::NoAnswer, 12, -1, ""},
+    {"--- 192.0.2.1 ping statistics ---", Nedrysoft::PingCommand::PingOutputParser::LineType::Unknown, -1, -1, ""},
+    {"1 packets transmitted, 0 received, 100% packet loss, time 0ms", Nedrysoft::PingCommand::PingOutputParser::LineType::Unknown, -1, -1, ""},
+
+    /* BusyBox */
+    {"PING 192.0.2.1 (192.0.2.1): 56 data bytes", Nedrysoft::PingCommand::PingOutputParser::LineType::Unknown, -1, -1, ""},
+    {"64 bytes from 192.0.2.1: seq=0 ttl=57 time=10.234 ms", Nedrysoft::PingCommand::PingOutputParser::LineType::Reply, 0, 10.234, "192.0.2.1"},
+
+    /* macOS */
+    {"64 bytes from 192.0.2.1: icmp_seq=0 ttl=57 time=10.234 ms", Nedrysoft::PingCommand::PingOutputParser::LineType::Reply, 0, 10.234, "192.0.2.1"},
+    {"12:34:56.789012 64 bytes from 192.0.2.1: icmp_seq=1 ttl=57 time=9.876 ms", Nedrysoft::PingCommand::PingOutputParser::LineType::Reply, 1, 9.876, "192.0.2.1"},
+    {"92 bytes from 192.0.2.254: Time to live exceeded", Nedrysoft::PingCommand::PingOutputParser::LineType::TimeExceeded, -1, -1, "192.0.2.254"},
+    {"92 bytes from 192.0.2.254: Destination Host Unreachable", Nedrysoft::PingCommand::PingOutputParser::LineType::Unreachable, -1, -1, "192.0.2.254"},
+    {"Request timeout for icmp_seq 5", Nedrysoft::PingCommand::PingOutputParser::LineType::NoAnswer, 5, -1, ""},
+    {"Vr HL TOS  Len   ID Flg  off TTL Pro  cks      Src      Dst", Nedrysoft::PingCommand::PingOutputParser::LineType::Unknown, -1, -1, ""},
+};
+
+/**
+ * @brief       The regular expression parser that the ping command path used before the byte parser.
+ *
+ * @details     Kept as a reference for the benchmark and to check that both parsers agree on iputils output.
+ */
+static auto regularExpressionParse(const QByteArray &data, QString &address, unsigned long &sequence) -> int {
+    static const QRegularExpression replyRegEx(R"(bytes from (?<ip>\S+?):? icmp_seq=(?<sequence>\d+) .*time=(?<time>[\d\.]+) ms)");
+    static const QRegularExpression errorRegEx(R"(From (?<ip>\S+?):? icmp_seq=(?<sequence>\d+) (?<message>.*))");
+    static const QRegularExpression noAnswerRegEx(R"(no answer yet for icmp_seq=(?<sequence>\d+))");
+
+    auto text = QString::fromLatin1(data);
+
+    auto replyMatch = replyRegEx.match(text);
+
+    if (replyMatch.hasMatch()) {
+        address = replyMatch.captured("ip");
+        sequence = replyMatch.captured("sequence").toULong();
+
+        return static_cast<int>(Nedrysoft::PingCommand::PingOutputParser::LineType::Reply);
+    }
+
+    auto errorMatch = errorRegEx.match(text);
+
+    if (errorMatch.hasMatch()) {
+        address = errorMatch.captured("ip");
+        sequence = errorMatch.captured("sequence").toULong();
+
+        if (errorMatch.captured("message").contains("exceeded")) {
+            return static_cast<int>(Nedrysoft::PingCommand::PingOutputParser::LineType::TimeExceeded);
+        }
+
+        return static_cast<int>(Nedrysoft::PingCommand::PingOutputParser::LineType::Unreachable);
+    }
+
+    auto noAnswerMatch = noAnswerRegEx.match(text);
+
+    if (noAnswerMatch.hasMatch()) {
+        sequence = noAnswerMatch.captured("sequence").toULong();
+
+        return static_cast<int>(Nedrysoft::PingCommand::PingOutputParser::LineType::NoAnswer);
+    }
+
+    return static_cast<int>(Nedrysoft::PingCommand::PingOutputParser::LineType::Unknown);
+}
+
+TEST_CASE("PingOutputParser Tests", "[app][libs][network]") {
+    SECTION("check the corpus is parsed") {
+        for (auto &corpusLine : PingOutputCorpus) {
+            Nedrysoft::PingCommand::PingOutputParser::Line line;
+
+            INFO(corpusLine.text);
+
+            auto isResult = Nedrysoft::PingCommand::PingOutputParser::parse(
+                corpusLine.text,
+                static_cast<int>(strlen(corpusLine.text)),
+                line
+            );
+
+            REQUIRE(isResult==(corpusLine.type!=Nedrysoft::PingCommand::PingOutputParser::LineType::Unknown));
+            REQUIRE(line.type==corpusLine.type);
+
+            if (!isResult) {
+                continue;
+            }
+
+            REQUIRE(line.hasSequence==(corpusLine.sequence>=0));
+
+            if (line.hasSequence) {
+                REQUIRE(line.sequence==static_cast<unsigned long>(corpusLine.sequence));
+            }
+
+            REQUIRE(line.roundTripTime==Approx(corpusLine.roundTripTime));
+            REQUIRE(Nedrysoft::PingCommand::PingOutputParser::hostAddress(line)==QHostAddress(corpusLine.address));
+        }
+    }
+
+    SECTION("check timestamps are parsed") {
+        Nedrysoft::PingCommand::PingOutputParser::Line line;
+
+        auto epochLine = "[1600000000.101500] 64 bytes from 192.0.2.1: icmp_seq=2 ttl=57 time=1.50 ms\n";
+
+        REQUIRE(Nedrysoft::PingCommand::PingOutputParser::parse(epochLine, static_cast<int>(strlen(epochLine)), line));
+        REQUIRE(line.timestampType==Nedrysoft::PingCommand::PingOutputParser::TimestampType::Epoch);
+        REQUIRE(qRound64(line.timestamp*1000000)==Q_INT64_C(1600000000101500));
+
+        auto timeOfDayLine = "12:34:56.789012 64 bytes from 192.0.2.1: icmp_seq=1 ttl=57 time=9.876 ms";
+
+        REQUIRE(Nedrysoft::PingCommand::PingOutputParser::parse(timeOfDayLine, static_cast<int>(strlen(timeOfDayLine)), line));
+        REQUIRE(line.timestampType==Nedrysoft::PingCommand::PingOutputParser::TimestampType::TimeOfDay);
+        REQUIRE(line.timestamp==Approx(12*3600+34*60+56.789012));
+    }
+
+    SECTION("check the parser agrees with the regular expressions on iputils output") {
+        for (auto &corpusLine : PingOutputCorpus) {
+            Nedrysoft::PingCommand::PingOutputParser::Line line;
+            QString regExAddress;
+            unsigned long regExSequence = 0;
+
+            if ((strstr(corpusLine.text, "icmp_seq=")==nullptr) || (strstr(corpusLine.text, "(")!=nullptr)) {
+                continue;
+            }
+
+            INFO(corpusLine.text);
+
+            auto regExType = regularExpressionParse(corpusLine.text, regExAddress, regExSequence);
+
+            Nedrysoft::PingCommand::PingOutputParser::parse(corpusLine.text, static_cast<int>(strlen(corpusLine.text)), line);
+
+            REQUIRE(static_cast<int>(line.type)==regExType);
+            REQUIRE(line.sequence==regExSequence);
+            REQUIRE(QString::fromLatin1(line.address, line.addressLength)==regExAddress);
+        }
+    }
+
+    SECTION("check mutated lines are parsed safely") {
+        std::mt19937 generator(0x50494e47);
+
+        /**
+         * every mutation is copied into a buffer of exactly its own length so that a read past the end of the
+         * line is caught by the address sanitizer, and the address must always lie within the line.
+         */
+
+        for (auto iteration=0;iteration<20000;iteration++) {
+            auto &corpusLine = PingOutputCorpus[generator()%(sizeof(PingOutputCorpus)/sizeof(PingOutputCorpus[0]))];
+            auto length = static_cast<int>(strlen(corpusLine.text));
+            auto mutation = std::vector<char>(corpusLine.text, corpusLine.text+length);
+
+            switch (generator()%3) {
+                case 0: {
+                    mutation.resize(generator()%(mutation.size()+1));
+                    break;
+                }
+
+                case 1: {
+                    for (auto flips=generator()%4;flips>0 && !mutation.empty();flips--) {
+                        mutation[generator()%mutation.size()] = static_cast<char>(generator());
+                    }
+                    break;
+                }
+
+                default: {
+                    for (auto &character : mutation) {
+                        if ((generator()%8)==0) {
+                            character = "0123456789.:=[] "[generator()%16];
+                        }
+                    }
+                    break;
+                }
+            }
+
+            auto buffer = std::vector<char>(mutation);
+            Nedrysoft::PingCommand::PingOutputParser::Line line;
+
+            if (buffer.empty()) {
+                REQUIRE_FALSE(Nedrysoft::PingCommand::PingOutputParser::parse(nullptr, 0, line));
+
+                continue;
+            }
+
+            Nedrysoft::PingCommand::PingOutputParser::parse(buffer.data(), static_cast<int>(buffer.size()), line);
+
+            if (line.address) {
+                REQUIRE(line.address>=buffer.data());
+                REQUIRE(line.address+line.addressLength<=buffer.data()+buffer.size());
+            }
+        }
+    }
+}
+
+TEST_CASE("PingOutputParser Throughput", "[.][benchmark][libs][network]") {
+    auto lines = QList<QByteArray>();
+
+    for (auto &corpusLine : PingOutputCorpus) {
+        lines.append(QByteArray(corpusLine.text));
+    }
+
+    BENCHMARK("regular expression parser") {
+        auto results = 0;
+
+        for (auto &line : lines) {
+            QString address;
+            unsigned long sequence;
+
+            if (regularExpressionParse(line, address, sequence)!=0) {
+                results++;
+            }
+        }
+
+        return results;
+    };
+
+    BENCHMARK("byte parser") {
+        auto results = 0;
+
+        for (auto &line : lines) {
+            Nedrysoft::PingCommand::PingOutputParser::Line parsedLine;
+
+            if (Nedrysoft::PingCommand::PingOutputParser::parse(line.constData(), line.length(), parsedLine)) {
+                results++;
+            }
+        }
+
+        return results;
+    };
+}